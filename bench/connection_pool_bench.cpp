@@ -0,0 +1,110 @@
+// 连接池争用基准：原 mutex + std::queue 空闲队列 vs 线程亲和槽 + 无锁MPMC环形队列，
+// 多个线程反复取出/归还连接（连接用占位对象代替，不访问数据库）
+// 用法: ConnectionPoolBench [每线程操作数] [池大小]
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+#include "ConnectionCache.h"
+
+namespace {
+
+struct FakeConnection {
+    uint64_t uses = 0;
+};
+
+// 迁移前ConnectionPool的空闲队列
+class MutexQueuePool {
+public:
+    explicit MutexQueuePool(size_t size) : maxConnections(size) {
+        for (size_t i = 0; i < size; ++i) pool.push(std::make_unique<FakeConnection>());
+    }
+
+    std::unique_ptr<FakeConnection> getConnection() {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        if (pool.empty()) return std::make_unique<FakeConnection>();
+        auto conn = std::move(pool.front());
+        pool.pop();
+        return conn;
+    }
+
+    void returnConnection(std::unique_ptr<FakeConnection> conn) {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        if (pool.size() < maxConnections) pool.push(std::move(conn));
+    }
+
+private:
+    std::queue<std::unique_ptr<FakeConnection>> pool;
+    std::mutex poolMutex;
+    size_t maxConnections;
+};
+
+class CachedPool {
+public:
+    explicit CachedPool(size_t size) : idle(size) {
+        for (size_t i = 0; i < size; ++i) idle.release(new FakeConnection());
+    }
+    ~CachedPool() {
+        idle.drain([](FakeConnection* conn) { delete conn; });
+    }
+
+    std::unique_ptr<FakeConnection> getConnection() {
+        FakeConnection* conn = idle.acquire();
+        return std::unique_ptr<FakeConnection>(conn ? conn : new FakeConnection());
+    }
+
+    void returnConnection(std::unique_ptr<FakeConnection> conn) {
+        if (idle.release(conn.get())) conn.release();
+    }
+
+private:
+    ConnectionCache<FakeConnection> idle;
+};
+
+template <typename Pool>
+double measure(size_t threads, size_t operations, size_t poolSize) {
+    Pool pool(poolSize);
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&]() {
+            while (!go.load()) std::this_thread::yield();
+            for (size_t i = 0; i < operations; ++i) {
+                auto conn = pool.getConnection();
+                ++conn->uses;  // 模拟一次DAO调用对连接的使用
+                pool.returnConnection(std::move(conn));
+            }
+        });
+    }
+    auto start = std::chrono::steady_clock::now();
+    go.store(true);
+    for (auto& worker : workers) worker.join();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return threads * operations / elapsed / 1e6;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t operations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    size_t poolSize = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10;
+    size_t maxThreads = std::max<size_t>(32, std::thread::hardware_concurrency());
+
+    std::cout << "每线程操作数: " << operations << ", 池大小: " << poolSize << " (单位: 百万次取还/秒)" << std::endl;
+    std::cout << std::left << std::setw(8) << "threads" << std::setw(16) << "mutex+queue" << std::setw(16)
+              << "affinity+mpmc" << "speedup" << std::endl;
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        double baseline = measure<MutexQueuePool>(threads, operations, poolSize);
+        double cached = measure<CachedPool>(threads, operations, poolSize);
+        std::cout << std::left << std::setw(8) << threads << std::fixed << std::setprecision(2) << std::setw(16)
+                  << baseline << std::setw(16) << cached << cached / baseline << "x" << std::endl;
+    }
+    return 0;
+}
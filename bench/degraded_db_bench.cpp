@@ -0,0 +1,108 @@
+// 数据库降级基准：多个线程在请求截止时间内反复取连接并查询，统计延迟分位数与
+// 成功/超时/失败/快速失败的次数，观察连接池、熔断与截止时间在数据库变慢或出错时的表现。
+// 需要本地mysqld；故障通过环境变量注入，例如:
+//   HOSPITAL_DB_FAULTS='table=appointments delay=5-50 tail=0.02:2000; * error=0.01:2013' DegradedDbBench localhost root secret hospital_db 32 200 1000
+// 用法: DegradedDbBench <主机> <用户> <密码> <数据库> [线程数] [每线程请求数] [超时毫秒]
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "DatabaseConnection.h"
+
+namespace {
+
+// 每个请求依次执行的读取，覆盖规则常用的几张表
+const char* const kQueries[] = {
+    "SELECT doctor_id, name FROM doctors ORDER BY doctor_id LIMIT 20",
+    "SELECT COUNT(*) FROM appointments WHERE status = 'Booked'",
+    "SELECT case_id, diagnosis FROM cases ORDER BY case_id DESC LIMIT 20"
+};
+
+enum class Outcome { OK, TIMEOUT, FAILED, UNAVAILABLE };
+
+Outcome runRequest(ConnectionPool& pool, std::chrono::milliseconds timeout) {
+    RequestDeadline deadline(RequestDeadline::Clock::now() + timeout);
+    RequestDeadline::Scope scope(&deadline);
+
+    auto conn = pool.getConnection();
+    if (!conn) {
+        return deadline.expired() ? Outcome::TIMEOUT : Outcome::UNAVAILABLE;
+    }
+    bool ok = true;
+    for (const char* query : kQueries) {
+        MYSQL_RES* result = conn->executeQuery(query);
+        if (!result) {
+            ok = false;
+            break;
+        }
+        mysql_free_result(result);
+    }
+    pool.returnConnection(std::move(conn));
+    if (ok) return Outcome::OK;
+    return deadline.wasExceeded() || deadline.expired() ? Outcome::TIMEOUT : Outcome::FAILED;
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    return sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()))];
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 5) {
+        std::cerr << "用法: " << argv[0] << " <主机> <用户> <密码> <数据库> [线程数] [每线程请求数] [超时毫秒]" << std::endl;
+        return 1;
+    }
+    size_t threads = argc > 5 ? std::strtoul(argv[5], nullptr, 10) : 16;
+    size_t requests = argc > 6 ? std::strtoul(argv[6], nullptr, 10) : 200;
+    std::chrono::milliseconds timeout(argc > 7 ? std::strtol(argv[7], nullptr, 10) : 1000);
+
+    ConnectionPool pool(argv[1], argv[2], argv[3], argv[4], 3306, std::max<size_t>(10, threads / 2));
+
+    std::mutex latencyMutex;
+    std::vector<double> latencies;
+    std::atomic<size_t> counts[4] = {};
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&]() {
+            std::vector<double> local;
+            for (size_t i = 0; i < requests; ++i) {
+                auto begin = std::chrono::steady_clock::now();
+                Outcome outcome = runRequest(pool, timeout);
+                local.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count());
+                counts[static_cast<int>(outcome)].fetch_add(1);
+            }
+            std::lock_guard<std::mutex> lock(latencyMutex);
+            latencies.insert(latencies.end(), local.begin(), local.end());
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::sort(latencies.begin(), latencies.end());
+
+    std::cout << "线程: " << threads << ", 每线程请求: " << requests << ", 超时: " << timeout.count() << "ms, 吞吐: "
+              << std::fixed << std::setprecision(1) << latencies.size() / elapsed << " 请求/秒" << std::endl;
+    std::cout << "延迟(ms) p50=" << percentile(latencies, 0.50) << " p95=" << percentile(latencies, 0.95)
+              << " p99=" << percentile(latencies, 0.99) << " max=" << (latencies.empty() ? 0 : latencies.back()) << std::endl;
+    std::cout << "成功: " << counts[0] << ", 超时: " << counts[1] << ", 失败: " << counts[2]
+              << ", 未取得连接(熔断或连接失败): " << counts[3] << std::endl;
+
+    auto breakerStats = pool.getBreaker()->getStats();
+    std::cout << "熔断器: " << CircuitBreaker::stateName(breakerStats.state) << ", 打开次数: " << breakerStats.timesOpened
+              << ", 拒绝: " << breakerStats.rejected << std::endl;
+    if (auto injector = DatabaseConnection::getFaultInjector()) {
+        auto faultStats = injector->getStats();
+        std::cout << "注入: 延迟 " << faultStats.delayed << " 次, 错误 " << faultStats.failed << " 次" << std::endl;
+    } else {
+        std::cout << "未设置HOSPITAL_DB_FAULTS，数据库未降级" << std::endl;
+    }
+    return 0;
+}
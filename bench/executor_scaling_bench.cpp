@@ -0,0 +1,87 @@
+// 执行器扩展性基准：模拟请求在工作窃取线程池上处理，请求内再扇出若干子任务，
+// 统计不同工作线程数下的吞吐量及相对单线程的加速比
+// 用法: ExecutorScalingBench [请求数] [每个请求的扇出数]
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "FanOutExecutor.h"
+#include "ThreadPool.h"
+
+namespace {
+
+volatile uint64_t benchSink = 0;
+
+// 模拟一次DAO读取后的结果组装（纯计算，约数微秒）
+uint64_t simulateWork(uint64_t seed) {
+    uint64_t value = seed | 1;
+    for (int i = 0; i < 2000; ++i) {
+        value ^= value << 13;
+        value ^= value >> 7;
+        value ^= value << 17;
+    }
+    return value;
+}
+
+double runScenario(size_t workers, size_t requests, size_t fanOut) {
+    auto pool = std::make_shared<ThreadPool>(workers);
+    FanOutExecutor executor(pool);
+    std::atomic<size_t> remaining{requests};
+    std::atomic<uint64_t> sink{0};
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < requests; ++r) {
+        pool->submit([&, r]() {
+            uint64_t total = simulateWork(r);
+            std::vector<FanOutExecutor::Future<uint64_t>> parts;
+            parts.reserve(fanOut);
+            for (size_t k = 0; k < fanOut; ++k) {
+                parts.push_back(executor.submit([r, k]() { return simulateWork(r * 31 + k); }));
+            }
+            for (auto& part : parts) {
+                total += part.get();
+            }
+            sink.fetch_add(total, std::memory_order_relaxed);
+            remaining.fetch_sub(1);
+        });
+    }
+    while (remaining.load() > 0) {
+        std::this_thread::yield();
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    pool->shutdown();
+    benchSink = sink.load();
+    return requests / elapsed;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t requests = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+    size_t fanOut = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4;
+    size_t maxWorkers = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<size_t> workerCounts;
+    for (size_t workers = 1; workers < maxWorkers; workers *= 2) {
+        workerCounts.push_back(workers);
+    }
+    workerCounts.push_back(maxWorkers);
+
+    std::cout << "请求数: " << requests << ", 每个请求扇出: " << fanOut << std::endl;
+    std::cout << std::left << std::setw(10) << "线程数" << std::setw(16) << "请求/秒" << "加速比" << std::endl;
+
+    double baseline = 0;
+    for (size_t workers : workerCounts) {
+        double rate = runScenario(workers, requests, fanOut);
+        if (baseline == 0) baseline = rate;
+        std::cout << std::left << std::setw(10) << workers << std::setw(16) << std::fixed << std::setprecision(0)
+                  << rate << std::setprecision(2) << rate / baseline << "x" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,221 @@
+// 请求解析/响应序列化微基准：完整DOM + 复制 vs 信封按需解析 + 响应直写
+// 用法: RequestCodecBench [测试语料目录] [轮数]
+// 请求取自 <目录>/{public,patient,doctor}/*.json，响应数据取自 <目录>/results 下的记录，
+// 另附一条4MB的 doctor.labResult.upload 请求；最后对比 JSON/MessagePack/CBOR 信封的体积与编解码耗时
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "JsonStream.h"
+
+namespace {
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+volatile size_t benchSink = 0;
+
+std::string readFile(const fs::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+}
+
+std::vector<std::string> loadCorpus(const fs::path& dir) {
+    std::vector<std::string> files;
+    if (!fs::is_directory(dir)) return files;
+    for (const auto& entry : fs::recursive_directory_iterator(dir)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".json") {
+            files.push_back(readFile(entry.path()));
+        }
+    }
+    return files;
+}
+
+// 迁移前的处理方式：完整解析、复制data、构造响应DOM后dump
+size_t legacyRoundTrip(const std::string& request, const json& responseData) {
+    json parsed = json::parse(request);
+    std::string api = parsed["api"];
+    json data = parsed["data"];
+
+    json response;
+    response["status"] = "success";
+    response["code"] = 200;
+    response["message"] = "ok";
+    response["data"] = responseData;
+    return response.dump().size() + api.size() + data.size();
+}
+
+size_t streamingRoundTrip(const std::string& request, const json& responseData, std::string& buffer) {
+    RequestEnvelope envelope;
+    if (!envelope.scan(request)) return 0;
+    json data = envelope.parseData();
+
+    JsonResponseWriter::write(buffer, "success", 200, "ok", responseData);
+    return buffer.size() + envelope.api.size() + data.size();
+}
+
+// 单一格式的完整往返：解码请求 + 写出响应
+size_t wireRoundTrip(const std::string& request, const json& responseData, WireFormat format, std::string& buffer) {
+    json parsed = WireCodec::decode(request, format);
+    WireCodec::writeResponse(buffer, format, "success", 200, "ok", responseData);
+    return buffer.size() + parsed.size();
+}
+
+std::string encodeAs(const json& value, WireFormat format) {
+    std::string out;
+    if (format == WireFormat::MSGPACK) {
+        json::to_msgpack(value, nlohmann::detail::output_adapter<char>(out));
+    } else if (format == WireFormat::CBOR) {
+        json::to_cbor(value, nlohmann::detail::output_adapter<char>(out));
+    } else {
+        out = value.dump();
+    }
+    return out;
+}
+
+struct Percentiles {
+    double p50;
+    double p99;
+};
+
+Percentiles percentiles(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    auto at = [&](double q) { return samples[static_cast<size_t>(q * (samples.size() - 1))]; };
+    return {at(0.50), at(0.99)};
+}
+
+template <typename Fn>
+Percentiles measure(const std::vector<std::string>& requests, const std::vector<json>& responses, int rounds, Fn fn) {
+    std::vector<double> samples;
+    samples.reserve(requests.size() * rounds);
+    size_t sink = 0;
+    for (int r = 0; r < rounds; ++r) {
+        for (size_t i = 0; i < requests.size(); ++i) {
+            auto start = std::chrono::steady_clock::now();
+            sink += fn(requests[i], responses[i % responses.size()]);
+            samples.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        }
+    }
+    benchSink = sink;
+    return percentiles(samples);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    fs::path corpus = argc > 1 ? argv[1] : "test";
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 200;
+
+    std::vector<std::string> requests;
+    for (const char* group : {"public", "patient", "doctor"}) {
+        auto files = loadCorpus(corpus / group);
+        requests.insert(requests.end(), files.begin(), files.end());
+    }
+    std::vector<json> responses;
+    for (const auto& text : loadCorpus(corpus / "results")) {
+        json parsed = json::parse(text, nullptr, false);
+        if (parsed.is_object() && parsed.contains("data")) responses.push_back(parsed["data"]);
+    }
+    if (requests.empty() || responses.empty()) {
+        std::cerr << "测试语料为空: " << corpus << std::endl;
+        return 1;
+    }
+
+    // 正确性自检：data区间解析结果与完整解析一致，直写输出与dump逐字节一致
+    std::string buffer;
+    for (const auto& request : requests) {
+        RequestEnvelope envelope;
+        json full = json::parse(request, nullptr, false);
+        if (full.is_discarded() || !envelope.scan(request)) continue;
+        if (envelope.parseData() != full["data"] || envelope.api != full["api"]) {
+            std::cerr << "信封解析结果不一致: " << request << std::endl;
+            return 1;
+        }
+    }
+    for (const auto& data : responses) {
+        JsonResponseWriter::write(buffer, "success", 200, "ok", data);
+        json expected;
+        expected["status"] = "success";
+        expected["code"] = 200;
+        expected["message"] = "ok";
+        expected["data"] = data;
+        if (buffer != expected.dump()) {
+            std::cerr << "响应直写结果不一致: " << expected.dump() << std::endl;
+            return 1;
+        }
+    }
+
+    auto legacy = measure(requests, responses, rounds, legacyRoundTrip);
+    auto streaming = measure(requests, responses, rounds, [&](const std::string& request, const json& data) {
+        return streamingRoundTrip(request, data, buffer);
+    });
+
+    std::string upload = R"({"api":"doctor.labResult.upload","data":{"token":"doctor_token","patientId":"pat_1",)"
+                         R"("reportName":"血常规","fileContentBase64":")" + std::string(4 << 20, 'A') + "\"}}";
+    std::vector<std::string> uploads = {upload};
+    std::vector<json> uploadResponses = {json{{"resultId", "lab_res_1"}}};
+    int uploadRounds = std::max(1, rounds / 10);
+    auto legacyUpload = measure(uploads, uploadResponses, uploadRounds, legacyRoundTrip);
+    auto streamingUpload = measure(uploads, uploadResponses, uploadRounds, [&](const std::string& request, const json& data) {
+        return streamingRoundTrip(request, data, buffer);
+    });
+
+    // 二进制信封：同一批请求/响应分别编码为三种格式
+    std::vector<json> parsedRequests;
+    for (const auto& request : requests) {
+        json parsed = json::parse(request, nullptr, false);
+        if (!parsed.is_discarded()) parsedRequests.push_back(parsed);
+    }
+    parsedRequests.push_back(json::parse(upload));
+
+    struct WireResult {
+        WireFormat format;
+        size_t requestBytes = 0;
+        size_t responseBytes = 0;
+        Percentiles latency{0, 0};
+    };
+    std::vector<WireResult> wireResults;
+    for (WireFormat format : {WireFormat::JSON, WireFormat::MSGPACK, WireFormat::CBOR}) {
+        WireResult result;
+        result.format = format;
+        std::vector<std::string> encoded;
+        for (const auto& parsed : parsedRequests) {
+            encoded.push_back(encodeAs(parsed, format));
+            result.requestBytes += encoded.back().size();
+        }
+        for (const auto& data : responses) {
+            WireCodec::writeResponse(buffer, format, "success", 200, "ok", data);
+            json expected = {{"status", "success"}, {"code", 200}, {"message", "ok"}, {"data", data}};
+            if (buffer != encodeAs(expected, format) || WireCodec::detect(buffer) != format) {
+                std::cerr << WireCodec::formatName(format) << "响应编码结果不一致" << std::endl;
+                return 1;
+            }
+            result.responseBytes += buffer.size();
+        }
+        result.latency = measure(encoded, responses, uploadRounds, [&](const std::string& request, const json& data) {
+            return wireRoundTrip(request, data, format, buffer);
+        });
+        wireResults.push_back(result);
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "语料: " << requests.size() << " 条请求, " << responses.size() << " 条响应, 轮数: " << rounds << std::endl;
+    std::cout << "legacy     p50: " << legacy.p50 << " us  p99: " << legacy.p99 << " us" << std::endl;
+    std::cout << "streaming  p50: " << streaming.p50 << " us  p99: " << streaming.p99 << " us" << std::endl;
+    std::cout << "4MB上传 legacy     p50: " << legacyUpload.p50 << " us  p99: " << legacyUpload.p99 << " us" << std::endl;
+    std::cout << "4MB上传 streaming  p50: " << streamingUpload.p50 << " us  p99: " << streamingUpload.p99 << " us" << std::endl;
+    for (const auto& result : wireResults) {
+        std::cout << std::left << std::setw(8) << WireCodec::formatName(result.format) << std::right
+                  << " 请求 " << result.requestBytes << " 字节, 响应 " << result.responseBytes << " 字节, "
+                  << "p50: " << result.latency.p50 << " us  p99: " << result.latency.p99 << " us" << std::endl;
+    }
+    return 0;
+}
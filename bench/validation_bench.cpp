@@ -0,0 +1,96 @@
+// 请求参数校验微基准：原std::regex逐字段校验 vs 手写DFA匹配器
+// 用法: ValidationBench [轮数]
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <regex>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include "RequestValidator.h"
+
+namespace {
+
+volatile size_t benchSink = 0;
+
+// 迁移前ApiHandler中的正则校验（每次调用都重新构造正则）
+bool regexEmail(const std::string& email) {
+    const std::regex emailPattern(R"([a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,})");
+    return std::regex_match(email, emailPattern);
+}
+
+bool regexPhone(const std::string& phone) {
+    const std::regex phonePattern(R"(^1[3-9]\d{9}$)");
+    return std::regex_match(phone, phonePattern);
+}
+
+bool regexIdNumber(const std::string& idNumber) {
+    const std::regex idPattern(R"(^\d{17}[\dXx]$)");
+    return std::regex_match(idNumber, idPattern);
+}
+
+template <typename Fn>
+double measure(int rounds, size_t perRound, Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    size_t sink = 0;
+    for (int r = 0; r < rounds; ++r) {
+        sink += fn();
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    benchSink = sink;
+    return rounds * perRound / elapsed;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int rounds = argc > 1 ? std::atoi(argv[1]) : 20000;
+
+    const std::vector<std::string> emails = {"patient@example.com", "newpatient_test@example.com",
+                                             "invalid-email-format", "a.b+c@mail.hospital.org.cn"};
+    const std::vector<std::string> phones = {"13800138000", "13900139000", "invalid_phone_number", "12345678901"};
+    const std::vector<std::string> ids = {"340123199001151230", "11010120250901002X", "000000000000000000",
+                                          "34012319900115123"};
+    const size_t perRound = emails.size() + phones.size() + ids.size();
+
+    double regexRate = measure(rounds / 100 + 1, perRound, [&]() {
+        size_t ok = 0;
+        for (const auto& v : emails) ok += regexEmail(v);
+        for (const auto& v : phones) ok += regexPhone(v);
+        for (const auto& v : ids) ok += regexIdNumber(v);
+        return ok;
+    });
+
+    double dfaRate = measure(rounds, perRound, [&]() {
+        size_t ok = 0;
+        for (const auto& v : emails) ok += RequestValidator::matchEmail(v);
+        for (const auto& v : phones) ok += RequestValidator::matchCnMobile(v);
+        for (const auto& v : ids) ok += RequestValidator::matchIdNumber(v);
+        return ok;
+    });
+
+    // 整份schema校验：profile.update带全部可选格式字段
+    RequestValidator validator;
+    using Format = RequestValidator::FieldFormat;
+    validator.addSchema("patient.profile.update", {
+        RequestValidator::field("token").required(401, "缺少认证token"),
+        RequestValidator::field("dateOfBirth").withFormat(Format::DATE),
+        RequestValidator::field("idCardNumber").withFormat(Format::ID_NUMBER),
+        RequestValidator::field("phone").withFormat(Format::CN_MOBILE),
+        RequestValidator::field("email").withFormat(Format::EMAIL)
+    });
+    const nlohmann::json request = {
+        {"token", "patient_token_123456"}, {"name", "张三"}, {"dateOfBirth", "1990-01-15"},
+        {"idCardNumber", "340123199001151230"}, {"phone", "13800138123"}, {"email", "patient@example.com"}
+    };
+    double schemaRate = measure(rounds, 1, [&]() {
+        return validator.validate("patient.profile.update", request).size();
+    });
+
+    std::cout << std::fixed << std::setprecision(0);
+    std::cout << "regex: " << regexRate << " field/s" << std::endl;
+    std::cout << "dfa:   " << dfaRate << " field/s" << std::endl;
+    std::cout << std::setprecision(1) << "加速比: " << dfaRate / regexRate << "x" << std::endl;
+    std::cout << std::setprecision(0) << "schema(profile.update): " << schemaRate << " request/s" << std::endl;
+    return 0;
+}
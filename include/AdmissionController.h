@@ -0,0 +1,162 @@
+#ifndef ADMISSION_CONTROLLER_H
+#define ADMISSION_CONTROLLER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// 准入控制：限制同时处理的请求数（全局与按API），超出时进入有界等待队列，
+// 队列按优先级出队；排队超时或队列已满时快速失败并给出重试间隔。
+// 另按用户ID维护令牌桶，限制单个用户的请求速率。
+// 多租户（院区）时名额在租户间按权重公平分配：放行时优先处理中请求数相对权重最少的租户，
+// 每个租户只能占用按权重分得的那部分队列，一个租户的高峰不会挤掉其他租户的请求
+class AdmissionController {
+public:
+    enum class Priority {
+        LOW = 0,     // 公共只读接口
+        NORMAL = 1,  // 需认证的只读接口
+        HIGH = 2     // 写操作（挂号、注册等）
+    };
+
+    struct Config {
+        size_t maxConcurrent = 32;                          // 全局同时处理的请求数
+        size_t maxQueue = 256;                              // 等待队列长度上限
+        std::chrono::milliseconds maxQueueTime{200};        // 排队超过该时间即快速失败
+        double userRatePerSecond = 20.0;                    // 每个用户的令牌补充速率
+        double userBurst = 40.0;                            // 每个用户的令牌桶容量
+    };
+
+    enum class Outcome {
+        ADMITTED,
+        QUEUE_FULL,      // 503
+        QUEUE_TIMEOUT    // 503
+    };
+
+    struct Stats {
+        uint64_t admitted = 0;
+        uint64_t queued = 0;
+        uint64_t rejectedQueueFull = 0;
+        uint64_t rejectedTimeout = 0;
+        uint64_t rejectedRateLimit = 0;
+        size_t inFlight = 0;
+        size_t waiting = 0;
+        double averageServiceMs = 0;
+    };
+
+    // 准入凭证：析构时归还并发名额
+    class Ticket {
+    public:
+        Ticket() = default;
+        Ticket(Ticket&& other) noexcept;
+        Ticket& operator=(Ticket&& other) noexcept;
+        Ticket(const Ticket&) = delete;
+        Ticket& operator=(const Ticket&) = delete;
+        ~Ticket();
+
+        bool admitted() const { return outcome == Outcome::ADMITTED; }
+        Outcome getOutcome() const { return outcome; }
+        // 拒绝时建议客户端等待的毫秒数
+        int64_t getRetryAfterMs() const { return retryAfterMs; }
+        void release();
+
+    private:
+        friend class AdmissionController;
+        AdmissionController* controller = nullptr;
+        std::string api;
+        std::string tenant;
+        Outcome outcome = Outcome::QUEUE_FULL;
+        int64_t retryAfterMs = 0;
+        bool nested = false;  // 只占用API名额，不占全局名额
+        std::chrono::steady_clock::time_point startTime;
+    };
+
+    AdmissionController();
+    explicit AdmissionController(const Config& config);
+
+    AdmissionController(const AdmissionController&) = delete;
+    AdmissionController& operator=(const AdmissionController&) = delete;
+
+    // 未配置的API不设单独并发上限，优先级为NORMAL
+    void setApiPolicy(const std::string& api, size_t maxConcurrent, Priority priority);
+
+    // 租户权重默认为1；未登记的租户首次出现时以权重1加入
+    void setTenantWeight(const std::string& tenant, double weight);
+
+    // 申请并发名额，必要时在队列中等待至多maxQueueTime，且不超过请求截止时间deadline；
+    // tenant为空表示默认租户
+    Ticket acquire(const std::string& api, const std::string& tenant = "",
+                   std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max());
+
+    // 已占用全局名额的请求（批量请求）为其子请求申请该API的单独名额：不再占用全局名额，
+    // 不排队，API已达上限时立即拒绝
+    Ticket acquireNested(const std::string& api, const std::string& tenant = "");
+
+    // 消耗用户令牌桶中的一个令牌；不足时返回false并给出重试间隔。用户ID只在租户内唯一
+    bool consumeUserToken(int userId, int64_t& retryAfterMs, const std::string& tenant = "");
+
+    const Config& getConfig() const { return config; }
+    Stats getStats();
+    // 按租户统计，键为租户名
+    std::map<std::string, Stats> getTenantStats();
+
+private:
+    struct ApiPolicy {
+        size_t maxConcurrent = 0;  // 0表示只受全局上限约束
+        Priority priority = Priority::NORMAL;
+        size_t inFlight = 0;
+    };
+
+    struct TenantState {
+        double weight = 1.0;
+        size_t inFlight = 0;
+        size_t waiting = 0;
+        double averageServiceMs = 10.0;
+        Stats stats;
+    };
+
+    struct Waiter {
+        ApiPolicy* policy;
+        TenantState* tenant;
+        Priority priority;
+        bool granted = false;
+        std::condition_variable wakeup;
+    };
+
+    struct TokenBucket {
+        double tokens;
+        std::chrono::steady_clock::time_point lastRefill;
+    };
+
+    Config config;
+    std::mutex mutex;
+    std::unordered_map<std::string, ApiPolicy> policies;
+    std::unordered_map<std::string, TenantState> tenants;
+    double totalWeight = 0;
+    std::list<Waiter*> waiters;  // 按到达顺序排列，放行顺序由precedes()决定
+    size_t inFlight = 0;
+    double averageServiceMs = 10.0;  // 处理耗时的指数滑动平均，用于估算重试间隔
+    Stats stats;
+
+    std::mutex bucketMutex;
+    std::unordered_map<std::string, TokenBucket> buckets;
+
+    ApiPolicy& policyFor(const std::string& api);
+    TenantState& tenantFor(const std::string& tenant);
+    bool hasCapacity(const ApiPolicy& policy) const;
+    // 租户相对负载较低者先放行，同一负载下按优先级、再按到达顺序
+    static bool precedes(const TenantState& tenant, Priority priority,
+                         const TenantState& other, Priority otherPriority);
+    size_t tenantQueueLimit(const TenantState& tenant, Priority priority) const;
+    void grantWaiters();
+    int64_t estimateRetryAfterMs() const;
+    void release(const std::string& api, const std::string& tenant, std::chrono::steady_clock::time_point startTime,
+                 bool nested);
+};
+
+#endif // ADMISSION_CONTROLLER_H
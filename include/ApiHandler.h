@@ -8,6 +8,10 @@
 #include <mutex>
 #include <chrono>
 #include "HospitalService.h"
+#include "CampusDirectory.h"
+#include "RequestValidator.h"
+#include "JsonStream.h"
+#include "AdmissionController.h"
 
 // 尝试包含nlohmann/json，支持不同的安装路径
 #if __has_include(<nlohmann/json.hpp>)
@@ -31,14 +35,20 @@ public:
         
         ApiResponse(const std::string& status = "error", int code = 500, 
                    const std::string& message = "Internal server error", 
-                   const json& data = json::object())
-            : status(status), code(code), message(message), data(data) {}
+                   json data = json::object())
+            : status(status), code(code), message(message), data(std::move(data)) {}
         
         std::string toJson() const;
+        void writeTo(std::string& out, WireFormat format = WireFormat::JSON) const;
     };
 
 private:
-    std::shared_ptr<HospitalService> hospitalService;
+    // 院区目录；单院区部署时只有一个标识为空的院区
+    std::shared_ptr<CampusDirectory> campuses;
+    // 当前请求所属院区的服务，请求之外为默认院区
+    HospitalService* service();
+    // 多院区时由data.campus或token前缀确定院区；失败时返回nullptr并填写error
+    const CampusDirectory::Campus* resolveCampus(const json& data, ApiResponse& error);
     
     // API处理函数类型定义
     using ApiHandlerFunc = std::function<ApiResponse(const json&)>;
@@ -48,11 +58,36 @@ private:
     bool validateToken(const std::string& token, int& userId, UserType& userType);
     std::string generateTokenForUser(int userId, const std::string& username);
     
-    // 输入验证
-    bool validateEmail(const std::string& email);
-    bool validatePhone(const std::string& phone);
-    bool validatePassword(const std::string& password);
-    bool validateIdNumber(const std::string& idNumber);
+    // 输入验证：按API声明的请求参数规则，构造时编译一次
+    RequestValidator requestValidator;
+    void registerRequestSchemas();
+    ApiResponse validationErrorResponse(const std::vector<RequestValidator::ValidationError>& errors);
+    
+    // 请求分发：信封按需解析路径与完整DOM回退路径共用同一处理流程
+    ApiResponse dispatchRequest(const std::string& jsonInput);
+    ApiResponse dispatchBinaryRequest(const std::string& input, WireFormat format);
+    ApiResponse dispatchParsedRequest(const json& request);
+    
+    // 准入控制：顶层请求先占用并发名额，再按解析出的用户ID限流；批量子请求共用批量请求的全局名额，
+    // 但各自计入所调API的并发上限与所属用户的令牌桶
+    AdmissionController admissionController;
+    void registerAdmissionPolicies();
+    ApiResponse admitAndInvoke(const std::string& apiName, const ApiHandlerFunc& handler, const json& data,
+                               int64_t timeoutMs = -1);
+    
+    // 请求截止时间：信封中的timeoutMs优先（不超过上限），否则取按API配置的默认值。
+    // 截止时间传递到数据库访问，超时后不再取连接、SELECT在服务端被终止，请求返回504
+    static constexpr int64_t DEFAULT_TIMEOUT_MS = 10000;
+    static constexpr int64_t MAX_TIMEOUT_MS = 60000;
+    std::unordered_map<std::string, int64_t> apiTimeouts;
+    void registerRequestTimeouts();
+    int64_t timeoutFor(const std::string& apiName, int64_t requestedMs) const;
+    
+    // 批量请求：token只验证一次，相邻的只读子请求在扇出执行器上并行执行，
+    // 写操作子请求作为屏障按数组顺序单独执行
+    static const size_t MAX_BATCH_REQUESTS = 50;
+    ApiResponse handleBatch(const json& data);
+    void runInParallel(size_t begin, size_t end, const std::function<void(size_t)>& task);
     
     // 公共接口处理函数
     ApiResponse handlePublicScheduleList(const json& data);
@@ -93,7 +128,6 @@ private:
     ApiResponse handleDoctorAttendanceCancelCheckIn(const json& data);
     
     // 工具函数
-    std::string hashPassword(const std::string& password);
     std::string getCurrentDateTime();
     json userToJson(const User& user);
     json doctorToJson(const Doctor& doctor);
@@ -105,13 +139,20 @@ private:
     
 public:
     explicit ApiHandler(std::shared_ptr<HospitalService> service);
+    explicit ApiHandler(std::shared_ptr<CampusDirectory> campuses);
     ~ApiHandler();
     
     // 主要接口函数
     std::string processApiRequest(const std::string& jsonInput);
+    // 响应写入调用方提供的缓冲区，便于常驻进程跨请求复用；
+    // 未指定格式时按请求首字节识别JSON/MessagePack/CBOR，响应与请求格式相同
+    void processApiRequest(const std::string& input, std::string& output);
+    void processApiRequest(const std::string& input, std::string& output, WireFormat format);
     
-    // 系统状态
+    // 系统状态；顶层计数来自默认院区
     json getSystemStats();
+    // 各院区的准入统计与全局连接预算
+    json getCampusStats();
 };
 
 #endif // API_HANDLER_H
\ No newline at end of file
@@ -52,30 +52,31 @@ private:
     
 public:
     AppointmentDAO(std::shared_ptr<ConnectionPool> pool);
+    virtual ~AppointmentDAO() = default;
     
     // CRUD operations
-    bool createAppointment(const Appointment& appointment);
-    std::unique_ptr<Appointment> getAppointmentById(int appointmentId);
-    std::vector<std::unique_ptr<Appointment>> getAppointmentsByPatientId(int patientId);
-    std::vector<std::unique_ptr<Appointment>> getAppointmentsByDoctorId(int doctorId);
-    std::vector<std::unique_ptr<Appointment>> getAppointmentsByDepartment(const std::string& department);
-    std::vector<std::unique_ptr<Appointment>> getAppointmentsByStatus(AppointmentStatus status);
-    std::vector<std::unique_ptr<Appointment>> getAllAppointments();
+    virtual bool createAppointment(const Appointment& appointment);
+    virtual std::unique_ptr<Appointment> getAppointmentById(int appointmentId);
+    virtual std::vector<std::unique_ptr<Appointment>> getAppointmentsByPatientId(int patientId);
+    virtual std::vector<std::unique_ptr<Appointment>> getAppointmentsByDoctorId(int doctorId);
+    virtual std::vector<std::unique_ptr<Appointment>> getAppointmentsByDepartment(const std::string& department);
+    virtual std::vector<std::unique_ptr<Appointment>> getAppointmentsByStatus(AppointmentStatus status);
+    virtual std::vector<std::unique_ptr<Appointment>> getAllAppointments();
     
-    bool updateAppointment(const Appointment& appointment);
-    bool updateAppointmentStatus(int appointmentId, AppointmentStatus status);
-    bool deleteAppointment(int appointmentId);
+    virtual bool updateAppointment(const Appointment& appointment);
+    virtual bool updateAppointmentStatus(int appointmentId, AppointmentStatus status);
+    virtual bool deleteAppointment(int appointmentId);
     
     // Status management
-    bool bookAppointment(int appointmentId);
-    bool attendAppointment(int appointmentId);
-    bool cancelAppointment(int appointmentId);
+    virtual bool bookAppointment(int appointmentId);
+    virtual bool attendAppointment(int appointmentId);
+    virtual bool cancelAppointment(int appointmentId);
     
     // Search and statistics
-    std::vector<std::unique_ptr<Appointment>> searchAppointments(const std::string& searchTerm);
-    int getAppointmentCount();
-    int getAppointmentCountByStatus(AppointmentStatus status);
-    int getAppointmentCountByDoctor(int doctorId);
+    virtual std::vector<std::unique_ptr<Appointment>> searchAppointments(const std::string& searchTerm);
+    virtual int getAppointmentCount();
+    virtual int getAppointmentCountByStatus(AppointmentStatus status);
+    virtual int getAppointmentCountByDoctor(int doctorId);
     
 private:
     Appointment* mapRowToAppointment(MYSQL_ROW row, unsigned long* lengths);
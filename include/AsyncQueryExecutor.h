@@ -0,0 +1,127 @@
+#ifndef ASYNC_QUERY_EXECUTOR_H
+#define ASYNC_QUERY_EXECUTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "DatabaseConnection.h"
+
+// 异步查询执行器：单个事件循环线程借助MySQL客户端的非阻塞接口
+// （MariaDB Connector/C 的 *_start/*_cont，或 MySQL 8.0.16+ 的 *_nonblocking），
+// 在自有的一组连接上同时推进多条查询，提交方无需为每条查询占用一个线程等待。
+// 客户端库不提供非阻塞接口时退化为在事件循环线程上逐条阻塞执行，语义不变。
+// 查询直接在自有连接上执行，不经过副本路由、查询缓存、慢查询日志与ConnectionBudget
+class AsyncQueryExecutor {
+public:
+    struct Result {
+        bool ok = false;
+        MYSQL_RES* rows = nullptr;  // 结果集由接收方释放；无结果集的语句为nullptr
+        uint64_t affectedRows = 0;
+        uint64_t insertId = 0;
+        std::string error;
+    };
+
+    // 回调在事件循环线程上执行，不能阻塞，也不能在回调中等待其他异步查询
+    using Callback = std::function<void(Result& result)>;
+
+    AsyncQueryExecutor(const std::string& host, const std::string& username, const std::string& password,
+                       const std::string& database, unsigned int port, size_t connectionCount);
+    ~AsyncQueryExecutor();
+
+    AsyncQueryExecutor(const AsyncQueryExecutor&) = delete;
+    AsyncQueryExecutor& operator=(const AsyncQueryExecutor&) = delete;
+
+    // 与连接池共用熔断器：数据库故障期间建立连接和重连立即失败，不在事件循环线程上阻塞。
+    // 须在start()之前调用
+    void setBreaker(std::shared_ptr<CircuitBreaker> shared) { breaker = std::move(shared); }
+
+    // 建立连接并启动事件循环；部分连接失败时用已建立的连接继续运行
+    bool start();
+
+    // 停止接收新查询，等已提交的查询全部完成后回收事件循环线程
+    void shutdown();
+
+    // 未启动或已关闭时返回false，回调不会被调用。
+    // 提交线程处于RequestDeadline内时，SELECT按其剩余时间限时，开始执行前已超时则直接失败
+    bool submit(const std::string& sql, Callback callback);
+
+    // 同步包装：查询完成时future就绪；提交失败时立即就绪并带错误信息
+    std::future<Result> submit(const std::string& sql);
+
+    // 在事件循环线程上用reader把结果集映射为T（reader不释放结果集）；
+    // 查询失败或提交失败时返回值初始化的T
+    template <typename T, typename Reader>
+    std::future<T> fetch(const std::string& sql, Reader reader);
+
+    // 编译时链接的客户端库是否提供非阻塞接口
+    static bool isNonBlocking();
+
+    size_t size() const { return slots.size(); }
+    std::string getError() const { return lastError; }
+
+private:
+    struct Request {
+        std::string sql;
+        Callback callback;
+        RequestDeadline::Clock::time_point deadline = RequestDeadline::Clock::time_point::max();
+    };
+    struct Slot;
+
+    std::string host;
+    std::string username;
+    std::string password;
+    std::string database;
+    unsigned int port;
+    size_t connectionCount;
+    std::shared_ptr<CircuitBreaker> breaker;
+
+    // 以下成员只由事件循环线程访问（start/shutdown除外）
+    std::vector<std::unique_ptr<Slot>> slots;
+    std::vector<Slot*> idleSlots;
+    int epollFd = -1;
+    int wakeFd = -1;
+    std::thread loopThread;
+
+    std::mutex queueMutex;
+    std::deque<Request> pending;
+    bool running = false;
+    bool stopping = false;
+    std::string lastError;
+
+    void eventLoop();
+    void begin(Slot& slot, Request request);
+    void advance(Slot& slot, int readyEvents);
+    void complete(Slot& slot, bool ok);
+    void watch(Slot& slot, int waitEvents);
+    bool registerSlot(Slot& slot);
+};
+
+template <typename T, typename Reader>
+std::future<T> AsyncQueryExecutor::fetch(const std::string& sql, Reader reader) {
+    auto promise = std::make_shared<std::promise<T>>();
+    std::future<T> future = promise->get_future();
+    bool accepted = submit(sql, [promise, reader](Result& result) {
+        try {
+            promise->set_value(result.ok ? reader(result.rows) : T());
+        } catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+        if (result.rows) {
+            mysql_free_result(result.rows);
+            result.rows = nullptr;
+        }
+    });
+    if (!accepted) {
+        promise->set_value(T());
+    }
+    return future;
+}
+
+#endif // ASYNC_QUERY_EXECUTOR_H
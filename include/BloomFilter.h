@@ -0,0 +1,60 @@
+#ifndef BLOOM_FILTER_H
+#define BLOOM_FILTER_H
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+
+// 存在性布隆过滤器：用于用户名/邮箱/身份证号的快速"一定不存在"判断
+// 位数组使用原子操作，插入与查询均可并发进行
+class BloomFilter {
+public:
+    struct Stats {
+        uint64_t queries;
+        uint64_t definiteNegatives;
+        uint64_t maybes;
+        uint64_t falsePositives;
+    };
+
+    BloomFilter(size_t expectedItems, double falsePositiveRate = 0.01);
+
+    void add(const std::string& key);
+    bool mightContain(const std::string& key);
+
+    // 数据库确认"maybe"实际不存在时调用，用于统计误判率
+    void recordFalsePositive() { falsePositives.fetch_add(1, std::memory_order_relaxed); }
+
+    Stats getStats() const;
+    double getFalsePositiveRate() const;
+    size_t getBitCount() const { return bitCount; }
+    unsigned int getHashCount() const { return hashCount; }
+
+    // 持久化：水位线记录保存时已纳入过滤器的最大user_id/patient_id，
+    // 加载后只需增量补齐水位线之后插入的行。
+    // 多个进程共用同一文件：保存时在 filePath.lock 上加排他锁，与文件中已有的同规格过滤器
+    // 按位或合并，水位线取两者较小值，不会丢掉其他进程纳入的键。
+    // UPDATE或直接SQL写入的键仍可能不在其中，因此"一定不存在"只能作为提示
+    bool saveToFile(const std::string& filePath, uint64_t userWatermark, uint64_t patientWatermark) const;
+    bool loadFromFile(const std::string& filePath, uint64_t& userWatermark, uint64_t& patientWatermark);
+
+    // 键归一化：数据库排序规则大小写不敏感，ASCII统一转小写并去掉尾部空格；
+    // 含非ASCII字符时排序规则还可能忽略重音，无法可靠归一化，返回false表示应直接查库
+    static bool normalizeKey(const std::string& prefix, const std::string& value, std::string& key);
+
+private:
+    std::vector<std::atomic<uint64_t>> bits;
+    size_t bitCount;
+    unsigned int hashCount;
+
+    std::atomic<uint64_t> queries{0};
+    std::atomic<uint64_t> definiteNegatives{0};
+    std::atomic<uint64_t> falsePositives{0};
+
+    void initialize(size_t numBits, unsigned int numHashes);
+    static bool readFile(const std::string& filePath, uint64_t& numBits, uint32_t& numHashes,
+                         uint64_t& userWatermark, uint64_t& patientWatermark, std::vector<uint64_t>& words);
+    static uint64_t hashKey(const std::string& key, uint64_t seed);
+};
+
+#endif // BLOOM_FILTER_H
@@ -0,0 +1,60 @@
+#ifndef CAMPUS_DIRECTORY_H
+#define CAMPUS_DIRECTORY_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "HospitalService.h"
+
+// 院区配置："院区标识=主机[:端口]/数据库[@权重]"，各院区使用相同的数据库账号
+struct CampusSpec {
+    std::string id;
+    std::string host;
+    unsigned int port = 3306;
+    std::string database;
+    double weight = 1.0;
+
+    static bool parse(const std::string& text, CampusSpec& spec);
+};
+
+// 院区目录：一个进程服务多个院区，每个院区有独立的数据库与HospitalService，
+// 所有院区的连接池共用一个全局连接预算
+class CampusDirectory {
+public:
+    struct Campus {
+        std::string id;
+        std::shared_ptr<HospitalService> service;
+        double weight = 1.0;  // 准入调度中的份额
+    };
+
+    explicit CampusDirectory(std::shared_ptr<ConnectionBudget> budget = nullptr);
+
+    // 单院区部署：院区标识为空，请求与token都不带院区
+    static std::shared_ptr<CampusDirectory> single(std::shared_ptr<HospitalService> service);
+
+    // 按配置连接各院区；budget为所有院区合计的连接数上限
+    static std::shared_ptr<CampusDirectory> connect(const std::vector<CampusSpec>& specs, const std::string& username,
+                                                    const std::string& password, size_t budget);
+
+    // 院区标识只允许字母、数字、'-'和'_'；重复或非法时返回false
+    bool add(const std::string& id, std::shared_ptr<HospitalService> service, double weight = 1.0);
+
+    const Campus* find(const std::string& id) const;
+    const Campus& getDefault() const { return campuses.front(); }
+    const std::vector<Campus>& getCampuses() const { return campuses; }
+    bool isMultiCampus() const { return !campuses.empty() && !campuses.front().id.empty(); }
+    std::shared_ptr<ConnectionBudget> getBudget() const { return budget; }
+
+    // 所有院区的扇出读取与请求处理共用同一个工作线程池
+    void useWorkerPool(std::shared_ptr<ThreadPool> pool);
+
+    // 每个院区常驻的连接数：预算的一半平均分给各院区，其余作为共享余量，
+    // 由高峰中的院区临时借用，归还时关闭
+    static size_t reservedConnections(size_t budget, size_t campusCount);
+
+private:
+    std::vector<Campus> campuses;
+    std::shared_ptr<ConnectionBudget> budget;
+};
+
+#endif // CAMPUS_DIRECTORY_H
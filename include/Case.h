@@ -42,23 +42,24 @@ private:
     
 public:
     CaseDAO(std::shared_ptr<ConnectionPool> pool);
+    virtual ~CaseDAO() = default;
     
     // CRUD operations
-    bool createCase(const Case& medicalCase);
-    std::unique_ptr<Case> getCaseById(int caseId);
-    std::vector<std::unique_ptr<Case>> getCasesByPatientId(int patientId);
-    std::vector<std::unique_ptr<Case>> getCasesByDoctorId(int doctorId);
-    std::vector<std::unique_ptr<Case>> getCasesByDepartment(const std::string& department);
-    std::vector<std::unique_ptr<Case>> getAllCases();
+    virtual bool createCase(const Case& medicalCase);
+    virtual std::unique_ptr<Case> getCaseById(int caseId);
+    virtual std::vector<std::unique_ptr<Case>> getCasesByPatientId(int patientId);
+    virtual std::vector<std::unique_ptr<Case>> getCasesByDoctorId(int doctorId);
+    virtual std::vector<std::unique_ptr<Case>> getCasesByDepartment(const std::string& department);
+    virtual std::vector<std::unique_ptr<Case>> getAllCases();
     
-    bool updateCase(const Case& medicalCase);
-    bool deleteCase(int caseId);
+    virtual bool updateCase(const Case& medicalCase);
+    virtual bool deleteCase(int caseId);
     
     // Search operations
-    std::vector<std::unique_ptr<Case>> searchCases(const std::string& searchTerm);
-    int getCaseCount();
-    int getCaseCountByDoctor(int doctorId);
-    int getCaseCountByPatient(int patientId);
+    virtual std::vector<std::unique_ptr<Case>> searchCases(const std::string& searchTerm);
+    virtual int getCaseCount();
+    virtual int getCaseCountByDoctor(int doctorId);
+    virtual int getCaseCountByPatient(int patientId);
     
 private:
     Case* mapRowToCase(MYSQL_ROW row, unsigned long* lengths);
@@ -0,0 +1,59 @@
+#ifndef CIRCUIT_BREAKER_H
+#define CIRCUIT_BREAKER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// Shared by the connections of one pool. After failureThreshold consecutive
+// failures to reach the server it opens, and calls fail at once instead of
+// each waiting out a connect timeout. After openDuration a single caller is
+// let through as a probe (half-open); its outcome closes or reopens the breaker.
+class CircuitBreaker {
+public:
+    enum class State { CLOSED, OPEN, HALF_OPEN };
+
+    struct Config {
+        size_t failureThreshold = 5;
+        std::chrono::milliseconds openDuration{2000};
+    };
+
+    struct Stats {
+        State state = State::CLOSED;
+        size_t consecutiveFailures = 0;
+        uint64_t timesOpened = 0;
+        uint64_t rejected = 0;
+    };
+
+    CircuitBreaker() : CircuitBreaker(Config()) {}
+    explicit CircuitBreaker(const Config& config) : config(config) {}
+
+    // False while open or while another caller's probe is outstanding. A true
+    // result must be followed by recordSuccess() or recordFailure().
+    bool allow();
+    // Like allow() but never claims the probe; for callers that only want to fail fast
+    bool isOpen() const;
+
+    void recordSuccess();
+    void recordFailure();
+
+    // Milliseconds until a probe is let through; 0 unless open
+    int64_t getRetryAfterMs() const;
+    Stats getStats() const;
+    static const char* stateName(State state);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Config config;
+    mutable std::mutex mutex;
+    std::atomic<State> state{State::CLOSED};
+    std::atomic<size_t> consecutiveFailures{0};
+    Clock::time_point openedAt;
+    uint64_t timesOpened = 0;
+    std::atomic<uint64_t> rejected{0};
+};
+
+#endif // CIRCUIT_BREAKER_H
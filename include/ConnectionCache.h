@@ -0,0 +1,136 @@
+#ifndef CONNECTION_CACHE_H
+#define CONNECTION_CACHE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+// Idle-connection cache used by ConnectionPool. Each thread first reuses the
+// connection it released last (its affinity slot), which keeps per-connection
+// server state such as prepared statements warm and touches no shared cache
+// line. Everything else goes through a bounded lock-free MPMC ring
+// (Vyukov's sequence-numbered queue). The cache does not own the items:
+// the caller destroys what release() rejects and what drain() hands back.
+template <typename T>
+class ConnectionCache {
+public:
+    explicit ConnectionCache(size_t capacity)
+        : capacity(std::max<size_t>(1, capacity)),
+          cells(new Cell[this->capacity]),
+          slotCount(std::max<size_t>(this->capacity, 2 * std::thread::hardware_concurrency())),
+          slots(new AffinitySlot[slotCount]) {
+        for (size_t i = 0; i < this->capacity; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ConnectionCache(const ConnectionCache&) = delete;
+    ConnectionCache& operator=(const ConnectionCache&) = delete;
+
+    // Own affinity slot, then the shared ring, then other threads' slots;
+    // nullptr when nothing is idle
+    T* acquire() {
+        size_t own = threadIndex() % slotCount;
+        T* item = slots[own].item.exchange(nullptr, std::memory_order_acquire);
+        if (item) return item;
+
+        item = pop();
+        if (item) return item;
+
+        for (size_t offset = 1; offset < slotCount; ++offset) {
+            AffinitySlot& slot = slots[(own + offset) % slotCount];
+            if (slot.item.load(std::memory_order_relaxed)) {
+                item = slot.item.exchange(nullptr, std::memory_order_acquire);
+                if (item) return item;
+            }
+        }
+        return nullptr;
+    }
+
+    // Returns false when both the affinity slot and the ring are full
+    bool release(T* item) {
+        T* expected = nullptr;
+        if (slots[threadIndex() % slotCount].item.compare_exchange_strong(expected, item, std::memory_order_release,
+                                                                         std::memory_order_relaxed)) {
+            return true;
+        }
+        return push(item);
+    }
+
+    // Removes every idle item and passes it to destroy
+    template <typename F>
+    void drain(F&& destroy) {
+        for (size_t i = 0; i < slotCount; ++i) {
+            if (T* item = slots[i].item.exchange(nullptr, std::memory_order_acquire)) destroy(item);
+        }
+        while (T* item = pop()) destroy(item);
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T* value = nullptr;
+    };
+
+    struct alignas(64) AffinitySlot {
+        std::atomic<T*> item{nullptr};
+    };
+
+    const size_t capacity;
+    std::unique_ptr<Cell[]> cells;
+    alignas(64) std::atomic<size_t> enqueuePos{0};
+    alignas(64) std::atomic<size_t> dequeuePos{0};
+    const size_t slotCount;
+    std::unique_ptr<AffinitySlot[]> slots;
+
+    static size_t threadIndex() {
+        static std::atomic<size_t> nextIndex{0};
+        thread_local size_t index = nextIndex.fetch_add(1, std::memory_order_relaxed);
+        return index;
+    }
+
+    bool push(T* item) {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[pos % capacity];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = item;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    T* pop() {
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[pos % capacity];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    T* item = cell.value;
+                    cell.sequence.store(pos + capacity, std::memory_order_release);
+                    return item;
+                }
+            } else if (diff < 0) {
+                return nullptr;
+            } else {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+#endif // CONNECTION_CACHE_H
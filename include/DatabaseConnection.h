@@ -6,9 +6,49 @@
 #include <memory>
 #include <vector>
 #include <mutex>
-#include <queue>
+#include <atomic>
+#include "ConnectionCache.h"
+#include "ReplicaRouter.h"
+#include "RequestDeadline.h"
+#include "CircuitBreaker.h"
+#include "FaultInjector.h"
+#include "SlowQueryLog.h"
+#include "QueryCache.h"
+
+class ConnectionPool;
+
+// Cap on open connections shared by several pools, e.g. the campus pools of
+// one process. Every connection opened by a pool with a budget holds one
+// permit until it is destroyed.
+class ConnectionBudget {
+public:
+    explicit ConnectionBudget(size_t limit) : limit(limit) {}
+    
+    bool tryAcquire() {
+        size_t current = used.load(std::memory_order_relaxed);
+        while (current < limit) {
+            if (used.compare_exchange_weak(current, current + 1, std::memory_order_relaxed)) return true;
+        }
+        return false;
+    }
+    void release() { used.fetch_sub(1, std::memory_order_relaxed); }
+    size_t getLimit() const { return limit; }
+    size_t getInUse() const { return used.load(std::memory_order_relaxed); }
+    
+private:
+    const size_t limit;
+    std::atomic<size_t> used{0};
+};
 
 class DatabaseConnection {
+public:
+    // Client-side network timeouts in seconds; 0 keeps the client library default
+    struct Timeouts {
+        unsigned int connectSeconds = 5;
+        unsigned int readSeconds = 0;
+        unsigned int writeSeconds = 0;
+    };
+    
 private:
     MYSQL* connection;
     std::string host;
@@ -16,6 +56,53 @@ private:
     std::string password;
     std::string database;
     unsigned int port;
+    bool nonBlocking = false;
+    // Opened with CLIENT_MULTI_STATEMENTS; such connections serve only executeMultiQuery
+    bool multiStatements = false;
+    std::string initCommand;
+    // Pool the connection belongs to; returnConnection() hands it back there
+    ConnectionPool* origin = nullptr;
+    // Permit released when the connection is destroyed
+    std::shared_ptr<ConnectionBudget> budget;
+    // Open connections of the origin pool; this one counts until destroyed
+    std::shared_ptr<std::atomic<size_t>> liveCount;
+    // MariaDB limits statements with SET STATEMENT instead of the MAX_EXECUTION_TIME hint
+    bool mariaDb = false;
+    // Breaker of the pool the connection came from, if any
+    std::shared_ptr<CircuitBreaker> breaker;
+    // Error code of a fault injected into the last call, 0 if none
+    unsigned int injectedError = 0;
+    // Set by an injected lost-connection error; the next call reconnects
+    bool dropped = false;
+    // Query cache of the pool the connection came from, if any; writes invalidate it
+    std::shared_ptr<QueryCache> queryCache;
+    bool inTransaction = false;
+    // Tables written by the open transaction, invalidated again when it ends
+    std::vector<std::string> transactionTables;
+    static Timeouts defaultTimeouts;
+    static std::shared_ptr<FaultInjector> faultInjector;
+    static std::shared_ptr<SlowQueryLog> slowQueryLog;
+    
+    // Opens the connection and reports the outcome to the breaker
+    bool establish();
+    // Reconnects a dropped connection; fails at once while the breaker is open
+    bool ensureConnected();
+    // Reports whether the last statement reached the server
+    void recordOutcome();
+    // Sends the statement unless an injected fault fails it first; mysql_query's status
+    int runStatement(const std::string& statement, const std::string& sent);
+    unsigned int lastErrno();
+    // Logs the statement if it ran past the slow query threshold; caller is
+    // the return address of the public execute* method
+    void recordIfSlow(const std::string& statement, std::chrono::steady_clock::time_point started,
+                      int64_t rows, const void* caller, bool explain);
+    std::string explainPlan(const std::string& statement);
+    MYSQL_RES* runQuery(const std::string& query, const void* caller);
+    // Invalidates the query cache entries a write statement affects
+    void noteWrite(const std::string& statement);
+    
+    // Marks the deadline exceeded when the server stopped the statement for it
+    void checkDeadlineError();
     
 public:
     DatabaseConnection(const std::string& host, const std::string& username, 
@@ -23,12 +110,35 @@ public:
                       unsigned int port = 3306);
     ~DatabaseConnection();
     
+    // Must be set before connect(); enables the client's non-blocking API
+    // (MariaDB requires MYSQL_OPT_NONBLOCK on the handle)
+    void setNonBlocking(bool enabled) { nonBlocking = enabled; }
+    // Must be set before connect(); only for connections kept apart for executeMultiQuery
+    void setMultiStatements(bool enabled) { multiStatements = enabled; }
+    bool hasMultiStatements() const { return multiStatements; }
+    // Must be set before connect(); runs on every (re)connect, e.g. to set session variables
+    void setInitCommand(const std::string& command) { initCommand = command; }
     bool connect();
     void disconnect();
     bool isConnected();
     bool reconnect();
     
+    // SELECTs run inside a RequestDeadline are limited to its remaining time
+    // and fail without reaching the server once it has passed
     MYSQL_RES* executeQuery(const std::string& query);
+    // Runs a SELECT and copies its rows out, e.g. to share them through a
+    // QueryCache; caller is reported to the slow query log in place of the
+    // function calling this one. nullptr on failure.
+    std::shared_ptr<QueryCache::Result> executeResultQuery(const std::string& query, const void* caller = nullptr);
+    MYSQL_RES* executeStreamingQuery(const std::string& query);
+    // Runs several SELECTs in one round trip; one result per statement
+    // (nullptr for statements without a result set), empty on failure.
+    // More than one statement needs a connection from
+    // ConnectionPool::getMultiStatementConnection(), and the statements must
+    // be built only from integer ids and constants.
+    // Caller frees every result with freeResults().
+    std::vector<MYSQL_RES*> executeMultiQuery(const std::vector<std::string>& statements);
+    static void freeResults(std::vector<MYSQL_RES*>& results);
     bool executeUpdate(const std::string& query);
     bool beginTransaction();
     bool commit();
@@ -37,27 +147,115 @@ public:
     std::string escapeString(const std::string& str);
     unsigned long getLastInsertId();
     std::string getError();
+    // The last statement failed on a UNIQUE or PRIMARY KEY constraint
+    bool isDuplicateKeyError();
+    
+    // Under a deadline: false once it has passed, otherwise a SELECT
+    // rewritten to stop server-side when the deadline does
+    bool applyDeadline(const std::string& statement, std::string& bounded,
+                       RequestDeadline* deadline = RequestDeadline::current());
     
     MYSQL* getConnection() { return connection; }
+    void setOrigin(ConnectionPool* pool) { origin = pool; }
+    ConnectionPool* getOrigin() const { return origin; }
+    void setBudget(std::shared_ptr<ConnectionBudget> permit) { budget = std::move(permit); }
+    void setLiveCount(std::shared_ptr<std::atomic<size_t>> counter) {
+        counter->fetch_add(1, std::memory_order_relaxed);
+        liveCount = std::move(counter);
+    }
+    void setBreaker(std::shared_ptr<CircuitBreaker> shared) { breaker = std::move(shared); }
+    void setQueryCache(std::shared_ptr<QueryCache> shared) { queryCache = std::move(shared); }
+    
+    // Applies to connections opened afterwards; set once at startup
+    static void setDefaultTimeouts(const Timeouts& timeouts) { defaultTimeouts = timeouts; }
+    static const Timeouts& getDefaultTimeouts() { return defaultTimeouts; }
+    // Read from the environment at startup (see FaultInjector); nullptr turns injection off
+    static void setFaultInjector(std::shared_ptr<FaultInjector> injector) { faultInjector = std::move(injector); }
+    static std::shared_ptr<FaultInjector> getFaultInjector() { return faultInjector; }
+    // Every statement is timed; set once at startup, nullptr (the default) logs nothing
+    static void setSlowQueryLog(std::shared_ptr<SlowQueryLog> log) { slowQueryLog = std::move(log); }
+    static std::shared_ptr<SlowQueryLog> getSlowQueryLog() { return slowQueryLog; }
 };
 
 class ConnectionPool {
 private:
-    std::queue<std::unique_ptr<DatabaseConnection>> pool;
-    std::mutex poolMutex;
+    // Idle connections; a thread gets back the connection it returned last
+    ConnectionCache<DatabaseConnection> idle;
+    // Idle multi-statement connections, kept apart so that no other caller
+    // gets a connection that accepts stacked statements
+    ConnectionCache<DatabaseConnection> multiStatementIdle;
+    size_t maxMultiStatementConnections;
+    std::shared_ptr<std::atomic<size_t>> liveMultiStatementConnections = std::make_shared<std::atomic<size_t>>(0);
     std::string host, username, password, database;
     unsigned int port;
     size_t maxConnections;
+    std::string initCommand;
+    std::shared_ptr<ConnectionBudget> budget;
+    // Trips when the server stops answering; every connection of the pool reports to it
+    std::shared_ptr<CircuitBreaker> breaker = std::make_shared<CircuitBreaker>();
+    // Connections of the pool in existence, idle or checked out; a returned
+    // connection is kept while this is within maxConnections, so the pool
+    // refills after connections are lost and shrinks back after a burst
+    std::shared_ptr<std::atomic<size_t>> liveConnections = std::make_shared<std::atomic<size_t>>(0);
+    // Read replicas, when enabled; destroyed before the idle cache
+    std::unique_ptr<ReplicaRouter> router;
+    static QueryCache::Config defaultQueryCache;
+    // Results of opted-in SELECTs; every connection of the pool invalidates it on writes
+    std::shared_ptr<QueryCache> queryCache =
+        defaultQueryCache.maxBytes ? std::make_shared<QueryCache>(defaultQueryCache) : nullptr;
+    
+    std::unique_ptr<DatabaseConnection> acquire(bool multiStatements = false);
+    std::unique_ptr<DatabaseConnection> createConnection(bool multiStatements = false);
     
 public:
     ConnectionPool(const std::string& host, const std::string& username,
                   const std::string& password, const std::string& database,
-                  unsigned int port = 3306, size_t maxConnections = 10);
+                  unsigned int port = 3306, size_t maxConnections = 10,
+                  const std::string& initCommand = "",
+                  std::shared_ptr<ConnectionBudget> budget = nullptr);
     ~ConnectionPool();
     
+    // A primary connection; inside a ReplicaRouter::SessionScope it also pins
+    // the session's later reads to the primary. nullptr when the pool is
+    // exhausted and its budget allows no further connection, when the
+    // current RequestDeadline has passed, or at once while the breaker is open.
     std::unique_ptr<DatabaseConnection> getConnection();
+    // A replica connection when one is healthy and the session has no recent
+    // write, otherwise a primary connection. Only for plain SELECTs.
+    std::unique_ptr<DatabaseConnection> getReadConnection();
+    // A primary connection for a read that must not see replica lag, such as
+    // one filling a cache; unlike getConnection() it does not pin the session
+    std::unique_ptr<DatabaseConnection> getPrimaryReadConnection() { return acquire(); }
+    // A connection opened with CLIENT_MULTI_STATEMENTS, for executeMultiQuery
+    // only; from a replica like getReadConnection() when one is available
+    std::unique_ptr<DatabaseConnection> getMultiStatementConnection();
+    // The same from the primary, for a batch whose rows fill a cache
+    std::unique_ptr<DatabaseConnection> getPrimaryMultiStatementConnection() { return acquire(true); }
+    // Runs a SELECT whose result depends only on table contents through the
+    // query cache: a hit needs no connection, a miss reads the primary (so no
+    // replica lag is cached) and stores the rows. Calling this is the opt-in;
+    // only statements without per-user parameters belong here. Without a
+    // cache it is a plain read. nullptr on failure.
+    std::shared_ptr<const QueryCache::Result> executeCachedQuery(const std::string& query);
+    // Accepts connections from either getter
     void returnConnection(std::unique_ptr<DatabaseConnection> conn);
     void initializePool();
+    // A new pool with this pool's credentials and size on another server or database
+    std::shared_ptr<ConnectionPool> connectTo(const std::string& host, unsigned int port,
+                                              const std::string& database, const std::string& initCommand = "") const;
+    // Opens a pool per replica with this pool's credentials and size and starts
+    // lag monitoring; call once, before the pool is shared
+    bool enableReplicas(const std::vector<ReplicaEndpoint>& endpoints, const ReplicaRouter::Policy& policy);
+    std::vector<ReplicaRouter::ReplicaStatus> getReplicaStatus() const;
+    size_t getMaxConnections() const { return maxConnections; }
+    std::shared_ptr<CircuitBreaker> getBreaker() const { return breaker; }
+    // nullptr when the pool has no query cache
+    std::shared_ptr<QueryCache> getQueryCache() const { return queryCache; }
+    
+    // Applies to pools created afterwards; set once at startup. maxBytes 0
+    // (the default) leaves pools without a query cache.
+    static void setDefaultQueryCache(const QueryCache::Config& config) { defaultQueryCache = config; }
+    static const QueryCache::Config& getDefaultQueryCache() { return defaultQueryCache; }
 };
 
 #endif // DATABASE_CONNECTION_H
\ No newline at end of file
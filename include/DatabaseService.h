@@ -122,7 +122,6 @@ public:
     bool cleanupOldData(int daysOld = 365);
     
 private:
-    std::string hashPassword(const std::string& password);
 };
 
 #endif // DATABASE_SERVICE_H
\ No newline at end of file
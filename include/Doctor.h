@@ -5,6 +5,8 @@
 #include <vector>
 #include <memory>
 #include "DatabaseConnection.h"
+#include "AsyncQueryExecutor.h"
+#include "LruCache.h"
 
 class Doctor {
 private:
@@ -40,12 +42,35 @@ public:
 };
 
 class DoctorDAO {
+public:
+    using CacheConfig = LruCache<int, Doctor>::Config;
+    
+    struct CacheStats {
+        LruCache<int, Doctor>::Stats byId;
+        LruCache<int, int>::Stats byUserId;
+        LruCache<int, std::vector<std::string>>::Stats departments;
+    };
+    
 private:
     std::shared_ptr<ConnectionPool> connectionPool;
+    // Read-through caches: doctors by id, doctor ids by user id (user_id never
+    // changes), and the department list under a single key
+    LruCache<int, Doctor> doctorsById;
+    LruCache<int, int> doctorIdsByUserId;
+    LruCache<int, std::vector<std::string>> departmentCache;
+    static CacheConfig cacheConfig;
     
 public:
     DoctorDAO(std::shared_ptr<ConnectionPool> pool);
     
+    // Applies to DAOs created afterwards; capacity 0 disables caching
+    static void setCacheConfig(const CacheConfig& config) { cacheConfig = config; }
+    static const CacheConfig& getCacheConfig() { return cacheConfig; }
+    CacheStats getCacheStats() const;
+    // For writes to doctors made outside this DAO
+    void invalidateDoctor(int doctorId);
+    void invalidateDepartments();
+    
     // CRUD operations
     bool createDoctor(const Doctor& doctor);
     std::unique_ptr<Doctor> getDoctorById(int doctorId);
@@ -62,8 +87,32 @@ public:
     int getDoctorCount();
     int getDoctorCountByDepartment(const std::string& department);
     
+    // Building blocks for multi-statement reads
+    std::string getDoctorByUserIdQuery(int userId);
+    std::string getAllDoctorsQuery();
+    std::unique_ptr<Doctor> readDoctor(MYSQL_RES* result);
+    std::vector<std::unique_ptr<Doctor>> readDoctors(MYSQL_RES* result);
+    
+    // getDoctorByUserId in pieces, so a caller can batch the miss with other
+    // statements: probe the caches (never queries), take a ticket before the
+    // read, then map a getDoctorByUserIdQuery() result and fill the caches.
+    // A read that fills must go to the primary when readPrimary is set
+    struct FillTicket {
+        uint64_t byId;
+        uint64_t byUserId;
+        bool readPrimary;
+    };
+    std::unique_ptr<Doctor> getCachedDoctorByUserId(int userId);
+    FillTicket beginUserIdFill();
+    std::unique_ptr<Doctor> readDoctorByUserId(MYSQL_RES* result, int userId, const FillTicket& ticket);
+    
+    // Non-blocking variants (see AsyncQueryExecutor)
+    std::future<std::unique_ptr<Doctor>> getDoctorByUserIdAsync(AsyncQueryExecutor& executor, int userId);
+    std::future<std::vector<std::unique_ptr<Doctor>>> getAllDoctorsAsync(AsyncQueryExecutor& executor);
+    
 private:
     Doctor* mapRowToDoctor(MYSQL_ROW row, unsigned long* lengths);
+    std::unique_ptr<DatabaseConnection> getFillConnection();
 };
 
 #endif // DOCTOR_H
\ No newline at end of file
@@ -0,0 +1,94 @@
+#ifndef FAN_OUT_EXECUTOR_H
+#define FAN_OUT_EXECUTOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include "ThreadPool.h"
+#include "RequestDeadline.h"
+#include "ReplicaRouter.h"
+
+// 扇出执行器：把一个请求内互不依赖的DAO读取分发到工作线程上并发执行，
+// 每个读取各自从连接池取连接，调用方通过Future汇合结果
+class FanOutExecutor {
+private:
+    template <typename T>
+    struct SharedState {
+        std::packaged_task<T()> task;
+        std::future<T> result;
+        std::atomic<bool> claimed{false};
+
+        // 工作线程与调用线程谁先领取谁执行，保证任务只执行一次
+        void runOnce() {
+            if (!claimed.exchange(true)) {
+                task();
+            }
+        }
+    };
+
+public:
+    template <typename T>
+    class Future {
+    public:
+        Future() = default;
+        explicit Future(std::shared_ptr<SharedState<T>> state) : state(std::move(state)) {}
+        Future(Future&&) = default;
+        Future& operator=(Future&&) = default;
+        Future(const Future&) = delete;
+        Future& operator=(const Future&) = delete;
+
+        // 未取结果就析构时等待任务结束，任务可以安全引用调用方栈上的变量
+        ~Future() {
+            if (state && state->result.valid()) {
+                state->runOnce();
+                state->result.wait();
+            }
+        }
+
+        // 任务尚未被工作线程领取时由调用线程直接执行，线程池繁忙或嵌套扇出时不会死锁；
+        // 任务抛出的异常在这里重新抛出
+        T get() {
+            state->runOnce();
+            return state->result.get();
+        }
+
+    private:
+        std::shared_ptr<SharedState<T>> state;
+    };
+
+    explicit FanOutExecutor(size_t workerCount) : pool(std::make_shared<ThreadPool>(workerCount)) {}
+
+    // 与请求处理共用同一个线程池：子任务进入当前工作线程的本地队列，由空闲线程窃取
+    explicit FanOutExecutor(std::shared_ptr<ThreadPool> pool) : pool(std::move(pool)) {}
+
+    // 子任务沿用提交线程当前请求的截止时间与只读副本会话（本请求或该用户刚写过时读主库）；
+    // 子任务中的写入只经由按用户的最近写入记录影响父请求
+    template <typename F>
+    Future<std::invoke_result_t<std::decay_t<F>>> submit(F&& function) {
+        using T = std::invoke_result_t<std::decay_t<F>>;
+        auto state = std::make_shared<SharedState<T>>();
+        RequestDeadline* deadline = RequestDeadline::current();
+        ReplicaRouter::SessionScope::Session session = ReplicaRouter::SessionScope::current();
+        state->task = std::packaged_task<T()>(
+            [deadline, session, function = std::decay_t<F>(std::forward<F>(function))]() mutable -> T {
+                RequestDeadline::Scope scope(deadline);
+                ReplicaRouter::SessionScope sessionScope(session);
+                return function();
+            });
+        state->result = state->task.get_future();
+
+        // 提交失败（线程池已关闭）时由get()在调用线程上执行
+        pool->submit([state]() { state->runOnce(); });
+        return Future<T>(state);
+    }
+
+    size_t size() const { return pool->size(); }
+
+private:
+    std::shared_ptr<ThreadPool> pool;
+};
+
+#endif // FAN_OUT_EXECUTOR_H
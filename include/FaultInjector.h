@@ -0,0 +1,76 @@
+#ifndef FAULT_INJECTOR_H
+#define FAULT_INJECTOR_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Degrades database access on purpose, so that pool, breaker, retry and
+// deadline handling can be exercised against a healthy local server.
+// Rules are text, one per line or separated by ';':
+//
+//   table=appointments delay=5-40 tail=0.01:800 error=0.02:1213
+//   match=LIKE delay=200
+//   connect delay=500-1500 error=0.05:2003
+//   * error=0.001:2006
+//
+// The first rule whose target matches applies. table=<name> matches
+// statements naming the table, match=<text> statements containing the text,
+// * every statement, and connect the opening of a connection. delay draws
+// milliseconds uniformly from the range, tail=<p>:<ms> adds a rare extra
+// delay, and error=<p>:<code> fails the call with that MySQL error code.
+class FaultInjector {
+public:
+    enum class Target { ANY, TABLE, MATCH, CONNECT };
+
+    struct Rule {
+        Target target = Target::ANY;
+        std::string subject;  // table name or text for TABLE / MATCH
+        unsigned int minDelayMs = 0;
+        unsigned int maxDelayMs = 0;
+        double tailProbability = 0;
+        unsigned int tailDelayMs = 0;
+        double errorProbability = 0;
+        unsigned int errorCode = 0;
+    };
+
+    // Outcome for one call: wait for delay, then fail with errorCode unless it is 0
+    struct Fault {
+        std::chrono::milliseconds delay{0};
+        unsigned int errorCode = 0;
+    };
+
+    struct Stats {
+        uint64_t delayed = 0;
+        uint64_t failed = 0;
+    };
+
+    explicit FaultInjector(std::vector<Rule> rules);
+
+    // nullptr with error set when a rule is malformed
+    static std::shared_ptr<FaultInjector> parse(const std::string& text, std::string& error);
+    static std::shared_ptr<FaultInjector> load(const std::string& path, std::string& error);
+    // Rules from HOSPITAL_DB_FAULTS, or from the file named by HOSPITAL_DB_FAULTS_FILE;
+    // nullptr when neither is set or the rules are malformed
+    static std::shared_ptr<FaultInjector> fromEnvironment(std::string& error);
+
+    Fault onStatement(const std::string& statement);
+    Fault onConnect();
+
+    Stats getStats() const;
+    size_t ruleCount() const { return rules.size(); }
+    // Message the client library or server reports for the code
+    static std::string describe(unsigned int errorCode);
+
+private:
+    std::vector<Rule> rules;
+    std::atomic<uint64_t> delayed{0};
+    std::atomic<uint64_t> failed{0};
+
+    bool matches(const Rule& rule, const std::string& statement) const;
+    Fault draw(const Rule& rule);
+};
+
+#endif // FAULT_INJECTOR_H
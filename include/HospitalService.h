@@ -2,7 +2,14 @@
 #define HOSPITAL_SERVICE_H
 
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include "DatabaseConnection.h"
+#include "BloomFilter.h"
+#include "FanOutExecutor.h"
+#include "ShardSet.h"
 #include "User.h"
 #include "Doctor.h"
 #include "Patient.h"
@@ -24,16 +31,40 @@ private:
     std::unique_ptr<PrescriptionDAO> prescriptionDAO;
     std::unique_ptr<MedicationDAO> medicationDAO;
     
+    // 患者数据分片（可选）：病例、预约、住院、处方、药品按patient_id分布到各分片，
+    // 用户、医生、患者仍在主库
+    std::shared_ptr<ShardSet> shards;
+    
+    // 用户名/邮箱/身份证号存在性过滤器（可选）
+    std::shared_ptr<BloomFilter> existenceFilter;
+    std::string existenceFilterPath;
+    uint64_t userWatermark = 0;
+    uint64_t patientWatermark = 0;
+    
+    // 请求内并发读取的执行器，首次使用时创建；最后声明以保证先于DAO析构
+    size_t fanOutWorkers;
+    std::once_flag fanOutOnce;
+    std::unique_ptr<FanOutExecutor> fanOutExecutor;
+    
 public:
     HospitalService(const std::string& host, const std::string& username,
                    const std::string& password, const std::string& database,
-                   unsigned int port = 3306, size_t maxConnections = 10);
+                   unsigned int port = 3306, size_t maxConnections = 10,
+                   std::shared_ptr<ConnectionBudget> budget = nullptr);
     ~HospitalService();
     
     // Initialize database
     bool initializeDatabase();
     bool createTables();
     bool dropTables();
+    // 各表删除时经ON DELETE CASCADE一并删除的子表，与createTables的外键一致；
+    // 查询缓存据此在删除父表行时同时失效子表上的缓存结果
+    static std::unordered_map<std::string, std::vector<std::string>> deleteCascades();
+    
+    // 启用存在性过滤器：persistPath非空时先从文件加载再增量补齐，析构时写回
+    bool initializeExistenceFilter(const std::string& persistPath = "");
+    bool saveExistenceFilter();
+    std::shared_ptr<BloomFilter> getExistenceFilter() { return existenceFilter; }
     
     // Get DAO instances
     UserDAO* getUserDAO() { return userDAO.get(); }
@@ -48,6 +79,20 @@ public:
     // Get connection pool for transaction management
     std::shared_ptr<ConnectionPool> getConnectionPool() { return connectionPool; }
     
+    // 并发执行互不依赖的DAO读取，每个读取使用独立的池连接
+    FanOutExecutor& getFanOutExecutor();
+    
+    // 让扇出读取与请求处理共用同一个工作线程池；须在首次扇出之前调用，否则返回false
+    bool useWorkerPool(std::shared_ptr<ThreadPool> pool);
+    
+    // 启用只读副本：读取按复制延迟路由到副本，刚写过数据的会话读主库；须在处理请求之前调用
+    bool enableReadReplicas(const std::vector<ReplicaEndpoint>& endpoints,
+                            const ReplicaRouter::Policy& policy = ReplicaRouter::Policy());
+    
+    // 按分片映射文件启用分片：在各分片上建表并换用分片DAO；须在处理请求之前调用
+    bool enableSharding(const std::string& mapPath);
+    std::shared_ptr<ShardSet> getShards() { return shards; }
+    
     // Business logic methods
     bool registerUser(const std::string& username, const std::string& password, 
                      UserType userType, const std::string& email = "", 
@@ -119,8 +164,30 @@ public:
     
     std::vector<DoctorAppointmentInfo> getDoctorAppointments(int doctorId);
     
+    // 多语句读取：一个请求需要的几个小结果集在一次网络往返内取回，
+    // 多语句执行失败时退回逐条DAO查询
+    struct PatientProfile {
+        std::unique_ptr<User> user;
+        std::unique_ptr<Patient> patient;
+    };
+    
+    struct DoctorProfile {
+        std::unique_ptr<User> user;
+        std::unique_ptr<Doctor> doctor;
+    };
+    
+    struct DoctorBookingInfo {
+        std::unique_ptr<Doctor> doctor;
+        int bookedCount;
+    };
+    
+    PatientProfile getPatientProfile(int userId);
+    DoctorProfile getDoctorProfile(int userId);
+    std::vector<DoctorBookingInfo> getDoctorsWithBookingCounts();
+    
 private:
-    std::string hashPassword(const std::string& password);
+    // primary: 结果用于填充缓存时读主库，避免缓存副本延迟的数据
+    std::vector<MYSQL_RES*> executeMultiQuery(const std::vector<std::string>& statements, bool primary = false);
     std::string generateDefaultIdNumber(int userId);
 };
 
@@ -42,26 +42,27 @@ private:
     
 public:
     HospitalizationDAO(std::shared_ptr<ConnectionPool> pool);
+    virtual ~HospitalizationDAO() = default;
     
     // CRUD operations
-    bool createHospitalization(const Hospitalization& hospitalization);
-    std::unique_ptr<Hospitalization> getHospitalizationById(int hospitalizationId);
-    std::vector<std::unique_ptr<Hospitalization>> getHospitalizationsByPatientId(int patientId);
-    std::vector<std::unique_ptr<Hospitalization>> getHospitalizationsByWard(const std::string& wardNumber);
-    std::vector<std::unique_ptr<Hospitalization>> getAllHospitalizations();
+    virtual bool createHospitalization(const Hospitalization& hospitalization);
+    virtual std::unique_ptr<Hospitalization> getHospitalizationById(int hospitalizationId);
+    virtual std::vector<std::unique_ptr<Hospitalization>> getHospitalizationsByPatientId(int patientId);
+    virtual std::vector<std::unique_ptr<Hospitalization>> getHospitalizationsByWard(const std::string& wardNumber);
+    virtual std::vector<std::unique_ptr<Hospitalization>> getAllHospitalizations();
     
-    bool updateHospitalization(const Hospitalization& hospitalization);
-    bool deleteHospitalization(int hospitalizationId);
+    virtual bool updateHospitalization(const Hospitalization& hospitalization);
+    virtual bool deleteHospitalization(int hospitalizationId);
     
     // Ward and bed management
-    std::vector<std::string> getAvailableBeds(const std::string& wardNumber);
-    bool isBedOccupied(const std::string& wardNumber, const std::string& bedNumber);
-    std::vector<std::string> getAllWards();
+    virtual std::vector<std::string> getAvailableBeds(const std::string& wardNumber);
+    virtual bool isBedOccupied(const std::string& wardNumber, const std::string& bedNumber);
+    virtual std::vector<std::string> getAllWards();
     
     // Search operations
-    std::vector<std::unique_ptr<Hospitalization>> searchHospitalizations(const std::string& searchTerm);
-    int getHospitalizationCount();
-    int getCurrentHospitalizationCount();
+    virtual std::vector<std::unique_ptr<Hospitalization>> searchHospitalizations(const std::string& searchTerm);
+    virtual int getHospitalizationCount();
+    virtual int getCurrentHospitalizationCount();
     
 private:
     Hospitalization* mapRowToHospitalization(MYSQL_ROW row, unsigned long* lengths);
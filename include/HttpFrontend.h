@@ -0,0 +1,119 @@
+#ifndef HTTP_FRONTEND_H
+#define HTTP_FRONTEND_H
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "JsonStream.h"
+#include "ThreadPool.h"
+
+// HTTP/1.1前端：单线程epoll事件循环负责连接与收发（非阻塞、keep-alive），
+// 完整的 POST /api 请求体交给固定大小的工作线程池处理，完成后经eventfd通知事件循环写回
+class HttpFrontend {
+public:
+    using RequestProcessor = std::function<void(const std::string& body, WireFormat format, std::string& response)>;
+
+    struct Options {
+        std::string host = "0.0.0.0";
+        uint16_t port = 8080;
+        size_t workers = 8;
+        size_t maxBodySize = 64u << 20;
+        size_t maxHeaderSize = 16u << 10;
+        size_t maxConnections = 10000;
+        int idleTimeoutSeconds = 60;
+        int shutdownGraceSeconds = 10;
+    };
+
+    struct Stats {
+        uint64_t connections;
+        uint64_t requests;
+        uint64_t rejectedRequests;
+    };
+
+    HttpFrontend(const Options& options, RequestProcessor processor);
+    ~HttpFrontend();
+
+    HttpFrontend(const HttpFrontend&) = delete;
+    HttpFrontend& operator=(const HttpFrontend&) = delete;
+
+    bool start();
+
+    // 运行事件循环直到requestStop()；退出前等待处理中的请求写回（最长shutdownGraceSeconds秒）
+    void run();
+
+    // 可在信号处理函数中调用
+    void requestStop();
+
+    std::string getError() const { return lastError; }
+    Stats getStats() const;
+
+    // 请求处理线程池；可交给业务层作为扇出执行器，请求与子任务共用同一组工作线程
+    std::shared_ptr<ThreadPool> getWorkerPool() const { return workerPool; }
+
+private:
+    struct Connection {
+        int fd = -1;
+        uint64_t id = 0;
+        std::string input;
+        std::string output;
+        size_t outputOffset = 0;
+        bool busy = false;              // 已有请求在工作线程中处理，暂停解析后续流水线请求
+        bool closeAfterWrite = false;
+        bool peerClosed = false;
+        bool continueSent = false;
+        bool readInterest = true;
+        bool writeInterest = false;
+        time_t lastActive = 0;
+    };
+
+    struct Completion {
+        uint64_t connectionId;
+        bool keepAlive;
+        WireFormat format;
+        std::string response;
+    };
+
+    Options options;
+    RequestProcessor processor;
+    std::shared_ptr<ThreadPool> workerPool;
+
+    int listenFd = -1;
+    int epollFd = -1;
+    int wakeFd = -1;
+    std::atomic<bool> stopRequested{false};
+    std::string lastError;
+
+    // 以连接序号为键（也作为epoll事件数据），避免fd复用时把响应写给新连接
+    std::unordered_map<uint64_t, std::unique_ptr<Connection>> connections;
+    uint64_t nextConnectionId = 1;
+
+    std::mutex completionMutex;
+    std::vector<Completion> completions;
+
+    std::atomic<uint64_t> totalConnections{0};
+    std::atomic<uint64_t> totalRequests{0};
+    std::atomic<uint64_t> rejectedRequests{0};
+
+    void acceptConnections();
+    bool readInput(Connection& connection);
+    bool flushOutput(Connection& connection);
+    void serviceConnection(uint64_t connectionId);
+    bool parseNextRequest(Connection& connection);
+    void drainCompletions();
+    void closeIdleConnections(time_t now, bool stopping);
+
+    void queueResponse(Connection& connection, int status, const char* reason, const char* contentType,
+                       const std::string& body, bool keepAlive, const char* extraHeaders = "");
+    void rejectRequest(Connection& connection, int status, const char* reason, bool keepAlive,
+                       const char* extraHeaders = "");
+    void updateInterest(Connection& connection);
+    void closeConnection(uint64_t connectionId);
+};
+
+#endif // HTTP_FRONTEND_H
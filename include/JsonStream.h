@@ -0,0 +1,75 @@
+#ifndef JSON_STREAM_H
+#define JSON_STREAM_H
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+#if __has_include(<nlohmann/json.hpp>)
+    #include <nlohmann/json.hpp>
+#elif __has_include(<json/json.hpp>)
+    #include <json/json.hpp>
+#else
+    #error "nlohmann/json library not found. Please install nlohmann-json3-dev package."
+#endif
+
+// 请求/响应的线上编码格式。内部客户端可使用MessagePack或CBOR二进制信封，
+// 结构与JSON信封相同（顶层 api/data 映射），由处理函数共用
+enum class WireFormat {
+    JSON,
+    MSGPACK,
+    CBOR
+};
+
+// 请求信封按需解析：只扫描顶层结构定位"api"与"data"，
+// 路由与拒绝无需解析data；data的原始字节区间在需要时才解析为DOM
+class RequestEnvelope {
+public:
+    std::string api;
+    bool hasApi = false;
+    int64_t timeoutMs = -1;  // 请求超时（毫秒），未提供时为-1
+
+    // 扫描顶层对象。信封不规范（语法错误、api不是普通字符串等）时返回false，
+    // 由调用方回退到完整解析以得到原有的错误信息
+    bool scan(const std::string& input);
+
+    bool hasData() const { return dataBegin != nullptr; }
+    size_t dataSize() const { return static_cast<size_t>(dataEnd - dataBegin); }
+
+    // 直接从输入缓冲区中的data区间解析，不复制请求文本
+    nlohmann::json parseData() const;
+
+private:
+    const char* dataBegin = nullptr;
+    const char* dataEnd = nullptr;
+};
+
+// 响应直写：按固定键序将响应信封直接写入可复用缓冲区，
+// 输出与 json{status, code, message, data}.dump() 逐字节一致；
+// 字符串含无效UTF-8时同样抛出 nlohmann::json::type_error(316)
+class JsonResponseWriter {
+public:
+    static void write(std::string& out, const std::string& status, int code,
+                      const std::string& message, const nlohmann::json& data);
+
+    // 与nlohmann::json::dump相同的字符串转义规则（不转义非ASCII字符，无效UTF-8抛出type_error）
+    static void appendEscaped(std::string& out, const std::string& value);
+};
+
+// 二进制信封编解码
+class WireCodec {
+public:
+    // 按首字节识别：MessagePack映射(0x80-0x8f, 0xde, 0xdf)、CBOR映射(0xa0-0xbb, 0xbf)，其余视为JSON
+    static WireFormat detect(const std::string& input);
+
+    static nlohmann::json decode(const std::string& input, WireFormat format);
+
+    // 按固定键序直接写出响应映射，data部分原样编码，不构造响应DOM
+    static void writeResponse(std::string& out, WireFormat format, const std::string& status, int code,
+                              const std::string& message, const nlohmann::json& data);
+
+    static const char* formatName(WireFormat format);
+    static bool parseFormatName(const std::string& name, WireFormat& format);
+};
+
+#endif // JSON_STREAM_H
@@ -0,0 +1,169 @@
+#ifndef LRU_CACHE_H
+#define LRU_CACHE_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+// Thread-safe LRU cache split into independently locked shards by key hash,
+// so concurrent lookups of different keys rarely contend. Each shard evicts
+// its least recently used entry when full; entries also expire after ttl as
+// a safety net for writes the owner never saw (another process, a cascade).
+//
+// A loader that misses takes a ticket with beginFill() before reading the
+// database and stores the row with fill(); if anything was invalidated in
+// between, the possibly stale row is dropped instead. Tickets are cache-wide,
+// so a loader can take one before it knows the key it will fill.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache {
+public:
+    struct Config {
+        size_t capacity = 4096;  // total entries; 0 disables the cache
+        size_t shards = 16;
+        std::chrono::milliseconds ttl{60000};
+    };
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        uint64_t expirations = 0;
+        uint64_t invalidations = 0;
+        size_t size = 0;
+        size_t capacity = 0;
+    };
+
+    LruCache() : LruCache(Config()) {}
+    explicit LruCache(const Config& config)
+        : config(config),
+          shardCount(std::max<size_t>(1, std::min(config.shards, std::max<size_t>(1, config.capacity)))),
+          shardCapacity(config.capacity ? (config.capacity + shardCount - 1) / shardCount : 0),
+          shards(new Shard[shardCount]) {}
+
+    LruCache(const LruCache&) = delete;
+    LruCache& operator=(const LruCache&) = delete;
+
+    bool enabled() const { return shardCapacity > 0; }
+
+    // Copies the cached value into value; false on a miss or an expired entry
+    bool get(const Key& key, Value& value) {
+        if (!enabled()) return false;
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto found = shard.index.find(key);
+        if (found == shard.index.end()) {
+            misses.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (Clock::now() >= found->second->expires) {
+            shard.entries.erase(found->second);
+            shard.index.erase(found);
+            expirations.fetch_add(1, std::memory_order_relaxed);
+            misses.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        shard.entries.splice(shard.entries.begin(), shard.entries, found->second);
+        value = found->second->value;
+        hits.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    uint64_t beginFill() const { return generation.load(std::memory_order_acquire); }
+
+    // Stores value unless an invalidation happened since beginFill()
+    void fill(const Key& key, const Value& value, uint64_t ticket) {
+        if (!enabled()) return;
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (generation.load(std::memory_order_acquire) != ticket) return;
+        auto found = shard.index.find(key);
+        if (found != shard.index.end()) {
+            found->second->value = value;
+            found->second->expires = Clock::now() + config.ttl;
+            shard.entries.splice(shard.entries.begin(), shard.entries, found->second);
+            return;
+        }
+        if (shard.entries.size() >= shardCapacity) {
+            shard.index.erase(shard.entries.back().key);
+            shard.entries.pop_back();
+            evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+        shard.entries.push_front(Entry{key, value, Clock::now() + config.ttl});
+        shard.index.emplace(key, shard.entries.begin());
+    }
+
+    void invalidate(const Key& key) {
+        if (!enabled()) return;
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        generation.fetch_add(1, std::memory_order_acq_rel);
+        auto found = shard.index.find(key);
+        if (found == shard.index.end()) return;
+        shard.entries.erase(found->second);
+        shard.index.erase(found);
+        invalidations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void clear() {
+        for (size_t i = 0; i < shardCount; ++i) {
+            std::lock_guard<std::mutex> lock(shards[i].mutex);
+            generation.fetch_add(1, std::memory_order_acq_rel);
+            invalidations.fetch_add(shards[i].entries.size(), std::memory_order_relaxed);
+            shards[i].entries.clear();
+            shards[i].index.clear();
+        }
+    }
+
+    Stats getStats() const {
+        Stats stats;
+        stats.hits = hits.load(std::memory_order_relaxed);
+        stats.misses = misses.load(std::memory_order_relaxed);
+        stats.evictions = evictions.load(std::memory_order_relaxed);
+        stats.expirations = expirations.load(std::memory_order_relaxed);
+        stats.invalidations = invalidations.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < shardCount; ++i) {
+            std::lock_guard<std::mutex> lock(shards[i].mutex);
+            stats.size += shards[i].entries.size();
+        }
+        stats.capacity = shardCapacity * shardCount;
+        return stats;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        Key key;
+        Value value;
+        Clock::time_point expires;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::list<Entry> entries;  // most recently used first
+        std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> index;
+    };
+
+    Shard& shardFor(const Key& key) { return shards[Hash()(key) % shardCount]; }
+
+    Config config;
+    size_t shardCount;
+    size_t shardCapacity;
+    std::unique_ptr<Shard[]> shards;
+    std::atomic<uint64_t> generation{0};  // bumped by every invalidation
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+    std::atomic<uint64_t> evictions{0};
+    std::atomic<uint64_t> expirations{0};
+    std::atomic<uint64_t> invalidations{0};
+};
+
+#endif // LRU_CACHE_H
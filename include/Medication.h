@@ -39,21 +39,22 @@ private:
     
 public:
     MedicationDAO(std::shared_ptr<ConnectionPool> pool);
+    virtual ~MedicationDAO() = default;
     
     // CRUD operations
-    bool createMedication(const Medication& medication);
-    std::unique_ptr<Medication> getMedicationById(int medicationId);
-    std::vector<std::unique_ptr<Medication>> getMedicationsByPrescriptionId(int prescriptionId);
-    std::vector<std::unique_ptr<Medication>> getAllMedications();
+    virtual bool createMedication(const Medication& medication);
+    virtual std::unique_ptr<Medication> getMedicationById(int medicationId);
+    virtual std::vector<std::unique_ptr<Medication>> getMedicationsByPrescriptionId(int prescriptionId);
+    virtual std::vector<std::unique_ptr<Medication>> getAllMedications();
     
-    bool updateMedication(const Medication& medication);
-    bool deleteMedication(int medicationId);
+    virtual bool updateMedication(const Medication& medication);
+    virtual bool deleteMedication(int medicationId);
     
     // Search operations
-    std::vector<std::unique_ptr<Medication>> searchMedications(const std::string& searchTerm);
-    std::vector<std::unique_ptr<Medication>> getMedicationsByName(const std::string& medicationName);
-    int getMedicationCount();
-    int getTotalQuantityByName(const std::string& medicationName);
+    virtual std::vector<std::unique_ptr<Medication>> searchMedications(const std::string& searchTerm);
+    virtual std::vector<std::unique_ptr<Medication>> getMedicationsByName(const std::string& medicationName);
+    virtual int getMedicationCount();
+    virtual int getTotalQuantityByName(const std::string& medicationName);
     
 private:
     Medication* mapRowToMedication(MYSQL_ROW row, unsigned long* lengths);
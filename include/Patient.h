@@ -5,6 +5,8 @@
 #include <vector>
 #include <memory>
 #include "DatabaseConnection.h"
+#include "AsyncQueryExecutor.h"
+#include "BloomFilter.h"
 
 enum class Gender {
     MALE,
@@ -52,10 +54,16 @@ public:
 class PatientDAO {
 private:
     std::shared_ptr<ConnectionPool> connectionPool;
+    std::shared_ptr<BloomFilter> existenceFilter;
     
 public:
     PatientDAO(std::shared_ptr<ConnectionPool> pool);
     
+    // Existence filter (id_number)
+    void setExistenceFilter(std::shared_ptr<BloomFilter> filter) { existenceFilter = filter; }
+    uint64_t loadExistenceFilter(uint64_t afterPatientId = 0);
+    void addToExistenceFilter(const std::string& idNumber);
+    
     // CRUD operations
     bool createPatient(const Patient& patient);
     std::unique_ptr<Patient> getPatientById(int patientId);
@@ -72,6 +80,13 @@ public:
     bool patientExists(const std::string& idNumber);
     int getPatientCount();
     
+    // Building blocks for multi-statement reads
+    std::string getPatientByUserIdQuery(int userId);
+    std::unique_ptr<Patient> readPatient(MYSQL_RES* result);
+    
+    // Non-blocking variant (see AsyncQueryExecutor)
+    std::future<std::unique_ptr<Patient>> getPatientByUserIdAsync(AsyncQueryExecutor& executor, int userId);
+    
 private:
     Patient* mapRowToPatient(MYSQL_ROW row, unsigned long* lengths);
 };
@@ -39,21 +39,22 @@ private:
     
 public:
     PrescriptionDAO(std::shared_ptr<ConnectionPool> pool);
+    virtual ~PrescriptionDAO() = default;
     
     // CRUD operations
-    bool createPrescription(const Prescription& prescription);
-    std::unique_ptr<Prescription> getPrescriptionById(int prescriptionId);
-    std::vector<std::unique_ptr<Prescription>> getPrescriptionsByCaseId(int caseId);
-    std::vector<std::unique_ptr<Prescription>> getPrescriptionsByDoctorId(int doctorId);
-    std::vector<std::unique_ptr<Prescription>> getAllPrescriptions();
+    virtual bool createPrescription(const Prescription& prescription);
+    virtual std::unique_ptr<Prescription> getPrescriptionById(int prescriptionId);
+    virtual std::vector<std::unique_ptr<Prescription>> getPrescriptionsByCaseId(int caseId);
+    virtual std::vector<std::unique_ptr<Prescription>> getPrescriptionsByDoctorId(int doctorId);
+    virtual std::vector<std::unique_ptr<Prescription>> getAllPrescriptions();
     
-    bool updatePrescription(const Prescription& prescription);
-    bool deletePrescription(int prescriptionId);
+    virtual bool updatePrescription(const Prescription& prescription);
+    virtual bool deletePrescription(int prescriptionId);
     
     // Search operations
-    std::vector<std::unique_ptr<Prescription>> searchPrescriptions(const std::string& searchTerm);
-    int getPrescriptionCount();
-    int getPrescriptionCountByDoctor(int doctorId);
+    virtual std::vector<std::unique_ptr<Prescription>> searchPrescriptions(const std::string& searchTerm);
+    virtual int getPrescriptionCount();
+    virtual int getPrescriptionCountByDoctor(int doctorId);
     
 private:
     Prescription* mapRowToPrescription(MYSQL_ROW row, unsigned long* lengths);
@@ -0,0 +1,134 @@
+#ifndef QUERY_CACHE_H
+#define QUERY_CACHE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Results of SELECTs that depend only on table contents (counts, lists of
+// reference data), keyed by the statement text with whitespace collapsed.
+// Each entry records the tables its statement reads; a write to one of them
+// bumps that table's version and drops the entries depending on it. Only
+// statements a caller explicitly runs through the cache are stored, and the
+// total size is capped, least recently used entries going first.
+//
+// A loader takes a ticket with beginFill() before running the statement and
+// stores the result with fill(); if one of the tables was written in between,
+// the possibly stale result is dropped instead. Entries also expire after ttl
+// as a safety net for writes this process never saw.
+class QueryCache {
+public:
+    struct Config {
+        size_t maxBytes = 0;                  // total size of cached results; 0 disables the cache
+        size_t maxEntryBytes = 256 * 1024;    // larger results are not cached
+        std::chrono::milliseconds ttl{30000};
+        // Tables whose rows a DELETE from the key table removes through
+        // ON DELETE CASCADE; followed transitively
+        std::unordered_map<std::string, std::vector<std::string>> deleteCascades;
+    };
+
+    // Rows of a result set, copied out of the client library's buffers so
+    // that they can be shared between threads
+    class Result {
+    public:
+        explicit Result(size_t columns) : columns(columns) {}
+
+        void addRow(char** row, const unsigned long* lengths);
+        size_t rowCount() const { return columns ? values.size() / columns : 0; }
+        size_t columnCount() const { return columns; }
+        // nullptr for SQL NULL
+        const std::string* get(size_t row, size_t column) const;
+        size_t bytes() const { return byteCount; }
+
+    private:
+        size_t columns;
+        std::vector<std::string> values;  // row-major
+        std::vector<bool> nulls;
+        size_t byteCount = sizeof(Result);
+    };
+
+    struct Ticket {
+        std::vector<std::pair<std::string, uint64_t>> versions;  // tables read, at beginFill()
+    };
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t fills = 0;
+        uint64_t staleFills = 0;     // dropped because a table was written meanwhile
+        uint64_t oversized = 0;      // results over maxEntryBytes
+        uint64_t invalidations = 0;  // entries dropped by writes
+        uint64_t evictions = 0;
+        uint64_t expirations = 0;
+        size_t entries = 0;
+        size_t bytes = 0;
+        size_t maxBytes = 0;
+    };
+
+    explicit QueryCache(const Config& config) : config(config) {}
+
+    QueryCache(const QueryCache&) = delete;
+    QueryCache& operator=(const QueryCache&) = delete;
+
+    bool enabled() const { return config.maxBytes > 0; }
+
+    // nullptr on a miss or an expired entry
+    std::shared_ptr<const Result> lookup(const std::string& statement);
+    Ticket beginFill(const std::string& statement) const;
+    // Stores result unless one of its tables was written since beginFill()
+    void fill(const std::string& statement, const Ticket& ticket, std::shared_ptr<const Result> result);
+    // Bumps the versions of the tables a write statement touches, including
+    // those a DELETE cascades into, and drops the entries reading them
+    void invalidate(const std::string& statement) { invalidateTables(writtenTables(statement)); }
+    void invalidateTables(const std::vector<std::string>& tables);
+    std::vector<std::string> writtenTables(const std::string& statement) const;
+    Stats getStats() const;
+
+    // Lower-cased names following FROM, JOIN, INTO, UPDATE and TABLE,
+    // without database qualifiers; quoted literals are skipped
+    static std::vector<std::string> tablesOf(const std::string& statement);
+    // Whitespace outside quoted literals collapsed to single spaces. Literals
+    // are kept: statements with different parameters have different results.
+    static std::string keyOf(const std::string& statement);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        std::shared_ptr<const Result> result;
+        std::vector<std::string> tables;
+        size_t bytes;
+        Clock::time_point expires;
+        std::list<std::string>::iterator position;
+    };
+
+    // Caller holds mutex
+    void erase(std::unordered_map<std::string, Entry>::iterator found);
+    uint64_t versionOf(const std::string& table) const;
+
+    Config config;
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+    std::list<std::string> order;  // keys, most recently used first
+    std::unordered_map<std::string, uint64_t> versions;
+    std::unordered_map<std::string, std::unordered_set<std::string>> dependents;  // table -> keys
+    size_t bytes = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t fills = 0;
+    uint64_t staleFills = 0;
+    uint64_t oversized = 0;
+    uint64_t invalidations = 0;
+    uint64_t evictions = 0;
+    uint64_t expirations = 0;
+};
+
+#endif // QUERY_CACHE_H
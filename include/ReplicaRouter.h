@@ -0,0 +1,126 @@
+#ifndef REPLICA_ROUTER_H
+#define REPLICA_ROUTER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class ConnectionPool;
+class DatabaseConnection;
+
+struct ReplicaEndpoint {
+    std::string host;
+    unsigned int port = 3306;
+
+    // Parses "host" or "host:port"
+    static bool parse(const std::string& text, ReplicaEndpoint& endpoint);
+};
+
+// Routes reads to read replicas. Replicas are picked round-robin among those
+// that answered the last heartbeat probe within maxLag. A request that has
+// written, and any request of a user who wrote within stickyWindow, reads
+// from the primary instead (read-your-writes).
+//
+// Lag comes from a heartbeat row the primary rewrites every heartbeatInterval
+// (pt-heartbeat style). The measured value is replication delay plus the age of
+// the newest beat, so maxLag should be well above heartbeatInterval.
+class ReplicaRouter {
+public:
+    struct Policy {
+        std::chrono::milliseconds maxLag{1000};
+        std::chrono::milliseconds stickyWindow{2000};
+        std::chrono::milliseconds heartbeatInterval{250};
+    };
+
+    struct ReplicaStatus {
+        std::string endpoint;
+        bool healthy;
+        int64_t lagMs;
+        uint64_t reads;
+    };
+
+    // Marks the current thread as serving a request of userId (0 = anonymous)
+    // so writes made through the primary pin later reads
+    class SessionScope {
+    public:
+        // The calling thread's session, to be continued on another thread
+        struct Session {
+            bool active = false;
+            int userId = 0;
+            bool wrote = false;
+        };
+        static Session current();
+
+        explicit SessionScope(int userId);
+        // Continues a session captured with current(), e.g. in a fan-out task
+        // running on a worker thread, so its reads stay pinned the same way
+        explicit SessionScope(const Session& session);
+        ~SessionScope();
+        SessionScope(const SessionScope&) = delete;
+        SessionScope& operator=(const SessionScope&) = delete;
+
+    private:
+        int previousUser;
+        bool previousWrote;
+        bool previousActive;
+    };
+
+    ReplicaRouter(ConnectionPool& primary, std::vector<std::pair<ReplicaEndpoint, std::shared_ptr<ConnectionPool>>> replicas,
+                  const Policy& policy);
+    ~ReplicaRouter();
+
+    ReplicaRouter(const ReplicaRouter&) = delete;
+    ReplicaRouter& operator=(const ReplicaRouter&) = delete;
+
+    // Creates the heartbeat table, probes every replica once and starts the monitor thread
+    void start();
+    void stop();
+
+    // A replica connection for a read, or nullptr when the read must use the primary;
+    // multiStatements takes one of the replica's multi-statement connections
+    std::unique_ptr<DatabaseConnection> acquireRead(bool multiStatements = false);
+
+    // Called whenever a connection is taken from the primary
+    void recordWrite();
+
+    std::vector<ReplicaStatus> getStatus() const;
+
+private:
+    struct Replica {
+        std::string endpoint;
+        std::shared_ptr<ConnectionPool> pool;
+        std::atomic<bool> healthy{false};
+        std::atomic<int64_t> lagMs{-1};
+        std::atomic<uint64_t> reads{0};
+    };
+
+    // Last write time per user, hashed into a fixed table; a collision can only
+    // pin a read to the primary, never send it to a stale replica
+    static const size_t kRecentWriteSlots = 4096;
+
+    ConnectionPool& primary;
+    std::vector<std::unique_ptr<Replica>> replicas;
+    Policy policy;
+    std::atomic<size_t> nextReplica{0};
+    std::array<std::atomic<int64_t>, kRecentWriteSlots> recentWrites;
+
+    std::thread monitor;
+    std::mutex monitorMutex;
+    std::condition_variable monitorWakeup;
+    bool stopping = false;
+
+    void writeHeartbeat();
+    void probe(Replica& replica);
+    void monitorLoop();
+    bool isPinnedToPrimary() const;
+    static int64_t nowMs();
+};
+
+#endif // REPLICA_ROUTER_H
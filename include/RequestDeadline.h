@@ -0,0 +1,49 @@
+#ifndef REQUEST_DEADLINE_H
+#define REQUEST_DEADLINE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Deadline of a request. While a Scope is active the thread's connections
+// bound their SELECTs by the remaining time, and pools hand out no further
+// connections once it has passed, so a request the client has given up on
+// stops holding connections.
+class RequestDeadline {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit RequestDeadline(Clock::time_point at) : at(at) {}
+
+    Clock::time_point getTime() const { return at; }
+    bool expired() const { return Clock::now() >= at; }
+    // Milliseconds left, at least 1 so it can be passed on as a server-side limit
+    int64_t remainingMs() const;
+
+    // Set when the deadline refused a connection or cut off a query; the
+    // request's result is then incomplete
+    void markExceeded() { exceeded.store(true, std::memory_order_relaxed); }
+    bool wasExceeded() const { return exceeded.load(std::memory_order_relaxed); }
+
+    // Deadline of the request served by the current thread, or nullptr
+    static RequestDeadline* current();
+
+    // Makes deadline current on this thread for the scope's lifetime.
+    // Fan-out tasks install their parent's deadline the same way.
+    class Scope {
+    public:
+        explicit Scope(RequestDeadline* deadline);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        RequestDeadline* previous;
+    };
+
+private:
+    Clock::time_point at;
+    std::atomic<bool> exceeded{false};
+};
+
+#endif // REQUEST_DEADLINE_H
@@ -0,0 +1,100 @@
+#ifndef REQUEST_VALIDATOR_H
+#define REQUEST_VALIDATOR_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#if __has_include(<nlohmann/json.hpp>)
+    #include <nlohmann/json.hpp>
+#elif __has_include(<json/json.hpp>)
+    #include <json/json.hpp>
+#else
+    #error "nlohmann/json library not found. Please install nlohmann-json3-dev package."
+#endif
+
+// 声明式请求参数校验：每个API注册一份字段规则，启动时编译为字段名索引，
+// 校验时单遍扫描data对象，一次性返回全部错误
+class RequestValidator {
+public:
+    enum class FieldType {
+        ANY,
+        STRING,
+        INTEGER,
+        NUMBER,
+        BOOLEAN,
+        ARRAY,
+        OBJECT
+    };
+
+    enum class FieldFormat {
+        NONE,
+        NON_EMPTY,
+        EMAIL,
+        CN_MOBILE,
+        ID_NUMBER,  // 18位身份证号（含校验位）
+        DATE,       // YYYY-MM-DD
+        PASSWORD    // 至少6位
+    };
+
+    struct FieldRule {
+        std::string name;
+        FieldType type = FieldType::STRING;
+        FieldFormat format = FieldFormat::NONE;
+        bool isRequired = false;
+        int missingCode = 400;
+        std::string missingMessage = "缺少必要参数";
+        int invalidCode = 400;
+        std::string invalidMessage;
+
+        FieldRule& required(int code = 400, const std::string& message = "缺少必要参数") {
+            isRequired = true;
+            missingCode = code;
+            missingMessage = message;
+            return *this;
+        }
+        FieldRule& ofType(FieldType fieldType) { type = fieldType; return *this; }
+        FieldRule& withFormat(FieldFormat fieldFormat, const std::string& message = "", int code = 400) {
+            format = fieldFormat;
+            invalidMessage = message;
+            invalidCode = code;
+            return *this;
+        }
+    };
+
+    struct ValidationError {
+        std::string field;
+        int code;
+        std::string message;
+    };
+
+    static FieldRule field(const std::string& name) {
+        FieldRule rule;
+        rule.name = name;
+        return rule;
+    }
+
+    void addSchema(const std::string& api, const std::vector<FieldRule>& rules);
+    bool hasSchema(const std::string& api) const { return schemas.count(api) > 0; }
+    std::vector<ValidationError> validate(const std::string& api, const nlohmann::json& data) const;
+
+    // 手写DFA匹配器，与原正则语义一致（身份证号额外校验校验位）
+    static bool matchEmail(const std::string& value);
+    static bool matchCnMobile(const std::string& value);
+    static bool matchIdNumber(const std::string& value);
+    static bool matchDate(const std::string& value);
+
+private:
+    struct CompiledSchema {
+        std::vector<FieldRule> rules;
+        std::unordered_map<std::string, size_t> index;
+    };
+
+    std::unordered_map<std::string, CompiledSchema> schemas;
+
+    static bool checkType(FieldType type, const nlohmann::json& value);
+    static bool checkFormat(FieldFormat format, const std::string& value);
+    static std::string typeName(FieldType type);
+};
+
+#endif // REQUEST_VALIDATOR_H
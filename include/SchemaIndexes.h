@@ -0,0 +1,33 @@
+#ifndef SCHEMA_INDEXES_H
+#define SCHEMA_INDEXES_H
+
+#include <string>
+#include <vector>
+#include "DatabaseConnection.h"
+
+// Secondary indexes matched to the DAO access paths: a filter column
+// followed by the column the query orders by, so per-patient, per-doctor
+// and per-department lists read rows in order instead of sorting them.
+// New databases get them from CREATE TABLE; migrate() brings databases
+// created with the earlier single-column indexes up to date.
+class SchemaIndexes {
+public:
+    struct Index {
+        const char* table;
+        const char* name;
+        const char* columns;
+    };
+
+    // Indexes every database should have
+    static const std::vector<Index>& required();
+    // Earlier indexes covered by a required one (a left prefix of it, or a
+    // duplicate of a UNIQUE key) that only slow down writes
+    static const std::vector<Index>& superseded();
+
+    // Adds the missing required indexes, then drops the superseded ones, on
+    // the tables of the connection's database; tables that do not exist are
+    // skipped. Adding an index to a large table takes a while.
+    static bool migrate(DatabaseConnection& conn, std::string& error);
+};
+
+#endif // SCHEMA_INDEXES_H
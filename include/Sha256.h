@@ -0,0 +1,30 @@
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// 共享SHA-256哈希模块（密码哈希与token生成）
+// 单条消息走OpenSSL EVP（内部自动使用SHA-NI）；批量接口在支持AVX2的CPU上
+// 以8路多缓冲方式并行计算多条互不相关的消息，否则逐条回退到标量实现
+class Sha256 {
+public:
+    static const size_t DIGEST_LENGTH = 32;
+
+    static void digest(const void* data, size_t length, uint8_t out[DIGEST_LENGTH]);
+    static std::string hex(const std::string& message);
+    static std::vector<std::string> hexBatch(const std::vector<std::string>& messages);
+
+    // 表驱动的十六进制编码，out至少需要2*length字节
+    static void toHex(const uint8_t* bytes, size_t length, char* out);
+
+    // 当前批量接口使用的实现（"avx2-x8" 或 "scalar"）
+    static const char* batchBackend();
+
+    // 强制批量接口使用标量实现，用于基准对比
+    static void setForceScalar(bool force);
+};
+
+#endif // SHA256_H
@@ -0,0 +1,66 @@
+#ifndef SHARD_MAP_H
+#define SHARD_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct ShardLocation {
+    std::string host;
+    unsigned int port = 3306;
+    std::string database;
+
+    // Parses "host[:port]/database"
+    static bool parse(const std::string& text, ShardLocation& location);
+    std::string toString() const;
+};
+
+// Maps a patient_id to the shard that stores the patient's cases,
+// appointments, hospitalizations, prescriptions and medications. Patients
+// hash into a fixed set of buckets and every bucket is owned by one shard,
+// so resharding moves whole buckets and never rehashes a patient.
+//
+// Row ids stay unique across shards: shard k only allocates AUTO_INCREMENT
+// ids congruent to k + 1 modulo kIdStride. Rows keep their id when their
+// bucket moves, and the counter of the receiving shard stays in its own
+// residue class, so an id only tells which shard created the row.
+class ShardMap {
+public:
+    static const int kBuckets = 1024;
+    static const int kIdStride = 32;
+    static const size_t kMaxShards = kIdStride;
+
+    // File format, one directive per line ('#' starts a comment):
+    //   shard <index> <host[:port]/database>
+    //   buckets <first>[-<last>] <shard>
+    // Buckets without an owner are split into equal contiguous ranges.
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+
+    static int bucketOf(int patientId);
+    // SQL expression computing bucketOf() of an integer column
+    static std::string bucketExpression(const std::string& column);
+
+    // Returns the new shard's index; it owns no buckets until assigned
+    size_t addShard(const ShardLocation& location);
+    size_t size() const { return shards.size(); }
+    const ShardLocation& getShard(size_t shard) const { return shards[shard]; }
+
+    size_t shardOf(int patientId) const { return buckets[bucketOf(patientId)]; }
+    size_t shardOfBucket(int bucket) const { return buckets[bucket]; }
+    void assignBucket(int bucket, size_t shard) { buckets[bucket] = shard; }
+    std::vector<int> bucketsOf(size_t shard) const;
+
+    // Shard that allocated id (or -1); ids from before sharding give an arbitrary shard
+    int homeShardOf(int id) const;
+
+    std::string getError() const { return lastError; }
+
+private:
+    std::vector<ShardLocation> shards;
+    std::vector<size_t> buckets = std::vector<size_t>(kBuckets, 0);
+    std::string lastError;
+};
+
+#endif // SHARD_MAP_H
@@ -0,0 +1,104 @@
+#ifndef SHARD_SET_H
+#define SHARD_SET_H
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "DatabaseConnection.h"
+#include "FanOutExecutor.h"
+#include "ShardMap.h"
+
+// Connection pools of the patient shards plus the map that routes to them
+class ShardSet {
+public:
+    // pools[i] serves map.getShard(i)
+    ShardSet(ShardMap map, std::vector<std::shared_ptr<ConnectionPool>> pools);
+
+    // Opens a pool per shard with the credentials and size of the main pool
+    static std::shared_ptr<ShardSet> connect(const ShardMap& map, const ConnectionPool& main);
+
+    // Scatter runs on this executor; without one, shards are queried one after another
+    void setExecutor(std::function<FanOutExecutor&()> provider) { executor = std::move(provider); }
+
+    size_t size() const { return pools.size(); }
+    const ShardMap& getMap() const { return map; }
+    std::shared_ptr<ConnectionPool> at(size_t shard) const { return pools[shard]; }
+    size_t shardOf(int patientId) const { return map.shardOf(patientId); }
+    std::shared_ptr<ConnectionPool> forPatient(int patientId) const { return pools[map.shardOf(patientId)]; }
+
+    // Calls fn(shard) for every shard, concurrently when an executor is set,
+    // and returns the results in shard order
+    template <typename F>
+    std::vector<std::invoke_result_t<F&, size_t>> scatter(F&& fn) const;
+
+    // Shard holding the row of table whose idColumn equals id; -1 if none does.
+    // Probes the shard that allocated the id first.
+    int locate(const std::string& table, const std::string& idColumn, int id) const;
+
+    // Creates the patient-owned tables on every shard
+    bool createTables();
+
+    // Session setup for every connection to shard: AUTO_INCREMENT ids in the shard's residue class
+    static std::string idAllocationCommand(size_t shard);
+    std::string getError() const { return lastError; }
+
+    // Merges per-shard lists that are each ordered by key; equal keys keep shard order
+    template <typename T, typename Key>
+    static std::vector<T> merge(std::vector<std::vector<T>> parts, Key key, bool descending);
+
+private:
+    ShardMap map;
+    std::vector<std::shared_ptr<ConnectionPool>> pools;
+    std::function<FanOutExecutor&()> executor;
+    std::string lastError;
+
+    bool hasRow(size_t shard, const std::string& query) const;
+};
+
+template <typename F>
+std::vector<std::invoke_result_t<F&, size_t>> ShardSet::scatter(F&& fn) const {
+    using T = std::invoke_result_t<F&, size_t>;
+    std::vector<T> results(pools.size());
+    if (!executor || pools.size() == 1) {
+        for (size_t shard = 0; shard < pools.size(); ++shard) {
+            results[shard] = fn(shard);
+        }
+        return results;
+    }
+
+    FanOutExecutor& fanOut = executor();
+    std::vector<FanOutExecutor::Future<T>> pending;
+    pending.reserve(pools.size() - 1);
+    for (size_t shard = 1; shard < pools.size(); ++shard) {
+        pending.push_back(fanOut.submit([&fn, shard]() { return fn(shard); }));
+    }
+    // Shard 0 on the calling thread
+    results[0] = fn(0);
+    for (size_t shard = 1; shard < pools.size(); ++shard) {
+        results[shard] = pending[shard - 1].get();
+    }
+    return results;
+}
+
+template <typename T, typename Key>
+std::vector<T> ShardSet::merge(std::vector<std::vector<T>> parts, Key key, bool descending) {
+    auto before = [&](const T& left, const T& right) {
+        return descending ? key(right) < key(left) : key(left) < key(right);
+    };
+    std::vector<T> merged;
+    for (auto& part : parts) {
+        std::vector<T> next;
+        next.reserve(merged.size() + part.size());
+        std::merge(std::make_move_iterator(merged.begin()), std::make_move_iterator(merged.end()),
+                   std::make_move_iterator(part.begin()), std::make_move_iterator(part.end()),
+                   std::back_inserter(next), before);
+        merged = std::move(next);
+    }
+    return merged;
+}
+
+#endif // SHARD_SET_H
@@ -0,0 +1,163 @@
+#ifndef SHARDED_DAO_H
+#define SHARDED_DAO_H
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "ShardSet.h"
+#include "Case.h"
+#include "Appointment.h"
+#include "Hospitalization.h"
+#include "Prescription.h"
+#include "Medication.h"
+
+// Routing shared by the sharded DAOs, which delegate to one plain DAO per shard.
+// Writes and per-patient reads go to the patient's shard; other reads
+// scatter to every shard and merge in the order the single-node query uses.
+template <typename DAO>
+class ShardedDAOBase {
+protected:
+    std::shared_ptr<ShardSet> shards;
+    std::vector<std::unique_ptr<DAO>> perShard;
+
+    explicit ShardedDAOBase(std::shared_ptr<ShardSet> shardSet) : shards(std::move(shardSet)) {
+        for (size_t shard = 0; shard < shards->size(); ++shard) {
+            perShard.push_back(std::make_unique<DAO>(shards->at(shard)));
+        }
+    }
+
+    DAO& forPatient(int patientId) { return *perShard[shards->shardOf(patientId)]; }
+
+    template <typename F>
+    auto scatter(F fn) {
+        return shards->scatter([&](size_t shard) { return fn(*perShard[shard]); });
+    }
+
+    template <typename F>
+    int sum(F fn) {
+        int total = 0;
+        for (int count : scatter(fn)) total += count;
+        return total;
+    }
+
+    template <typename F, typename Key>
+    auto gather(F fn, Key key, bool descending) {
+        return ShardSet::merge(scatter(fn), key, descending);
+    }
+
+    // Point lookup: the shard that allocated the id first, then all the others
+    template <typename F>
+    auto findById(int id, F fn) {
+        int home = shards->getMap().homeShardOf(id);
+        if (home >= 0) {
+            auto row = fn(*perShard[home]);
+            if (row) return row;
+        }
+        auto rows = shards->scatter([&](size_t shard) {
+            return static_cast<int>(shard) == home ? decltype(fn(*perShard[shard]))() : fn(*perShard[shard]);
+        });
+        for (auto& row : rows) {
+            if (row) return std::move(row);
+        }
+        return decltype(fn(*perShard[0]))();
+    }
+
+    // Shard holding the row, or nullptr
+    DAO* locate(const std::string& table, const std::string& idColumn, int id) {
+        int shard = shards->locate(table, idColumn, id);
+        return shard >= 0 ? perShard[shard].get() : nullptr;
+    }
+};
+
+class ShardedCaseDAO : public CaseDAO, private ShardedDAOBase<CaseDAO> {
+public:
+    explicit ShardedCaseDAO(std::shared_ptr<ShardSet> shards);
+
+    bool createCase(const Case& medicalCase) override;
+    std::unique_ptr<Case> getCaseById(int caseId) override;
+    std::vector<std::unique_ptr<Case>> getCasesByPatientId(int patientId) override;
+    std::vector<std::unique_ptr<Case>> getCasesByDoctorId(int doctorId) override;
+    std::vector<std::unique_ptr<Case>> getCasesByDepartment(const std::string& department) override;
+    std::vector<std::unique_ptr<Case>> getAllCases() override;
+    bool updateCase(const Case& medicalCase) override;
+    bool deleteCase(int caseId) override;
+    std::vector<std::unique_ptr<Case>> searchCases(const std::string& searchTerm) override;
+    int getCaseCount() override;
+    int getCaseCountByDoctor(int doctorId) override;
+    int getCaseCountByPatient(int patientId) override;
+};
+
+class ShardedAppointmentDAO : public AppointmentDAO, private ShardedDAOBase<AppointmentDAO> {
+public:
+    explicit ShardedAppointmentDAO(std::shared_ptr<ShardSet> shards);
+
+    bool createAppointment(const Appointment& appointment) override;
+    std::unique_ptr<Appointment> getAppointmentById(int appointmentId) override;
+    std::vector<std::unique_ptr<Appointment>> getAppointmentsByPatientId(int patientId) override;
+    std::vector<std::unique_ptr<Appointment>> getAppointmentsByDoctorId(int doctorId) override;
+    std::vector<std::unique_ptr<Appointment>> getAppointmentsByDepartment(const std::string& department) override;
+    std::vector<std::unique_ptr<Appointment>> getAppointmentsByStatus(AppointmentStatus status) override;
+    std::vector<std::unique_ptr<Appointment>> getAllAppointments() override;
+    bool updateAppointment(const Appointment& appointment) override;
+    bool updateAppointmentStatus(int appointmentId, AppointmentStatus status) override;
+    bool deleteAppointment(int appointmentId) override;
+    std::vector<std::unique_ptr<Appointment>> searchAppointments(const std::string& searchTerm) override;
+    int getAppointmentCount() override;
+    int getAppointmentCountByStatus(AppointmentStatus status) override;
+    int getAppointmentCountByDoctor(int doctorId) override;
+};
+
+class ShardedHospitalizationDAO : public HospitalizationDAO, private ShardedDAOBase<HospitalizationDAO> {
+public:
+    explicit ShardedHospitalizationDAO(std::shared_ptr<ShardSet> shards);
+
+    bool createHospitalization(const Hospitalization& hospitalization) override;
+    std::unique_ptr<Hospitalization> getHospitalizationById(int hospitalizationId) override;
+    std::vector<std::unique_ptr<Hospitalization>> getHospitalizationsByPatientId(int patientId) override;
+    std::vector<std::unique_ptr<Hospitalization>> getHospitalizationsByWard(const std::string& wardNumber) override;
+    std::vector<std::unique_ptr<Hospitalization>> getAllHospitalizations() override;
+    bool updateHospitalization(const Hospitalization& hospitalization) override;
+    bool deleteHospitalization(int hospitalizationId) override;
+    // Beds are shared by all patients, so occupancy is checked on every shard
+    bool isBedOccupied(const std::string& wardNumber, const std::string& bedNumber) override;
+    std::vector<std::string> getAllWards() override;
+    std::vector<std::unique_ptr<Hospitalization>> searchHospitalizations(const std::string& searchTerm) override;
+    int getHospitalizationCount() override;
+};
+
+// Prescriptions live on the shard of their case
+class ShardedPrescriptionDAO : public PrescriptionDAO, private ShardedDAOBase<PrescriptionDAO> {
+public:
+    explicit ShardedPrescriptionDAO(std::shared_ptr<ShardSet> shards);
+
+    bool createPrescription(const Prescription& prescription) override;
+    std::unique_ptr<Prescription> getPrescriptionById(int prescriptionId) override;
+    std::vector<std::unique_ptr<Prescription>> getPrescriptionsByCaseId(int caseId) override;
+    std::vector<std::unique_ptr<Prescription>> getPrescriptionsByDoctorId(int doctorId) override;
+    std::vector<std::unique_ptr<Prescription>> getAllPrescriptions() override;
+    bool updatePrescription(const Prescription& prescription) override;
+    bool deletePrescription(int prescriptionId) override;
+    std::vector<std::unique_ptr<Prescription>> searchPrescriptions(const std::string& searchTerm) override;
+    int getPrescriptionCount() override;
+    int getPrescriptionCountByDoctor(int doctorId) override;
+};
+
+// Medications live on the shard of their prescription
+class ShardedMedicationDAO : public MedicationDAO, private ShardedDAOBase<MedicationDAO> {
+public:
+    explicit ShardedMedicationDAO(std::shared_ptr<ShardSet> shards);
+
+    bool createMedication(const Medication& medication) override;
+    std::unique_ptr<Medication> getMedicationById(int medicationId) override;
+    std::vector<std::unique_ptr<Medication>> getMedicationsByPrescriptionId(int prescriptionId) override;
+    std::vector<std::unique_ptr<Medication>> getAllMedications() override;
+    bool updateMedication(const Medication& medication) override;
+    bool deleteMedication(int medicationId) override;
+    std::vector<std::unique_ptr<Medication>> searchMedications(const std::string& searchTerm) override;
+    std::vector<std::unique_ptr<Medication>> getMedicationsByName(const std::string& medicationName) override;
+    int getMedicationCount() override;
+    int getTotalQuantityByName(const std::string& medicationName) override;
+};
+
+#endif // SHARDED_DAO_H
@@ -0,0 +1,64 @@
+#ifndef SLOW_QUERY_LOG_H
+#define SLOW_QUERY_LOG_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+// Statements slower than a threshold, written as JSON lines to a log that
+// rotates by size. Each entry carries the statement with its literals
+// replaced by '?', so repeats of one query shape group together, plus the
+// duration, row count and calling function. The first time a shape is
+// logged the connection attaches its EXPLAIN FORMAT=JSON plan.
+class SlowQueryLog {
+public:
+    struct Config {
+        std::string path = "slow_query.log";
+        std::chrono::milliseconds threshold{200};
+        size_t maxBytes = 16 * 1024 * 1024;
+        size_t maxFiles = 4;  // rotated files kept as path.1 ... path.N
+        bool explain = true;
+    };
+
+    struct Entry {
+        std::string statement;  // normalized
+        std::chrono::microseconds duration{0};
+        int64_t rows = -1;      // returned or affected; -1 when unknown
+        std::string caller;
+        unsigned int error = 0;
+        std::string plan;       // EXPLAIN FORMAT=JSON output, empty if none
+    };
+
+    explicit SlowQueryLog(const Config& config);
+
+    // nullptr with error set when the log file cannot be opened
+    static std::shared_ptr<SlowQueryLog> open(const Config& config, std::string& error);
+
+    bool isSlow(std::chrono::steady_clock::duration elapsed) const { return elapsed >= config.threshold; }
+    // True the first time a normalized statement is seen, i.e. when to capture its plan
+    bool claimExplain(const std::string& normalized);
+    void record(const Entry& entry);
+    uint64_t getRecorded() const { return recorded.load(std::memory_order_relaxed); }
+
+    // Literals and numbers become '?', lists of them "?+", whitespace runs one space
+    static std::string normalize(const std::string& statement);
+    // Qualified name of the function containing the address, or "" when unknown
+    static std::string describeCaller(const void* address);
+
+private:
+    Config config;
+    std::mutex mutex;
+    std::ofstream out;
+    size_t written = 0;
+    std::unordered_set<std::string> explained;
+    std::atomic<uint64_t> recorded{0};
+
+    void rotate();
+};
+
+#endif // SLOW_QUERY_LOG_H
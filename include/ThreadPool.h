@@ -0,0 +1,61 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 固定大小的工作窃取线程池：外部线程提交的任务进入共享注入队列，按提交顺序出队；
+// 工作线程内提交的任务（如扇出子任务）进入该线程自己的双端队列，
+// 由本线程从尾部取（LIFO，缓存友好），空闲线程从头部窃取
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t workerCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // 关闭后提交的任务被拒绝并返回false
+    bool submit(std::function<void()> task);
+
+    // 停止接收新任务，执行完已排队的任务后回收所有线程
+    void shutdown();
+
+    size_t size() const { return workerCount; }
+
+    // 当前线程是否为本线程池的工作线程
+    bool isWorkerThread() const;
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    size_t workerCount;
+    std::vector<std::unique_ptr<WorkerQueue>> localQueues;
+    WorkerQueue injectQueue;
+    std::vector<std::thread> workers;
+
+    // 已计入但尚未被取走的任务数；提交时先计数再入队，关闭时据此判断能否退出
+    std::atomic<size_t> pendingTasks{0};
+    std::atomic<size_t> idleWorkers{0};
+    std::atomic<bool> stopping{false};
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+    std::mutex shutdownMutex;
+
+    void workerLoop(size_t index);
+    bool takeTask(size_t index, std::function<void()>& task);
+    static bool popBack(WorkerQueue& queue, std::function<void()>& task);
+    static bool popFront(WorkerQueue& queue, std::function<void()>& task);
+};
+
+#endif // THREAD_POOL_H
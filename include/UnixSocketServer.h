@@ -0,0 +1,90 @@
+#ifndef UNIX_SOCKET_SERVER_H
+#define UNIX_SOCKET_SERVER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ThreadPool.h"
+
+// Unix域套接字常驻服务：帧格式为4字节大端长度 + 请求体，响应使用相同帧格式。
+// 同一连接可连续发送多个请求（流水线），请求并发处理，响应按请求顺序写回
+class UnixSocketServer {
+public:
+    using RequestProcessor = std::function<void(const std::string& request, std::string& response)>;
+
+    static const uint32_t DEFAULT_MAX_FRAME_SIZE = 64u << 20;
+    static const size_t DEFAULT_MAX_IN_FLIGHT = 64;
+    static const size_t DEFAULT_MAX_CONNECTIONS = 1024;
+
+    // 超过maxConnections的新连接在接受后立即关闭（每个连接占用读写两个线程）
+    UnixSocketServer(const std::string& socketPath, RequestProcessor processor, size_t workerCount,
+                     uint32_t maxFrameSize = DEFAULT_MAX_FRAME_SIZE,
+                     size_t maxInFlightPerConnection = DEFAULT_MAX_IN_FLIGHT,
+                     size_t maxConnections = DEFAULT_MAX_CONNECTIONS);
+    ~UnixSocketServer();
+
+    UnixSocketServer(const UnixSocketServer&) = delete;
+    UnixSocketServer& operator=(const UnixSocketServer&) = delete;
+
+    // 创建并监听套接字文件；已存在但无人监听的旧套接字文件会被清理
+    bool start();
+
+    // 接受连接直到requestStop()，随后停止读取新请求，等待已接收的请求处理完并写回后返回
+    void run();
+
+    // 可在信号处理函数中调用
+    void requestStop();
+
+    std::string getError() const { return lastError; }
+
+    struct Stats {
+        uint64_t connections;
+        uint64_t requests;
+        uint64_t rejectedFrames;
+        uint64_t rejectedConnections;
+    };
+    Stats getStats() const;
+
+    // 请求处理线程池；可交给业务层作为扇出执行器，请求与子任务共用同一组工作线程
+    std::shared_ptr<ThreadPool> getWorkerPool() const { return workerPool; }
+
+private:
+    struct Connection;
+
+    std::string socketPath;
+    RequestProcessor processor;
+    std::shared_ptr<ThreadPool> workerPool;
+    uint32_t maxFrameSize;
+    size_t maxInFlight;
+    size_t maxConnections;
+
+    int listenFd = -1;
+    int wakePipe[2] = {-1, -1};
+    std::string lastError;
+
+    // 每个连接一个读线程，负责拆帧并把请求提交到工作线程池；读线程另启一个写线程按序写回响应
+    struct ConnectionSlot {
+        std::shared_ptr<Connection> connection;
+        std::thread reader;
+    };
+    std::mutex connectionsMutex;
+    std::vector<ConnectionSlot> connections;
+
+    std::atomic<uint64_t> totalConnections{0};
+    std::atomic<uint64_t> totalRequests{0};
+    std::atomic<uint64_t> rejectedFrames{0};
+    std::atomic<uint64_t> rejectedConnections{0};
+
+    void serveConnection(std::shared_ptr<Connection> connection);
+    void completeRequest(const std::shared_ptr<Connection>& connection, uint64_t sequence, std::string response);
+    void writeResponses(std::shared_ptr<Connection> connection);
+    void reapFinishedConnections();
+    void closeListener();
+};
+
+#endif // UNIX_SOCKET_SERVER_H
@@ -5,6 +5,8 @@
 #include <vector>
 #include <memory>
 #include "DatabaseConnection.h"
+#include "AsyncQueryExecutor.h"
+#include "BloomFilter.h"
 
 enum class UserType {
     DOCTOR,
@@ -56,13 +58,20 @@ public:
 class UserDAO {
 private:
     std::shared_ptr<ConnectionPool> connectionPool;
+    std::shared_ptr<BloomFilter> existenceFilter;
     
 public:
     UserDAO(std::shared_ptr<ConnectionPool> pool);
     
+    // Existence filter (username/email)
+    void setExistenceFilter(std::shared_ptr<BloomFilter> filter) { existenceFilter = filter; }
+    uint64_t loadExistenceFilter(uint64_t afterUserId = 0);
+    void addToExistenceFilter(const std::string& username, const std::string& email);
+    
     // CRUD operations
     bool createUser(const User& user);
     std::unique_ptr<User> getUserById(int userId);
+    // Read the primary: login and token checks must see just-written accounts
     std::unique_ptr<User> getUserByUsername(const std::string& username);
     std::unique_ptr<User> getUserByEmail(const std::string& email);
     std::vector<std::unique_ptr<User>> getAllUsers();
@@ -85,9 +94,16 @@ public:
     bool userExists(const std::string& username, const std::string& email);
     int getUserCount();
     
+    // Building blocks for multi-statement reads
+    std::string getUserByIdQuery(int userId);
+    std::unique_ptr<User> readUser(MYSQL_RES* result);
+    
+    // Non-blocking variants: the query runs on the executor's event loop and
+    // the future resolves when the row has been mapped
+    std::future<std::unique_ptr<User>> getUserByIdAsync(AsyncQueryExecutor& executor, int userId);
+    
 private:
     User* mapRowToUser(MYSQL_ROW row, unsigned long* lengths);
-    std::string hashPassword(const std::string& password);
     bool verifyPassword(const std::string& password, const std::string& hash);
 };
 
@@ -27,8 +27,6 @@ CREATE TABLE users (
     created_at DATETIME NOT NULL DEFAULT CURRENT_TIMESTAMP,
     
     -- 索引
-    INDEX idx_username (username),
-    INDEX idx_email (email),
     INDEX idx_user_type (user_type),
     INDEX idx_created_at (created_at)
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci;
@@ -50,7 +48,7 @@ CREATE TABLE doctors (
     
     -- 索引
     INDEX idx_user_id (user_id),
-    INDEX idx_department (department),
+    INDEX idx_department_name (department, name),
     INDEX idx_name (name)
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci;
 
@@ -71,7 +69,7 @@ CREATE TABLE patients (
     
     -- 索引
     INDEX idx_user_id (user_id),
-    INDEX idx_id_number (id_number),
+    INDEX idx_gender_name (gender, name),
     INDEX idx_name (name),
     INDEX idx_birth_date (birth_date)
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci;
@@ -92,9 +90,9 @@ CREATE TABLE cases (
     FOREIGN KEY (doctor_id) REFERENCES doctors(doctor_id) ON DELETE CASCADE,
     
     -- 索引
-    INDEX idx_patient_id (patient_id),
-    INDEX idx_doctor_id (doctor_id),
-    INDEX idx_department (department),
+    INDEX idx_patient_date (patient_id, diagnosis_date),
+    INDEX idx_doctor_date (doctor_id, diagnosis_date),
+    INDEX idx_department_date (department, diagnosis_date),
     INDEX idx_diagnosis_date (diagnosis_date)
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci;
 
@@ -114,11 +112,11 @@ CREATE TABLE appointments (
     FOREIGN KEY (doctor_id) REFERENCES doctors(doctor_id) ON DELETE CASCADE,
     
     -- 索引
-    INDEX idx_patient_id (patient_id),
-    INDEX idx_doctor_id (doctor_id),
-    INDEX idx_appointment_time (appointment_time),
-    INDEX idx_status (status),
-    INDEX idx_department (department)
+    INDEX idx_patient_time (patient_id, appointment_time),
+    INDEX idx_doctor_time (doctor_id, appointment_time),
+    INDEX idx_department_time (department, appointment_time),
+    INDEX idx_status_time (status, appointment_time),
+    INDEX idx_appointment_time (appointment_time)
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci;
 
 -- 6. Hospitalization Table (hospitalization)
@@ -136,9 +134,8 @@ CREATE TABLE hospitalization (
     FOREIGN KEY (patient_id) REFERENCES patients(patient_id) ON DELETE CASCADE,
     
     -- 索引
-    INDEX idx_patient_id (patient_id),
-    INDEX idx_ward_number (ward_number),
-    INDEX idx_bed_number (bed_number),
+    INDEX idx_patient_date (patient_id, admission_date),
+    INDEX idx_ward_bed (ward_number, bed_number),
     INDEX idx_admission_date (admission_date)
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci;
 
@@ -157,8 +154,8 @@ CREATE TABLE prescriptions (
     FOREIGN KEY (doctor_id) REFERENCES doctors(doctor_id) ON DELETE CASCADE,
     
     -- 索引
-    INDEX idx_case_id (case_id),
-    INDEX idx_doctor_id (doctor_id),
+    INDEX idx_case_date (case_id, issued_date),
+    INDEX idx_doctor_date (doctor_id, issued_date),
     INDEX idx_issued_date (issued_date)
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci;
 
@@ -176,8 +173,8 @@ CREATE TABLE medications (
     FOREIGN KEY (prescription_id) REFERENCES prescriptions(prescription_id) ON DELETE CASCADE,
     
     -- 索引
-    INDEX idx_prescription_id (prescription_id),
-    INDEX idx_medication_name (medication_name)
+    INDEX idx_prescription_name (prescription_id, medication_name),
+    INDEX idx_name_quantity (medication_name, quantity)
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci;
 
 -- =====================================================
@@ -0,0 +1,295 @@
+#include "AdmissionController.h"
+#include <algorithm>
+
+namespace {
+const size_t kMaxIdleBuckets = 10000;
+const int64_t kMinRetryAfterMs = 100;
+const int64_t kMaxRetryAfterMs = 10000;
+}
+
+AdmissionController::Ticket::Ticket(Ticket&& other) noexcept
+    : controller(other.controller), api(std::move(other.api)), tenant(std::move(other.tenant)), outcome(other.outcome),
+      retryAfterMs(other.retryAfterMs), nested(other.nested), startTime(other.startTime) {
+    other.controller = nullptr;
+}
+
+AdmissionController::Ticket& AdmissionController::Ticket::operator=(Ticket&& other) noexcept {
+    if (this != &other) {
+        release();
+        controller = other.controller;
+        api = std::move(other.api);
+        tenant = std::move(other.tenant);
+        outcome = other.outcome;
+        retryAfterMs = other.retryAfterMs;
+        nested = other.nested;
+        startTime = other.startTime;
+        other.controller = nullptr;
+    }
+    return *this;
+}
+
+AdmissionController::Ticket::~Ticket() {
+    release();
+}
+
+void AdmissionController::Ticket::release() {
+    if (controller) {
+        controller->release(api, tenant, startTime, nested);
+        controller = nullptr;
+    }
+}
+
+AdmissionController::AdmissionController() : AdmissionController(Config()) {}
+
+AdmissionController::AdmissionController(const Config& config) : config(config) {
+    if (this->config.maxConcurrent == 0) this->config.maxConcurrent = 1;
+}
+
+void AdmissionController::setApiPolicy(const std::string& api, size_t maxConcurrent, Priority priority) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ApiPolicy& policy = policies[api];
+    policy.maxConcurrent = maxConcurrent;
+    policy.priority = priority;
+}
+
+AdmissionController::ApiPolicy& AdmissionController::policyFor(const std::string& api) {
+    // unordered_map的元素地址在重新散列后保持不变，等待者可以直接持有指针
+    return policies[api];
+}
+
+AdmissionController::TenantState& AdmissionController::tenantFor(const std::string& tenant) {
+    auto inserted = tenants.emplace(tenant, TenantState());
+    if (inserted.second) {
+        totalWeight += inserted.first->second.weight;
+    }
+    return inserted.first->second;
+}
+
+void AdmissionController::setTenantWeight(const std::string& tenant, double weight) {
+    std::lock_guard<std::mutex> lock(mutex);
+    TenantState& state = tenantFor(tenant);
+    weight = std::max(weight, 0.01);
+    totalWeight += weight - state.weight;
+    state.weight = weight;
+}
+
+bool AdmissionController::precedes(const TenantState& tenant, Priority priority,
+                                   const TenantState& other, Priority otherPriority) {
+    double load = tenant.inFlight / tenant.weight;
+    double otherLoad = other.inFlight / other.weight;
+    if (load != otherLoad) return load < otherLoad;
+    return priority > otherPriority;
+}
+
+size_t AdmissionController::tenantQueueLimit(const TenantState& tenant, Priority priority) const {
+    size_t share = std::max<size_t>(1, static_cast<size_t>(config.maxQueue * tenant.weight / totalWeight));
+    return priority == Priority::LOW ? std::max<size_t>(1, share / 2) : share;
+}
+
+bool AdmissionController::hasCapacity(const ApiPolicy& policy) const {
+    return inFlight < config.maxConcurrent && (policy.maxConcurrent == 0 || policy.inFlight < policy.maxConcurrent);
+}
+
+AdmissionController::Ticket AdmissionController::acquire(const std::string& api, const std::string& tenant,
+                                                        std::chrono::steady_clock::time_point deadline) {
+    Ticket ticket;
+    ticket.api = api;
+    ticket.tenant = tenant;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    ApiPolicy& policy = policyFor(api);
+    TenantState& state = tenantFor(tenant);
+
+    // 排在本请求之前放行、且其API尚有余量的请求在排队时不能插队
+    bool blockedByWaiters = std::any_of(waiters.begin(), waiters.end(), [&](const Waiter* waiter) {
+        return !precedes(state, policy.priority, *waiter->tenant, waiter->priority) && hasCapacity(*waiter->policy);
+    });
+    if (!blockedByWaiters && hasCapacity(policy)) {
+        ++inFlight;
+        ++policy.inFlight;
+        ++state.inFlight;
+        ++stats.admitted;
+        ++state.stats.admitted;
+        ticket.controller = this;
+        ticket.outcome = Outcome::ADMITTED;
+        ticket.startTime = std::chrono::steady_clock::now();
+        return ticket;
+    }
+
+    // 低优先级请求只能占用一半队列，拥塞时最先被丢弃；每个租户另受其队列份额限制
+    size_t queueLimit = policy.priority == Priority::LOW ? config.maxQueue / 2 : config.maxQueue;
+    if (waiters.size() >= queueLimit || state.waiting >= tenantQueueLimit(state, policy.priority)) {
+        ++stats.rejectedQueueFull;
+        ++state.stats.rejectedQueueFull;
+        ticket.outcome = Outcome::QUEUE_FULL;
+        ticket.retryAfterMs = estimateRetryAfterMs();
+        return ticket;
+    }
+
+    Waiter waiter;
+    waiter.policy = &policy;
+    waiter.tenant = &state;
+    waiter.priority = policy.priority;
+    auto self = waiters.insert(waiters.end(), &waiter);
+    ++state.waiting;
+    ++stats.queued;
+    ++state.stats.queued;
+    grantWaiters();
+
+    auto waitUntil = std::min(deadline, std::chrono::steady_clock::now() + config.maxQueueTime);
+    waiter.wakeup.wait_until(lock, waitUntil, [&]() { return waiter.granted; });
+
+    if (!waiter.granted) {
+        // 未被放行的等待者仍在队列中（放行时会被移出）
+        waiters.erase(self);
+        --state.waiting;
+        ++stats.rejectedTimeout;
+        ++state.stats.rejectedTimeout;
+        ticket.outcome = Outcome::QUEUE_TIMEOUT;
+        ticket.retryAfterMs = estimateRetryAfterMs();
+        // 队首等待者离开后，被它挡住的其他API的等待者可能已经可以放行
+        grantWaiters();
+        return ticket;
+    }
+
+    ++stats.admitted;
+    ++state.stats.admitted;
+    ticket.controller = this;
+    ticket.outcome = Outcome::ADMITTED;
+    ticket.startTime = std::chrono::steady_clock::now();
+    return ticket;
+}
+
+AdmissionController::Ticket AdmissionController::acquireNested(const std::string& api, const std::string& tenant) {
+    Ticket ticket;
+    ticket.api = api;
+    ticket.tenant = tenant;
+    ticket.nested = true;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ApiPolicy& policy = policyFor(api);
+    TenantState& state = tenantFor(tenant);
+    // 外层请求已占着全局名额，在这里等待可能与其他批量请求互相等待，因此直接拒绝
+    if (policy.maxConcurrent != 0 && policy.inFlight >= policy.maxConcurrent) {
+        ++stats.rejectedQueueFull;
+        ++state.stats.rejectedQueueFull;
+        ticket.outcome = Outcome::QUEUE_FULL;
+        ticket.retryAfterMs = estimateRetryAfterMs();
+        return ticket;
+    }
+    ++policy.inFlight;
+    ticket.controller = this;
+    ticket.outcome = Outcome::ADMITTED;
+    ticket.startTime = std::chrono::steady_clock::now();
+    return ticket;
+}
+
+void AdmissionController::grantWaiters() {
+    // 每次放行precedes()排序最靠前的等待者，放行后租户负载变化，下一轮重新比较；
+    // 某个API已达上限时跳过其等待者，不阻塞其他API
+    while (inFlight < config.maxConcurrent) {
+        auto next = waiters.end();
+        for (auto it = waiters.begin(); it != waiters.end(); ++it) {
+            const Waiter* waiter = *it;
+            if (!hasCapacity(*waiter->policy)) continue;
+            if (next == waiters.end() ||
+                precedes(*waiter->tenant, waiter->priority, *(*next)->tenant, (*next)->priority)) {
+                next = it;
+            }
+        }
+        if (next == waiters.end()) break;
+
+        Waiter* waiter = *next;
+        ++inFlight;
+        ++waiter->policy->inFlight;
+        ++waiter->tenant->inFlight;
+        --waiter->tenant->waiting;
+        waiter->granted = true;
+        waiter->wakeup.notify_one();
+        waiters.erase(next);
+    }
+}
+
+void AdmissionController::release(const std::string& api, const std::string& tenant,
+                                  std::chrono::steady_clock::time_point startTime, bool nested) {
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ApiPolicy& policy = policyFor(api);
+    if (nested) {
+        // 空出的API名额可能让排队中的同API请求得以放行
+        --policy.inFlight;
+        grantWaiters();
+        return;
+    }
+    TenantState& state = tenantFor(tenant);
+    --inFlight;
+    --policy.inFlight;
+    --state.inFlight;
+    averageServiceMs = averageServiceMs * 0.9 + elapsedMs * 0.1;
+    state.averageServiceMs = state.averageServiceMs * 0.9 + elapsedMs * 0.1;
+    grantWaiters();
+}
+
+int64_t AdmissionController::estimateRetryAfterMs() const {
+    // 排在前面的请求按当前并发度处理完所需的时间
+    double rounds = static_cast<double>(waiters.size()) / config.maxConcurrent + 1.0;
+    int64_t estimate = static_cast<int64_t>(averageServiceMs * rounds);
+    return std::min(kMaxRetryAfterMs, std::max(kMinRetryAfterMs, estimate));
+}
+
+bool AdmissionController::consumeUserToken(int userId, int64_t& retryAfterMs, const std::string& tenant) {
+    auto now = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(bucketMutex);
+    if (buckets.size() > kMaxIdleBuckets) {
+        // 已补满的桶与新建桶等价，可以丢弃
+        for (auto it = buckets.begin(); it != buckets.end();) {
+            double elapsed = std::chrono::duration<double>(now - it->second.lastRefill).count();
+            if (it->second.tokens + elapsed * config.userRatePerSecond >= config.userBurst) {
+                it = buckets.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    auto inserted = buckets.emplace(std::to_string(userId) + "@" + tenant, TokenBucket{config.userBurst, now});
+    TokenBucket& bucket = inserted.first->second;
+    double elapsed = std::chrono::duration<double>(now - bucket.lastRefill).count();
+    bucket.tokens = std::min(config.userBurst, bucket.tokens + elapsed * config.userRatePerSecond);
+    bucket.lastRefill = now;
+
+    if (bucket.tokens >= 1.0) {
+        bucket.tokens -= 1.0;
+        return true;
+    }
+
+    retryAfterMs = static_cast<int64_t>((1.0 - bucket.tokens) / config.userRatePerSecond * 1000.0) + 1;
+    std::lock_guard<std::mutex> statsLock(mutex);
+    ++stats.rejectedRateLimit;
+    ++tenantFor(tenant).stats.rejectedRateLimit;
+    return false;
+}
+
+AdmissionController::Stats AdmissionController::getStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats snapshot = stats;
+    snapshot.inFlight = inFlight;
+    snapshot.waiting = waiters.size();
+    snapshot.averageServiceMs = averageServiceMs;
+    return snapshot;
+}
+
+std::map<std::string, AdmissionController::Stats> AdmissionController::getTenantStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::map<std::string, Stats> snapshot;
+    for (const auto& entry : tenants) {
+        Stats& tenantStats = snapshot[entry.first];
+        tenantStats = entry.second.stats;
+        tenantStats.inFlight = entry.second.inFlight;
+        tenantStats.waiting = entry.second.waiting;
+        tenantStats.averageServiceMs = entry.second.averageServiceMs;
+    }
+    return snapshot;
+}
@@ -1,13 +1,133 @@
 #include "ApiHandler.h"
+#include "Sha256.h"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
-#include <openssl/sha.h>
-#include <regex>
 #include <random>
 #include <chrono>
+#include <utility>
+#include <atomic>
+#include <unordered_set>
 
-ApiHandler::ApiHandler(std::shared_ptr<HospitalService> service) : hospitalService(service) {
+namespace {
+
+// 准入阶段或批量请求中已验证过的token，处理期间对当前线程生效
+struct ResolvedAuth {
+    std::string token;
+    bool valid = true;
+    int userId = 0;
+    UserType userType = UserType::PATIENT;
+};
+
+thread_local const ResolvedAuth* currentAuth = nullptr;
+
+// 当前请求所属的院区，处理期间对当前线程生效
+thread_local const CampusDirectory::Campus* currentCampus = nullptr;
+
+class CampusScope {
+public:
+    explicit CampusScope(const CampusDirectory::Campus* campus) : previous(currentCampus) { currentCampus = campus; }
+    ~CampusScope() { currentCampus = previous; }
+private:
+    const CampusDirectory::Campus* previous;
+};
+
+class AuthContextScope {
+public:
+    explicit AuthContextScope(const ResolvedAuth* auth) : previous(currentAuth) { currentAuth = auth; }
+    ~AuthContextScope() { currentAuth = previous; }
+private:
+    const ResolvedAuth* previous;
+};
+
+// 同时标记只读副本路由的会话：本请求或该用户刚写过数据时，后续读取走主库
+class ResolvedAuthScope {
+public:
+    explicit ResolvedAuthScope(const ResolvedAuth* auth)
+        : context(auth), session(auth && auth->valid ? auth->userId : 0) {}
+private:
+    AuthContextScope context;
+    ReplicaRouter::SessionScope session;
+};
+
+// 全局并发上限与连接数一致：每个处理中的请求至少占用一个连接。
+// 多院区时为所有院区共用的连接预算
+AdmissionController::Config makeAdmissionConfig(const CampusDirectory& campuses) {
+    AdmissionController::Config config;
+    auto budget = campuses.getBudget();
+    size_t connections = budget ? budget->getLimit()
+                                : campuses.getDefault().service->getConnectionPool()->getMaxConnections();
+    config.maxConcurrent = std::max<size_t>(1, connections);
+    config.maxQueue = config.maxConcurrent * 8;
+    return config;
+}
+
+json admissionStatsToJson(const AdmissionController::Stats& admissionStats) {
+    json admissionJson;
+    admissionJson["admitted"] = admissionStats.admitted;
+    admissionJson["queued"] = admissionStats.queued;
+    admissionJson["rejectedQueueFull"] = admissionStats.rejectedQueueFull;
+    admissionJson["rejectedTimeout"] = admissionStats.rejectedTimeout;
+    admissionJson["rejectedRateLimit"] = admissionStats.rejectedRateLimit;
+    admissionJson["inFlight"] = admissionStats.inFlight;
+    admissionJson["waiting"] = admissionStats.waiting;
+    return admissionJson;
+}
+
+json breakerStatsToJson(const CircuitBreaker& breaker) {
+    auto breakerStats = breaker.getStats();
+    json breakerJson;
+    breakerJson["state"] = CircuitBreaker::stateName(breakerStats.state);
+    breakerJson["consecutiveFailures"] = breakerStats.consecutiveFailures;
+    breakerJson["timesOpened"] = breakerStats.timesOpened;
+    breakerJson["rejected"] = breakerStats.rejected;
+    return breakerJson;
+}
+
+template <typename Stats>
+json cacheStatsToJson(const Stats& cacheStats) {
+    json cacheJson;
+    cacheJson["hits"] = cacheStats.hits;
+    cacheJson["misses"] = cacheStats.misses;
+    cacheJson["evictions"] = cacheStats.evictions;
+    cacheJson["expirations"] = cacheStats.expirations;
+    cacheJson["invalidations"] = cacheStats.invalidations;
+    cacheJson["size"] = cacheStats.size;
+    cacheJson["capacity"] = cacheStats.capacity;
+    return cacheJson;
+}
+
+// 不修改任何数据的接口，批量请求中可以相互并行
+
+bool isReadOnlyApi(const std::string& apiName) {
+    static const std::unordered_set<std::string> readOnlyApis = {
+        "public.schedule.list",
+        "public.doctor.get",
+        "patient.profile.get",
+        "patient.medicalRecord.list",
+        "patient.prescription.list",
+        "patient.prescription.get",
+        "patient.labResult.list",
+        "patient.chat.getHistory",
+        "patient.assessment.getLink",
+        "doctor.profile.get",
+        "doctor.appointment.list",
+        "doctor.patient.getMedicalRecords",
+        "doctor.attendance.getHistory",
+        "doctor.leaveRequest.list"
+    };
+    return readOnlyApis.count(apiName) > 0;
+}
+
+}
+
+ApiHandler::ApiHandler(std::shared_ptr<HospitalService> service)
+    : ApiHandler(CampusDirectory::single(std::move(service))) {}
+
+ApiHandler::ApiHandler(std::shared_ptr<CampusDirectory> campuses)
+    : campuses(campuses), admissionController(makeAdmissionConfig(*campuses)) {
+    registerRequestSchemas();
+    
     // 注册公共接口处理函数
     apiHandlers["public.schedule.list"] = [this](const json& data) { return handlePublicScheduleList(data); };
     apiHandlers["public.doctor.get"] = [this](const json& data) { return handlePublicDoctorGet(data); };
@@ -45,42 +165,615 @@ ApiHandler::ApiHandler(std::shared_ptr<HospitalService> service) : hospitalServi
     apiHandlers["doctor.leaveRequest.submit"] = [this](const json& data) { return handleDoctorLeaveRequestSubmit(data); };
     apiHandlers["doctor.leaveRequest.list"] = [this](const json& data) { return handleDoctorLeaveRequestList(data); };
     apiHandlers["doctor.leaveRequest.cancel"] = [this](const json& data) { return handleDoctorLeaveRequestCancel(data); };
+    
+    // 注册批量接口
+    apiHandlers["batch"] = [this](const json& data) { return handleBatch(data); };
+    
+    registerAdmissionPolicies();
+    registerRequestTimeouts();
 }
 
 ApiHandler::~ApiHandler() = default;
 
+HospitalService* ApiHandler::service() {
+    return (currentCampus ? *currentCampus : campuses->getDefault()).service.get();
+}
+
+const CampusDirectory::Campus* ApiHandler::resolveCampus(const json& data, ApiResponse& error) {
+    if (!campuses->isMultiCampus()) {
+        return &campuses->getDefault();
+    }
+    
+    // 显式指定的院区与token签发院区必须一致
+    std::string requested, issuer;
+    if (data.is_object()) {
+        auto campusIt = data.find("campus");
+        if (campusIt != data.end() && campusIt->is_string()) {
+            requested = campusIt->get<std::string>();
+        }
+        auto tokenIt = data.find("token");
+        if (tokenIt != data.end() && tokenIt->is_string()) {
+            const std::string& token = tokenIt->get_ref<const std::string&>();
+            size_t colon = token.find(':');
+            if (colon != std::string::npos) {
+                issuer = token.substr(0, colon);
+            }
+        }
+    }
+    
+    if (!requested.empty() && !issuer.empty() && requested != issuer) {
+        error = ApiResponse("error", 403, "token不属于该院区", json::object());
+        return nullptr;
+    }
+    const std::string& id = requested.empty() ? issuer : requested;
+    if (id.empty()) {
+        error = ApiResponse("error", 400, "缺少院区标识", json::object());
+        return nullptr;
+    }
+    const CampusDirectory::Campus* campus = campuses->find(id);
+    if (!campus) {
+        error = ApiResponse("error", 404, "院区不存在", json::object());
+    }
+    return campus;
+}
+
+// 请求参数规则：缺失字段的错误码与提示沿用各处理函数原有的返回值
+void ApiHandler::registerRequestSchemas() {
+    using Type = RequestValidator::FieldType;
+    using Format = RequestValidator::FieldFormat;
+    auto field = RequestValidator::field;
+    auto token = [&]() { return field("token").required(401, "缺少认证token"); };
+    auto tokenParam = [&]() { return field("token").required(); };
+    
+    // 公共接口
+    requestValidator.addSchema("public.schedule.list", {
+        field("departmentId"),
+        field("date").withFormat(Format::DATE),
+        field("doctorName")
+    });
+    requestValidator.addSchema("public.doctor.get", {
+        field("doctorId").required(400, "缺少医生ID参数")
+    });
+    
+    // 患者端接口
+    requestValidator.addSchema("patient.auth.register", {
+        field("email").required().withFormat(Format::EMAIL, "邮箱格式不符合要求"),
+        field("password").required().withFormat(Format::PASSWORD, "密码不符合要求"),
+        field("verificationCode")
+    });
+    requestValidator.addSchema("patient.auth.login", {
+        field("account").required(400, "缺少必需参数: account 或 password"),
+        field("password").required(400, "缺少必需参数: account 或 password")
+    });
+    requestValidator.addSchema("patient.auth.resetPassword", {
+        field("username").required(),
+        field("email").required(),
+        field("verificationCode"),
+        field("newPassword").required()
+    });
+    requestValidator.addSchema("patient.profile.get", {token()});
+    requestValidator.addSchema("patient.profile.update", {
+        token(),
+        field("dateOfBirth").withFormat(Format::DATE, "出生日期格式应为YYYY-MM-DD"),
+        field("idCardNumber").withFormat(Format::ID_NUMBER, "身份证号格式不符合要求"),
+        field("phone").withFormat(Format::CN_MOBILE, "手机号格式不符合要求"),
+        field("email").withFormat(Format::EMAIL, "邮箱格式不符合要求")
+    });
+    requestValidator.addSchema("patient.appointment.create", {
+        tokenParam(),
+        field("scheduleId").required(),
+        field("timeSlot")
+    });
+    requestValidator.addSchema("patient.medicalRecord.list", {token()});
+    requestValidator.addSchema("patient.prescription.list", {token()});
+    requestValidator.addSchema("patient.prescription.get", {
+        tokenParam(),
+        field("prescriptionId").required()
+    });
+    requestValidator.addSchema("patient.labResult.list", {token()});
+    requestValidator.addSchema("patient.chat.sendMessage", {
+        tokenParam(),
+        field("doctorId").required(),
+        field("content").required().withFormat(Format::NON_EMPTY, "消息内容不能为空")
+    });
+    requestValidator.addSchema("patient.chat.getHistory", {
+        tokenParam(),
+        field("doctorId").required(),
+        field("lastMessageId")
+    });
+    requestValidator.addSchema("patient.assessment.getLink", {token()});
+    requestValidator.addSchema("patient.consultation.requestOnline", {token()});
+    
+    // 医生端接口
+    requestValidator.addSchema("doctor.auth.login", {
+        field("employeeId").required(400, "缺少工号或密码"),
+        field("password").required(400, "缺少工号或密码")
+    });
+    requestValidator.addSchema("doctor.auth.resetPassword", {
+        field("employeeId").required(),
+        field("idCardNumber").required(),
+        field("newPassword").required()
+    });
+    requestValidator.addSchema("doctor.profile.get", {token()});
+    requestValidator.addSchema("doctor.profile.update", {
+        token(),
+        field("bio"),
+        field("registrationFee").ofType(Type::NUMBER),
+        field("email").withFormat(Format::EMAIL, "邮箱格式不符合要求"),
+        field("phone").withFormat(Format::CN_MOBILE, "手机号格式不符合要求")
+    });
+    requestValidator.addSchema("doctor.appointment.list", {
+        token(),
+        field("date").withFormat(Format::DATE)
+    });
+    requestValidator.addSchema("doctor.patient.getMedicalRecords", {
+        tokenParam(),
+        field("patientId").required()
+    });
+    requestValidator.addSchema("doctor.medicalRecord.create", {
+        tokenParam(),
+        field("patientId").required(),
+        field("appointmentId"),
+        field("diagnosis").required().withFormat(Format::NON_EMPTY, "诊断内容不能为空"),
+        field("doctorAdvice").required()
+    });
+    requestValidator.addSchema("doctor.prescription.create", {
+        tokenParam(),
+        field("patientId").required(),
+        field("appointmentId"),
+        field("medicines").required().ofType(Type::ARRAY)
+    });
+    requestValidator.addSchema("doctor.labResult.upload", {
+        tokenParam(),
+        field("patientId").required(),
+        field("reportName").required(),
+        field("fileContentBase64").required().withFormat(Format::NON_EMPTY, "文件内容不能为空")
+    });
+    requestValidator.addSchema("doctor.status.update", {
+        tokenParam(),
+        field("status").required()
+    });
+    requestValidator.addSchema("doctor.attendance.checkIn", {token()});
+    requestValidator.addSchema("doctor.attendance.cancelCheckIn", {token()});
+    requestValidator.addSchema("doctor.attendance.getHistory", {
+        token(),
+        field("startDate").withFormat(Format::DATE),
+        field("endDate").withFormat(Format::DATE)
+    });
+    requestValidator.addSchema("doctor.leaveRequest.submit", {
+        tokenParam(),
+        field("contactPhone").required().withFormat(Format::CN_MOBILE, "联系电话格式不符合要求"),
+        field("type").required(),
+        field("startDate").required().withFormat(Format::DATE),
+        field("endDate").required().withFormat(Format::DATE),
+        field("reason").required()
+    });
+    requestValidator.addSchema("doctor.leaveRequest.list", {token()});
+    requestValidator.addSchema("doctor.leaveRequest.cancel", {
+        tokenParam(),
+        field("requestId").required()
+    });
+    
+    // 批量接口
+    requestValidator.addSchema("batch", {
+        field("token"),
+        field("failFast").ofType(Type::BOOLEAN),
+        field("requests").required(400, "缺少子请求列表").ofType(Type::ARRAY)
+    });
+}
+
+void ApiHandler::registerAdmissionPolicies() {
+    using Priority = AdmissionController::Priority;
+    size_t maxConcurrent = admissionController.getConfig().maxConcurrent;
+    size_t quarter = std::max<size_t>(1, maxConcurrent / 4);
+    size_t half = std::max<size_t>(1, maxConcurrent / 2);
+    
+    // 公共只读接口优先级最低，写操作最高
+    for (const auto& entry : apiHandlers) {
+        const std::string& apiName = entry.first;
+        Priority priority = Priority::HIGH;
+        if (apiName.compare(0, 7, "public.") == 0) {
+            priority = Priority::LOW;
+        } else if (isReadOnlyApi(apiName)) {
+            priority = Priority::NORMAL;
+        }
+        admissionController.setApiPolicy(apiName, 0, priority);
+    }
+    
+    // 注册/登录/找回密码涉及密码哈希与全表比对，集中重试时单独限流，不挤占挂号等写操作
+    for (const char* apiName : {"patient.auth.register", "patient.auth.login", "patient.auth.resetPassword",
+                                "doctor.auth.login", "doctor.auth.resetPassword"}) {
+        admissionController.setApiPolicy(apiName, quarter, Priority::HIGH);
+    }
+    admissionController.setApiPolicy("public.schedule.list", half, Priority::LOW);
+    admissionController.setApiPolicy("batch", half, Priority::NORMAL);
+    
+    // 各院区按权重分享并发名额与等待队列
+    for (const auto& campus : campuses->getCampuses()) {
+        admissionController.setTenantWeight(campus.id, campus.weight);
+    }
+}
+
+void ApiHandler::registerRequestTimeouts() {
+    // 公共排班列表可随时重试，登录类请求超时后用户通常已重新提交
+    apiTimeouts["public.schedule.list"] = 3000;
+    for (const char* apiName : {"patient.auth.register", "patient.auth.login", "patient.auth.resetPassword",
+                                "doctor.auth.login", "doctor.auth.resetPassword"}) {
+        apiTimeouts[apiName] = 5000;
+    }
+    // 上传大文件与批量请求本身耗时较长
+    apiTimeouts["doctor.labResult.upload"] = 30000;
+    apiTimeouts["batch"] = 30000;
+}
+
+int64_t ApiHandler::timeoutFor(const std::string& apiName, int64_t requestedMs) const {
+    if (requestedMs > 0) {
+        return std::min(requestedMs, MAX_TIMEOUT_MS);
+    }
+    auto it = apiTimeouts.find(apiName);
+    return it != apiTimeouts.end() ? it->second : DEFAULT_TIMEOUT_MS;
+}
+
+ApiHandler::ApiResponse ApiHandler::validationErrorResponse(const std::vector<RequestValidator::ValidationError>& errors) {
+    // 错误码与提示取第一条错误，完整错误列表放在data.errors中
+    json errorList = json::array();
+    for (const auto& error : errors) {
+        errorList.push_back({{"field", error.field}, {"message", error.message}});
+    }
+    
+    json responseData;
+    responseData["errors"] = errorList;
+    return ApiResponse("error", errors.front().code, errors.front().message, std::move(responseData));
+}
+
 std::string ApiHandler::processApiRequest(const std::string& jsonInput) {
+    std::string output;
+    processApiRequest(jsonInput, output);
+    return output;
+}
+
+void ApiHandler::processApiRequest(const std::string& input, std::string& output) {
+    processApiRequest(input, output, WireCodec::detect(input));
+}
+
+void ApiHandler::processApiRequest(const std::string& input, std::string& output, WireFormat format) {
+    if (format == WireFormat::JSON) {
+        dispatchRequest(input).writeTo(output);
+    } else {
+        dispatchBinaryRequest(input, format).writeTo(output, format);
+    }
+}
+
+ApiHandler::ApiResponse ApiHandler::dispatchRequest(const std::string& jsonInput) {
     try {
-        json request = json::parse(jsonInput);
-        
-        if (!request.contains("api") || !request.contains("data")) {
-            return ApiResponse("error", 400, "Invalid request format", json::object()).toJson();
+        // 先只扫描信封：未知接口在解析data之前即被拒绝
+        RequestEnvelope envelope;
+        if (!envelope.scan(jsonInput)) {
+            return dispatchParsedRequest(json::parse(jsonInput));
         }
         
-        std::string apiName = request["api"];
-        json data = request["data"];
+        if (!envelope.hasApi || !envelope.hasData()) {
+            return ApiResponse("error", 400, "Invalid request format", json::object());
+        }
         
-        auto it = apiHandlers.find(apiName);
+        auto it = apiHandlers.find(envelope.api);
         if (it == apiHandlers.end()) {
-            return ApiResponse("error", 404, "API endpoint not found", json::object()).toJson();
+            return ApiResponse("error", 404, "API endpoint not found", json::object());
         }
         
-        return it->second(data).toJson();
+        json data;
+        try {
+            data = envelope.parseData();
+        } catch (const json::parse_error&) {
+            // 重新完整解析，使错误位置相对于整个请求
+            return dispatchParsedRequest(json::parse(jsonInput));
+        }
+        
+        return admitAndInvoke(envelope.api, it->second, data, envelope.timeoutMs);
         
     } catch (const json::parse_error& e) {
-        return ApiResponse("error", 400, "Invalid JSON format: ", std::string(e.what())).toJson();
+        return ApiResponse("error", 400, "Invalid JSON format: ", std::string(e.what()));
     } catch (const std::exception& e) {
-        return ApiResponse("error", 500, "Internal server error: ", std::string(e.what())).toJson();
+        return ApiResponse("error", 500, "Internal server error: ", std::string(e.what()));
     }
 }
 
+ApiHandler::ApiResponse ApiHandler::dispatchBinaryRequest(const std::string& input, WireFormat format) {
+    try {
+        return dispatchParsedRequest(WireCodec::decode(input, format));
+        
+    } catch (const json::parse_error& e) {
+        std::string formatName = format == WireFormat::MSGPACK ? "MessagePack" : "CBOR";
+        return ApiResponse("error", 400, "Invalid " + formatName + " format: ", std::string(e.what()));
+    } catch (const std::exception& e) {
+        return ApiResponse("error", 500, "Internal server error: ", std::string(e.what()));
+    }
+}
+
+ApiHandler::ApiResponse ApiHandler::dispatchParsedRequest(const json& request) {
+    if (!request.contains("api") || !request.contains("data")) {
+        return ApiResponse("error", 400, "Invalid request format", json::object());
+    }
+    
+    std::string apiName = request["api"];
+    
+    auto it = apiHandlers.find(apiName);
+    if (it == apiHandlers.end()) {
+        return ApiResponse("error", 404, "API endpoint not found", json::object());
+    }
+    
+    int64_t timeoutMs = -1;
+    if (request.contains("timeoutMs")) {
+        const json& timeout = request["timeoutMs"];
+        if (!timeout.is_number_unsigned() || timeout.get<uint64_t>() == 0 ||
+            timeout.get<uint64_t>() > static_cast<uint64_t>(INT64_MAX)) {
+            return ApiResponse("error", 400, "timeoutMs必须为正整数", json::object());
+        }
+        timeoutMs = timeout.get<int64_t>();
+    }
+    
+    return admitAndInvoke(apiName, it->second, request["data"], timeoutMs);
+}
+
+ApiHandler::ApiResponse ApiHandler::admitAndInvoke(const std::string& apiName, const ApiHandlerFunc& handler, const json& data,
+                                                   int64_t timeoutMs) {
+    // 截止时间从分发开始计算，排队等待也计入
+    RequestDeadline deadline(RequestDeadline::Clock::now() + std::chrono::milliseconds(timeoutFor(apiName, timeoutMs)));
+    
+    // 参数校验失败的请求不占用并发名额
+    auto errors = requestValidator.validate(apiName, data);
+    if (!errors.empty()) {
+        return validationErrorResponse(errors);
+    }
+    
+    ApiResponse campusError;
+    const CampusDirectory::Campus* campus = resolveCampus(data, campusError);
+    if (!campus) {
+        return campusError;
+    }
+    CampusScope campusScope(campus);
+    
+    AdmissionController::Ticket ticket = admissionController.acquire(apiName, campus->id, deadline.getTime());
+    if (!ticket.admitted()) {
+        if (deadline.expired()) {
+            return ApiResponse("error", 504, "请求超时", json::object());
+        }
+        json responseData;
+        responseData["retryAfterMs"] = ticket.getRetryAfterMs();
+        return ApiResponse("error", 503, "服务繁忙，请稍后重试", std::move(responseData));
+    }
+    
+    RequestDeadline::Scope deadlineScope(&deadline);
+    ApiResponse response;
+    
+    // 在名额内解析一次token得到用户ID并按用户限流，处理函数复用该验证结果。
+    // 批量请求本身不计入令牌桶，由其子请求逐个计入
+    auto tokenIt = data.is_object() ? data.find("token") : data.end();
+    if (tokenIt != data.end() && tokenIt->is_string()) {
+        ResolvedAuth auth;
+        auth.token = tokenIt->get<std::string>();
+        auth.valid = validateToken(auth.token, auth.userId, auth.userType);
+        if (auth.valid && apiName != "batch") {
+            int64_t retryAfterMs = 0;
+            if (!admissionController.consumeUserToken(auth.userId, retryAfterMs, campus->id)) {
+                json responseData;
+                responseData["retryAfterMs"] = retryAfterMs;
+                return ApiResponse("error", 429, "请求过于频繁，请稍后重试", std::move(responseData));
+            }
+        }
+        // 无效token同样缓存，处理函数直接得到验证失败而不再重复查询
+        ResolvedAuthScope scope(&auth);
+        response = handler(data);
+    } else {
+        ResolvedAuthScope scope(nullptr);
+        response = handler(data);
+    }
+    
+    // 数据库访问被截止时间截断时结果不完整；超时后失败的请求同样按超时报告。
+    // 批量请求逐个子请求报告超时，已完成的子请求结果照常返回
+    if (apiName != "batch" && (deadline.wasExceeded() || (response.status != "success" && deadline.expired()))) {
+        return ApiResponse("error", 504, "请求超时", json::object());
+    }
+    // 主库熔断期间连接池直接拒绝，失败的请求报告为暂不可用并给出重试时间
+    const CircuitBreaker& breaker = *campus->service->getConnectionPool()->getBreaker();
+    if (apiName != "batch" && response.status != "success" && breaker.isOpen()) {
+        json responseData;
+        responseData["retryAfterMs"] = breaker.getRetryAfterMs();
+        return ApiResponse("error", 503, "数据库暂不可用，请稍后重试", std::move(responseData));
+    }
+    return response;
+}
+
 std::string ApiHandler::ApiResponse::toJson() const {
-    json response;
-    response["status"] = status;
-    response["code"] = code;
-    response["message"] = message;
-    response["data"] = data;
-    return response.dump();
+    std::string out;
+    writeTo(out);
+    return out;
+}
+
+void ApiHandler::ApiResponse::writeTo(std::string& out, WireFormat format) const {
+    WireCodec::writeResponse(out, format, status, code, message, data);
+}
+
+void ApiHandler::runInParallel(size_t begin, size_t end, const std::function<void(size_t)>& task) {
+    // 调用线程与辅助任务从同一个下标计数器领取子请求：线程池繁忙时由调用线程
+    // 独自完成，未被领取的辅助任务在汇合时直接返回，因此不会因线程池饱和而死锁。
+    // 与请求处理共用同一个工作窃取线程池，辅助任务进入当前线程的本地队列
+    std::atomic<size_t> next{begin};
+    auto drain = [&]() {
+        size_t index;
+        while ((index = next.fetch_add(1)) < end) {
+            task(index);
+        }
+    };
+    
+    FanOutExecutor& executor = service()->getFanOutExecutor();
+    size_t helperCount = std::min(end - begin, executor.size() + 1) - 1;
+    
+    // 辅助任务在其他工作线程上执行，沿用当前请求的院区与认证（截止时间与副本会话由执行器传递）
+    const CampusDirectory::Campus* campus = currentCampus;
+    const ResolvedAuth* auth = currentAuth;
+    auto helper = [&drain, campus, auth]() {
+        CampusScope campusScope(campus);
+        AuthContextScope authScope(auth);
+        drain();
+    };
+    
+    std::vector<FanOutExecutor::Future<void>> helpers;
+    helpers.reserve(helperCount);
+    for (size_t i = 0; i < helperCount; ++i) {
+        helpers.push_back(executor.submit(helper));
+    }
+    
+    drain();
+    for (auto& helper : helpers) {
+        helper.get();
+    }
+}
+
+ApiHandler::ApiResponse ApiHandler::handleBatch(const json& data) {
+    const json& requests = data["requests"];
+    if (requests.empty()) {
+        return ApiResponse("error", 400, "子请求列表不能为空", json::object());
+    }
+    if (requests.size() > MAX_BATCH_REQUESTS) {
+        return ApiResponse("error", 400, "子请求数量不能超过" + std::to_string(MAX_BATCH_REQUESTS), json::object());
+    }
+    bool failFast = data.value("failFast", false);
+    
+    // 批量级token只验证一次，子请求未携带token时继承该token
+    ResolvedAuth auth;
+    bool hasAuth = data.contains("token");
+    if (hasAuth) {
+        auth.token = data["token"];
+        if (!validateToken(auth.token, auth.userId, auth.userType)) {
+            return ApiResponse("error", 401, "无效的认证token", json::object());
+        }
+    }
+    
+    std::vector<ApiResponse> results(requests.size());
+    std::atomic<bool> aborted{false};
+    // 子请求可能在其他工作线程上执行，院区随批量请求一起传递
+    const CampusDirectory::Campus* campus = currentCampus;
+    
+    RequestDeadline* deadline = RequestDeadline::current();
+    
+    // 子请求与单独请求一样受该API的并发上限（如登录/注册的四分之一名额）和用户令牌桶约束，
+    // 打包成批量请求不能绕过限流；携带自己token的子请求按该token的用户计算
+    auto runBatchItem = [&](const std::string& apiName, const ApiHandlerFunc& handler, const json& itemData) {
+        auto errors = requestValidator.validate(apiName, itemData);
+        if (!errors.empty()) {
+            return validationErrorResponse(errors);
+        }
+        
+        const ResolvedAuth* itemAuth = hasAuth ? &auth : nullptr;
+        ResolvedAuth ownAuth;
+        auto tokenIt = itemData.is_object() ? itemData.find("token") : itemData.end();
+        if (tokenIt != itemData.end() && tokenIt->is_string() &&
+            (!hasAuth || tokenIt->get_ref<const std::string&>() != auth.token)) {
+            ownAuth.token = tokenIt->get<std::string>();
+            ownAuth.valid = validateToken(ownAuth.token, ownAuth.userId, ownAuth.userType);
+            itemAuth = &ownAuth;
+        }
+        
+        std::string campusId = campus ? campus->id : std::string();
+        AdmissionController::Ticket ticket = admissionController.acquireNested(apiName, campusId);
+        if (!ticket.admitted()) {
+            json responseData;
+            responseData["retryAfterMs"] = ticket.getRetryAfterMs();
+            return ApiResponse("error", 503, "服务繁忙，请稍后重试", std::move(responseData));
+        }
+        int64_t retryAfterMs = 0;
+        if (itemAuth && itemAuth->valid && !admissionController.consumeUserToken(itemAuth->userId, retryAfterMs, campusId)) {
+            json responseData;
+            responseData["retryAfterMs"] = retryAfterMs;
+            return ApiResponse("error", 429, "请求过于频繁，请稍后重试", std::move(responseData));
+        }
+        
+        ResolvedAuthScope scope(itemAuth);
+        return handler(itemData);
+    };
+    
+    auto runItem = [&](size_t index) {
+        CampusScope campusScope(campus);
+        ApiResponse& result = results[index];
+        const json& item = requests[index];
+        
+        if (failFast && aborted.load()) {
+            result = ApiResponse("error", 424, "前序子请求失败，已跳过", json::object());
+        } else if (deadline && deadline->expired()) {
+            result = ApiResponse("error", 504, "请求超时，已跳过", json::object());
+        } else if (!item.is_object() || !item.contains("api") || !item["api"].is_string() || !item.contains("data")) {
+            result = ApiResponse("error", 400, "Invalid request format", json::object());
+        } else {
+            const std::string& apiName = item["api"].get_ref<const std::string&>();
+            auto it = apiHandlers.find(apiName);
+            json itemCampus = item["data"].is_object() ? item["data"].value("campus", json()) : json();
+            if (apiName == "batch") {
+                result = ApiResponse("error", 400, "批量请求不能嵌套", json::object());
+            } else if (itemCampus.is_string() && campus && itemCampus.get_ref<const std::string&>() != campus->id) {
+                result = ApiResponse("error", 400, "子请求必须与批量请求属于同一院区", json::object());
+            } else if (it == apiHandlers.end()) {
+                result = ApiResponse("error", 404, "API endpoint not found", json::object());
+            } else {
+                const json* itemData = &item["data"];
+                json inherited;
+                if (hasAuth && itemData->is_object() && !itemData->contains("token")) {
+                    inherited = *itemData;
+                    inherited["token"] = auth.token;
+                    itemData = &inherited;
+                }
+                
+                try {
+                    result = runBatchItem(apiName, it->second, *itemData);
+                } catch (const std::exception& e) {
+                    result = ApiResponse("error", 500, "Internal server error: ", std::string(e.what()));
+                }
+                if (result.status != "success" && deadline && deadline->expired()) {
+                    result = ApiResponse("error", 504, "请求超时", json::object());
+                }
+            }
+        }
+        
+        if (result.status != "success") {
+            aborted.store(true);
+        }
+    };
+    
+    // 连续的只读子请求并行执行；写操作按数组顺序单独执行，保证其前后的读取顺序不变
+    size_t pos = 0;
+    while (pos < requests.size()) {
+        size_t end = pos;
+        while (end < requests.size() && requests[end].is_object() && requests[end].contains("api") &&
+               requests[end]["api"].is_string() && isReadOnlyApi(requests[end]["api"])) {
+            ++end;
+        }
+        if (end - pos > 1) {
+            runInParallel(pos, end, runItem);
+        } else {
+            end = std::max(end, pos + 1);
+            runItem(pos);
+        }
+        pos = end;
+    }
+    
+    json responses = json::array();
+    size_t succeeded = 0;
+    for (auto& result : results) {
+        if (result.status == "success") ++succeeded;
+        json entry;
+        entry["status"] = result.status;
+        entry["code"] = result.code;
+        entry["message"] = result.message;
+        entry["data"] = std::move(result.data);
+        responses.push_back(std::move(entry));
+    }
+    
+    json responseData;
+    responseData["responses"] = std::move(responses);
+    responseData["succeeded"] = succeeded;
+    responseData["failed"] = results.size() - succeeded;
+    
+    return ApiResponse("success", 200, "批量请求处理完成", std::move(responseData));
 }
 
 // Token验证函数 - 新的基于数据库的验证逻辑
@@ -89,14 +782,38 @@ bool ApiHandler::validateToken(const std::string& token, int& userId, UserType&
         return false;
     }
     
-    // 获取所有用户，计算每个用户的token并进行匹配
-    auto users = hospitalService->getUserDAO()->getAllUsers();
+    // 准入阶段或批量请求内已验证过的token直接复用验证结果
+    if (currentAuth && token == currentAuth->token) {
+        if (!currentAuth->valid) return false;
+        userId = currentAuth->userId;
+        userType = currentAuth->userType;
+        return true;
+    }
+    
+    // 多院区时token带签发院区前缀，只在该院区的用户中匹配
+    std::string digest = token;
+    if (campuses->isMultiCampus()) {
+        std::string prefix = (currentCampus ? *currentCampus : campuses->getDefault()).id + ":";
+        if (token.compare(0, prefix.size(), prefix) != 0) {
+            return false;
+        }
+        digest = token.substr(prefix.size());
+    }
+    
+    // 获取所有用户，批量计算每个用户的token并进行匹配
+    auto users = service()->getUserDAO()->getAllUsers();
     
+    std::vector<std::string> tokenSources;
+    tokenSources.reserve(users.size());
     for (const auto& user : users) {
-        std::string expectedToken = generateTokenForUser(user->getUserId(), user->getUsername());
-        if (expectedToken == token) {
-            userId = user->getUserId();
-            userType = user->getUserType();
+        tokenSources.push_back(std::to_string(user->getUserId()) + user->getUsername());
+    }
+    
+    std::vector<std::string> expectedTokens = Sha256::hexBatch(tokenSources);
+    for (size_t i = 0; i < users.size(); ++i) {
+        if (expectedTokens[i] == digest) {
+            userId = users[i]->getUserId();
+            userType = users[i]->getUserType();
             return true;
         }
     }
@@ -107,7 +824,10 @@ bool ApiHandler::validateToken(const std::string& token, int& userId, UserType&
 // 生成用户token的函数
 std::string ApiHandler::generateTokenForUser(int userId, const std::string& username) {
     std::string tokenSource = std::to_string(userId) + username;
-    return hashPassword(tokenSource);
+    if (campuses->isMultiCampus()) {
+        return (currentCampus ? *currentCampus : campuses->getDefault()).id + ":" + Sha256::hex(tokenSource);
+    }
+    return Sha256::hex(tokenSource);
 }
 
 // 公共接口处理函数
@@ -116,10 +836,11 @@ ApiHandler::ApiResponse ApiHandler::handlePublicScheduleList(const json& data) {
         // 模拟医生排班数据查询
         json schedules = json::array();
         
-        // 从数据库获取医生排班信息
-        auto doctors = hospitalService->getDoctorDAO()->getAllDoctors();
+        // 从数据库获取医生排班信息（医生列表与预约数一次往返取回）
+        auto doctors = service()->getDoctorsWithBookingCounts();
         
-        for (const auto& doctor : doctors) {
+        for (const auto& entry : doctors) {
+            const auto& doctor = entry.doctor;
             json schedule = {
                 {"scheduleId", "sched_" + std::to_string(doctor->getDoctorId())},
                 {"doctorName", doctor->getName()},
@@ -128,8 +849,8 @@ ApiHandler::ApiResponse ApiHandler::handlePublicScheduleList(const json& data) {
                 {"timePeriod", doctor->getWorkingHours()},
                 {"registrationFee", 50.0},
                 {"patientLimit", 30},
-                {"bookedCount", hospitalService->getAppointmentDAO()->getAppointmentCountByDoctor(doctor->getDoctorId())},
-                {"remainingCount", 30 - hospitalService->getAppointmentDAO()->getAppointmentCountByDoctor(doctor->getDoctorId())}
+                {"bookedCount", entry.bookedCount},
+                {"remainingCount", 30 - entry.bookedCount}
             };
             schedules.push_back(schedule);
         }
@@ -137,7 +858,7 @@ ApiHandler::ApiResponse ApiHandler::handlePublicScheduleList(const json& data) {
         json responseData;
         responseData["schedules"] = schedules;
         
-        return ApiResponse("success", 200, "获取坐诊安排成功", responseData);
+        return ApiResponse("success", 200, "获取坐诊安排成功", std::move(responseData));
         
     } catch (const std::exception& e) {
         return ApiResponse("error", 500, "获取坐诊安排失败:", std::string(e.what()));
@@ -146,15 +867,11 @@ ApiHandler::ApiResponse ApiHandler::handlePublicScheduleList(const json& data) {
 
 ApiHandler::ApiResponse ApiHandler::handlePublicDoctorGet(const json& data) {
     try {
-        if (!data.contains("doctorId")) {
-            return ApiResponse("error", 400, "缺少医生ID参数", json::object());
-        }
-        
         // doctorId传入为doc_xxx形式
         std::string doctorIdStr = data["doctorId"];
         int doctorId = std::stoi(doctorIdStr.substr(4));
         
-        auto doctor = hospitalService->getDoctorDAO()->getDoctorById(doctorId);
+        auto doctor = service()->getDoctorDAO()->getDoctorById(doctorId);
         if (!doctor) {
             return ApiResponse("error", 404, "医生不存在", json::object());
         }
@@ -170,7 +887,7 @@ ApiHandler::ApiResponse ApiHandler::handlePublicDoctorGet(const json& data) {
         responseData["registrationFee"] = 50.0;
         responseData["dailyPatientLimit"] = 30;
         
-        return ApiResponse("success", 200, "获取医生信息成功", responseData);
+        return ApiResponse("success", 200, "获取医生信息成功", std::move(responseData));
         
     } catch (const std::exception& e) {
         return ApiResponse("error", 500, "获取医生信息失败", json::object());
@@ -180,41 +897,34 @@ ApiHandler::ApiResponse ApiHandler::handlePublicDoctorGet(const json& data) {
 // 患者端接口处理函数
 ApiHandler::ApiResponse ApiHandler::handlePatientRegister(const json& data) {
     try {
-        if (!data.contains("email") || !data.contains("password")) {
-            return ApiResponse("error", 400, "缺少必要参数", json::object());
-        }
-        
         std::string email = data["email"];
         std::string password = data["password"];
         std::string verificationCode = data["verificationCode"];
 
-        if (!validateEmail(email)) {
-            return ApiResponse("error", 400, "邮箱格式不符合要求", json::object());
-        }
-        
-        if (!validatePassword(password)) {
-            return ApiResponse("error", 400, "密码不符合要求", json::object());
-        }
-
         if (verificationCode != "123456") {
             return ApiResponse("error", 400, "验证码错误", json::object());
         }
 
         // 检查用户是否已存在
-        if (hospitalService->getUserDAO()->userExists(email, email)) {
+        if (service()->getUserDAO()->userExists(email, email)) {
             return ApiResponse("error", 409, "用户已存在", json::object());
         }
         
         // 创建用户
-        if (hospitalService->registerUser(email, password, UserType::PATIENT, email)) {
-            auto user = hospitalService->getUserDAO()->getUserByEmail(email);
+        if (service()->registerUser(email, password, UserType::PATIENT, email)) {
+            auto user = service()->getUserDAO()->getUserByEmail(email);
             if (user) {
                 json responseData;
                 responseData["userId"] = "pat_" + std::to_string(user->getUserId());
-                return ApiResponse("success", 201, "注册成功", responseData);
+                return ApiResponse("success", 201, "注册成功", std::move(responseData));
             }
         }
-        
+
+        // 上面的检查可能被并发注册或过滤器未覆盖的行放过，插入随后违反唯一约束；以数据库为准
+        if (service()->getUserDAO()->getUserByUsername(email) || service()->getUserDAO()->getUserByEmail(email)) {
+            return ApiResponse("error", 409, "用户已存在", json::object());
+        }
+
         return ApiResponse("error", 500, "注册失败", json::object());
         
     } catch (const std::exception& e) {
@@ -224,14 +934,10 @@ ApiHandler::ApiResponse ApiHandler::handlePatientRegister(const json& data) {
 
 ApiHandler::ApiResponse ApiHandler::handlePatientLogin(const json& data) {
     try {
-        if (!data.contains("account") || !data.contains("password")) {
-            return ApiResponse("error", 400, "缺少必需参数: account 或 password");
-        }
-        
         std::string account = data["account"];
         std::string password = data["password"];
         
-        auto user = hospitalService->loginUser(account, password);
+        auto user = service()->loginUser(account, password);
         if (!user || user->getUserType() != UserType::PATIENT) {
             return ApiResponse("error", 401, "登录失败，账户或密码错误");
         }
@@ -242,7 +948,7 @@ ApiHandler::ApiResponse ApiHandler::handlePatientLogin(const json& data) {
         responseData["token"] = token;
         responseData["userId"] = "pat_" + std::to_string(user->getUserId());
         
-        return ApiResponse("success", 200, "登录成功", responseData);
+        return ApiResponse("success", 200, "登录成功", std::move(responseData));
         
     } catch (const std::exception& e) {
         return ApiResponse("error", 500, "登录失败", std::string(e.what()));
@@ -251,16 +957,12 @@ ApiHandler::ApiResponse ApiHandler::handlePatientLogin(const json& data) {
 
 ApiHandler::ApiResponse ApiHandler::handlePatientResetPassword(const json& data) {
     try {
-        if (!data.contains("username") || !data.contains("email") || !data.contains("newPassword")) {
-            return ApiResponse("error", 400, "缺少必要参数", json::object());
-        }
-        
         std::string username = data["username"];
         std::string email = data["email"];
         std::string verificationCode = data["verificationCode"];
         std::string newPassword = data["newPassword"];
         
-        auto user = hospitalService->getUserDAO()->getUserByUsername(username);
+        auto user = service()->getUserDAO()->getUserByUsername(username);
         if (!user) {
             return ApiResponse("error", 404, "用户不存在", json::object());
         }
@@ -279,7 +981,7 @@ ApiHandler::ApiResponse ApiHandler::handlePatientResetPassword(const json& data)
         }
         
         // 更新密码
-        if (hospitalService->getUserDAO()->resetPassword(user->getUserId(), newPassword)) {
+        if (service()->getUserDAO()->resetPassword(user->getUserId(), newPassword)) {
             return ApiResponse("success", 200, "密码重置成功", json::object());
         }
         
@@ -292,10 +994,6 @@ ApiHandler::ApiResponse ApiHandler::handlePatientResetPassword(const json& data)
 
 ApiHandler::ApiResponse ApiHandler::handlePatientProfileGet(const json& data) {
     try {
-        if (!data.contains("token")) {
-            return ApiResponse("error", 401, "缺少认证token", json::object());
-        }
-        
         std::string token = data["token"];
         int userId;
         UserType userType;
@@ -304,9 +1002,10 @@ ApiHandler::ApiResponse ApiHandler::handlePatientProfileGet(const json& data) {
             return ApiResponse("error", 401, "无效的认证token", json::object());
         }
         
-        // std::cout << "userId:" << userId << std::endl;
-        auto user = hospitalService->getUserDAO()->getUserById(userId);
-        auto patient = hospitalService->getPatientDAO()->getPatientByUserId(userId);
+        // 用户与患者信息一次往返读取
+        auto profile = service()->getPatientProfile(userId);
+        auto& user = profile.user;
+        auto& patient = profile.patient;
         
         if (!user) {
             return ApiResponse("error", 404, "用户信息不存在", json::object());
@@ -325,7 +1024,7 @@ ApiHandler::ApiResponse ApiHandler::handlePatientProfileGet(const json& data) {
         responseData["gender"] = patient->genderToString();
         responseData["age"] = patient->getAge();
         
-        return ApiResponse("success", 200, "获取个人信息成功", responseData);
+        return ApiResponse("success", 200, "获取个人信息成功", std::move(responseData));
         
     } catch (const std::exception& e) {
         return ApiResponse("error", 500, "获取个人信息失败", std::string(e.what()));
@@ -334,10 +1033,6 @@ ApiHandler::ApiResponse ApiHandler::handlePatientProfileGet(const json& data) {
 
 ApiHandler::ApiResponse ApiHandler::handlePatientProfileUpdate(const json& data) {
     try {
-        if (!data.contains("token")) {
-            return ApiResponse("error", 401, "缺少认证token", json::object());
-        }
-        
         std::string token = data["token"];
         int userId;
         UserType userType;
@@ -346,8 +1041,8 @@ ApiHandler::ApiResponse ApiHandler::handlePatientProfileUpdate(const json& data)
             return ApiResponse("error", 401, "无效的认证token", json::object());
         }
         
-        auto user = hospitalService->getUserDAO()->getUserById(userId);
-        auto patient = hospitalService->getPatientDAO()->getPatientByUserId(userId);
+        auto user = service()->getUserDAO()->getUserById(userId);
+        auto patient = service()->getPatientDAO()->getPatientByUserId(userId);
         
         if (!user || !patient) {
             return ApiResponse("error", 404, "患者信息不存在", json::object());
@@ -362,8 +1057,8 @@ ApiHandler::ApiResponse ApiHandler::handlePatientProfileUpdate(const json& data)
         // 更新用户信息
         if (data.contains("email")) user->setEmail(data["email"]);
         
-        bool patientUpdated = hospitalService->getPatientDAO()->updatePatient(*patient);
-        bool userUpdated = hospitalService->getUserDAO()->updateUser(*user);
+        bool patientUpdated = service()->getPatientDAO()->updatePatient(*patient);
+        bool userUpdated = service()->getUserDAO()->updateUser(*user);
         
         if (patientUpdated && userUpdated) {
             json responseData;
@@ -373,7 +1068,7 @@ ApiHandler::ApiResponse ApiHandler::handlePatientProfileUpdate(const json& data)
             responseData["phone"] = patient->getPhoneNumber();
             responseData["email"] = user->getEmail();
             
-            return ApiResponse("success", 200, "个人信息更新成功", responseData);
+            return ApiResponse("success", 200, "个人信息更新成功", std::move(responseData));
         }
         
         return ApiResponse("error", 500, "个人信息更新失败", json::object());
@@ -385,10 +1080,6 @@ ApiHandler::ApiResponse ApiHandler::handlePatientProfileUpdate(const json& data)
 
 ApiHandler::ApiResponse ApiHandler::handlePatientAppointmentCreate(const json& data) {
     try {
-        if (!data.contains("token") || !data.contains("scheduleId")) {
-            return ApiResponse("error", 400, "缺少必要参数", json::object());
-        }
-        
         std::string token = data["token"];
         int userId;
         UserType userType;
@@ -397,7 +1088,7 @@ ApiHandler::ApiResponse ApiHandler::handlePatientAppointmentCreate(const json& d
             return ApiResponse("error", 401, "无效的认证token", json::object());
         }
         
-        auto patient = hospitalService->getPatientDAO()->getPatientByUserId(userId);
+        auto patient = service()->getPatientDAO()->getPatientByUserId(userId);
         if (!patient) {
             return ApiResponse("error", 404, "患者信息不存在", json::object());
         }
@@ -409,13 +1100,13 @@ ApiHandler::ApiResponse ApiHandler::handlePatientAppointmentCreate(const json& d
             doctorId = std::stoi(scheduleId.substr(6));
         }
         
-        auto doctor = hospitalService->getDoctorDAO()->getDoctorById(doctorId);
+        auto doctor = service()->getDoctorDAO()->getDoctorById(doctorId);
         if (!doctor) {
             return ApiResponse("error", 404, "医生不存在", json::object());
         }
         
         std::string appointmentTime = getCurrentDateTime();
-        int appointmentId = hospitalService->bookAppointment(
+        int appointmentId = service()->bookAppointment(
             patient->getPatientId(), doctorId, appointmentTime, doctor->getDepartment());
         
         // std::cout << "doctorId:" << doctorId << std::endl;
@@ -431,7 +1122,7 @@ ApiHandler::ApiResponse ApiHandler::handlePatientAppointmentCreate(const json& d
             responseData["doctorName"] = doctor->getName();
             responseData["department"] = doctor->getDepartment();
             
-            return ApiResponse("success", 201, "预约成功", responseData);
+            return ApiResponse("success", 201, "预约成功", std::move(responseData));
         } else {
             std::cerr << "Failed to create appointment" << std::endl;
             return ApiResponse("error", 500, "预约失败", json::object());
@@ -444,10 +1135,6 @@ ApiHandler::ApiResponse ApiHandler::handlePatientAppointmentCreate(const json& d
 
 ApiHandler::ApiResponse ApiHandler::handlePatientMedicalRecordList(const json& data) {
     try {
-        if (!data.contains("token")) {
-            return ApiResponse("error", 401, "缺少认证token", json::object());
-        }
-        
         std::string token = data["token"];
         int userId;
         UserType userType;
@@ -456,16 +1143,16 @@ ApiHandler::ApiResponse ApiHandler::handlePatientMedicalRecordList(const json& d
             return ApiResponse("error", 401, "无效的认证token", json::object());
         }
         
-        auto patient = hospitalService->getPatientDAO()->getPatientByUserId(userId);
+        auto patient = service()->getPatientDAO()->getPatientByUserId(userId);
         if (!patient) {
             return ApiResponse("error", 404, "患者信息不存在", json::object());
         }
         
-        auto cases = hospitalService->getCaseDAO()->getCasesByPatientId(patient->getPatientId());
+        auto cases = service()->getCaseDAO()->getCasesByPatientId(patient->getPatientId());
         
         json records = json::array();
         for (const auto& medicalCase : cases) {
-            auto doctor = hospitalService->getDoctorDAO()->getDoctorById(medicalCase->getDoctorId());
+            auto doctor = service()->getDoctorDAO()->getDoctorById(medicalCase->getDoctorId());
             
             json record;
             record["recordId"] = "rec_" + std::to_string(medicalCase->getCaseId());
@@ -481,7 +1168,7 @@ ApiHandler::ApiResponse ApiHandler::handlePatientMedicalRecordList(const json& d
         json responseData;
         responseData["records"] = records;
         
-        return ApiResponse("success", 200, "获取病历列表成功", responseData);
+        return ApiResponse("success", 200, "获取病历列表成功", std::move(responseData));
         
     } catch (const std::exception& e) {
         return ApiResponse("error", 500, "获取病历列表失败", json::object());
@@ -490,10 +1177,6 @@ ApiHandler::ApiResponse ApiHandler::handlePatientMedicalRecordList(const json& d
 
 ApiHandler::ApiResponse ApiHandler::handlePatientPrescriptionList(const json& data) {
     try {
-        if (!data.contains("token")) {
-            return ApiResponse("error", 401, "缺少认证token", json::object());
-        }
-        
         std::string token = data["token"];
         int userId;
         UserType userType;
@@ -502,17 +1185,17 @@ ApiHandler::ApiResponse ApiHandler::handlePatientPrescriptionList(const json& da
             return ApiResponse("error", 401, "无效的认证token", json::object());
         }
         
-        auto patient = hospitalService->getPatientDAO()->getPatientByUserId(userId);
+        auto patient = service()->getPatientDAO()->getPatientByUserId(userId);
         if (!patient) {
             return ApiResponse("error", 404, "患者信息不存在", json::object());
         }
         
         // 获取患者的所有病例
-        auto cases = hospitalService->getCaseDAO()->getCasesByPatientId(patient->getPatientId());
+        auto cases = service()->getCaseDAO()->getCasesByPatientId(patient->getPatientId());
         
         json prescriptions = json::array();
         for (const auto& medicalCase : cases) {
-            auto casePrescriptions = hospitalService->getPrescriptionDAO()->getPrescriptionsByCaseId(medicalCase->getCaseId());
+            auto casePrescriptions = service()->getPrescriptionDAO()->getPrescriptionsByCaseId(medicalCase->getCaseId());
             
             for (const auto& prescription : casePrescriptions) {
                 json prescData;
@@ -527,7 +1210,7 @@ ApiHandler::ApiResponse ApiHandler::handlePatientPrescriptionList(const json& da
         json responseData;
         responseData["prescriptions"] = prescriptions;
         
-        return ApiResponse("success", 200, "获取处方列表成功", responseData);
+        return ApiResponse("success", 200, "获取处方列表成功", std::move(responseData));
         
     } catch (const std::exception& e) {
         return ApiResponse("error", 500, "获取处方列表失败", json::object());
@@ -536,10 +1219,6 @@ ApiHandler::ApiResponse ApiHandler::handlePatientPrescriptionList(const json& da
 
 ApiHandler::ApiResponse ApiHandler::handlePatientPrescriptionGet(const json& data) {
     try {
-        if (!data.contains("token") || !data.contains("prescriptionId")) {
-            return ApiResponse("error", 400, "缺少必要参数", json::object());
-        }
-        
         std::string token = data["token"];
         int userId;
         UserType userType;
@@ -551,12 +1230,12 @@ ApiHandler::ApiResponse ApiHandler::handlePatientPrescriptionGet(const json& dat
         std::string prescriptionIdStr = data["prescriptionId"];
         int prescriptionId = std::stoi(prescriptionIdStr.substr(6)); // 去掉 "presc_" 前缀
         
-        auto prescription = hospitalService->getPrescriptionDAO()->getPrescriptionById(prescriptionId);
+        auto prescription = service()->getPrescriptionDAO()->getPrescriptionById(prescriptionId);
         if (!prescription) {
             return ApiResponse("error", 404, "处方不存在", json::object());
         }
         
-        auto medications = hospitalService->getMedicationDAO()->getMedicationsByPrescriptionId(prescriptionId);
+        auto medications = service()->getMedicationDAO()->getMedicationsByPrescriptionId(prescriptionId);
         
         json medicines = json::array();
         for (const auto& medication : medications) {
@@ -573,7 +1252,7 @@ ApiHandler::ApiResponse ApiHandler::handlePatientPrescriptionGet(const json& dat
         responseData["date"] = prescription->getIssuedDate();
         responseData["medicines"] = medicines;
         
-        return ApiResponse("success", 200, "获取处方详情成功", responseData);
+        return ApiResponse("success", 200, "获取处方详情成功", std::move(responseData));
         
     } catch (const std::exception& e) {
         return ApiResponse("error", 500, "获取处方详情失败", json::object());
@@ -582,10 +1261,6 @@ ApiHandler::ApiResponse ApiHandler::handlePatientPrescriptionGet(const json& dat
 
 ApiHandler::ApiResponse ApiHandler::handlePatientLabResultList(const json& data) {
     try {
-        if (!data.contains("token")) {
-            return ApiResponse("error", 401, "缺少认证token", json::object());
-        }
-        
         std::string token = data["token"];
         int userId;
         UserType userType;
@@ -607,7 +1282,7 @@ ApiHandler::ApiResponse ApiHandler::handlePatientLabResultList(const json& data)
         json responseData;
         responseData["results"] = results;
         
-        return ApiResponse("success", 200, "获取检查结果成功", responseData);
+        return ApiResponse("success", 200, "获取检查结果成功", std::move(responseData));
         
     } catch (const std::exception& e) {
         return ApiResponse("error", 500, "获取检查结果失败", json::object());
@@ -616,10 +1291,6 @@ ApiHandler::ApiResponse ApiHandler::handlePatientLabResultList(const json& data)
 
 ApiHandler::ApiResponse ApiHandler::handlePatientChatSendMessage(const json& data) {
     try {
-        if (!data.contains("token") || !data.contains("doctorId") || !data.contains("content")) {
-            return ApiResponse("error", 400, "缺少必要参数", json::object());
-        }
-        
         std::string token = data["token"];
         int userId;
         UserType userType;
@@ -631,17 +1302,13 @@ ApiHandler::ApiResponse ApiHandler::handlePatientChatSendMessage(const json& dat
         std::string doctorId = data["doctorId"];
         std::string content = data["content"];
         
-        if (content.empty()) {
-            return ApiResponse("error", 400, "消息内容不能为空", json::object());
-        }
-        
         // 模拟消息发送成功
         json responseData;
         responseData["messageId"] = "msg_" + std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::system_clock::now().time_since_epoch()).count());
         responseData["sentTime"] = getCurrentDateTime();
         
-        return ApiResponse("success", 200, "消息发送成功", responseData);
+        return ApiResponse("success", 200, "消息发送成功", std::move(responseData));
         
     } catch (const std::exception& e) {
         return ApiResponse("error", 500, "消息发送失败", json::object());
@@ -650,10 +1317,6 @@ ApiHandler::ApiResponse ApiHandler::handlePatientChatSendMessage(const json& dat
 
 ApiHandler::ApiResponse ApiHandler::handlePatientChatGetHistory(const json& data) {
     try {
-        if (!data.contains("token") || !data.contains("doctorId")) {
-            return ApiResponse("error", 400, "缺少必要参数", json::object());
-        }
-        
         std::string token = data["token"];
         int userId;
         UserType userType;
@@ -675,7 +1338,7 @@ ApiHandler::ApiResponse ApiHandler::handlePatientChatGetHistory(const json& data
         json responseData;
         responseData["messages"] = messages;
         
-        return ApiResponse("success", 200, "获取聊天历史成功", responseData);
+        return ApiResponse("success", 200, "获取聊天历史成功", std::move(responseData));
         
     } catch (const std::exception& e) {
         return ApiResponse("error", 500, "获取聊天历史失败", json::object());
@@ -684,10 +1347,6 @@ ApiHandler::ApiResponse ApiHandler::handlePatientChatGetHistory(const json& data
 
 ApiHandler::ApiResponse ApiHandler::handlePatientAssessmentGetLink(const json& data) {
     try {
-        if (!data.contains("token")) {
-            return ApiResponse("error", 401, "缺少认证token", json::object());
-        }
-        
         std::string token = data["token"];
         int userId;
         UserType userType;
@@ -699,7 +1358,7 @@ ApiHandler::ApiResponse ApiHandler::handlePatientAssessmentGetLink(const json& d
         json responseData;
         responseData["url"] = "https://example.com/questionnaire/health_check";
         
-        return ApiResponse("success", 200, "获取成功", responseData);
+        return ApiResponse("success", 200, "获取成功", std::move(responseData));
         
     } catch (const std::exception& e) {
         return ApiResponse("error", 500, "获取失败", json::object());
@@ -708,10 +1367,6 @@ ApiHandler::ApiResponse ApiHandler::handlePatientAssessmentGetLink(const json& d
 
 ApiHandler::ApiResponse ApiHandler::handlePatientConsultationRequestOnline(const json& data) {
     try {
-        if (!data.contains("token")) {
-            return ApiResponse("error", 401, "缺少认证token", json::object());
-        }
-        
         std::string token = data["token"];
         int userId;
         UserType userType;
@@ -725,7 +1380,7 @@ ApiHandler::ApiResponse ApiHandler::handlePatientConsultationRequestOnline(const
         responseData["agoraToken"] = "agora_token_example";
         responseData["doctorId"] = "doc_online_007";
         
-        return ApiResponse("success", 200, "匹配成功，正在建立连接", responseData);
+        return ApiResponse("success", 200, "匹配成功，正在建立连接", std::move(responseData));
         
     } catch (const std::exception& e) {
         return ApiResponse("error", 500, "线上医疗服务请求失败", json::object());
@@ -735,10 +1390,6 @@ ApiHandler::ApiResponse ApiHandler::handlePatientConsultationRequestOnline(const
 // 医生端接口处理函数
 ApiHandler::ApiResponse ApiHandler::handleDoctorLogin(const json& data) {
     try {
-        if (!data.contains("employeeId") || !data.contains("password")) {
-            return ApiResponse("error", 400, "缺少工号或密码", json::object());
-        }
-        
         std::string employeeId = data["employeeId"];
         std::string password = data["password"];
         
@@ -748,7 +1399,7 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorLogin(const json& data) {
             username = "dr_" + employeeId.substr(3);
         }
         
-        auto user = hospitalService->loginUser(username, password);
+        auto user = service()->loginUser(username, password);
         if (!user || user->getUserType() != UserType::DOCTOR) {
             return ApiResponse("error", 401, "登录失败，工号或密码错误", json::object());
         }
@@ -759,7 +1410,7 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorLogin(const json& data) {
         responseData["token"] = token;
         responseData["doctorId"] = "doc_" + std::to_string(user->getUserId());
         
-        return ApiResponse("success", 200, "登录成功", responseData);
+        return ApiResponse("success", 200, "登录成功", std::move(responseData));
         
     } catch (const std::exception& e) {
         return ApiResponse("error", 500, "登录失败", json::object());
@@ -768,10 +1419,6 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorLogin(const json& data) {
 
 ApiHandler::ApiResponse ApiHandler::handleDoctorResetPassword(const json& data) {
     try {
-        if (!data.contains("employeeId") || !data.contains("idCardNumber") || !data.contains("newPassword")) {
-            return ApiResponse("error", 400, "缺少必要参数", json::object());
-        }
-        
         std::string employeeId = data["employeeId"];
         std::string idCardNumber = data["idCardNumber"];
         std::string newPassword = data["newPassword"];
@@ -782,13 +1429,13 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorResetPassword(const json& data)
             username = "dr_" + employeeId.substr(3);
         }
         
-        auto user = hospitalService->getUserDAO()->getUserByUsername(username);
+        auto user = service()->getUserDAO()->getUserByUsername(username);
         if (!user || user->getUserType() != UserType::DOCTOR) {
             return ApiResponse("error", 404, "医生不存在", json::object());
         }
         
         // 更新密码
-        if (hospitalService->getUserDAO()->changePassword(user->getUserId(), user->getPasswordHash(), newPassword)) {
+        if (service()->getUserDAO()->changePassword(user->getUserId(), user->getPasswordHash(), newPassword)) {
             return ApiResponse("success", 200, "密码重置成功", json::object());
         }
         
@@ -801,10 +1448,6 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorResetPassword(const json& data)
 
 ApiHandler::ApiResponse ApiHandler::handleDoctorProfileGet(const json& data) {
     try {
-        if (!data.contains("token")) {
-            return ApiResponse("error", 401, "缺少认证token", json::object());
-        }
-        
         std::string token = data["token"];
         int userId;
         UserType userType;
@@ -813,8 +1456,10 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorProfileGet(const json& data) {
             return ApiResponse("error", 401, "无效的认证token", json::object());
         }
         
-        auto user = hospitalService->getUserDAO()->getUserById(userId);
-        auto doctor = hospitalService->getDoctorDAO()->getDoctorByUserId(userId);
+        // 用户与医生信息一次往返读取
+        auto profile = service()->getDoctorProfile(userId);
+        auto& user = profile.user;
+        auto& doctor = profile.doctor;
         
         if (!user || !doctor) {
             return ApiResponse("error", 404, "医生信息不存在", json::object());
@@ -831,7 +1476,7 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorProfileGet(const json& data) {
         responseData["bio"] = "专业医生，经验丰富";
         responseData["registrationFee"] = 50.0;
         
-        return ApiResponse("success", 200, "获取医生信息成功", responseData);
+        return ApiResponse("success", 200, "获取医生信息成功", std::move(responseData));
         
     } catch (const std::exception& e) {
         return ApiResponse("error", 500, "获取医生信息失败", json::object());
@@ -840,10 +1485,6 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorProfileGet(const json& data) {
 
 ApiHandler::ApiResponse ApiHandler::handleDoctorProfileUpdate(const json& data) {
     try {
-        if (!data.contains("token")) {
-            return ApiResponse("error", 401, "缺少认证token", json::object());
-        }
-        
         std::string token = data["token"];
         int userId;
         UserType userType;
@@ -852,8 +1493,8 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorProfileUpdate(const json& data)
             return ApiResponse("error", 401, "无效的认证token", json::object());
         }
         
-        auto user = hospitalService->getUserDAO()->getUserById(userId);
-        auto doctor = hospitalService->getDoctorDAO()->getDoctorByUserId(userId);
+        auto user = service()->getUserDAO()->getUserById(userId);
+        auto doctor = service()->getDoctorDAO()->getDoctorByUserId(userId);
         
         if (!user || !doctor) {
             return ApiResponse("error", 404, "医生信息不存在", json::object());
@@ -871,8 +1512,8 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorProfileUpdate(const json& data)
         if (data.contains("email")) user->setEmail(data["email"]);
         if (data.contains("phone")) user->setPhoneNumber(data["phone"]);
         
-        bool userUpdated = hospitalService->getUserDAO()->updateUser(*user);
-        bool doctorUpdated = hospitalService->getDoctorDAO()->updateDoctor(*doctor);
+        bool userUpdated = service()->getUserDAO()->updateUser(*user);
+        bool doctorUpdated = service()->getDoctorDAO()->updateDoctor(*doctor);
         
         if (userUpdated && doctorUpdated) {
             json responseData;
@@ -883,7 +1524,7 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorProfileUpdate(const json& data)
             responseData["email"] = user->getEmail();
             responseData["phone"] = user->getPhoneNumber();
             
-            return ApiResponse("success", 200, "医生信息更新成功", responseData);
+            return ApiResponse("success", 200, "医生信息更新成功", std::move(responseData));
         }
         
         return ApiResponse("error", 500, "医生信息更新失败", json::object());
@@ -895,10 +1536,6 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorProfileUpdate(const json& data)
 
 ApiHandler::ApiResponse ApiHandler::handleDoctorAppointmentList(const json& data) {
     try {
-        if (!data.contains("token")) {
-            return ApiResponse("error", 401, "缺少认证token", json::object());
-        }
-        
         std::string token = data["token"];
         int userId;
         UserType userType;
@@ -907,16 +1544,16 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorAppointmentList(const json& data
             return ApiResponse("error", 401, "无效的认证token", json::object());
         }
         
-        auto doctor = hospitalService->getDoctorDAO()->getDoctorByUserId(userId);
+        auto doctor = service()->getDoctorDAO()->getDoctorByUserId(userId);
         if (!doctor) {
             return ApiResponse("error", 404, "医生信息不存在", json::object());
         }
         
-        auto appointments = hospitalService->getAppointmentDAO()->getAppointmentsByDoctorId(doctor->getDoctorId());
+        auto appointments = service()->getAppointmentDAO()->getAppointmentsByDoctorId(doctor->getDoctorId());
         
         json appointmentList = json::array();
         for (const auto& appointment : appointments) {
-            auto patient = hospitalService->getPatientDAO()->getPatientById(appointment->getPatientId());
+            auto patient = service()->getPatientDAO()->getPatientById(appointment->getPatientId());
             
             json appt;
             appt["appointmentId"] = "appt_" + std::to_string(appointment->getAppointmentId());
@@ -931,7 +1568,7 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorAppointmentList(const json& data
         json responseData;
         responseData["appointments"] = appointmentList;
         
-        return ApiResponse("success", 200, "获取预约列表成功", responseData);
+        return ApiResponse("success", 200, "获取预约列表成功", std::move(responseData));
         
     } catch (const std::exception& e) {
         return ApiResponse("error", 500, "获取预约列表失败", json::object());
@@ -940,10 +1577,6 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorAppointmentList(const json& data
 
 ApiHandler::ApiResponse ApiHandler::handleDoctorPatientGetMedicalRecords(const json& data) {
     try {
-        if (!data.contains("token") || !data.contains("patientId")) {
-            return ApiResponse("error", 400, "缺少必要参数", json::object());
-        }
-        
         std::string token = data["token"];
         int userId;
         UserType userType;
@@ -955,16 +1588,16 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorPatientGetMedicalRecords(const j
         std::string patientIdStr = data["patientId"];
         int patientId = std::stoi(patientIdStr.substr(4)); // 去掉 "pat_" 前缀
         
-        auto patient = hospitalService->getPatientDAO()->getPatientById(patientId);
+        auto patient = service()->getPatientDAO()->getPatientById(patientId);
         if (!patient) {
             return ApiResponse("error", 404, "患者不存在", json::object());
         }
         
-        auto cases = hospitalService->getCaseDAO()->getCasesByPatientId(patientId);
+        auto cases = service()->getCaseDAO()->getCasesByPatientId(patientId);
         
         json records = json::array();
         for (const auto& medicalCase : cases) {
-            auto caseDoctor = hospitalService->getDoctorDAO()->getDoctorById(medicalCase->getDoctorId());
+            auto caseDoctor = service()->getDoctorDAO()->getDoctorById(medicalCase->getDoctorId());
             
             json record;
             record["recordId"] = "rec_" + std::to_string(medicalCase->getCaseId());
@@ -980,7 +1613,7 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorPatientGetMedicalRecords(const j
         json responseData;
         responseData["records"] = records;
         
-        return ApiResponse("success", 200, "获取患者病历成功", responseData);
+        return ApiResponse("success", 200, "获取患者病历成功", std::move(responseData));
         
     } catch (const std::exception& e) {
         return ApiResponse("error", 500, "获取患者病历失败", json::object());
@@ -989,11 +1622,6 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorPatientGetMedicalRecords(const j
 
 ApiHandler::ApiResponse ApiHandler::handleDoctorMedicalRecordCreate(const json& data) {
     try {
-        if (!data.contains("token") || !data.contains("patientId") || 
-            !data.contains("diagnosis") || !data.contains("doctorAdvice")) {
-            return ApiResponse("error", 400, "缺少必要参数", json::object());
-        }
-        
         std::string token = data["token"];
         int userId;
         UserType userType;
@@ -1002,7 +1630,7 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorMedicalRecordCreate(const json&
             return ApiResponse("error", 401, "无效的认证token", json::object());
         }
         
-        auto doctor = hospitalService->getDoctorDAO()->getDoctorByUserId(userId);
+        auto doctor = service()->getDoctorDAO()->getDoctorByUserId(userId);
         if (!doctor) {
             return ApiResponse("error", 404, "医生信息不存在", json::object());
         }
@@ -1014,7 +1642,7 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorMedicalRecordCreate(const json&
         std::string doctorAdvice = data["doctorAdvice"];
         
         // 创建病例记录
-        int caseId = hospitalService->createMedicalCase(patientId, doctor->getDepartment(), 
+        int caseId = service()->createMedicalCase(patientId, doctor->getDepartment(), 
                                                        doctor->getDoctorId(), diagnosis + " " + doctorAdvice);
         
         if (caseId > 0) {
@@ -1022,7 +1650,7 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorMedicalRecordCreate(const json&
             responseData["recordId"] = "rec_" + std::to_string(caseId);
             responseData["date"] = getCurrentDateTime();
             
-            return ApiResponse("success", 201, "病历创建成功", responseData);
+            return ApiResponse("success", 201, "病历创建成功", std::move(responseData));
         }
         
         return ApiResponse("error", 500, "病历创建失败", json::object());
@@ -1034,10 +1662,6 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorMedicalRecordCreate(const json&
 
 ApiHandler::ApiResponse ApiHandler::handleDoctorPrescriptionCreate(const json& data) {
     try {
-        if (!data.contains("token") || !data.contains("patientId") || !data.contains("medicines")) {
-            return ApiResponse("error", 400, "缺少必要参数", json::object());
-        }
-        
         std::string token = data["token"];
         int userId;
         UserType userType;
@@ -1046,7 +1670,7 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorPrescriptionCreate(const json& d
             return ApiResponse("error", 401, "无效的认证token", json::object());
         }
         
-        auto doctor = hospitalService->getDoctorDAO()->getDoctorByUserId(userId);
+        auto doctor = service()->getDoctorDAO()->getDoctorByUserId(userId);
         if (!doctor) {
             return ApiResponse("error", 404, "医生信息不存在", json::object());
         }
@@ -1060,7 +1684,7 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorPrescriptionCreate(const json& d
         }
         
         // 获取患者最新的病例
-        auto cases = hospitalService->getCaseDAO()->getCasesByPatientId(patientId);
+        auto cases = service()->getCaseDAO()->getCasesByPatientId(patientId);
         if (cases.empty()) {
             return ApiResponse("error", 404, "患者没有病例记录", json::object());
         }
@@ -1076,13 +1700,13 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorPrescriptionCreate(const json& d
         }
         
         // 创建处方
-        int prescriptionId = hospitalService->issuePrescription(caseId, doctor->getDoctorId(), 
+        int prescriptionId = service()->issuePrescription(caseId, doctor->getDoctorId(), 
                                                                prescriptionContent.str());
         
         if (prescriptionId > 0) {
             // 添加药物详情
             for (const auto& medicine : medicines) {
-                hospitalService->addMedication(prescriptionId, 
+                service()->addMedication(prescriptionId, 
                                              medicine["name"].get<std::string>(),
                                              medicine.contains("quantity") ? medicine["quantity"].get<int>() : 1,
                                              medicine["frequency"].get<std::string>());
@@ -1092,7 +1716,7 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorPrescriptionCreate(const json& d
             responseData["prescriptionId"] = "presc_" + std::to_string(prescriptionId);
             responseData["date"] = getCurrentDateTime();
             
-            return ApiResponse("success", 201, "处方开具成功", responseData);
+            return ApiResponse("success", 201, "处方开具成功", std::move(responseData));
         }
         
         return ApiResponse("error", 500, "处方开具失败", json::object());
@@ -1104,11 +1728,6 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorPrescriptionCreate(const json& d
 
 ApiHandler::ApiResponse ApiHandler::handleDoctorLabResultUpload(const json& data) {
     try {
-        if (!data.contains("token") || !data.contains("patientId") || 
-            !data.contains("reportName") || !data.contains("fileContentBase64")) {
-            return ApiResponse("error", 400, "缺少必要参数", json::object());
-        }
-        
         std::string token = data["token"];
         int userId;
         UserType userType;
@@ -1119,12 +1738,7 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorLabResultUpload(const json& data
         
         std::string patientIdStr = data["patientId"];
         std::string reportName = data["reportName"];
-        std::string fileContentBase64 = data["fileContentBase64"];
-        
-        // 验证Base64格式
-        if (fileContentBase64.empty()) {
-            return ApiResponse("error", 400, "文件内容不能为空", json::object());
-        }
+        // 文件内容（可达数MB）已由参数校验确认非空，模拟上传不再复制
         
         // 模拟文件上传成功
         json responseData;
@@ -1133,7 +1747,7 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorLabResultUpload(const json& data
         responseData["reportUrl"] = "https://example.com/reports/" + responseData["resultId"].get<std::string>() + ".pdf";
         responseData["uploadTime"] = getCurrentDateTime();
         
-        return ApiResponse("success", 201, "检验报告上传成功", responseData);
+        return ApiResponse("success", 201, "检验报告上传成功", std::move(responseData));
         
     } catch (const std::exception& e) {
         return ApiResponse("error", 500, "检验报告上传失败", json::object());
@@ -1142,10 +1756,6 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorLabResultUpload(const json& data
 
 ApiHandler::ApiResponse ApiHandler::handleDoctorStatusUpdate(const json& data) {
     try {
-        if (!data.contains("token") || !data.contains("status")) {
-            return ApiResponse("error", 400, "缺少必要参数", json::object());
-        }
-        
         std::string token = data["token"];
         int userId;
         UserType userType;
@@ -1164,7 +1774,7 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorStatusUpdate(const json& data) {
         responseData["status"] = status;
         responseData["updateTime"] = getCurrentDateTime();
         
-        return ApiResponse("success", 200, "状态更新成功", responseData);
+        return ApiResponse("success", 200, "状态更新成功", std::move(responseData));
         
     } catch (const std::exception& e) {
         return ApiResponse("error", 500, "状态更新失败", json::object());
@@ -1173,10 +1783,6 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorStatusUpdate(const json& data) {
 
 ApiHandler::ApiResponse ApiHandler::handleDoctorAttendanceCheckIn(const json& data) {
     try {
-        if (!data.contains("token")) {
-            return ApiResponse("error", 401, "缺少认证token", json::object());
-        }
-        
         std::string token = data["token"];
         int userId;
         UserType userType;
@@ -1190,7 +1796,7 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorAttendanceCheckIn(const json& da
         responseData["checkInTime"] = getCurrentDateTime();
         responseData["status"] = "checked_in";
         
-        return ApiResponse("success", 200, "打卡成功", responseData);
+        return ApiResponse("success", 200, "打卡成功", std::move(responseData));
         
     } catch (const std::exception& e) {
         return ApiResponse("error", 500, "打卡失败", json::object());
@@ -1199,10 +1805,6 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorAttendanceCheckIn(const json& da
 
 ApiHandler::ApiResponse ApiHandler::handleDoctorAttendanceCancelCheckIn(const json& data) {
     try {
-        if (!data.contains("token")) {
-            return ApiResponse("error", 401, "缺少认证token", json::object());
-        }
-        
         std::string token = data["token"];
         int userId;
         UserType userType;
@@ -1216,7 +1818,7 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorAttendanceCancelCheckIn(const js
         responseData["cancelTime"] = getCurrentDateTime();
         responseData["status"] = "cancelled";
         
-        return ApiResponse("success", 200, "取消打卡成功", responseData);
+        return ApiResponse("success", 200, "取消打卡成功", std::move(responseData));
         
     } catch (const std::exception& e) {
         return ApiResponse("error", 500, "取消打卡失败", json::object());
@@ -1225,10 +1827,6 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorAttendanceCancelCheckIn(const js
 
 ApiHandler::ApiResponse ApiHandler::handleDoctorAttendanceGetHistory(const json& data) {
     try {
-        if (!data.contains("token")) {
-            return ApiResponse("error", 401, "缺少认证token", json::object());
-        }
-        
         std::string token = data["token"];
         int userId;
         UserType userType;
@@ -1250,7 +1848,7 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorAttendanceGetHistory(const json&
         json responseData;
         responseData["history"] = history;
         
-        return ApiResponse("success", 200, "获取考勤历史成功", responseData);
+        return ApiResponse("success", 200, "获取考勤历史成功", std::move(responseData));
         
     } catch (const std::exception& e) {
         return ApiResponse("error", 500, "获取考勤历史失败", json::object());
@@ -1259,12 +1857,6 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorAttendanceGetHistory(const json&
 
 ApiHandler::ApiResponse ApiHandler::handleDoctorLeaveRequestSubmit(const json& data) {
     try {
-        if (!data.contains("token") || !data.contains("contactPhone") || 
-            !data.contains("type") || !data.contains("startDate") || 
-            !data.contains("endDate") || !data.contains("reason")) {
-            return ApiResponse("error", 400, "缺少必要参数", json::object());
-        }
-        
         std::string token = data["token"];
         int userId;
         UserType userType;
@@ -1285,7 +1877,7 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorLeaveRequestSubmit(const json& d
         responseData["status"] = "pending";
         responseData["submittedAt"] = getCurrentDateTime();
         
-        return ApiResponse("success", 201, "请假申请提交成功", responseData);
+        return ApiResponse("success", 201, "请假申请提交成功", std::move(responseData));
         
     } catch (const std::exception& e) {
         return ApiResponse("error", 500, "请假申请提交失败", json::object());
@@ -1294,10 +1886,6 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorLeaveRequestSubmit(const json& d
 
 ApiHandler::ApiResponse ApiHandler::handleDoctorLeaveRequestList(const json& data) {
     try {
-        if (!data.contains("token")) {
-            return ApiResponse("error", 401, "缺少认证token", json::object());
-        }
-        
         std::string token = data["token"];
         int userId;
         UserType userType;
@@ -1322,7 +1910,7 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorLeaveRequestList(const json& dat
         json responseData;
         responseData["requests"] = requests;
         
-        return ApiResponse("success", 200, "获取请假列表成功", responseData);
+        return ApiResponse("success", 200, "获取请假列表成功", std::move(responseData));
         
     } catch (const std::exception& e) {
         return ApiResponse("error", 500, "获取请假列表失败", json::object());
@@ -1331,10 +1919,6 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorLeaveRequestList(const json& dat
 
 ApiHandler::ApiResponse ApiHandler::handleDoctorLeaveRequestCancel(const json& data) {
     try {
-        if (!data.contains("token") || !data.contains("requestId")) {
-            return ApiResponse("error", 400, "缺少必要参数", json::object());
-        }
-        
         std::string token = data["token"];
         int userId;
         UserType userType;
@@ -1351,7 +1935,7 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorLeaveRequestCancel(const json& d
         responseData["status"] = "cancelled";
         responseData["cancelledAt"] = getCurrentDateTime();
         
-        return ApiResponse("success", 200, "销假成功", responseData);
+        return ApiResponse("success", 200, "销假成功", std::move(responseData));
         
     } catch (const std::exception& e) {
         return ApiResponse("error", 500, "销假失败", json::object());
@@ -1359,43 +1943,12 @@ ApiHandler::ApiResponse ApiHandler::handleDoctorLeaveRequestCancel(const json& d
 }
 
 // 工具函数实现
-bool ApiHandler::validateEmail(const std::string& email) {
-    const std::regex emailPattern(R"([a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,})");
-    return std::regex_match(email, emailPattern);
-}
-
-bool ApiHandler::validatePhone(const std::string& phone) {
-    const std::regex phonePattern(R"(^1[3-9]\d{9}$)");
-    return std::regex_match(phone, phonePattern);
-}
-
-bool ApiHandler::validatePassword(const std::string& password) {
-    return password.length() >= 6;
-}
-
-bool ApiHandler::validateIdNumber(const std::string& idNumber) {
-    const std::regex idPattern(R"(^\d{17}[\dXx]$)");
-    return std::regex_match(idNumber, idPattern);
-}
-
-std::string ApiHandler::hashPassword(const std::string& password) {
-    unsigned char hash[SHA256_DIGEST_LENGTH];
-    SHA256_CTX sha256;
-    SHA256_Init(&sha256);
-    SHA256_Update(&sha256, password.c_str(), password.length());
-    SHA256_Final(hash, &sha256);
-    
-    std::stringstream ss;
-    for (int i = 0; i < SHA256_DIGEST_LENGTH; i++) {
-        ss << std::hex << std::setw(2) << std::setfill('0') << (int)hash[i];
-    }
-    return ss.str();
-}
-
 std::string ApiHandler::getCurrentDateTime() {
     auto now = std::chrono::system_clock::now();
     auto time_t = std::chrono::system_clock::to_time_t(now);
-    auto tm = *std::localtime(&time_t);
+    // localtime返回共享的静态缓冲区，工作线程并发调用时须使用可重入版本
+    std::tm tm{};
+    localtime_r(&time_t, &tm);
     
     std::stringstream ss;
     ss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
@@ -1482,7 +2035,7 @@ json ApiHandler::medicationToJson(const Medication& medication) {
 }
 
 json ApiHandler::getSystemStats() {
-    auto stats = hospitalService->getHospitalStats();
+    auto stats = service()->getHospitalStats();
     
     json systemStats;
     systemStats["totalUsers"] = stats.totalUsers;
@@ -1497,5 +2050,104 @@ json ApiHandler::getSystemStats() {
     systemStats["totalPrescriptions"] = stats.totalPrescriptions;
     systemStats["totalMedications"] = stats.totalMedications;
     
+    auto filter = service()->getExistenceFilter();
+    if (filter) {
+        auto filterStats = filter->getStats();
+        json filterJson;
+        filterJson["queries"] = filterStats.queries;
+        filterJson["definiteNegatives"] = filterStats.definiteNegatives;
+        filterJson["maybes"] = filterStats.maybes;
+        filterJson["falsePositives"] = filterStats.falsePositives;
+        filterJson["falsePositiveRate"] = filter->getFalsePositiveRate();
+        systemStats["existenceFilter"] = filterJson;
+    }
+    
+    systemStats["admission"] = admissionStatsToJson(admissionController.getStats());
+    systemStats["database"] = breakerStatsToJson(*service()->getConnectionPool()->getBreaker());
+    auto faultInjector = DatabaseConnection::getFaultInjector();
+    if (faultInjector) {
+        auto faultStats = faultInjector->getStats();
+        json faultJson;
+        faultJson["delayed"] = faultStats.delayed;
+        faultJson["failed"] = faultStats.failed;
+        systemStats["faultInjection"] = faultJson;
+    }
+    auto slowQueryLog = DatabaseConnection::getSlowQueryLog();
+    if (slowQueryLog) {
+        systemStats["slowQueries"] = slowQueryLog->getRecorded();
+    }
+    auto doctorCacheStats = service()->getDoctorDAO()->getCacheStats();
+    json doctorCacheJson;
+    doctorCacheJson["byId"] = cacheStatsToJson(doctorCacheStats.byId);
+    doctorCacheJson["byUserId"] = cacheStatsToJson(doctorCacheStats.byUserId);
+    doctorCacheJson["departments"] = cacheStatsToJson(doctorCacheStats.departments);
+    systemStats["doctorCache"] = doctorCacheJson;
+    auto queryCache = service()->getConnectionPool()->getQueryCache();
+    if (queryCache) {
+        auto queryCacheStats = queryCache->getStats();
+        json queryCacheJson;
+        queryCacheJson["hits"] = queryCacheStats.hits;
+        queryCacheJson["misses"] = queryCacheStats.misses;
+        queryCacheJson["fills"] = queryCacheStats.fills;
+        queryCacheJson["staleFills"] = queryCacheStats.staleFills;
+        queryCacheJson["oversized"] = queryCacheStats.oversized;
+        queryCacheJson["invalidations"] = queryCacheStats.invalidations;
+        queryCacheJson["evictions"] = queryCacheStats.evictions;
+        queryCacheJson["expirations"] = queryCacheStats.expirations;
+        queryCacheJson["entries"] = queryCacheStats.entries;
+        queryCacheJson["bytes"] = queryCacheStats.bytes;
+        queryCacheJson["maxBytes"] = queryCacheStats.maxBytes;
+        systemStats["queryCache"] = queryCacheJson;
+    }
+    if (campuses->isMultiCampus()) {
+        json campusStats = getCampusStats();
+        systemStats["campuses"] = std::move(campusStats["campuses"]);
+        systemStats["connectionBudget"] = std::move(campusStats["connectionBudget"]);
+    }
+    
+    auto replicaStatus = service()->getConnectionPool()->getReplicaStatus();
+    if (!replicaStatus.empty()) {
+        json replicasJson = json::array();
+        for (const auto& replica : replicaStatus) {
+            json replicaJson;
+            replicaJson["endpoint"] = replica.endpoint;
+            replicaJson["healthy"] = replica.healthy;
+            replicaJson["lagMs"] = replica.lagMs;
+            replicaJson["reads"] = replica.reads;
+            replicasJson.push_back(replicaJson);
+        }
+        systemStats["replicas"] = replicasJson;
+    }
+    
     return systemStats;
+}
+
+json ApiHandler::getCampusStats() {
+    auto tenantStats = admissionController.getTenantStats();
+    
+    json campusList = json::array();
+    for (const auto& campus : campuses->getCampuses()) {
+        json campusJson;
+        campusJson["id"] = campus.id;
+        campusJson["weight"] = campus.weight;
+        auto it = tenantStats.find(campus.id);
+        AdmissionController::Stats admissionStats = it != tenantStats.end() ? it->second : AdmissionController::Stats();
+        campusJson["admission"] = admissionStatsToJson(admissionStats);
+        campusJson["admission"]["averageServiceMs"] = admissionStats.averageServiceMs;
+        campusJson["database"] = breakerStatsToJson(*campus.service->getConnectionPool()->getBreaker());
+        campusList.push_back(std::move(campusJson));
+    }
+    
+    json result;
+    result["campuses"] = std::move(campusList);
+    auto budget = campuses->getBudget();
+    if (budget) {
+        json budgetJson;
+        budgetJson["limit"] = budget->getLimit();
+        budgetJson["inUse"] = budget->getInUse();
+        result["connectionBudget"] = budgetJson;
+    } else {
+        result["connectionBudget"] = nullptr;
+    }
+    return result;
 }
\ No newline at end of file
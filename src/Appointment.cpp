@@ -45,7 +45,7 @@ bool AppointmentDAO::createAppointment(const Appointment& appointment) {
 }
 
 std::unique_ptr<Appointment> AppointmentDAO::getAppointmentById(int appointmentId) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     if (!conn) return nullptr;
     
     std::stringstream query;
@@ -72,7 +72,7 @@ std::unique_ptr<Appointment> AppointmentDAO::getAppointmentById(int appointmentI
 }
 
 std::vector<std::unique_ptr<Appointment>> AppointmentDAO::getAppointmentsByPatientId(int patientId) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<Appointment>> appointments;
     if (!conn) return appointments;
     
@@ -98,7 +98,7 @@ std::vector<std::unique_ptr<Appointment>> AppointmentDAO::getAppointmentsByPatie
 }
 
 std::vector<std::unique_ptr<Appointment>> AppointmentDAO::getAppointmentsByDoctorId(int doctorId) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<Appointment>> appointments;
     if (!conn) return appointments;
     
@@ -124,7 +124,7 @@ std::vector<std::unique_ptr<Appointment>> AppointmentDAO::getAppointmentsByDocto
 }
 
 std::vector<std::unique_ptr<Appointment>> AppointmentDAO::getAppointmentsByDepartment(const std::string& department) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<Appointment>> appointments;
     if (!conn) return appointments;
     
@@ -151,7 +151,7 @@ std::vector<std::unique_ptr<Appointment>> AppointmentDAO::getAppointmentsByDepar
 }
 
 std::vector<std::unique_ptr<Appointment>> AppointmentDAO::getAppointmentsByStatus(AppointmentStatus status) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<Appointment>> appointments;
     if (!conn) return appointments;
     
@@ -178,7 +178,7 @@ std::vector<std::unique_ptr<Appointment>> AppointmentDAO::getAppointmentsByStatu
 }
 
 std::vector<std::unique_ptr<Appointment>> AppointmentDAO::getAllAppointments() {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<Appointment>> appointments;
     if (!conn) return appointments;
     
@@ -258,7 +258,7 @@ bool AppointmentDAO::cancelAppointment(int appointmentId) {
 }
 
 std::vector<std::unique_ptr<Appointment>> AppointmentDAO::searchAppointments(const std::string& searchTerm) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<Appointment>> appointments;
     if (!conn) return appointments;
     
@@ -285,53 +285,21 @@ std::vector<std::unique_ptr<Appointment>> AppointmentDAO::searchAppointments(con
 }
 
 int AppointmentDAO::getAppointmentCount() {
-    auto conn = connectionPool->getConnection();
-    if (!conn) return 0;
-    
-    std::string query = "SELECT COUNT(*) FROM appointments";
-    MYSQL_RES* result = conn->executeQuery(query);
-    if (!result) {
-        connectionPool->returnConnection(std::move(conn));
-        return 0;
-    }
-    
-    MYSQL_ROW row = mysql_fetch_row(result);
-    int count = 0;
-    if (row && row[0]) {
-        count = std::stoi(row[0]);
-    }
-    
-    mysql_free_result(result);
-    connectionPool->returnConnection(std::move(conn));
-    return count;
+    auto result = connectionPool->executeCachedQuery("SELECT COUNT(*) FROM appointments");
+    if (!result || result->rowCount() == 0 || !result->get(0, 0)) return 0;
+    return std::stoi(*result->get(0, 0));
 }
 
 int AppointmentDAO::getAppointmentCountByStatus(AppointmentStatus status) {
-    auto conn = connectionPool->getConnection();
-    if (!conn) return 0;
-    
-    std::stringstream query;
-    query << "SELECT COUNT(*) FROM appointments WHERE status = '" << statusToString(status) << "'";
-    
-    MYSQL_RES* result = conn->executeQuery(query.str());
-    if (!result) {
-        connectionPool->returnConnection(std::move(conn));
-        return 0;
-    }
-    
-    MYSQL_ROW row = mysql_fetch_row(result);
-    int count = 0;
-    if (row && row[0]) {
-        count = std::stoi(row[0]);
-    }
-    
-    mysql_free_result(result);
-    connectionPool->returnConnection(std::move(conn));
-    return count;
+    // The status is one of a few fixed strings, so it needs no escaping (and no connection)
+    auto result = connectionPool->executeCachedQuery(
+        "SELECT COUNT(*) FROM appointments WHERE status = '" + statusToString(status) + "'");
+    if (!result || result->rowCount() == 0 || !result->get(0, 0)) return 0;
+    return std::stoi(*result->get(0, 0));
 }
 
 int AppointmentDAO::getAppointmentCountByDoctor(int doctorId) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     if (!conn) return 0;
     
     std::stringstream query;
@@ -0,0 +1,429 @@
+#include "AsyncQueryExecutor.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+// MariaDB Connector/C 定义了 MYSQL_WAIT_* 与 *_start/*_cont 接口；
+// MySQL 8.0.16 起提供 *_nonblocking 接口，但不告知需要等待的事件
+#if defined(MYSQL_WAIT_READ)
+#define ASYNC_QUERY_MARIADB_API 1
+#elif defined(MYSQL_VERSION_ID) && MYSQL_VERSION_ID >= 80016
+#define ASYNC_QUERY_MYSQL_API 1
+#endif
+
+namespace {
+
+// 与MariaDB的MYSQL_WAIT_*取值一致
+const int kWaitRead = 1;
+const int kWaitWrite = 2;
+const int kWaitExcept = 4;
+const int kWaitTimeout = 8;
+
+const uint64_t kWakeToken = std::numeric_limits<uint64_t>::max();
+
+#if defined(ASYNC_QUERY_MYSQL_API)
+// MySQL的非阻塞接口可能在等待写入时返回NOT_READY，只监听可读事件时需要定期重试
+const int kRetryIntervalMs = 5;
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+// 连接已断开的错误码（CR_SERVER_GONE_ERROR / CR_SERVER_LOST），下次使用前重连
+bool isConnectionLost(unsigned int error) {
+    return error == 2006 || error == 2013;
+}
+
+int socketOf(MYSQL* mysql) {
+#if defined(ASYNC_QUERY_MARIADB_API)
+    return mysql_get_socket(mysql);
+#elif defined(ASYNC_QUERY_MYSQL_API)
+    return mysql->net.fd;
+#else
+    (void)mysql;
+    return -1;
+#endif
+}
+
+}
+
+struct AsyncQueryExecutor::Slot {
+    enum class Stage { QUERY, STORE };
+
+    size_t index = 0;
+    std::unique_ptr<DatabaseConnection> connection;
+    int fd = -1;
+    bool busy = false;
+    Stage stage = Stage::QUERY;
+    Request request;
+    int queryError = 0;
+    MYSQL_RES* rows = nullptr;
+    Clock::time_point deadline = Clock::time_point::max();
+};
+
+AsyncQueryExecutor::AsyncQueryExecutor(const std::string& host, const std::string& username,
+                                       const std::string& password, const std::string& database,
+                                       unsigned int port, size_t connectionCount)
+    : host(host), username(username), password(password), database(database), port(port),
+      connectionCount(connectionCount == 0 ? 1 : connectionCount) {}
+
+AsyncQueryExecutor::~AsyncQueryExecutor() {
+    shutdown();
+}
+
+bool AsyncQueryExecutor::isNonBlocking() {
+#if defined(ASYNC_QUERY_MARIADB_API) || defined(ASYNC_QUERY_MYSQL_API)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool AsyncQueryExecutor::start() {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    if (running) return true;
+    // 事件循环异常退出后不再重启：其连接可能停在查询中途
+    if (stopping || loopThread.joinable()) return false;
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd < 0 || wakeFd < 0) {
+        lastError = std::string("创建事件循环失败: ") + std::strerror(errno);
+        return false;
+    }
+    epoll_event wakeEvent{};
+    wakeEvent.events = EPOLLIN;
+    wakeEvent.data.u64 = kWakeToken;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &wakeEvent);
+
+    for (size_t i = 0; i < connectionCount; ++i) {
+        auto slot = std::make_unique<Slot>();
+        slot->index = slots.size();
+        slot->connection = std::make_unique<DatabaseConnection>(host, username, password, database, port);
+        slot->connection->setNonBlocking(true);
+        slot->connection->setBreaker(breaker);
+        if (!slot->connection->connect() || !registerSlot(*slot)) {
+            lastError = "建立异步查询连接失败: " + slot->connection->getError();
+            continue;
+        }
+        idleSlots.push_back(slot.get());
+        slots.push_back(std::move(slot));
+    }
+    if (slots.empty()) {
+        return false;
+    }
+
+    running = true;
+    loopThread = std::thread(&AsyncQueryExecutor::eventLoop, this);
+    return true;
+}
+
+void AsyncQueryExecutor::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    if (wakeFd >= 0) {
+        uint64_t one = 1;
+        ssize_t written = write(wakeFd, &one, sizeof(one));
+        (void)written;
+    }
+    if (loopThread.joinable()) {
+        loopThread.join();
+    }
+    slots.clear();
+    idleSlots.clear();
+    if (epollFd >= 0) {
+        close(epollFd);
+        epollFd = -1;
+    }
+    if (wakeFd >= 0) {
+        close(wakeFd);
+        wakeFd = -1;
+    }
+}
+
+bool AsyncQueryExecutor::submit(const std::string& sql, Callback callback) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (!running || stopping) return false;
+        RequestDeadline* deadline = RequestDeadline::current();
+        pending.push_back(Request{sql, std::move(callback),
+                                  deadline ? deadline->getTime() : RequestDeadline::Clock::time_point::max()});
+    }
+    uint64_t one = 1;
+    ssize_t written = write(wakeFd, &one, sizeof(one));
+    (void)written;
+    return true;
+}
+
+std::future<AsyncQueryExecutor::Result> AsyncQueryExecutor::submit(const std::string& sql) {
+    auto promise = std::make_shared<std::promise<Result>>();
+    std::future<Result> future = promise->get_future();
+    bool accepted = submit(sql, [promise](Result& result) {
+        promise->set_value(std::move(result));
+    });
+    if (!accepted) {
+        Result result;
+        result.error = "异步查询执行器未运行";
+        promise->set_value(std::move(result));
+    }
+    return future;
+}
+
+bool AsyncQueryExecutor::registerSlot(Slot& slot) {
+    slot.fd = socketOf(slot.connection->getConnection());
+    if (slot.fd < 0) {
+        // 阻塞退化模式下查询在advance中同步完成，无需监听套接字
+        return !isNonBlocking();
+    }
+    epoll_event event{};
+    event.events = 0;
+    event.data.u64 = slot.index;
+    return epoll_ctl(epollFd, EPOLL_CTL_ADD, slot.fd, &event) == 0;
+}
+
+void AsyncQueryExecutor::eventLoop() {
+    std::vector<epoll_event> events(slots.size() + 1);
+
+    for (;;) {
+        std::deque<Request> ready;
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            while (!pending.empty() && ready.size() < idleSlots.size()) {
+                ready.push_back(std::move(pending.front()));
+                pending.pop_front();
+            }
+            if (stopping && pending.empty() && ready.empty() && idleSlots.size() == slots.size()) {
+                break;
+            }
+        }
+
+        for (auto& request : ready) {
+            Slot* slot = idleSlots.back();
+            idleSlots.pop_back();
+            begin(*slot, std::move(request));
+        }
+
+        // 有排队请求且有空闲连接（退化模式或回调中提交了新查询）时不阻塞等待
+        int timeoutMs = -1;
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if ((!pending.empty() && !idleSlots.empty()) || (stopping && idleSlots.size() == slots.size())) {
+                timeoutMs = 0;
+            }
+        }
+        if (timeoutMs != 0) {
+            auto now = Clock::now();
+            for (const auto& slot : slots) {
+                if (!slot->busy || slot->deadline == Clock::time_point::max()) continue;
+                auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(slot->deadline - now).count();
+                int wait = remaining <= 0 ? 0 : static_cast<int>(remaining) + 1;
+                timeoutMs = timeoutMs < 0 ? wait : std::min(timeoutMs, wait);
+            }
+        }
+
+        int count = epoll_wait(epollFd, events.data(), static_cast<int>(events.size()), timeoutMs);
+        if (count < 0 && errno != EINTR) {
+            std::cerr << "异步查询事件循环失败: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            if (events[i].data.u64 == kWakeToken) {
+                uint64_t value;
+                ssize_t drained = read(wakeFd, &value, sizeof(value));
+                (void)drained;
+                continue;
+            }
+            Slot& slot = *slots[events[i].data.u64];
+            if (!slot.busy) continue;
+            int readyEvents = 0;
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) readyEvents |= kWaitRead;
+            if (events[i].events & EPOLLOUT) readyEvents |= kWaitWrite;
+            if (events[i].events & EPOLLPRI) readyEvents |= kWaitExcept;
+            advance(slot, readyEvents);
+        }
+
+        auto now = Clock::now();
+        for (const auto& slot : slots) {
+            if (slot->busy && slot->deadline <= now) {
+                advance(*slot, kWaitTimeout);
+            }
+        }
+    }
+
+    // 事件循环异常退出时，未执行与执行中的请求都以失败结束，避免提交方永久等待；
+    // 执行中的连接协议状态未知，之后不再使用
+    std::deque<Request> abandoned;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        running = false;
+        abandoned.swap(pending);
+    }
+    for (const auto& slot : slots) {
+        if (!slot->busy) continue;
+        if (slot->rows) {
+            mysql_free_result(slot->rows);
+            slot->rows = nullptr;
+        }
+        slot->busy = false;
+        abandoned.push_back(std::move(slot->request));
+        idleSlots.push_back(slot.get());
+    }
+    for (auto& request : abandoned) {
+        Result result;
+        result.error = "异步查询执行器已停止";
+        request.callback(result);
+    }
+}
+
+void AsyncQueryExecutor::begin(Slot& slot, Request request) {
+    // 提交方的请求已超时则不再执行，否则SELECT在服务端按剩余时间限时
+    RequestDeadline deadline(request.deadline);
+    bool hasDeadline = request.deadline != RequestDeadline::Clock::time_point::max();
+    std::string bounded;
+    if (!slot.connection->applyDeadline(request.sql, bounded, hasDeadline ? &deadline : nullptr)) {
+        idleSlots.push_back(&slot);
+        Result result;
+        result.error = "请求已超时";
+        request.callback(result);
+        return;
+    }
+    request.sql = std::move(bounded);
+
+    slot.busy = true;
+    slot.stage = Slot::Stage::QUERY;
+    slot.request = std::move(request);
+    slot.queryError = 0;
+    slot.rows = nullptr;
+
+    // 上一条查询发现连接已断开时在这里重连（阻塞，仅在故障后发生）
+    if (slot.fd < 0 && isNonBlocking()) {
+        if (!slot.connection->reconnect() || !registerSlot(slot)) {
+            complete(slot, false);
+            return;
+        }
+    }
+    advance(slot, 0);
+}
+
+void AsyncQueryExecutor::advance(Slot& slot, int readyEvents) {
+    MYSQL* mysql = slot.connection->getConnection();
+    const std::string& sql = slot.request.sql;
+
+#if defined(ASYNC_QUERY_MARIADB_API)
+    // readyEvents为0表示开始新阶段，否则把就绪事件交给*_cont继续
+    if (slot.stage == Slot::Stage::QUERY) {
+        int status = readyEvents == 0
+            ? mysql_real_query_start(&slot.queryError, mysql, sql.data(), sql.size())
+            : mysql_real_query_cont(&slot.queryError, mysql, readyEvents);
+        if (status != 0) {
+            watch(slot, status);
+            return;
+        }
+        if (slot.queryError != 0) {
+            complete(slot, false);
+            return;
+        }
+        slot.stage = Slot::Stage::STORE;
+        readyEvents = 0;
+    }
+    int status = readyEvents == 0
+        ? mysql_store_result_start(&slot.rows, mysql)
+        : mysql_store_result_cont(&slot.rows, mysql, readyEvents);
+    if (status != 0) {
+        watch(slot, status);
+        return;
+    }
+    complete(slot, slot.rows != nullptr || mysql_field_count(mysql) == 0);
+#elif defined(ASYNC_QUERY_MYSQL_API)
+    (void)readyEvents;
+    if (slot.stage == Slot::Stage::QUERY) {
+        net_async_status status = mysql_real_query_nonblocking(mysql, sql.data(), sql.size());
+        if (status == NET_ASYNC_NOT_READY) {
+            watch(slot, kWaitRead | kWaitTimeout);
+            return;
+        }
+        if (status == NET_ASYNC_ERROR) {
+            complete(slot, false);
+            return;
+        }
+        slot.stage = Slot::Stage::STORE;
+    }
+    net_async_status status = mysql_store_result_nonblocking(mysql, &slot.rows);
+    if (status == NET_ASYNC_NOT_READY) {
+        watch(slot, kWaitRead | kWaitTimeout);
+        return;
+    }
+    complete(slot, status != NET_ASYNC_ERROR && (slot.rows != nullptr || mysql_field_count(mysql) == 0));
+#else
+    (void)readyEvents;
+    bool ok = mysql_real_query(mysql, sql.data(), sql.size()) == 0;
+    if (ok) {
+        slot.rows = mysql_store_result(mysql);
+        ok = slot.rows != nullptr || mysql_field_count(mysql) == 0;
+    }
+    complete(slot, ok);
+#endif
+}
+
+void AsyncQueryExecutor::watch(Slot& slot, int waitEvents) {
+    epoll_event event{};
+    if (waitEvents & kWaitRead) event.events |= EPOLLIN;
+    if (waitEvents & kWaitWrite) event.events |= EPOLLOUT;
+    if (waitEvents & kWaitExcept) event.events |= EPOLLPRI;
+    event.data.u64 = slot.index;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, slot.fd, &event);
+
+    slot.deadline = Clock::time_point::max();
+    if (waitEvents & kWaitTimeout) {
+#if defined(ASYNC_QUERY_MARIADB_API)
+        auto timeout = std::chrono::seconds(mysql_get_timeout_value(slot.connection->getConnection()));
+#elif defined(ASYNC_QUERY_MYSQL_API)
+        auto timeout = std::chrono::milliseconds(kRetryIntervalMs);
+#else
+        auto timeout = std::chrono::milliseconds(0);
+#endif
+        slot.deadline = Clock::now() + timeout;
+    }
+}
+
+void AsyncQueryExecutor::complete(Slot& slot, bool ok) {
+    MYSQL* mysql = slot.connection->getConnection();
+
+    Result result;
+    result.ok = ok;
+    if (ok) {
+        result.rows = slot.rows;
+        result.affectedRows = mysql_affected_rows(mysql);
+        result.insertId = mysql_insert_id(mysql);
+    } else {
+        result.error = mysql ? mysql_error(mysql) : "连接不可用";
+        if (slot.rows) mysql_free_result(slot.rows);
+        if (slot.fd >= 0 && mysql && isConnectionLost(mysql_errno(mysql))) {
+            epoll_ctl(epollFd, EPOLL_CTL_DEL, slot.fd, nullptr);
+            slot.fd = -1;
+        }
+    }
+
+    if (slot.fd >= 0) {
+        watch(slot, 0);
+    }
+    slot.deadline = Clock::time_point::max();
+    slot.rows = nullptr;
+    slot.busy = false;
+    Request request = std::move(slot.request);
+    idleSlots.push_back(&slot);
+
+    try {
+        request.callback(result);
+    } catch (const std::exception& e) {
+        std::cerr << "异步查询回调异常: " << e.what() << std::endl;
+    }
+}
@@ -0,0 +1,201 @@
+#include "BloomFilter.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+namespace {
+const char kFileMagic[4] = {'H', 'B', 'F', '1'};
+const size_t kMinBits = 1 << 16;
+}
+
+BloomFilter::BloomFilter(size_t expectedItems, double falsePositiveRate) {
+    if (expectedItems == 0) expectedItems = 1;
+    if (falsePositiveRate <= 0.0 || falsePositiveRate >= 1.0) falsePositiveRate = 0.01;
+
+    // m = -n*ln(p)/(ln2)^2, k = m/n*ln2
+    const double ln2 = std::log(2.0);
+    double m = -static_cast<double>(expectedItems) * std::log(falsePositiveRate) / (ln2 * ln2);
+    size_t numBits = std::max(kMinBits, static_cast<size_t>(m));
+    unsigned int numHashes = static_cast<unsigned int>(
+        std::round(static_cast<double>(numBits) / expectedItems * ln2));
+    numHashes = std::min(16u, std::max(1u, numHashes));
+
+    initialize(numBits, numHashes);
+}
+
+void BloomFilter::initialize(size_t numBits, unsigned int numHashes) {
+    size_t words = (numBits + 63) / 64;
+    bits = std::vector<std::atomic<uint64_t>>(words);
+    bitCount = words * 64;
+    hashCount = numHashes;
+}
+
+uint64_t BloomFilter::hashKey(const std::string& key, uint64_t seed) {
+    // FNV-1a + splitmix64终结混合
+    uint64_t h = 1469598103934665603ULL ^ seed;
+    for (unsigned char c : key) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    h += 0x9e3779b97f4a7c15ULL;
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+    return h ^ (h >> 31);
+}
+
+void BloomFilter::add(const std::string& key) {
+    // 双重哈希：g_i = h1 + i*h2
+    uint64_t h1 = hashKey(key, 0);
+    uint64_t h2 = hashKey(key, 0x5bd1e995ULL) | 1;
+    for (unsigned int i = 0; i < hashCount; ++i) {
+        uint64_t bit = (h1 + i * h2) % bitCount;
+        bits[bit / 64].fetch_or(1ULL << (bit % 64), std::memory_order_relaxed);
+    }
+}
+
+bool BloomFilter::mightContain(const std::string& key) {
+    queries.fetch_add(1, std::memory_order_relaxed);
+    uint64_t h1 = hashKey(key, 0);
+    uint64_t h2 = hashKey(key, 0x5bd1e995ULL) | 1;
+    for (unsigned int i = 0; i < hashCount; ++i) {
+        uint64_t bit = (h1 + i * h2) % bitCount;
+        if (!(bits[bit / 64].load(std::memory_order_relaxed) & (1ULL << (bit % 64)))) {
+            definiteNegatives.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    return true;
+}
+
+BloomFilter::Stats BloomFilter::getStats() const {
+    Stats stats;
+    stats.queries = queries.load(std::memory_order_relaxed);
+    stats.definiteNegatives = definiteNegatives.load(std::memory_order_relaxed);
+    stats.maybes = stats.queries - stats.definiteNegatives;
+    stats.falsePositives = falsePositives.load(std::memory_order_relaxed);
+    return stats;
+}
+
+double BloomFilter::getFalsePositiveRate() const {
+    // 误判率 = 误判次数 / 实际不存在的查询次数
+    Stats stats = getStats();
+    uint64_t negatives = stats.definiteNegatives + stats.falsePositives;
+    if (negatives == 0) return 0.0;
+    return static_cast<double>(stats.falsePositives) / negatives;
+}
+
+bool BloomFilter::saveToFile(const std::string& filePath, uint64_t userWatermark, uint64_t patientWatermark) const {
+    // 排他锁串行化各进程的"读-合并-写"，否则后写者会覆盖先写者纳入的键
+    std::string lockPath = filePath + ".lock";
+    int lockFd = ::open(lockPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (lockFd < 0) return false;
+    if (::flock(lockFd, LOCK_EX) != 0) {
+        ::close(lockFd);
+        return false;
+    }
+
+    std::vector<uint64_t> words(bits.size());
+    for (size_t i = 0; i < bits.size(); ++i) {
+        words[i] = bits[i].load(std::memory_order_relaxed);
+    }
+
+    // 合并文件中已有的同规格过滤器；水位线取较小值，增量加载会补齐两者之间的行
+    uint64_t savedBits = 0, savedUserMark = 0, savedPatientMark = 0;
+    uint32_t savedHashes = 0;
+    std::vector<uint64_t> existing;
+    if (readFile(filePath, savedBits, savedHashes, savedUserMark, savedPatientMark, existing) &&
+        savedBits == bitCount && savedHashes == hashCount) {
+        for (size_t i = 0; i < words.size(); ++i) {
+            words[i] |= existing[i];
+        }
+        userWatermark = std::min(userWatermark, savedUserMark);
+        patientWatermark = std::min(patientWatermark, savedPatientMark);
+    }
+
+    // 先写临时文件再重命名，避免并发读取到半写状态
+    std::string tmpPath = filePath + ".tmp";
+    std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+    bool written = file.is_open();
+    if (written) {
+        uint64_t numBits = bitCount;
+        uint32_t numHashes = hashCount;
+        file.write(kFileMagic, sizeof(kFileMagic));
+        file.write(reinterpret_cast<const char*>(&numBits), sizeof(numBits));
+        file.write(reinterpret_cast<const char*>(&numHashes), sizeof(numHashes));
+        file.write(reinterpret_cast<const char*>(&userWatermark), sizeof(userWatermark));
+        file.write(reinterpret_cast<const char*>(&patientWatermark), sizeof(patientWatermark));
+        file.write(reinterpret_cast<const char*>(words.data()), words.size() * sizeof(uint64_t));
+        file.close();
+        written = file && std::rename(tmpPath.c_str(), filePath.c_str()) == 0;
+    }
+
+    ::flock(lockFd, LOCK_UN);
+    ::close(lockFd);
+    return written;
+}
+
+bool BloomFilter::readFile(const std::string& filePath, uint64_t& numBits, uint32_t& numHashes,
+                           uint64_t& userWatermark, uint64_t& patientWatermark, std::vector<uint64_t>& words) {
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    char magic[4];
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&numBits), sizeof(numBits));
+    file.read(reinterpret_cast<char*>(&numHashes), sizeof(numHashes));
+    file.read(reinterpret_cast<char*>(&userWatermark), sizeof(userWatermark));
+    file.read(reinterpret_cast<char*>(&patientWatermark), sizeof(patientWatermark));
+    if (!file || std::memcmp(magic, kFileMagic, sizeof(magic)) != 0 ||
+        numBits == 0 || numBits % 64 != 0 || numHashes == 0 || numHashes > 16) {
+        return false;
+    }
+
+    // 位图长度必须与文件剩余字节数一致，损坏或截断的头部不会触发超大分配
+    std::streampos headerEnd = file.tellg();
+    file.seekg(0, std::ios::end);
+    std::streamoff payload = file.tellg() - headerEnd;
+    if (!file || payload < 0 || static_cast<uint64_t>(payload) != numBits / 8) {
+        return false;
+    }
+    file.seekg(headerEnd);
+
+    words.resize(numBits / 64);
+    file.read(reinterpret_cast<char*>(words.data()), words.size() * sizeof(uint64_t));
+    return static_cast<bool>(file);
+}
+
+bool BloomFilter::loadFromFile(const std::string& filePath, uint64_t& userWatermark, uint64_t& patientWatermark) {
+    uint64_t numBits = 0;
+    uint32_t numHashes = 0;
+    uint64_t userMark = 0, patientMark = 0;
+    std::vector<uint64_t> words;
+    if (!readFile(filePath, numBits, numHashes, userMark, patientMark, words)) return false;
+
+    initialize(numBits, numHashes);
+    for (size_t i = 0; i < words.size(); ++i) {
+        bits[i].store(words[i], std::memory_order_relaxed);
+    }
+    userWatermark = userMark;
+    patientWatermark = patientMark;
+    return true;
+}
+
+bool BloomFilter::normalizeKey(const std::string& prefix, const std::string& value, std::string& key) {
+    size_t end = value.find_last_not_of(' ');
+    size_t length = (end == std::string::npos) ? 0 : end + 1;
+
+    key.clear();
+    key.reserve(prefix.size() + length);
+    key += prefix;
+    for (size_t i = 0; i < length; ++i) {
+        unsigned char c = static_cast<unsigned char>(value[i]);
+        if (c >= 0x80) return false;
+        key += static_cast<char>((c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c);
+    }
+    return true;
+}
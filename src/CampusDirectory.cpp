@@ -0,0 +1,87 @@
+#include "CampusDirectory.h"
+#include "ShardMap.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+namespace {
+
+bool isValidCampusId(const std::string& id) {
+    return !id.empty() && std::all_of(id.begin(), id.end(), [](unsigned char c) {
+        return std::isalnum(c) || c == '-' || c == '_';
+    });
+}
+
+}
+
+bool CampusSpec::parse(const std::string& text, CampusSpec& spec) {
+    size_t equals = text.find('=');
+    if (equals == std::string::npos) return false;
+    spec.id = text.substr(0, equals);
+
+    std::string location = text.substr(equals + 1);
+    spec.weight = 1.0;
+    size_t at = location.rfind('@');
+    if (at != std::string::npos) {
+        char* end = nullptr;
+        spec.weight = std::strtod(location.c_str() + at + 1, &end);
+        if (*end != '\0' || !(spec.weight > 0)) return false;
+        location.resize(at);
+    }
+
+    // 与分片映射相同的"主机[:端口]/数据库"格式
+    ShardLocation parsed;
+    if (!isValidCampusId(spec.id) || !ShardLocation::parse(location, parsed)) return false;
+    spec.host = parsed.host;
+    spec.port = parsed.port;
+    spec.database = parsed.database;
+    return true;
+}
+
+CampusDirectory::CampusDirectory(std::shared_ptr<ConnectionBudget> budget) : budget(std::move(budget)) {}
+
+std::shared_ptr<CampusDirectory> CampusDirectory::single(std::shared_ptr<HospitalService> service) {
+    auto directory = std::make_shared<CampusDirectory>();
+    directory->campuses.push_back({"", std::move(service), 1.0});
+    return directory;
+}
+
+std::shared_ptr<CampusDirectory> CampusDirectory::connect(const std::vector<CampusSpec>& specs, const std::string& username,
+                                                          const std::string& password, size_t budget) {
+    auto shared = std::make_shared<ConnectionBudget>(std::max(budget, specs.size()));
+    auto directory = std::make_shared<CampusDirectory>(shared);
+    size_t reserved = reservedConnections(shared->getLimit(), specs.size());
+    for (const auto& spec : specs) {
+        auto service = std::make_shared<HospitalService>(spec.host, username, password, spec.database, spec.port,
+                                                         reserved, shared);
+        if (!directory->add(spec.id, std::move(service), spec.weight)) {
+            return nullptr;
+        }
+    }
+    return directory;
+}
+
+bool CampusDirectory::add(const std::string& id, std::shared_ptr<HospitalService> service, double weight) {
+    if (!isValidCampusId(id) || find(id) || (!campuses.empty() && !isMultiCampus())) {
+        return false;
+    }
+    campuses.push_back({id, std::move(service), weight});
+    return true;
+}
+
+const CampusDirectory::Campus* CampusDirectory::find(const std::string& id) const {
+    for (const auto& campus : campuses) {
+        if (campus.id == id) return &campus;
+    }
+    return nullptr;
+}
+
+void CampusDirectory::useWorkerPool(std::shared_ptr<ThreadPool> pool) {
+    for (const auto& campus : campuses) {
+        campus.service->useWorkerPool(pool);
+    }
+}
+
+size_t CampusDirectory::reservedConnections(size_t budget, size_t campusCount) {
+    return std::max<size_t>(1, budget / (2 * std::max<size_t>(1, campusCount)));
+}
@@ -28,7 +28,7 @@ bool CaseDAO::createCase(const Case& medicalCase) {
 }
 
 std::unique_ptr<Case> CaseDAO::getCaseById(int caseId) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     if (!conn) return nullptr;
     
     std::stringstream query;
@@ -55,7 +55,7 @@ std::unique_ptr<Case> CaseDAO::getCaseById(int caseId) {
 }
 
 std::vector<std::unique_ptr<Case>> CaseDAO::getCasesByPatientId(int patientId) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<Case>> cases;
     if (!conn) return cases;
     
@@ -81,7 +81,7 @@ std::vector<std::unique_ptr<Case>> CaseDAO::getCasesByPatientId(int patientId) {
 }
 
 std::vector<std::unique_ptr<Case>> CaseDAO::getCasesByDoctorId(int doctorId) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<Case>> cases;
     if (!conn) return cases;
     
@@ -107,7 +107,7 @@ std::vector<std::unique_ptr<Case>> CaseDAO::getCasesByDoctorId(int doctorId) {
 }
 
 std::vector<std::unique_ptr<Case>> CaseDAO::getCasesByDepartment(const std::string& department) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<Case>> cases;
     if (!conn) return cases;
     
@@ -134,7 +134,7 @@ std::vector<std::unique_ptr<Case>> CaseDAO::getCasesByDepartment(const std::stri
 }
 
 std::vector<std::unique_ptr<Case>> CaseDAO::getAllCases() {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<Case>> cases;
     if (!conn) return cases;
     
@@ -188,7 +188,7 @@ bool CaseDAO::deleteCase(int caseId) {
 }
 
 std::vector<std::unique_ptr<Case>> CaseDAO::searchCases(const std::string& searchTerm) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<Case>> cases;
     if (!conn) return cases;
     
@@ -216,29 +216,13 @@ std::vector<std::unique_ptr<Case>> CaseDAO::searchCases(const std::string& searc
 }
 
 int CaseDAO::getCaseCount() {
-    auto conn = connectionPool->getConnection();
-    if (!conn) return 0;
-    
-    std::string query = "SELECT COUNT(*) FROM cases";
-    MYSQL_RES* result = conn->executeQuery(query);
-    if (!result) {
-        connectionPool->returnConnection(std::move(conn));
-        return 0;
-    }
-    
-    MYSQL_ROW row = mysql_fetch_row(result);
-    int count = 0;
-    if (row && row[0]) {
-        count = std::stoi(row[0]);
-    }
-    
-    mysql_free_result(result);
-    connectionPool->returnConnection(std::move(conn));
-    return count;
+    auto result = connectionPool->executeCachedQuery("SELECT COUNT(*) FROM cases");
+    if (!result || result->rowCount() == 0 || !result->get(0, 0)) return 0;
+    return std::stoi(*result->get(0, 0));
 }
 
 int CaseDAO::getCaseCountByDoctor(int doctorId) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     if (!conn) return 0;
     
     std::stringstream query;
@@ -262,7 +246,7 @@ int CaseDAO::getCaseCountByDoctor(int doctorId) {
 }
 
 int CaseDAO::getCaseCountByPatient(int patientId) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     if (!conn) return 0;
     
     std::stringstream query;
@@ -0,0 +1,79 @@
+#include "CircuitBreaker.h"
+
+bool CircuitBreaker::allow() {
+    if (state.load(std::memory_order_acquire) == State::CLOSED) {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    State current = state.load(std::memory_order_relaxed);
+    if (current == State::CLOSED) {
+        return true;
+    }
+    // A probe that never reported back is replaced after another openDuration
+    Clock::time_point now = Clock::now();
+    if (now - openedAt >= config.openDuration) {
+        state.store(State::HALF_OPEN, std::memory_order_release);
+        openedAt = now;
+        return true;
+    }
+    rejected.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+bool CircuitBreaker::isOpen() const {
+    if (state.load(std::memory_order_acquire) == State::CLOSED) return false;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    return state.load(std::memory_order_relaxed) != State::CLOSED && Clock::now() - openedAt < config.openDuration;
+}
+
+void CircuitBreaker::recordSuccess() {
+    // Common case: nothing to reset, no lock
+    if (state.load(std::memory_order_acquire) == State::CLOSED &&
+        consecutiveFailures.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    consecutiveFailures.store(0, std::memory_order_relaxed);
+    state.store(State::CLOSED, std::memory_order_release);
+}
+
+void CircuitBreaker::recordFailure() {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t failures = consecutiveFailures.fetch_add(1, std::memory_order_relaxed) + 1;
+    State current = state.load(std::memory_order_relaxed);
+    // A failed probe reopens at once; a late failure from before opening does not extend it
+    if (current == State::HALF_OPEN || (current == State::CLOSED && failures >= config.failureThreshold)) {
+        state.store(State::OPEN, std::memory_order_release);
+        openedAt = Clock::now();
+        ++timesOpened;
+    }
+}
+
+int64_t CircuitBreaker::getRetryAfterMs() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (state.load(std::memory_order_relaxed) != State::OPEN) return 0;
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(openedAt + config.openDuration - Clock::now());
+    return remaining.count() > 0 ? remaining.count() : 0;
+}
+
+CircuitBreaker::Stats CircuitBreaker::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats stats;
+    stats.state = state.load(std::memory_order_relaxed);
+    stats.consecutiveFailures = consecutiveFailures.load(std::memory_order_relaxed);
+    stats.timesOpened = timesOpened;
+    stats.rejected = rejected.load(std::memory_order_relaxed);
+    return stats;
+}
+
+const char* CircuitBreaker::stateName(State state) {
+    switch (state) {
+        case State::CLOSED: return "closed";
+        case State::OPEN: return "open";
+        case State::HALF_OPEN: return "half-open";
+    }
+    return "unknown";
+}
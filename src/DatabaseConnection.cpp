@@ -1,6 +1,67 @@
 #include "DatabaseConnection.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <stdexcept>
+#include <thread>
+#include <strings.h>
+
+namespace {
+
+// Server errors for a statement stopped by its execution time limit
+const unsigned int kMySqlQueryTimeout = 3024;        // ER_QUERY_TIMEOUT
+const unsigned int kMariaDbStatementTimeout = 1969;  // ER_STATEMENT_TIMEOUT
+// Client errors after which the connection is unusable
+const unsigned int kConnectError = 2003;     // CR_CONN_HOST_ERROR
+const unsigned int kServerGone = 2006;       // CR_SERVER_GONE_ERROR
+const unsigned int kServerLost = 2013;       // CR_SERVER_LOST
+// A row with the same UNIQUE or PRIMARY KEY value exists
+const unsigned int kDuplicateEntry = 1062;   // ER_DUP_ENTRY
+
+// Offset of the SELECT keyword, or npos for other statements
+size_t selectKeyword(const std::string& statement) {
+    size_t start = statement.find_first_not_of(" \t\r\n");
+    if (start == std::string::npos || statement.size() - start < 6 ||
+        strncasecmp(statement.c_str() + start, "SELECT", 6) != 0) {
+        return std::string::npos;
+    }
+    return start;
+}
+
+// Statements EXPLAIN accepts
+bool isExplainable(const std::string& statement) {
+    size_t start = statement.find_first_not_of(" \t\r\n");
+    if (start == std::string::npos) return false;
+    for (const char* keyword : {"SELECT", "UPDATE", "DELETE", "INSERT", "REPLACE"}) {
+        size_t length = std::strlen(keyword);
+        if (statement.size() - start > length && strncasecmp(statement.c_str() + start, keyword, length) == 0 &&
+            std::isspace(static_cast<unsigned char>(statement[start + length]))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Fault injection can be switched on for any binary through the environment
+std::shared_ptr<FaultInjector> loadFaultInjector() {
+    std::string error;
+    auto injector = FaultInjector::fromEnvironment(error);
+    if (!error.empty()) {
+        std::cerr << "Ignoring database fault rules: " << error << std::endl;
+    } else if (injector) {
+        std::cerr << "Database fault injection enabled: " << injector->ruleCount() << " rules" << std::endl;
+    }
+    return injector;
+}
+
+}
+
+DatabaseConnection::Timeouts DatabaseConnection::defaultTimeouts;
+std::shared_ptr<FaultInjector> DatabaseConnection::faultInjector = loadFaultInjector();
+std::shared_ptr<SlowQueryLog> DatabaseConnection::slowQueryLog;
+QueryCache::Config ConnectionPool::defaultQueryCache;
 
 DatabaseConnection::DatabaseConnection(const std::string& host, const std::string& username,
                                      const std::string& password, const std::string& database,
@@ -14,9 +75,22 @@ DatabaseConnection::DatabaseConnection(const std::string& host, const std::strin
 
 DatabaseConnection::~DatabaseConnection() {
     disconnect();
+    if (budget) {
+        budget->release();
+    }
+    if (liveCount) {
+        liveCount->fetch_sub(1, std::memory_order_relaxed);
+    }
 }
 
 bool DatabaseConnection::connect() {
+    if (breaker && !breaker->allow()) {
+        return false;
+    }
+    return establish();
+}
+
+bool DatabaseConnection::establish() {
     if (!connection) {
         connection = mysql_init(nullptr);
         if (!connection) {
@@ -24,16 +98,57 @@ bool DatabaseConnection::connect() {
         }
     }
     
-    bool reconnect = true;
-    mysql_options(connection, MYSQL_OPT_RECONNECT, &reconnect);
+    // No MYSQL_OPT_RECONNECT: a client-side reconnect inside mysql_ping or a
+    // query would skip the breaker and fault injection and silently drop an
+    // open transaction; ensureConnected() does every reconnect instead
     mysql_options(connection, MYSQL_SET_CHARSET_NAME, "utf8mb4");
+    if (!initCommand.empty()) {
+        mysql_options(connection, MYSQL_INIT_COMMAND, initCommand.c_str());
+    }
+#ifdef MYSQL_WAIT_READ
+    if (nonBlocking) {
+        mysql_options(connection, MYSQL_OPT_NONBLOCK, nullptr);
+    }
+#endif
+    if (defaultTimeouts.connectSeconds) {
+        mysql_options(connection, MYSQL_OPT_CONNECT_TIMEOUT, &defaultTimeouts.connectSeconds);
+    }
+    if (defaultTimeouts.readSeconds) {
+        mysql_options(connection, MYSQL_OPT_READ_TIMEOUT, &defaultTimeouts.readSeconds);
+    }
+    if (defaultTimeouts.writeSeconds) {
+        mysql_options(connection, MYSQL_OPT_WRITE_TIMEOUT, &defaultTimeouts.writeSeconds);
+    }
     
-    if (!mysql_real_connect(connection, host.c_str(), username.c_str(),
-                           password.c_str(), database.c_str(), port, nullptr, 0)) {
+    injectedError = 0;
+    if (faultInjector) {
+        FaultInjector::Fault fault = faultInjector->onConnect();
+        // A connect slower than the connect timeout fails like an unreachable host
+        std::chrono::milliseconds limit = std::chrono::seconds(defaultTimeouts.connectSeconds);
+        if (defaultTimeouts.connectSeconds && fault.delay >= limit) {
+            fault.delay = limit;
+            fault.errorCode = kConnectError;
+        }
+        std::this_thread::sleep_for(fault.delay);
+        if (fault.errorCode) {
+            injectedError = fault.errorCode;
+            std::cerr << "Connection failed: " << getError() << std::endl;
+            if (breaker) breaker->recordFailure();
+            return false;
+        }
+    }
+    
+    // Only the pool's dedicated executeMultiQuery connections accept stacked statements
+    if (!mysql_real_connect(connection, host.c_str(), username.c_str(), password.c_str(), database.c_str(),
+                           port, nullptr, multiStatements ? CLIENT_MULTI_STATEMENTS : 0)) {
         std::cerr << "Connection failed: " << mysql_error(connection) << std::endl;
+        if (breaker) breaker->recordFailure();
         return false;
     }
+    if (breaker) breaker->recordSuccess();
     
+    const char* serverInfo = mysql_get_server_info(connection);
+    mariaDb = serverInfo && std::strstr(serverInfo, "MariaDB") != nullptr;
     return true;
 }
 
@@ -54,36 +169,332 @@ bool DatabaseConnection::reconnect() {
     return connect();
 }
 
-MYSQL_RES* DatabaseConnection::executeQuery(const std::string& query) {
-    if (!connection || !isConnected()) {
-        if (!reconnect()) {
-            return nullptr;
+bool DatabaseConnection::ensureConnected() {
+    // While open, fail before pinging a server known to be down; when a probe
+    // is due this call is the probe, and its statement's outcome settles it
+    if (breaker && !breaker->allow()) {
+        return false;
+    }
+    if (connection && !dropped && isConnected()) {
+        return true;
+    }
+    dropped = false;
+    disconnect();
+    return establish();
+}
+
+void DatabaseConnection::recordOutcome() {
+    if (!breaker) return;
+    // Client errors (CR_*, 2000-2999) mean the server was not reached; any
+    // answer from the server, errors included, shows it is up
+    unsigned int error = lastErrno();
+    if (error >= 2000 && error < 3000) {
+        breaker->recordFailure();
+    } else {
+        breaker->recordSuccess();
+    }
+}
+
+int DatabaseConnection::runStatement(const std::string& statement, const std::string& sent) {
+    injectedError = 0;
+    FaultInjector::Fault fault;
+    if (faultInjector) {
+        fault = faultInjector->onStatement(statement);
+        // The server stops a SELECT when the deadline passes, however slow it was going to be
+        RequestDeadline* deadline = RequestDeadline::current();
+        if (deadline && selectKeyword(statement) != std::string::npos &&
+            fault.delay.count() >= deadline->remainingMs()) {
+            fault.delay = std::chrono::milliseconds(deadline->remainingMs());
+            fault.errorCode = mariaDb ? kMariaDbStatementTimeout : kMySqlQueryTimeout;
         }
+        std::this_thread::sleep_for(fault.delay);
+    }
+    
+    int status = 1;
+    if (fault.errorCode) {
+        injectedError = fault.errorCode;
+        // The client loses the connection on these, so the next call reconnects
+        dropped = injectedError == kServerGone || injectedError == kServerLost;
+    } else {
+        status = mysql_query(connection, sent.c_str());
+    }
+    recordOutcome();
+    return status;
+}
+
+void DatabaseConnection::recordIfSlow(const std::string& statement, std::chrono::steady_clock::time_point started,
+                                      int64_t rows, const void* caller, bool explain) {
+    if (!slowQueryLog) return;
+    auto elapsed = std::chrono::steady_clock::now() - started;
+    if (!slowQueryLog->isSlow(elapsed)) return;
+    
+    SlowQueryLog::Entry entry;
+    entry.statement = SlowQueryLog::normalize(statement);
+    entry.duration = std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
+    entry.rows = rows;
+    entry.caller = SlowQueryLog::describeCaller(caller);
+    entry.error = lastErrno();
+    // The plan comes from this connection, so only after it finished the statement
+    // normally or was stopped by the server for its deadline
+    bool completed = entry.error == 0 || entry.error == kMySqlQueryTimeout || entry.error == kMariaDbStatementTimeout;
+    if (explain && completed && isExplainable(statement) && slowQueryLog->claimExplain(entry.statement)) {
+        entry.plan = explainPlan(statement);
+    }
+    slowQueryLog->record(entry);
+}
+
+std::string DatabaseConnection::explainPlan(const std::string& statement) {
+    std::string plan;
+    std::string explain = "EXPLAIN FORMAT=JSON " + statement;
+    if (mysql_query(connection, explain.c_str()) != 0) {
+        return plan;
+    }
+    MYSQL_RES* result = mysql_store_result(connection);
+    if (!result) {
+        return plan;
+    }
+    MYSQL_ROW row = mysql_fetch_row(result);
+    if (row && row[0]) {
+        plan = row[0];
+    }
+    mysql_free_result(result);
+    return plan;
+}
+
+unsigned int DatabaseConnection::lastErrno() {
+    return injectedError ? injectedError : mysql_errno(connection);
+}
+
+bool DatabaseConnection::applyDeadline(const std::string& statement, std::string& bounded,
+                                       RequestDeadline* deadline) {
+    if (!deadline) {
+        bounded = statement;
+        return true;
+    }
+    if (deadline->expired()) {
+        deadline->markExceeded();
+        return false;
     }
     
-    if (mysql_query(connection, query.c_str()) != 0) {
-        std::cerr << "Query failed: " << mysql_error(connection) << std::endl;
+    // Only SELECTs are limited: a write is never cut off halfway through a request
+    size_t keyword = selectKeyword(statement);
+    if (keyword == std::string::npos) {
+        bounded = statement;
+        return true;
+    }
+    
+    int64_t remainingMs = deadline->remainingMs();
+    if (mariaDb) {
+        char seconds[32];
+        std::snprintf(seconds, sizeof(seconds), "%.3f", remainingMs / 1000.0);
+        bounded = "SET STATEMENT max_statement_time=" + std::string(seconds) + " FOR " + statement;
+    } else {
+        bounded.assign(statement, 0, keyword + 6);
+        bounded += " /*+ MAX_EXECUTION_TIME(" + std::to_string(remainingMs) + ") */";
+        bounded.append(statement, keyword + 6, std::string::npos);
+    }
+    return true;
+}
+
+void DatabaseConnection::checkDeadlineError() {
+    RequestDeadline* deadline = RequestDeadline::current();
+    unsigned int error = lastErrno();
+    if (deadline && (error == kMySqlQueryTimeout || error == kMariaDbStatementTimeout)) {
+        deadline->markExceeded();
+    }
+}
+
+MYSQL_RES* DatabaseConnection::executeQuery(const std::string& query) {
+    return runQuery(query, __builtin_return_address(0));
+}
+
+std::shared_ptr<QueryCache::Result> DatabaseConnection::executeResultQuery(const std::string& query, const void* caller) {
+    MYSQL_RES* result = runQuery(query, caller ? caller : __builtin_return_address(0));
+    if (!result) {
         return nullptr;
     }
     
-    return mysql_store_result(connection);
+    auto rows = std::make_shared<QueryCache::Result>(mysql_num_fields(result));
+    while (MYSQL_ROW row = mysql_fetch_row(result)) {
+        rows->addRow(row, mysql_fetch_lengths(result));
+    }
+    mysql_free_result(result);
+    return rows;
 }
 
-bool DatabaseConnection::executeUpdate(const std::string& query) {
-    if (!connection || !isConnected()) {
-        if (!reconnect()) {
-            return false;
+MYSQL_RES* DatabaseConnection::runQuery(const std::string& query, const void* caller) {
+    std::string bounded;
+    if (!applyDeadline(query, bounded)) {
+        return nullptr;
+    }
+    
+    if (!ensureConnected()) {
+        return nullptr;
+    }
+    
+    auto started = std::chrono::steady_clock::now();
+    int status = runStatement(query, bounded);
+    if (status != 0) {
+        std::cerr << "Query failed: " << getError() << std::endl;
+        checkDeadlineError();
+        recordIfSlow(query, started, -1, caller, true);
+        return nullptr;
+    }
+    
+    MYSQL_RES* result = mysql_store_result(connection);
+    if (!result) {
+        checkDeadlineError();
+    }
+    recordIfSlow(query, started, result ? static_cast<int64_t>(mysql_num_rows(result)) : -1, caller, true);
+    return result;
+}
+
+// 逐行流式读取结果（mysql_use_result），用于大表全列扫描，避免整表缓存在客户端
+// 调用方必须读完所有行并释放结果后才能在该连接上执行其他语句
+MYSQL_RES* DatabaseConnection::executeStreamingQuery(const std::string& query) {
+    const void* caller = __builtin_return_address(0);
+    std::string bounded;
+    if (!applyDeadline(query, bounded)) {
+        return nullptr;
+    }
+    
+    if (!ensureConnected()) {
+        return nullptr;
+    }
+    
+    // Only the time to the first row is known here, and the unread rows block an EXPLAIN
+    auto started = std::chrono::steady_clock::now();
+    int status = runStatement(query, bounded);
+    if (status != 0) {
+        std::cerr << "Query failed: " << getError() << std::endl;
+        checkDeadlineError();
+        recordIfSlow(query, started, -1, caller, false);
+        return nullptr;
+    }
+    
+    MYSQL_RES* result = mysql_use_result(connection);
+    recordIfSlow(query, started, -1, caller, false);
+    return result;
+}
+
+std::vector<MYSQL_RES*> DatabaseConnection::executeMultiQuery(const std::vector<std::string>& statements) {
+    const void* caller = __builtin_return_address(0);
+    std::vector<MYSQL_RES*> results;
+    if (statements.empty()) return results;
+    if (statements.size() > 1 && !multiStatements) {
+        std::cerr << "Multi-statement query on a connection not opened for it" << std::endl;
+        return results;
+    }
+    
+    if (!ensureConnected()) {
+        return results;
+    }
+    
+    std::string query;
+    std::string bounded;
+    for (const auto& statement : statements) {
+        if (!applyDeadline(statement, bounded)) {
+            return results;
         }
+        if (!query.empty()) query += "; ";
+        query += bounded;
     }
     
-    if (mysql_query(connection, query.c_str()) != 0) {
-        std::cerr << "Update failed: " << mysql_error(connection) << std::endl;
+    // EXPLAIN takes one statement, so batches are logged without a plan
+    auto started = std::chrono::steady_clock::now();
+    int queryStatus = runStatement(query, query);
+    if (queryStatus != 0) {
+        std::cerr << "Query failed: " << getError() << std::endl;
+        checkDeadlineError();
+        recordIfSlow(query, started, -1, caller, false);
+        return results;
+    }
+    
+    results.reserve(statements.size());
+    bool failed = false;
+    int status = 0;
+    int64_t rows = 0;
+    do {
+        // Keep draining after a failure so the connection is usable again
+        MYSQL_RES* result = mysql_store_result(connection);
+        if (!result && mysql_field_count(connection) != 0) {
+            failed = true;
+        }
+        if (result) rows += static_cast<int64_t>(mysql_num_rows(result));
+        results.push_back(result);
+        status = mysql_next_result(connection);
+    } while (status == 0);
+    
+    if (status > 0 || failed || results.size() != statements.size()) {
+        std::cerr << "Multi-statement query failed: " << mysql_error(connection) << std::endl;
+        checkDeadlineError();
+        freeResults(results);
+        rows = -1;
+    }
+    recordIfSlow(query, started, rows, caller, false);
+    return results;
+}
+
+void DatabaseConnection::freeResults(std::vector<MYSQL_RES*>& results) {
+    for (MYSQL_RES* result : results) {
+        if (result) mysql_free_result(result);
+    }
+    results.clear();
+}
+
+bool DatabaseConnection::executeUpdate(const std::string& query) {
+    const void* caller = __builtin_return_address(0);
+    // Writes are not time-limited, but a request whose reads were cut off may be
+    // acting on incomplete data (e.g. a skipped existence check), so it writes nothing further
+    RequestDeadline* deadline = RequestDeadline::current();
+    if (deadline && deadline->wasExceeded() && query != "ROLLBACK") {
         return false;
     }
     
+    if (!ensureConnected()) {
+        return false;
+    }
+    
+    auto started = std::chrono::steady_clock::now();
+    int queryStatus = runStatement(query, query);
+    // Even a failed write may have changed rows (e.g. the connection dropped after commit)
+    if (queryCache) {
+        noteWrite(query);
+    }
+    if (queryStatus != 0) {
+        std::cerr << "Update failed: " << getError() << std::endl;
+        recordIfSlow(query, started, -1, caller, true);
+        return false;
+    }
+    
+    recordIfSlow(query, started, static_cast<int64_t>(mysql_affected_rows(connection)), caller, true);
     return true;
 }
 
+void DatabaseConnection::noteWrite(const std::string& statement) {
+    if (strcasecmp(statement.c_str(), "START TRANSACTION") == 0 || strcasecmp(statement.c_str(), "BEGIN") == 0) {
+        inTransaction = true;
+        return;
+    }
+    // Another connection may have cached the pre-commit contents after the
+    // statements below invalidated them, so the transaction's tables go again
+    if (strcasecmp(statement.c_str(), "COMMIT") == 0 || strcasecmp(statement.c_str(), "ROLLBACK") == 0) {
+        queryCache->invalidateTables(transactionTables);
+        transactionTables.clear();
+        inTransaction = false;
+        return;
+    }
+    
+    std::vector<std::string> tables = queryCache->writtenTables(statement);
+    queryCache->invalidateTables(tables);
+    if (!inTransaction) return;
+    for (auto& table : tables) {
+        if (std::find(transactionTables.begin(), transactionTables.end(), table) == transactionTables.end()) {
+            transactionTables.push_back(std::move(table));
+        }
+    }
+}
+
 bool DatabaseConnection::beginTransaction() {
     return executeUpdate("START TRANSACTION");
 }
@@ -99,11 +510,12 @@ bool DatabaseConnection::rollback() {
 std::string DatabaseConnection::escapeString(const std::string& str) {
     if (!connection) return str;
     
-    char* escaped = new char[str.length() * 2 + 1];
-    mysql_real_escape_string(connection, escaped, str.c_str(), str.length());
-    std::string result(escaped);
-    delete[] escaped;
-    return result;
+    // Per-thread scratch buffer: every DAO call escapes its parameters, so avoid
+    // a heap allocation per call. Connections are used by one thread at a time.
+    thread_local std::vector<char> scratch;
+    scratch.resize(str.length() * 2 + 1);
+    unsigned long length = mysql_real_escape_string(connection, scratch.data(), str.c_str(), str.length());
+    return std::string(scratch.data(), length);
 }
 
 unsigned long DatabaseConnection::getLastInsertId() {
@@ -111,7 +523,12 @@ unsigned long DatabaseConnection::getLastInsertId() {
     return mysql_insert_id(connection);
 }
 
+bool DatabaseConnection::isDuplicateKeyError() {
+    return lastErrno() == kDuplicateEntry;
+}
+
 std::string DatabaseConnection::getError() {
+    if (injectedError) return "[injected] " + FaultInjector::describe(injectedError);
     if (!connection) return "No connection";
     return std::string(mysql_error(connection));
 }
@@ -119,54 +536,170 @@ std::string DatabaseConnection::getError() {
 // ConnectionPool implementation
 ConnectionPool::ConnectionPool(const std::string& host, const std::string& username,
                               const std::string& password, const std::string& database,
-                              unsigned int port, size_t maxConnections)
-    : host(host), username(username), password(password), database(database),
-      port(port), maxConnections(maxConnections) {
+                              unsigned int port, size_t maxConnections, const std::string& initCommand,
+                              std::shared_ptr<ConnectionBudget> budget)
+    : idle(maxConnections), multiStatementIdle(std::max<size_t>(1, maxConnections / 4)),
+      maxMultiStatementConnections(std::max<size_t>(1, maxConnections / 4)), host(host), username(username),
+      password(password), database(database), port(port), maxConnections(maxConnections),
+      initCommand(initCommand), budget(std::move(budget)) {
     initializePool();
 }
 
 ConnectionPool::~ConnectionPool() {
-    std::lock_guard<std::mutex> lock(poolMutex);
-    while (!pool.empty()) {
-        pool.pop();
+    // Stop the monitor (it takes connections from this pool) before tearing down
+    if (router) {
+        router->stop();
+        router.reset();
     }
+    idle.drain([](DatabaseConnection* conn) { delete conn; });
+    multiStatementIdle.drain([](DatabaseConnection* conn) { delete conn; });
 }
 
 void ConnectionPool::initializePool() {
-    std::lock_guard<std::mutex> lock(poolMutex);
     for (size_t i = 0; i < maxConnections; ++i) {
-        auto conn = std::make_unique<DatabaseConnection>(host, username, password, database, port);
-        if (conn->connect()) {
-            pool.push(std::move(conn));
+        auto conn = createConnection();
+        if (!conn) break;
+        if (conn->connect() && idle.release(conn.get())) {
+            conn.release();
         }
     }
 }
 
+std::unique_ptr<DatabaseConnection> ConnectionPool::createConnection(bool multiStatements) {
+    if (budget && !budget->tryAcquire()) {
+        return nullptr;
+    }
+    auto conn = std::make_unique<DatabaseConnection>(host, username, password, database, port);
+    conn->setBudget(budget);
+    conn->setLiveCount(multiStatements ? liveMultiStatementConnections : liveConnections);
+    conn->setMultiStatements(multiStatements);
+    conn->setBreaker(breaker);
+    conn->setQueryCache(queryCache);
+    conn->setOrigin(this);
+    conn->setInitCommand(initCommand);
+    return conn;
+}
+
 std::unique_ptr<DatabaseConnection> ConnectionPool::getConnection() {
-    std::lock_guard<std::mutex> lock(poolMutex);
-    if (pool.empty()) {
-        auto conn = std::make_unique<DatabaseConnection>(host, username, password, database, port);
-        if (conn->connect()) {
-            return conn;
-        }
+    if (router) {
+        router->recordWrite();
+    }
+    return acquire();
+}
+
+std::unique_ptr<DatabaseConnection> ConnectionPool::getReadConnection() {
+    if (router) {
+        auto conn = router->acquireRead();
+        if (conn) return conn;
+    }
+    return acquire();
+}
+
+std::unique_ptr<DatabaseConnection> ConnectionPool::getMultiStatementConnection() {
+    if (router) {
+        auto conn = router->acquireRead(true);
+        if (conn) return conn;
+    }
+    return acquire(true);
+}
+
+std::unique_ptr<DatabaseConnection> ConnectionPool::acquire(bool multiStatements) {
+    // A request past its deadline gets no connection; its caller fails fast
+    RequestDeadline* deadline = RequestDeadline::current();
+    if (deadline && deadline->expired()) {
+        deadline->markExceeded();
         return nullptr;
     }
     
-    auto conn = std::move(pool.front());
-    pool.pop();
+    // The server is known to be down: fail at once instead of pinging and reconnecting
+    if (breaker->isOpen()) {
+        return nullptr;
+    }
     
-    if (!conn->isConnected()) {
-        conn->reconnect();
+    // Multi-statement connections are opened on first use: most pools never run a batch
+    std::unique_ptr<DatabaseConnection> conn(multiStatements ? multiStatementIdle.acquire() : idle.acquire());
+    if (!conn) {
+        // Nothing idle: open a connection (outside any lock) if the budget
+        // allows; returnConnection() keeps it unless the pool is over its size
+        conn = createConnection(multiStatements);
+        if (conn && conn->connect()) {
+            return conn;
+        }
+        return nullptr;
     }
     
+    // A connection that died while idle is reopened by ensureConnected() on its first statement
     return conn;
 }
 
+std::shared_ptr<const QueryCache::Result> ConnectionPool::executeCachedQuery(const std::string& query) {
+    const void* caller = __builtin_return_address(0);
+    if (!queryCache) {
+        auto conn = getReadConnection();
+        if (!conn) return nullptr;
+        auto result = conn->executeResultQuery(query, caller);
+        returnConnection(std::move(conn));
+        return result;
+    }
+    
+    auto cached = queryCache->lookup(query);
+    if (cached) return cached;
+    
+    // The ticket is taken before the read, so a write landing in between drops the result
+    QueryCache::Ticket ticket = queryCache->beginFill(query);
+    auto conn = acquire();
+    if (!conn) return nullptr;
+    std::shared_ptr<const QueryCache::Result> result = conn->executeResultQuery(query, caller);
+    returnConnection(std::move(conn));
+    if (result) {
+        queryCache->fill(query, ticket, result);
+    }
+    return result;
+}
+
 void ConnectionPool::returnConnection(std::unique_ptr<DatabaseConnection> conn) {
-    if (conn && conn->isConnected()) {
-        std::lock_guard<std::mutex> lock(poolMutex);
-        if (pool.size() < maxConnections) {
-            pool.push(std::move(conn));
+    if (!conn) return;
+    ConnectionPool* owner = conn->getOrigin();
+    if (owner && owner != this) {
+        owner->returnConnection(std::move(conn));
+        return;
+    }
+    // Dead and surplus connections are closed; destroying one lowers the
+    // live count, so a later acquire() opens a replacement
+    if (!conn->isConnected()) return;
+    if (conn->hasMultiStatements()) {
+        if (liveMultiStatementConnections->load(std::memory_order_relaxed) <= maxMultiStatementConnections &&
+            multiStatementIdle.release(conn.get())) {
+            conn.release();
         }
+        return;
+    }
+    if (liveConnections->load(std::memory_order_relaxed) > maxConnections) return;
+    
+    if (idle.release(conn.get())) {
+        conn.release();
     }
-}
\ No newline at end of file
+}
+std::shared_ptr<ConnectionPool> ConnectionPool::connectTo(const std::string& host, unsigned int port,
+                                                          const std::string& database, const std::string& initCommand) const {
+    return std::make_shared<ConnectionPool>(host, username, password, database, port, maxConnections, initCommand);
+}
+
+bool ConnectionPool::enableReplicas(const std::vector<ReplicaEndpoint>& endpoints, const ReplicaRouter::Policy& policy) {
+    if (router || endpoints.empty()) return false;
+    
+    std::vector<std::pair<ReplicaEndpoint, std::shared_ptr<ConnectionPool>>> replicas;
+    for (const auto& endpoint : endpoints) {
+        replicas.emplace_back(endpoint, connectTo(endpoint.host, endpoint.port, database));
+    }
+    
+    // Replicas count as unhealthy until start() has probed them, so reads stay on the primary
+    router = std::make_unique<ReplicaRouter>(*this, std::move(replicas), policy);
+    router->start();
+    return true;
+}
+
+std::vector<ReplicaRouter::ReplicaStatus> ConnectionPool::getReplicaStatus() const {
+    if (!router) return {};
+    return router->getStatus();
+}
@@ -1,7 +1,7 @@
 #include "DatabaseService.h"
+#include "Sha256.h"
 #include <iostream>
 #include <sstream>
-#include <openssl/sha.h>
 #include <iomanip>
 
 DatabaseService::DatabaseService(const std::string& host, const std::string& username,
@@ -545,17 +545,3 @@ bool DatabaseService::cleanupOldData(int daysOld) {
     
     return result;
 }
-
-std::string DatabaseService::hashPassword(const std::string& password) {
-    unsigned char hash[SHA256_DIGEST_LENGTH];
-    SHA256_CTX sha256;
-    SHA256_Init(&sha256);
-    SHA256_Update(&sha256, password.c_str(), password.length());
-    SHA256_Final(hash, &sha256);
-    
-    std::stringstream ss;
-    for (int i = 0; i < SHA256_DIGEST_LENGTH; i++) {
-        ss << std::hex << std::setw(2) << std::setfill('0') << (int)hash[i];
-    }
-    return ss.str();
-}
\ No newline at end of file
@@ -9,7 +9,56 @@ Doctor::Doctor(int userId, const std::string& name, const std::string& departmen
     : doctorId(0), userId(userId), name(name), department(department), workingHours(workingHours) {}
 
 // DoctorDAO class implementation
-DoctorDAO::DoctorDAO(std::shared_ptr<ConnectionPool> pool) : connectionPool(pool) {}
+namespace {
+
+// The department list is a single entry
+LruCache<int, std::vector<std::string>>::Config departmentCacheConfig(const DoctorDAO::CacheConfig& config) {
+    LruCache<int, std::vector<std::string>>::Config single;
+    single.capacity = config.capacity > 0 ? 1 : 0;
+    single.shards = 1;
+    single.ttl = config.ttl;
+    return single;
+}
+
+LruCache<int, int>::Config userIdCacheConfig(const DoctorDAO::CacheConfig& config) {
+    LruCache<int, int>::Config userIds;
+    userIds.capacity = config.capacity;
+    userIds.shards = config.shards;
+    userIds.ttl = config.ttl;
+    return userIds;
+}
+
+}
+
+DoctorDAO::CacheConfig DoctorDAO::cacheConfig;
+
+DoctorDAO::DoctorDAO(std::shared_ptr<ConnectionPool> pool)
+    : connectionPool(pool),
+      doctorsById(cacheConfig),
+      doctorIdsByUserId(userIdCacheConfig(cacheConfig)),
+      departmentCache(departmentCacheConfig(cacheConfig)) {}
+
+DoctorDAO::CacheStats DoctorDAO::getCacheStats() const {
+    CacheStats stats;
+    stats.byId = doctorsById.getStats();
+    stats.byUserId = doctorIdsByUserId.getStats();
+    stats.departments = departmentCache.getStats();
+    return stats;
+}
+
+void DoctorDAO::invalidateDoctor(int doctorId) {
+    doctorsById.invalidate(doctorId);
+}
+
+void DoctorDAO::invalidateDepartments() {
+    departmentCache.invalidate(0);
+}
+
+// Cache fills read from the primary: a lagging replica's row would otherwise
+// stay cached for a whole TTL after this process updated the doctor
+std::unique_ptr<DatabaseConnection> DoctorDAO::getFillConnection() {
+    return doctorsById.enabled() ? connectionPool->getPrimaryReadConnection() : connectionPool->getReadConnection();
+}
 
 bool DoctorDAO::createDoctor(const Doctor& doctor) {
     auto conn = connectionPool->getConnection();
@@ -26,11 +75,18 @@ bool DoctorDAO::createDoctor(const Doctor& doctor) {
     
     bool result = conn->executeUpdate(query.str());
     connectionPool->returnConnection(std::move(conn));
+    invalidateDepartments();
     return result;
 }
 
 std::unique_ptr<Doctor> DoctorDAO::getDoctorById(int doctorId) {
-    auto conn = connectionPool->getConnection();
+    Doctor cached;
+    if (doctorsById.get(doctorId, cached)) {
+        return std::make_unique<Doctor>(cached);
+    }
+    
+    uint64_t ticket = doctorsById.beginFill();
+    auto conn = getFillConnection();
     if (!conn) return nullptr;
     
     std::stringstream query;
@@ -49,6 +105,7 @@ std::unique_ptr<Doctor> DoctorDAO::getDoctorById(int doctorId) {
     if (row) {
         unsigned long* lengths = mysql_fetch_lengths(result);
         doctor = std::unique_ptr<Doctor>(mapRowToDoctor(row, lengths));
+        doctorsById.fill(doctorId, *doctor, ticket);
     }
     
     mysql_free_result(result);
@@ -57,26 +114,20 @@ std::unique_ptr<Doctor> DoctorDAO::getDoctorById(int doctorId) {
 }
 
 std::unique_ptr<Doctor> DoctorDAO::getDoctorByUserId(int userId) {
-    auto conn = connectionPool->getConnection();
-    if (!conn) return nullptr;
+    std::unique_ptr<Doctor> cached = getCachedDoctorByUserId(userId);
+    if (cached) return cached;
     
-    std::stringstream query;
-    query << "SELECT doctor_id, user_id, name, department, title, working_hours, profile_picture "
-          << "FROM doctors WHERE user_id = " << userId;
+    FillTicket ticket = beginUserIdFill();
+    auto conn = getFillConnection();
+    if (!conn) return nullptr;
     
-    MYSQL_RES* result = conn->executeQuery(query.str());
+    MYSQL_RES* result = conn->executeQuery(getDoctorByUserIdQuery(userId));
     if (!result) {
         connectionPool->returnConnection(std::move(conn));
         return nullptr;
     }
     
-    MYSQL_ROW row = mysql_fetch_row(result);
-    std::unique_ptr<Doctor> doctor = nullptr;
-    
-    if (row) {
-        unsigned long* lengths = mysql_fetch_lengths(result);
-        doctor = std::unique_ptr<Doctor>(mapRowToDoctor(row, lengths));
-    }
+    std::unique_ptr<Doctor> doctor = readDoctorByUserId(result, userId, ticket);
     
     mysql_free_result(result);
     connectionPool->returnConnection(std::move(conn));
@@ -84,32 +135,92 @@ std::unique_ptr<Doctor> DoctorDAO::getDoctorByUserId(int userId) {
 }
 
 std::vector<std::unique_ptr<Doctor>> DoctorDAO::getAllDoctors() {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<Doctor>> doctors;
     if (!conn) return doctors;
     
-    std::string query = "SELECT doctor_id, user_id, name, department, title, working_hours, profile_picture "
-                       "FROM doctors ORDER BY name";
-    
-    MYSQL_RES* result = conn->executeQuery(query);
+    MYSQL_RES* result = conn->executeQuery(getAllDoctorsQuery());
     if (!result) {
         connectionPool->returnConnection(std::move(conn));
         return doctors;
     }
     
+    doctors = readDoctors(result);
+    
+    mysql_free_result(result);
+    connectionPool->returnConnection(std::move(conn));
+    return doctors;
+}
+
+std::string DoctorDAO::getDoctorByUserIdQuery(int userId) {
+    std::stringstream query;
+    query << "SELECT doctor_id, user_id, name, department, title, working_hours, profile_picture "
+          << "FROM doctors WHERE user_id = " << userId;
+    return query.str();
+}
+
+std::string DoctorDAO::getAllDoctorsQuery() {
+    return "SELECT doctor_id, user_id, name, department, title, working_hours, profile_picture "
+           "FROM doctors ORDER BY name";
+}
+
+// Maps the first row of a doctor SELECT result; the caller frees the result
+std::unique_ptr<Doctor> DoctorDAO::readDoctor(MYSQL_RES* result) {
+    MYSQL_ROW row = result ? mysql_fetch_row(result) : nullptr;
+    if (!row) return nullptr;
+    
+    unsigned long* lengths = mysql_fetch_lengths(result);
+    return std::unique_ptr<Doctor>(mapRowToDoctor(row, lengths));
+}
+
+std::unique_ptr<Doctor> DoctorDAO::getCachedDoctorByUserId(int userId) {
+    int doctorId = 0;
+    Doctor cached;
+    if (doctorIdsByUserId.get(userId, doctorId) && doctorsById.get(doctorId, cached)) {
+        return std::make_unique<Doctor>(cached);
+    }
+    return nullptr;
+}
+
+DoctorDAO::FillTicket DoctorDAO::beginUserIdFill() {
+    return FillTicket{doctorsById.beginFill(), doctorIdsByUserId.beginFill(), doctorsById.enabled()};
+}
+
+// Maps a getDoctorByUserIdQuery() result and caches it; the caller frees the result
+std::unique_ptr<Doctor> DoctorDAO::readDoctorByUserId(MYSQL_RES* result, int userId, const FillTicket& ticket) {
+    std::unique_ptr<Doctor> doctor = readDoctor(result);
+    if (doctor) {
+        doctorsById.fill(doctor->getDoctorId(), *doctor, ticket.byId);
+        doctorIdsByUserId.fill(userId, doctor->getDoctorId(), ticket.byUserId);
+    }
+    return doctor;
+}
+
+// Maps every row of a doctor SELECT result; the caller frees the result
+std::vector<std::unique_ptr<Doctor>> DoctorDAO::readDoctors(MYSQL_RES* result) {
+    std::vector<std::unique_ptr<Doctor>> doctors;
+    if (!result) return doctors;
+    
     MYSQL_ROW row;
     while ((row = mysql_fetch_row(result))) {
         unsigned long* lengths = mysql_fetch_lengths(result);
         doctors.push_back(std::unique_ptr<Doctor>(mapRowToDoctor(row, lengths)));
     }
-    
-    mysql_free_result(result);
-    connectionPool->returnConnection(std::move(conn));
     return doctors;
 }
 
+std::future<std::unique_ptr<Doctor>> DoctorDAO::getDoctorByUserIdAsync(AsyncQueryExecutor& executor, int userId) {
+    return executor.fetch<std::unique_ptr<Doctor>>(getDoctorByUserIdQuery(userId),
+                                                   [this](MYSQL_RES* result) { return readDoctor(result); });
+}
+
+std::future<std::vector<std::unique_ptr<Doctor>>> DoctorDAO::getAllDoctorsAsync(AsyncQueryExecutor& executor) {
+    return executor.fetch<std::vector<std::unique_ptr<Doctor>>>(getAllDoctorsQuery(),
+                                                                [this](MYSQL_RES* result) { return readDoctors(result); });
+}
+
 std::vector<std::unique_ptr<Doctor>> DoctorDAO::getDoctorsByDepartment(const std::string& department) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<Doctor>> doctors;
     if (!conn) return doctors;
     
@@ -147,8 +258,11 @@ bool DoctorDAO::updateDoctor(const Doctor& doctor) {
           << "profile_picture = " << (doctor.getProfilePicture().empty() ? "NULL" : "'" + conn->escapeString(doctor.getProfilePicture()) + "'") << " "
           << "WHERE doctor_id = " << doctor.getDoctorId();
     
+    // Invalidated even on failure: a timed-out update may still have been applied
     bool result = conn->executeUpdate(query.str());
     connectionPool->returnConnection(std::move(conn));
+    invalidateDoctor(doctor.getDoctorId());
+    invalidateDepartments();
     return result;
 }
 
@@ -161,11 +275,13 @@ bool DoctorDAO::deleteDoctor(int doctorId) {
     
     bool result = conn->executeUpdate(query.str());
     connectionPool->returnConnection(std::move(conn));
+    invalidateDoctor(doctorId);
+    invalidateDepartments();
     return result;
 }
 
 std::vector<std::unique_ptr<Doctor>> DoctorDAO::searchDoctors(const std::string& searchTerm) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<Doctor>> doctors;
     if (!conn) return doctors;
     
@@ -194,8 +310,13 @@ std::vector<std::unique_ptr<Doctor>> DoctorDAO::searchDoctors(const std::string&
 }
 
 std::vector<std::string> DoctorDAO::getAllDepartments() {
-    auto conn = connectionPool->getConnection();
     std::vector<std::string> departments;
+    if (departmentCache.get(0, departments)) {
+        return departments;
+    }
+    
+    uint64_t ticket = departmentCache.beginFill();
+    auto conn = getFillConnection();
     if (!conn) return departments;
     
     std::string query = "SELECT DISTINCT department FROM doctors ORDER BY department";
@@ -212,6 +333,7 @@ std::vector<std::string> DoctorDAO::getAllDepartments() {
             departments.push_back(std::string(row[0]));
         }
     }
+    departmentCache.fill(0, departments, ticket);
     
     mysql_free_result(result);
     connectionPool->returnConnection(std::move(conn));
@@ -219,29 +341,13 @@ std::vector<std::string> DoctorDAO::getAllDepartments() {
 }
 
 int DoctorDAO::getDoctorCount() {
-    auto conn = connectionPool->getConnection();
-    if (!conn) return 0;
-    
-    std::string query = "SELECT COUNT(*) FROM doctors";
-    MYSQL_RES* result = conn->executeQuery(query);
-    if (!result) {
-        connectionPool->returnConnection(std::move(conn));
-        return 0;
-    }
-    
-    MYSQL_ROW row = mysql_fetch_row(result);
-    int count = 0;
-    if (row && row[0]) {
-        count = std::stoi(row[0]);
-    }
-    
-    mysql_free_result(result);
-    connectionPool->returnConnection(std::move(conn));
-    return count;
+    auto result = connectionPool->executeCachedQuery("SELECT COUNT(*) FROM doctors");
+    if (!result || result->rowCount() == 0 || !result->get(0, 0)) return 0;
+    return std::stoi(*result->get(0, 0));
 }
 
 int DoctorDAO::getDoctorCountByDepartment(const std::string& department) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     if (!conn) return 0;
     
     std::stringstream query;
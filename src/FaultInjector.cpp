@@ -0,0 +1,211 @@
+#include "FaultInjector.h"
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+namespace {
+
+std::mt19937_64& generator() {
+    thread_local std::mt19937_64 engine(std::random_device{}());
+    return engine;
+}
+
+bool chance(double probability) {
+    if (probability <= 0) return false;
+    return std::uniform_real_distribution<double>(0.0, 1.0)(generator()) < probability;
+}
+
+bool isIdentifierChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+bool parseUnsigned(const std::string& text, unsigned int& value) {
+    if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos) return false;
+    value = static_cast<unsigned int>(std::strtoul(text.c_str(), nullptr, 10));
+    return true;
+}
+
+bool parseProbability(const std::string& text, double& value) {
+    char* end = nullptr;
+    value = std::strtod(text.c_str(), &end);
+    return !text.empty() && *end == '\0' && value >= 0 && value <= 1;
+}
+
+// "<probability>:<number>"
+bool parsePair(const std::string& text, double& probability, unsigned int& number) {
+    size_t colon = text.find(':');
+    return colon != std::string::npos && parseProbability(text.substr(0, colon), probability) &&
+           parseUnsigned(text.substr(colon + 1), number);
+}
+
+bool parseRule(const std::string& line, FaultInjector::Rule& rule, std::string& error) {
+    std::istringstream tokens(line);
+    std::string token;
+    tokens >> token;
+    if (token == "*") {
+        rule.target = FaultInjector::Target::ANY;
+    } else if (token == "connect") {
+        rule.target = FaultInjector::Target::CONNECT;
+    } else if (token.compare(0, 6, "table=") == 0 && token.size() > 6) {
+        rule.target = FaultInjector::Target::TABLE;
+        rule.subject = token.substr(6);
+    } else if (token.compare(0, 6, "match=") == 0 && token.size() > 6) {
+        rule.target = FaultInjector::Target::MATCH;
+        rule.subject = token.substr(6);
+    } else {
+        error = "unknown target '" + token + "'";
+        return false;
+    }
+
+    while (tokens >> token) {
+        size_t equals = token.find('=');
+        std::string key = token.substr(0, equals);
+        std::string value = equals == std::string::npos ? "" : token.substr(equals + 1);
+        bool valid = false;
+        if (key == "delay") {
+            size_t dash = value.find('-');
+            valid = parseUnsigned(value.substr(0, dash), rule.minDelayMs);
+            rule.maxDelayMs = rule.minDelayMs;
+            if (valid && dash != std::string::npos) {
+                valid = parseUnsigned(value.substr(dash + 1), rule.maxDelayMs) && rule.maxDelayMs >= rule.minDelayMs;
+            }
+        } else if (key == "tail") {
+            valid = parsePair(value, rule.tailProbability, rule.tailDelayMs);
+        } else if (key == "error") {
+            valid = parsePair(value, rule.errorProbability, rule.errorCode) && rule.errorCode != 0;
+        }
+        if (!valid) {
+            error = "invalid setting '" + token + "'";
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+FaultInjector::FaultInjector(std::vector<Rule> rules) : rules(std::move(rules)) {}
+
+std::shared_ptr<FaultInjector> FaultInjector::parse(const std::string& text, std::string& error) {
+    std::vector<Rule> rules;
+    std::string normalized = text;
+    for (char& c : normalized) {
+        if (c == ';') c = '\n';
+    }
+
+    std::istringstream lines(normalized);
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(lines, line)) {
+        ++lineNumber;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+        Rule rule;
+        if (!parseRule(line, rule, error)) {
+            error = "fault rule " + std::to_string(lineNumber) + ": " + error;
+            return nullptr;
+        }
+        rules.push_back(rule);
+    }
+    return std::make_shared<FaultInjector>(std::move(rules));
+}
+
+std::shared_ptr<FaultInjector> FaultInjector::load(const std::string& path, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = "cannot open " + path;
+        return nullptr;
+    }
+    std::stringstream content;
+    content << file.rdbuf();
+    return parse(content.str(), error);
+}
+
+std::shared_ptr<FaultInjector> FaultInjector::fromEnvironment(std::string& error) {
+    if (const char* text = std::getenv("HOSPITAL_DB_FAULTS")) {
+        return parse(text, error);
+    }
+    if (const char* path = std::getenv("HOSPITAL_DB_FAULTS_FILE")) {
+        return load(path, error);
+    }
+    return nullptr;
+}
+
+bool FaultInjector::matches(const Rule& rule, const std::string& statement) const {
+    switch (rule.target) {
+        case Target::ANY:
+            return true;
+        case Target::MATCH:
+            return statement.find(rule.subject) != std::string::npos;
+        case Target::TABLE:
+            // Whole identifier only, so "cases" does not match "showcases"
+            for (size_t pos = statement.find(rule.subject); pos != std::string::npos;
+                 pos = statement.find(rule.subject, pos + 1)) {
+                size_t end = pos + rule.subject.size();
+                bool startsWord = pos == 0 || (!isIdentifierChar(statement[pos - 1]) && statement[pos - 1] != '.');
+                if (startsWord && (end == statement.size() || !isIdentifierChar(statement[end]))) return true;
+            }
+            return false;
+        case Target::CONNECT:
+            return false;
+    }
+    return false;
+}
+
+FaultInjector::Fault FaultInjector::draw(const Rule& rule) {
+    Fault fault;
+    unsigned int delayMs = rule.minDelayMs;
+    if (rule.maxDelayMs > rule.minDelayMs) {
+        delayMs = std::uniform_int_distribution<unsigned int>(rule.minDelayMs, rule.maxDelayMs)(generator());
+    }
+    if (chance(rule.tailProbability)) {
+        delayMs += rule.tailDelayMs;
+    }
+    if (chance(rule.errorProbability)) {
+        fault.errorCode = rule.errorCode;
+        failed.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (delayMs > 0) {
+        fault.delay = std::chrono::milliseconds(delayMs);
+        delayed.fetch_add(1, std::memory_order_relaxed);
+    }
+    return fault;
+}
+
+FaultInjector::Fault FaultInjector::onStatement(const std::string& statement) {
+    for (const Rule& rule : rules) {
+        if (matches(rule, statement)) return draw(rule);
+    }
+    return Fault();
+}
+
+FaultInjector::Fault FaultInjector::onConnect() {
+    for (const Rule& rule : rules) {
+        if (rule.target == Target::CONNECT) return draw(rule);
+    }
+    return Fault();
+}
+
+FaultInjector::Stats FaultInjector::getStats() const {
+    Stats stats;
+    stats.delayed = delayed.load(std::memory_order_relaxed);
+    stats.failed = failed.load(std::memory_order_relaxed);
+    return stats;
+}
+
+std::string FaultInjector::describe(unsigned int errorCode) {
+    switch (errorCode) {
+        case 1205: return "Lock wait timeout exceeded; try restarting transaction";
+        case 1213: return "Deadlock found when trying to get lock; try restarting transaction";
+        case 1969: return "Query execution was interrupted (max_statement_time exceeded)";
+        case 2003: return "Can't connect to MySQL server";
+        case 2006: return "MySQL server has gone away";
+        case 2013: return "Lost connection to MySQL server during query";
+        case 3024: return "Query execution was interrupted, maximum statement execution time exceeded";
+        default: return "Error " + std::to_string(errorCode);
+    }
+}
@@ -1,13 +1,42 @@
 #include "HospitalService.h"
+#include "ShardedDAO.h"
+#include "SchemaIndexes.h"
+#include "Sha256.h"
 #include <iostream>
 #include <sstream>
-#include <openssl/sha.h>
 #include <iomanip>
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+
+// 读取单值COUNT(*)结果集
+int readCount(MYSQL_RES* result) {
+    MYSQL_ROW row = result ? mysql_fetch_row(result) : nullptr;
+    return (row && row[0]) ? std::stoi(row[0]) : 0;
+}
+
+const char* const kBookingCountsQuery = "SELECT doctor_id, COUNT(*) FROM appointments GROUP BY doctor_id";
+
+// 按医生分组的预约数累加到counts
+void addBookingCounts(MYSQL_RES* result, std::unordered_map<int, int>& counts) {
+    MYSQL_ROW row;
+    while ((row = mysql_fetch_row(result))) {
+        if (row[0] && row[1]) {
+            counts[std::stoi(row[0])] += std::stoi(row[1]);
+        }
+    }
+}
+
+}
 
 HospitalService::HospitalService(const std::string& host, const std::string& username,
                                 const std::string& password, const std::string& database,
-                                unsigned int port, size_t maxConnections) {
-    connectionPool = std::make_shared<ConnectionPool>(host, username, password, database, port, maxConnections);
+                                unsigned int port, size_t maxConnections,
+                                std::shared_ptr<ConnectionBudget> budget)
+    : fanOutWorkers(std::max<size_t>(2, maxConnections / 2)) {
+    connectionPool = std::make_shared<ConnectionPool>(host, username, password, database, port, maxConnections, "",
+                                                      std::move(budget));
     userDAO = std::make_unique<UserDAO>(connectionPool);
     doctorDAO = std::make_unique<DoctorDAO>(connectionPool);
     patientDAO = std::make_unique<PatientDAO>(connectionPool);
@@ -18,12 +47,111 @@ HospitalService::HospitalService(const std::string& host, const std::string& use
     medicationDAO = std::make_unique<MedicationDAO>(connectionPool);
 }
 
-HospitalService::~HospitalService() = default;
+FanOutExecutor& HospitalService::getFanOutExecutor() {
+    std::call_once(fanOutOnce, [this]() {
+        fanOutExecutor = std::make_unique<FanOutExecutor>(fanOutWorkers);
+    });
+    return *fanOutExecutor;
+}
+
+bool HospitalService::useWorkerPool(std::shared_ptr<ThreadPool> pool) {
+    bool adopted = false;
+    std::call_once(fanOutOnce, [&]() {
+        fanOutExecutor = std::make_unique<FanOutExecutor>(std::move(pool));
+        adopted = true;
+    });
+    return adopted;
+}
+
+bool HospitalService::enableReadReplicas(const std::vector<ReplicaEndpoint>& endpoints, const ReplicaRouter::Policy& policy) {
+    return connectionPool->enableReplicas(endpoints, policy);
+}
+
+bool HospitalService::enableSharding(const std::string& mapPath) {
+    ShardMap map;
+    if (!map.load(mapPath)) {
+        std::cerr << "Failed to load shard map: " << map.getError() << std::endl;
+        return false;
+    }
+    
+    auto shardSet = ShardSet::connect(map, *connectionPool);
+    // 跨分片查询与请求内扇出共用同一个执行器
+    shardSet->setExecutor([this]() -> FanOutExecutor& { return getFanOutExecutor(); });
+    if (!shardSet->createTables()) {
+        std::cerr << shardSet->getError() << std::endl;
+        return false;
+    }
+    
+    shards = shardSet;
+    caseDAO = std::make_unique<ShardedCaseDAO>(shards);
+    appointmentDAO = std::make_unique<ShardedAppointmentDAO>(shards);
+    hospitalizationDAO = std::make_unique<ShardedHospitalizationDAO>(shards);
+    prescriptionDAO = std::make_unique<ShardedPrescriptionDAO>(shards);
+    medicationDAO = std::make_unique<ShardedMedicationDAO>(shards);
+    return true;
+}
+
+HospitalService::~HospitalService() {
+    if (existenceFilter && !existenceFilterPath.empty()) {
+        saveExistenceFilter();
+    }
+}
+
+bool HospitalService::initializeExistenceFilter(const std::string& persistPath) {
+    existenceFilterPath = persistPath;
+    userWatermark = 0;
+    patientWatermark = 0;
+    
+    std::shared_ptr<BloomFilter> filter;
+    if (!persistPath.empty()) {
+        // 容量无关紧要，loadFromFile会按文件中的尺寸重建位数组
+        filter = std::make_shared<BloomFilter>(1);
+        if (!filter->loadFromFile(persistPath, userWatermark, patientWatermark)) {
+            filter.reset();
+            userWatermark = 0;
+            patientWatermark = 0;
+        }
+    }
+    
+    if (!filter) {
+        // 每个用户贡献用户名+邮箱两个键，预留一倍余量供后续注册
+        size_t existingKeys = static_cast<size_t>(userDAO->getUserCount()) * 2 +
+                              static_cast<size_t>(patientDAO->getPatientCount());
+        filter = std::make_shared<BloomFilter>(std::max<size_t>(existingKeys * 2, 100000));
+    }
+    
+    existenceFilter = filter;
+    userDAO->setExistenceFilter(existenceFilter);
+    patientDAO->setExistenceFilter(existenceFilter);
+    
+    // 流式读取水位线之后的行；水位线为0时即全量加载
+    userWatermark = userDAO->loadExistenceFilter(userWatermark);
+    patientWatermark = patientDAO->loadExistenceFilter(patientWatermark);
+    
+    std::cout << "Existence filter ready: " << existenceFilter->getBitCount() << " bits, "
+              << existenceFilter->getHashCount() << " hashes" << std::endl;
+    return true;
+}
+
+bool HospitalService::saveExistenceFilter() {
+    if (!existenceFilter || existenceFilterPath.empty()) return false;
+    return existenceFilter->saveToFile(existenceFilterPath, userWatermark, patientWatermark);
+}
 
 bool HospitalService::initializeDatabase() {
     return createTables();
 }
 
+std::unordered_map<std::string, std::vector<std::string>> HospitalService::deleteCascades() {
+    return {
+        {"users", {"doctors", "patients"}},
+        {"doctors", {"cases", "appointments", "prescriptions"}},
+        {"patients", {"cases", "appointments", "hospitalization"}},
+        {"cases", {"prescriptions"}},
+        {"prescriptions", {"medications"}}
+    };
+}
+
 bool HospitalService::createTables() {
     auto conn = connectionPool->getConnection();
     if (!conn) return false;
@@ -38,8 +166,6 @@ bool HospitalService::createTables() {
             email VARCHAR(100) UNIQUE,
             phone_number VARCHAR(20),
             created_at DATETIME NOT NULL DEFAULT CURRENT_TIMESTAMP,
-            INDEX idx_username (username),
-            INDEX idx_email (email),
             INDEX idx_user_type (user_type)
         ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4)",
         
@@ -54,7 +180,7 @@ bool HospitalService::createTables() {
             profile_picture VARCHAR(255),
             FOREIGN KEY (user_id) REFERENCES users(user_id) ON DELETE CASCADE,
             INDEX idx_user_id (user_id),
-            INDEX idx_department (department),
+            INDEX idx_department_name (department, name),
             INDEX idx_name (name)
         ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4)",
         
@@ -69,7 +195,7 @@ bool HospitalService::createTables() {
             phone_number VARCHAR(20),
             FOREIGN KEY (user_id) REFERENCES users(user_id) ON DELETE CASCADE,
             INDEX idx_user_id (user_id),
-            INDEX idx_id_number (id_number),
+            INDEX idx_gender_name (gender, name),
             INDEX idx_name (name)
         ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4)",
         
@@ -83,9 +209,9 @@ bool HospitalService::createTables() {
             diagnosis_date DATETIME NOT NULL DEFAULT CURRENT_TIMESTAMP,
             FOREIGN KEY (patient_id) REFERENCES patients(patient_id) ON DELETE CASCADE,
             FOREIGN KEY (doctor_id) REFERENCES doctors(doctor_id) ON DELETE CASCADE,
-            INDEX idx_patient_id (patient_id),
-            INDEX idx_doctor_id (doctor_id),
-            INDEX idx_department (department),
+            INDEX idx_patient_date (patient_id, diagnosis_date),
+            INDEX idx_doctor_date (doctor_id, diagnosis_date),
+            INDEX idx_department_date (department, diagnosis_date),
             INDEX idx_diagnosis_date (diagnosis_date)
         ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4)",
         
@@ -99,11 +225,11 @@ bool HospitalService::createTables() {
             status ENUM('Booked', 'Attended', 'Cancelled') NOT NULL DEFAULT 'Booked',
             FOREIGN KEY (patient_id) REFERENCES patients(patient_id) ON DELETE CASCADE,
             FOREIGN KEY (doctor_id) REFERENCES doctors(doctor_id) ON DELETE CASCADE,
-            INDEX idx_patient_id (patient_id),
-            INDEX idx_doctor_id (doctor_id),
-            INDEX idx_appointment_time (appointment_time),
-            INDEX idx_status (status),
-            INDEX idx_department (department)
+            INDEX idx_patient_time (patient_id, appointment_time),
+            INDEX idx_doctor_time (doctor_id, appointment_time),
+            INDEX idx_department_time (department, appointment_time),
+            INDEX idx_status_time (status, appointment_time),
+            INDEX idx_appointment_time (appointment_time)
         ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4)",
         
         // Hospitalization table
@@ -115,9 +241,8 @@ bool HospitalService::createTables() {
             admission_date DATETIME NOT NULL DEFAULT CURRENT_TIMESTAMP,
             attending_doctor VARCHAR(100) NOT NULL,
             FOREIGN KEY (patient_id) REFERENCES patients(patient_id) ON DELETE CASCADE,
-            INDEX idx_patient_id (patient_id),
-            INDEX idx_ward_number (ward_number),
-            INDEX idx_bed_number (bed_number),
+            INDEX idx_patient_date (patient_id, admission_date),
+            INDEX idx_ward_bed (ward_number, bed_number),
             INDEX idx_admission_date (admission_date)
         ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4)",
         
@@ -130,8 +255,8 @@ bool HospitalService::createTables() {
             issued_date DATETIME NOT NULL DEFAULT CURRENT_TIMESTAMP,
             FOREIGN KEY (case_id) REFERENCES cases(case_id) ON DELETE CASCADE,
             FOREIGN KEY (doctor_id) REFERENCES doctors(doctor_id) ON DELETE CASCADE,
-            INDEX idx_case_id (case_id),
-            INDEX idx_doctor_id (doctor_id),
+            INDEX idx_case_date (case_id, issued_date),
+            INDEX idx_doctor_date (doctor_id, issued_date),
             INDEX idx_issued_date (issued_date)
         ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4)",
         
@@ -143,8 +268,8 @@ bool HospitalService::createTables() {
             quantity INT NOT NULL,
             usage_instructions TEXT NOT NULL,
             FOREIGN KEY (prescription_id) REFERENCES prescriptions(prescription_id) ON DELETE CASCADE,
-            INDEX idx_prescription_id (prescription_id),
-            INDEX idx_medication_name (medication_name)
+            INDEX idx_prescription_name (prescription_id, medication_name),
+            INDEX idx_name_quantity (medication_name, quantity)
         ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4)"
     };
     
@@ -163,6 +288,13 @@ bool HospitalService::createTables() {
     }
     
     bool result = conn->commit();
+    
+    // 旧库的表已存在，CREATE TABLE IF NOT EXISTS不会更新索引，需单独迁移
+    std::string migrateError;
+    if (result && !SchemaIndexes::migrate(*conn, migrateError)) {
+        std::cerr << "Failed to migrate indexes: " << migrateError << std::endl;
+        result = false;
+    }
     connectionPool->returnConnection(std::move(conn));
     
     if (result) {
@@ -231,7 +363,7 @@ bool HospitalService::registerUser(const std::string& username, const std::strin
     }
     
     // 1. 创建用户记录 - 直接在这里执行SQL而不是通过DAO
-    std::string hashedPassword = hashPassword(password);
+    std::string hashedPassword = Sha256::hex(password);
     
     std::stringstream userQuery;
     userQuery << "INSERT INTO users (username, password, user_type, email, phone_number) VALUES ("
@@ -242,6 +374,10 @@ bool HospitalService::registerUser(const std::string& username, const std::strin
               << (phoneNumber.empty() ? "NULL" : "'" + conn->escapeString(phoneNumber) + "'") << ")";
     
     if (!conn->executeUpdate(userQuery.str())) {
+        // 过滤器的"不存在"只是提示：其他进程或直接SQL写入的行可能不在其中，以唯一约束为准，并补上漏掉的键
+        if (conn->isDuplicateKeyError()) {
+            userDAO->addToExistenceFilter(username, email);
+        }
         conn->rollback();
         connectionPool->returnConnection(std::move(conn));
         return false;
@@ -261,10 +397,11 @@ bool HospitalService::registerUser(const std::string& username, const std::strin
     
     // 3. 根据用户类型创建对应的业务记录
     bool businessRecordCreated = false;
+    std::string defaultIdNumber;
     
     if (userType == UserType::PATIENT) {
         // 直接执行患者插入SQL
-        std::string defaultIdNumber = generateDefaultIdNumber(newUserId);
+        defaultIdNumber = generateDefaultIdNumber(newUserId);
         
         std::stringstream patientQuery;
         patientQuery << "INSERT INTO patients (user_id, name, gender, birth_date, id_number, phone_number) VALUES ("
@@ -303,6 +440,14 @@ bool HospitalService::registerUser(const std::string& username, const std::strin
     connectionPool->returnConnection(std::move(conn));
     
     if (result) {
+        userDAO->addToExistenceFilter(username, email);
+        if (!defaultIdNumber.empty()) {
+            patientDAO->addToExistenceFilter(defaultIdNumber);
+        }
+        if (userType == UserType::DOCTOR) {
+            // 新医生的科室可能不在缓存的科室列表中
+            doctorDAO->invalidateDepartments();
+        }
         std::cout << "Successfully registered user: " << username 
                   << " with ID: " << newUserId << std::endl;
     }
@@ -385,7 +530,9 @@ int HospitalService::bookAppointment(int patientId, int doctorId, const std::str
         return 0;
     }
     
-    auto conn = connectionPool->getConnection();
+    // 分片时插入患者所在的分片
+    std::shared_ptr<ConnectionPool> pool = shards ? shards->forPatient(patientId) : connectionPool;
+    auto conn = pool->getConnection();
     if (!conn) {
         std::cerr << "Failed to get database connection" << std::endl;
         return 0;
@@ -405,11 +552,11 @@ int HospitalService::bookAppointment(int patientId, int doctorId, const std::str
     if (conn->executeUpdate(query.str())) {
         int appointmentId = static_cast<int>(conn->getLastInsertId());
         std::cout << "Appointment created successfully with ID: " << appointmentId << std::endl;
-        connectionPool->returnConnection(std::move(conn));
+        pool->returnConnection(std::move(conn));
         return appointmentId;
     } else {
         std::cerr << "Failed to create appointment: " << conn->getError() << std::endl;
-        connectionPool->returnConnection(std::move(conn));
+        pool->returnConnection(std::move(conn));
         return 0;
     }
 }
@@ -486,24 +633,209 @@ bool HospitalService::addMedication(int prescriptionId, const std::string& medic
 HospitalService::HospitalStats HospitalService::getHospitalStats() {
     HospitalStats stats = {};
     
-    stats.totalUsers = userDAO->getUserCount();
-    stats.totalDoctors = doctorDAO->getDoctorCount();
-    stats.totalPatients = patientDAO->getPatientCount();
-    stats.totalCases = caseDAO->getCaseCount();
-    stats.totalAppointments = appointmentDAO->getAppointmentCount();
-    stats.bookedAppointments = appointmentDAO->getAppointmentCountByStatus(AppointmentStatus::BOOKED);
-    stats.attendedAppointments = appointmentDAO->getAppointmentCountByStatus(AppointmentStatus::ATTENDED);
-    stats.cancelledAppointments = appointmentDAO->getAppointmentCountByStatus(AppointmentStatus::CANCELLED);
-    stats.totalHospitalizations = hospitalizationDAO->getHospitalizationCount();
-    stats.totalPrescriptions = prescriptionDAO->getPrescriptionCount();
+    // 11个计数在一次往返内取回；多语句不可用时并发执行单条计数，耗时取决于最慢的一条查询
+    const std::vector<std::string> statements = {
+        "SELECT COUNT(*) FROM users",
+        "SELECT COUNT(*) FROM doctors",
+        "SELECT COUNT(*) FROM patients",
+        "SELECT COUNT(*) FROM cases",
+        "SELECT COUNT(*) FROM appointments",
+        "SELECT COUNT(*) FROM appointments WHERE status = 'Booked'",
+        "SELECT COUNT(*) FROM appointments WHERE status = 'Attended'",
+        "SELECT COUNT(*) FROM appointments WHERE status = 'Cancelled'",
+        "SELECT COUNT(*) FROM hospitalization",
+        "SELECT COUNT(*) FROM prescriptions",
+        "SELECT COUNT(*) FROM medications"
+    };
+    int* const fields[] = {
+        &stats.totalUsers, &stats.totalDoctors, &stats.totalPatients, &stats.totalCases,
+        &stats.totalAppointments, &stats.bookedAppointments, &stats.attendedAppointments,
+        &stats.cancelledAppointments, &stats.totalHospitalizations, &stats.totalPrescriptions,
+        &stats.totalMedications
+    };
+    
+    // 分片时患者数据不在主库，计数只能经由分片DAO在各分片上汇总；
+    // 启用查询缓存时同样逐条经由DAO计数：命中无需连接，只有被写入失效的计数才并发重查
+    bool perCount = shards || connectionPool->getQueryCache();
+    std::vector<MYSQL_RES*> results = perCount ? std::vector<MYSQL_RES*>() : executeMultiQuery(statements);
+    if (!results.empty()) {
+        for (size_t i = 0; i < statements.size(); ++i) {
+            *fields[i] = readCount(results[i]);
+        }
+        DatabaseConnection::freeResults(results);
+        return stats;
+    }
+    
+    FanOutExecutor& executor = getFanOutExecutor();
+    auto totalUsers = executor.submit([this]() { return userDAO->getUserCount(); });
+    auto totalDoctors = executor.submit([this]() { return doctorDAO->getDoctorCount(); });
+    auto totalPatients = executor.submit([this]() { return patientDAO->getPatientCount(); });
+    auto totalCases = executor.submit([this]() { return caseDAO->getCaseCount(); });
+    auto totalAppointments = executor.submit([this]() { return appointmentDAO->getAppointmentCount(); });
+    auto bookedAppointments = executor.submit([this]() {
+        return appointmentDAO->getAppointmentCountByStatus(AppointmentStatus::BOOKED);
+    });
+    auto attendedAppointments = executor.submit([this]() {
+        return appointmentDAO->getAppointmentCountByStatus(AppointmentStatus::ATTENDED);
+    });
+    auto cancelledAppointments = executor.submit([this]() {
+        return appointmentDAO->getAppointmentCountByStatus(AppointmentStatus::CANCELLED);
+    });
+    auto totalHospitalizations = executor.submit([this]() { return hospitalizationDAO->getHospitalizationCount(); });
+    auto totalPrescriptions = executor.submit([this]() { return prescriptionDAO->getPrescriptionCount(); });
+    
+    // 最后一条在调用线程上执行
     stats.totalMedications = medicationDAO->getMedicationCount();
+    stats.totalUsers = totalUsers.get();
+    stats.totalDoctors = totalDoctors.get();
+    stats.totalPatients = totalPatients.get();
+    stats.totalCases = totalCases.get();
+    stats.totalAppointments = totalAppointments.get();
+    stats.bookedAppointments = bookedAppointments.get();
+    stats.attendedAppointments = attendedAppointments.get();
+    stats.cancelledAppointments = cancelledAppointments.get();
+    stats.totalHospitalizations = totalHospitalizations.get();
+    stats.totalPrescriptions = totalPrescriptions.get();
     
     return stats;
 }
 
+std::vector<MYSQL_RES*> HospitalService::executeMultiQuery(const std::vector<std::string>& statements, bool primary) {
+    auto conn = primary ? connectionPool->getPrimaryMultiStatementConnection()
+                        : connectionPool->getMultiStatementConnection();
+    if (!conn) return {};
+    
+    std::vector<MYSQL_RES*> results = conn->executeMultiQuery(statements);
+    connectionPool->returnConnection(std::move(conn));
+    return results;
+}
+
+HospitalService::PatientProfile HospitalService::getPatientProfile(int userId) {
+    PatientProfile profile;
+    
+    std::vector<MYSQL_RES*> results = executeMultiQuery({
+        userDAO->getUserByIdQuery(userId),
+        patientDAO->getPatientByUserIdQuery(userId)
+    });
+    if (results.empty()) {
+        profile.user = userDAO->getUserById(userId);
+        profile.patient = patientDAO->getPatientByUserId(userId);
+        return profile;
+    }
+    
+    profile.user = userDAO->readUser(results[0]);
+    profile.patient = patientDAO->readPatient(results[1]);
+    DatabaseConnection::freeResults(results);
+    return profile;
+}
+
+HospitalService::DoctorProfile HospitalService::getDoctorProfile(int userId) {
+    DoctorProfile profile;
+    
+    // 医生信息命中缓存时只需读取用户行；未命中时两行一次取回，并用结果填充医生缓存
+    profile.doctor = doctorDAO->getCachedDoctorByUserId(userId);
+    if (profile.doctor) {
+        profile.user = userDAO->getUserById(userId);
+        return profile;
+    }
+    
+    DoctorDAO::FillTicket ticket = doctorDAO->beginUserIdFill();
+    std::vector<MYSQL_RES*> results = executeMultiQuery({
+        userDAO->getUserByIdQuery(userId),
+        doctorDAO->getDoctorByUserIdQuery(userId)
+    }, ticket.readPrimary);
+    if (results.empty()) {
+        profile.user = userDAO->getUserById(userId);
+        profile.doctor = doctorDAO->getDoctorByUserId(userId);
+        return profile;
+    }
+    
+    profile.user = userDAO->readUser(results[0]);
+    profile.doctor = doctorDAO->readDoctorByUserId(results[1], userId, ticket);
+    DatabaseConnection::freeResults(results);
+    return profile;
+}
+
+std::vector<HospitalService::DoctorBookingInfo> HospitalService::getDoctorsWithBookingCounts() {
+    std::vector<DoctorBookingInfo> doctors;
+    
+    // 预约分布在各分片上：每个分片一次分组计数，按医生累加
+    if (shards) {
+        std::unordered_map<int, int> counts;
+        auto perShard = shards->scatter([this](size_t shard) {
+            std::unordered_map<int, int> shardCounts;
+            auto pool = shards->at(shard);
+            auto conn = pool->getReadConnection();
+            if (!conn) return shardCounts;
+            MYSQL_RES* result = conn->executeQuery(kBookingCountsQuery);
+            if (result) {
+                addBookingCounts(result, shardCounts);
+                mysql_free_result(result);
+            }
+            pool->returnConnection(std::move(conn));
+            return shardCounts;
+        });
+        for (const auto& shardCounts : perShard) {
+            for (const auto& entry : shardCounts) {
+                counts[entry.first] += entry.second;
+            }
+        }
+        for (auto& doctor : doctorDAO->getAllDoctors()) {
+            auto it = counts.find(doctor->getDoctorId());
+            int bookedCount = it == counts.end() ? 0 : it->second;
+            doctors.push_back({std::move(doctor), bookedCount});
+        }
+        return doctors;
+    }
+    
+    // 医生列表与按医生分组的预约数一次取回，替代每位医生一次计数查询
+    std::vector<MYSQL_RES*> results = executeMultiQuery({
+        doctorDAO->getAllDoctorsQuery(),
+        kBookingCountsQuery
+    });
+    if (results.empty()) {
+        for (auto& doctor : doctorDAO->getAllDoctors()) {
+            int bookedCount = appointmentDAO->getAppointmentCountByDoctor(doctor->getDoctorId());
+            doctors.push_back({std::move(doctor), bookedCount});
+        }
+        return doctors;
+    }
+    
+    std::unordered_map<int, int> counts;
+    addBookingCounts(results[1], counts);
+    
+    for (auto& doctor : doctorDAO->readDoctors(results[0])) {
+        auto it = counts.find(doctor->getDoctorId());
+        int bookedCount = it == counts.end() ? 0 : it->second;
+        doctors.push_back({std::move(doctor), bookedCount});
+    }
+    DatabaseConnection::freeResults(results);
+    return doctors;
+}
+
 std::vector<HospitalService::PatientCaseInfo> HospitalService::getPatientCaseHistory(int patientId) {
-    auto conn = connectionPool->getConnection();
     std::vector<PatientCaseInfo> caseHistory;
+    if (shards) {
+        // 病例与患者、医生不在同一个库，无法JOIN：分别读取后在内存中拼接，
+        // 缺少患者或医生的病例与JOIN一样被略去
+        auto patient = patientDAO->getPatientById(patientId);
+        if (!patient) return caseHistory;
+        std::unordered_map<int, std::string> doctorNames;
+        for (const auto& medicalCase : caseDAO->getCasesByPatientId(patientId)) {
+            auto it = doctorNames.find(medicalCase->getDoctorId());
+            if (it == doctorNames.end()) {
+                auto doctor = doctorDAO->getDoctorById(medicalCase->getDoctorId());
+                if (!doctor) continue;
+                it = doctorNames.emplace(medicalCase->getDoctorId(), doctor->getName()).first;
+            }
+            caseHistory.push_back({patientId, patient->getName(), patient->getIdNumber(),
+                                   medicalCase->getCaseId(), medicalCase->getDiagnosis(),
+                                   medicalCase->getDiagnosisDate(), it->second, medicalCase->getDepartment()});
+        }
+        return caseHistory;
+    }
+    
+    auto conn = connectionPool->getReadConnection();
     if (!conn) return caseHistory;
     
     std::stringstream query;
@@ -540,8 +872,27 @@ std::vector<HospitalService::PatientCaseInfo> HospitalService::getPatientCaseHis
 }
 
 std::vector<HospitalService::DoctorAppointmentInfo> HospitalService::getDoctorAppointments(int doctorId) {
-    auto conn = connectionPool->getConnection();
     std::vector<DoctorAppointmentInfo> appointments;
+    if (shards) {
+        // 同getPatientCaseHistory：预约从各分片汇总，医生与患者姓名从主库补齐
+        auto doctor = doctorDAO->getDoctorById(doctorId);
+        if (!doctor) return appointments;
+        std::unordered_map<int, std::string> patientNames;
+        for (const auto& appointment : appointmentDAO->getAppointmentsByDoctorId(doctorId)) {
+            auto it = patientNames.find(appointment->getPatientId());
+            if (it == patientNames.end()) {
+                auto patient = patientDAO->getPatientById(appointment->getPatientId());
+                if (!patient) continue;
+                it = patientNames.emplace(appointment->getPatientId(), patient->getName()).first;
+            }
+            appointments.push_back({doctorId, doctor->getName(), doctor->getDepartment(),
+                                    appointment->getAppointmentId(), it->second,
+                                    appointment->getAppointmentTime(), appointment->statusToString()});
+        }
+        return appointments;
+    }
+    
+    auto conn = connectionPool->getReadConnection();
     if (!conn) return appointments;
     
     std::stringstream query;
@@ -576,26 +927,13 @@ std::vector<HospitalService::DoctorAppointmentInfo> HospitalService::getDoctorAp
     return appointments;
 }
 
-std::string HospitalService::hashPassword(const std::string& password) {
-    unsigned char hash[SHA256_DIGEST_LENGTH];
-    SHA256_CTX sha256;
-    SHA256_Init(&sha256);
-    SHA256_Update(&sha256, password.c_str(), password.length());
-    SHA256_Final(hash, &sha256);
-    
-    std::stringstream ss;
-    for (int i = 0; i < SHA256_DIGEST_LENGTH; i++) {
-        ss << std::hex << std::setw(2) << std::setfill('0') << (int)hash[i];
-    }
-    return ss.str();
-}
-
 std::string HospitalService::generateDefaultIdNumber(int userId) {
     // 生成基于用户ID的唯一默认身份证号
     // 格式：110101 + 年份 + 月日 + 用户ID补零到4位
     auto now = std::chrono::system_clock::now();
     auto time_t = std::chrono::system_clock::to_time_t(now);
-    auto tm = *std::localtime(&time_t);
+    std::tm tm{};
+    localtime_r(&time_t, &tm);
     
     std::stringstream ss;
     ss << "110101"  // 地区代码
@@ -28,7 +28,7 @@ bool HospitalizationDAO::createHospitalization(const Hospitalization& hospitaliz
 }
 
 std::unique_ptr<Hospitalization> HospitalizationDAO::getHospitalizationById(int hospitalizationId) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     if (!conn) return nullptr;
     
     std::stringstream query;
@@ -55,7 +55,7 @@ std::unique_ptr<Hospitalization> HospitalizationDAO::getHospitalizationById(int
 }
 
 std::vector<std::unique_ptr<Hospitalization>> HospitalizationDAO::getHospitalizationsByPatientId(int patientId) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<Hospitalization>> hospitalizations;
     if (!conn) return hospitalizations;
     
@@ -81,7 +81,7 @@ std::vector<std::unique_ptr<Hospitalization>> HospitalizationDAO::getHospitaliza
 }
 
 std::vector<std::unique_ptr<Hospitalization>> HospitalizationDAO::getHospitalizationsByWard(const std::string& wardNumber) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<Hospitalization>> hospitalizations;
     if (!conn) return hospitalizations;
     
@@ -108,7 +108,7 @@ std::vector<std::unique_ptr<Hospitalization>> HospitalizationDAO::getHospitaliza
 }
 
 std::vector<std::unique_ptr<Hospitalization>> HospitalizationDAO::getAllHospitalizations() {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<Hospitalization>> hospitalizations;
     if (!conn) return hospitalizations;
     
@@ -194,32 +194,22 @@ bool HospitalizationDAO::isBedOccupied(const std::string& wardNumber, const std:
 }
 
 std::vector<std::string> HospitalizationDAO::getAllWards() {
-    auto conn = connectionPool->getConnection();
     std::vector<std::string> wards;
-    if (!conn) return wards;
-    
-    std::string query = "SELECT DISTINCT ward_number FROM hospitalization ORDER BY ward_number";
-    
-    MYSQL_RES* result = conn->executeQuery(query);
-    if (!result) {
-        connectionPool->returnConnection(std::move(conn));
-        return wards;
-    }
-    
-    MYSQL_ROW row;
-    while ((row = mysql_fetch_row(result))) {
-        if (row[0]) {
-            wards.push_back(std::string(row[0]));
+    auto result = connectionPool->executeCachedQuery(
+        "SELECT DISTINCT ward_number FROM hospitalization ORDER BY ward_number");
+    if (!result) return wards;
+    
+    wards.reserve(result->rowCount());
+    for (size_t i = 0; i < result->rowCount(); ++i) {
+        if (const std::string* ward = result->get(i, 0)) {
+            wards.push_back(*ward);
         }
     }
-    
-    mysql_free_result(result);
-    connectionPool->returnConnection(std::move(conn));
     return wards;
 }
 
 std::vector<std::unique_ptr<Hospitalization>> HospitalizationDAO::searchHospitalizations(const std::string& searchTerm) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<Hospitalization>> hospitalizations;
     if (!conn) return hospitalizations;
     
@@ -248,25 +238,9 @@ std::vector<std::unique_ptr<Hospitalization>> HospitalizationDAO::searchHospital
 }
 
 int HospitalizationDAO::getHospitalizationCount() {
-    auto conn = connectionPool->getConnection();
-    if (!conn) return 0;
-    
-    std::string query = "SELECT COUNT(*) FROM hospitalization";
-    MYSQL_RES* result = conn->executeQuery(query);
-    if (!result) {
-        connectionPool->returnConnection(std::move(conn));
-        return 0;
-    }
-    
-    MYSQL_ROW row = mysql_fetch_row(result);
-    int count = 0;
-    if (row && row[0]) {
-        count = std::stoi(row[0]);
-    }
-    
-    mysql_free_result(result);
-    connectionPool->returnConnection(std::move(conn));
-    return count;
+    auto result = connectionPool->executeCachedQuery("SELECT COUNT(*) FROM hospitalization");
+    if (!result || result->rowCount() == 0 || !result->get(0, 0)) return 0;
+    return std::stoi(*result->get(0, 0));
 }
 
 int HospitalizationDAO::getCurrentHospitalizationCount() {
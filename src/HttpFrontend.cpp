@@ -0,0 +1,514 @@
+#include "HttpFrontend.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+const uint64_t kListenToken = 0;
+const uint64_t kWakeToken = UINT64_MAX;
+const size_t kReadChunk = 64 * 1024;
+
+bool equalsIgnoreCase(const std::string& a, const char* b) {
+    size_t length = std::strlen(b);
+    if (a.size() != length) return false;
+    for (size_t i = 0; i < length; ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool containsIgnoreCase(const std::string& haystack, const char* needle) {
+    std::string lower(haystack);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return lower.find(needle) != std::string::npos;
+}
+
+std::string trim(const std::string& value) {
+    size_t begin = value.find_first_not_of(" \t");
+    if (begin == std::string::npos) return "";
+    size_t end = value.find_last_not_of(" \t");
+    return value.substr(begin, end - begin + 1);
+}
+
+const char* contentTypeFor(WireFormat format) {
+    switch (format) {
+        case WireFormat::MSGPACK: return "application/msgpack";
+        case WireFormat::CBOR: return "application/cbor";
+        case WireFormat::JSON: break;
+    }
+    return "application/json; charset=utf-8";
+}
+
+// Content-Type优先，未声明二进制类型时按请求体首字节识别
+WireFormat formatFor(const std::string& contentType, const std::string& body) {
+    if (containsIgnoreCase(contentType, "msgpack")) return WireFormat::MSGPACK;
+    if (containsIgnoreCase(contentType, "cbor")) return WireFormat::CBOR;
+    return WireCodec::detect(body);
+}
+
+} // namespace
+
+HttpFrontend::HttpFrontend(const Options& options, RequestProcessor processor)
+    : options(options), processor(std::move(processor)), workerPool(std::make_shared<ThreadPool>(options.workers)) {}
+
+HttpFrontend::~HttpFrontend() {
+    for (auto& entry : connections) {
+        ::close(entry.second->fd);
+    }
+    connections.clear();
+    for (int fd : {listenFd, epollFd, wakeFd}) {
+        if (fd >= 0) ::close(fd);
+    }
+}
+
+bool HttpFrontend::start() {
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(options.port);
+    if (::inet_pton(AF_INET, options.host.c_str(), &address.sin_addr) != 1) {
+        lastError = "无效的监听地址: " + options.host;
+        return false;
+    }
+
+    listenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    int enable = 1;
+    if (listenFd < 0 ||
+        ::setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable)) != 0 ||
+        ::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listenFd, SOMAXCONN) != 0) {
+        lastError = std::string("监听端口失败: ") + std::strerror(errno);
+        return false;
+    }
+
+    epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd < 0 || wakeFd < 0) {
+        lastError = std::string("创建epoll/eventfd失败: ") + std::strerror(errno);
+        return false;
+    }
+
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u64 = kListenToken;
+    ::epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+    event.data.u64 = kWakeToken;
+    ::epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+    return true;
+}
+
+void HttpFrontend::run() {
+    const int kMaxEvents = 256;
+    epoll_event events[kMaxEvents];
+    bool stopping = false;
+    time_t deadline = 0;
+    time_t lastSweep = ::time(nullptr);
+
+    for (;;) {
+        int count = ::epoll_wait(epollFd, events, kMaxEvents, 1000);
+        if (count < 0 && errno != EINTR) {
+            lastError = std::string("epoll_wait失败: ") + std::strerror(errno);
+            break;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            uint64_t token = events[i].data.u64;
+            if (token == kListenToken) {
+                if (!stopping) acceptConnections();
+                continue;
+            }
+            if (token == kWakeToken) {
+                uint64_t value;
+                while (::read(wakeFd, &value, sizeof(value)) > 0) {}
+                drainCompletions();
+                continue;
+            }
+
+            auto it = connections.find(token);
+            if (it == connections.end()) continue;
+            // 双向关闭或出错：响应已无法写回，且这两个事件无法屏蔽，不关闭会持续就绪
+            if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+                closeConnection(token);
+                continue;
+            }
+            if ((events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) && !readInput(*it->second)) {
+                continue;
+            }
+            serviceConnection(token);
+        }
+
+        time_t now = ::time(nullptr);
+        if (stopRequested.load() && !stopping) {
+            // 停止接受新连接，处理中的请求写回后以Connection: close结束
+            stopping = true;
+            deadline = now + options.shutdownGraceSeconds;
+            ::epoll_ctl(epollFd, EPOLL_CTL_DEL, listenFd, nullptr);
+            ::close(listenFd);
+            listenFd = -1;
+            for (auto& entry : connections) {
+                entry.second->closeAfterWrite = true;
+            }
+        }
+        if (stopping) {
+            closeIdleConnections(now, true);
+            if (connections.empty() || now >= deadline) break;
+        } else if (now != lastSweep) {
+            closeIdleConnections(now, false);
+            lastSweep = now;
+        }
+    }
+
+    std::vector<uint64_t> remaining;
+    for (const auto& entry : connections) remaining.push_back(entry.first);
+    for (uint64_t id : remaining) closeConnection(id);
+    workerPool->shutdown();
+}
+
+void HttpFrontend::requestStop() {
+    // 原子写与eventfd写均为异步信号安全
+    stopRequested.store(true);
+    uint64_t one = 1;
+    ssize_t ignored = ::write(wakeFd, &one, sizeof(one));
+    (void)ignored;
+}
+
+HttpFrontend::Stats HttpFrontend::getStats() const {
+    Stats stats;
+    stats.connections = totalConnections.load(std::memory_order_relaxed);
+    stats.requests = totalRequests.load(std::memory_order_relaxed);
+    stats.rejectedRequests = rejectedRequests.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void HttpFrontend::acceptConnections() {
+    for (;;) {
+        int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+
+        if (connections.size() >= options.maxConnections) {
+            ::close(fd);
+            rejectedRequests.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        int enable = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+
+        auto connection = std::make_unique<Connection>();
+        connection->fd = fd;
+        connection->id = nextConnectionId++;
+        connection->lastActive = ::time(nullptr);
+
+        epoll_event event;
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.u64 = connection->id;
+        if (::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            ::close(fd);
+            continue;
+        }
+        totalConnections.fetch_add(1, std::memory_order_relaxed);
+        connections.emplace(connection->id, std::move(connection));
+    }
+}
+
+bool HttpFrontend::readInput(Connection& connection) {
+    char buffer[kReadChunk];
+    for (;;) {
+        ssize_t n = ::read(connection.fd, buffer, sizeof(buffer));
+        if (n > 0) {
+            connection.input.append(buffer, static_cast<size_t>(n));
+            connection.lastActive = ::time(nullptr);
+            // 处理中的请求之后堆积的数据不能超过一个最大请求
+            if (connection.input.size() > options.maxHeaderSize + options.maxBodySize) {
+                closeConnection(connection.id);
+                return false;
+            }
+        } else if (n == 0) {
+            connection.peerClosed = true;
+            updateInterest(connection);
+            return true;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return true;
+        } else {
+            closeConnection(connection.id);
+            return false;
+        }
+    }
+}
+
+bool HttpFrontend::flushOutput(Connection& connection) {
+    while (connection.outputOffset < connection.output.size()) {
+        ssize_t n = ::send(connection.fd, connection.output.data() + connection.outputOffset,
+                           connection.output.size() - connection.outputOffset, MSG_NOSIGNAL);
+        if (n > 0) {
+            connection.outputOffset += static_cast<size_t>(n);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            closeConnection(connection.id);
+            return false;
+        }
+    }
+
+    if (connection.outputOffset == connection.output.size()) {
+        connection.output.clear();
+        connection.outputOffset = 0;
+        connection.lastActive = ::time(nullptr);
+    }
+    updateInterest(connection);
+    return true;
+}
+
+void HttpFrontend::serviceConnection(uint64_t connectionId) {
+    // 循环而非递归地推进：写出待发数据 -> 解析下一个流水线请求，直到需要等待IO或工作线程
+    for (;;) {
+        auto it = connections.find(connectionId);
+        if (it == connections.end()) return;
+        Connection& connection = *it->second;
+
+        if (!connection.output.empty()) {
+            if (!flushOutput(connection) || !connection.output.empty()) return;
+        }
+        if (connection.busy) return;
+        if (connection.closeAfterWrite) {
+            closeConnection(connectionId);
+            return;
+        }
+        if (!parseNextRequest(connection)) {
+            if (connection.peerClosed) closeConnection(connectionId);
+            return;
+        }
+    }
+}
+
+bool HttpFrontend::parseNextRequest(Connection& connection) {
+    size_t headerEnd = connection.input.find("\r\n\r\n");
+    if (headerEnd == std::string::npos) {
+        if (connection.input.size() > options.maxHeaderSize) {
+            rejectRequest(connection, 431, "Request Header Fields Too Large", false);
+            return true;
+        }
+        return false;
+    }
+    if (headerEnd > options.maxHeaderSize) {
+        rejectRequest(connection, 431, "Request Header Fields Too Large", false);
+        return true;
+    }
+
+    // 请求行: METHOD SP TARGET SP VERSION
+    size_t lineEnd = connection.input.find("\r\n");
+    std::string requestLine = connection.input.substr(0, lineEnd);
+    size_t firstSpace = requestLine.find(' ');
+    size_t secondSpace = firstSpace == std::string::npos ? std::string::npos : requestLine.find(' ', firstSpace + 1);
+    if (secondSpace == std::string::npos) {
+        rejectRequest(connection, 400, "Bad Request", false);
+        return true;
+    }
+    std::string method = requestLine.substr(0, firstSpace);
+    std::string target = requestLine.substr(firstSpace + 1, secondSpace - firstSpace - 1);
+    std::string version = requestLine.substr(secondSpace + 1);
+    if (version != "HTTP/1.1" && version != "HTTP/1.0") {
+        rejectRequest(connection, 505, "HTTP Version Not Supported", false);
+        return true;
+    }
+
+    bool keepAlive = version == "HTTP/1.1";
+    bool hasContentLength = false;
+    bool expectContinue = false;
+    size_t contentLength = 0;
+    std::string contentType;
+
+    size_t pos = lineEnd + 2;
+    while (pos < headerEnd) {
+        size_t end = connection.input.find("\r\n", pos);
+        std::string line = connection.input.substr(pos, end - pos);
+        pos = end + 2;
+
+        size_t colon = line.find(':');
+        if (colon == std::string::npos || colon == 0) {
+            rejectRequest(connection, 400, "Bad Request", false);
+            return true;
+        }
+        std::string name = line.substr(0, colon);
+        std::string value = trim(line.substr(colon + 1));
+
+        if (equalsIgnoreCase(name, "Content-Length")) {
+            if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos || value.size() > 18) {
+                rejectRequest(connection, 400, "Bad Request", false);
+                return true;
+            }
+            size_t length = std::stoull(value);
+            if (hasContentLength && length != contentLength) {
+                rejectRequest(connection, 400, "Bad Request", false);
+                return true;
+            }
+            hasContentLength = true;
+            contentLength = length;
+        } else if (equalsIgnoreCase(name, "Transfer-Encoding")) {
+            // 内部客户端均带Content-Length，不支持分块请求体
+            rejectRequest(connection, 501, "Not Implemented", false);
+            return true;
+        } else if (equalsIgnoreCase(name, "Connection")) {
+            if (containsIgnoreCase(value, "close")) keepAlive = false;
+            else if (containsIgnoreCase(value, "keep-alive")) keepAlive = true;
+        } else if (equalsIgnoreCase(name, "Content-Type")) {
+            contentType = value;
+        } else if (equalsIgnoreCase(name, "Expect")) {
+            expectContinue = containsIgnoreCase(value, "100-continue");
+        }
+    }
+
+    if (contentLength > options.maxBodySize) {
+        rejectRequest(connection, 413, "Payload Too Large", false);
+        return true;
+    }
+
+    size_t total = headerEnd + 4 + contentLength;
+    if (connection.input.size() < total) {
+        if (expectContinue && !connection.continueSent) {
+            connection.continueSent = true;
+            connection.output += "HTTP/1.1 100 Continue\r\n\r\n";
+            return true;
+        }
+        return false;
+    }
+
+    std::string path = target.substr(0, target.find('?'));
+    if (path != "/api") {
+        connection.input.erase(0, total);
+        connection.continueSent = false;
+        rejectRequest(connection, 404, "Not Found", keepAlive);
+        return true;
+    }
+    if (method != "POST") {
+        connection.input.erase(0, total);
+        connection.continueSent = false;
+        rejectRequest(connection, 405, "Method Not Allowed", keepAlive, "Allow: POST\r\n");
+        return true;
+    }
+
+    std::string body = connection.input.substr(headerEnd + 4, contentLength);
+    connection.input.erase(0, total);
+    connection.continueSent = false;
+    connection.busy = true;
+    totalRequests.fetch_add(1, std::memory_order_relaxed);
+
+    WireFormat format = formatFor(contentType, body);
+    uint64_t id = connection.id;
+    bool submitted = workerPool->submit([this, id, keepAlive, format, body = std::move(body)]() {
+        Completion completion{id, keepAlive, format, std::string()};
+        processor(body, format, completion.response);
+        {
+            std::lock_guard<std::mutex> lock(completionMutex);
+            completions.push_back(std::move(completion));
+        }
+        uint64_t one = 1;
+        ssize_t ignored = ::write(wakeFd, &one, sizeof(one));
+        (void)ignored;
+    });
+    if (!submitted) {
+        connection.busy = false;
+        rejectRequest(connection, 503, "Service Unavailable", false);
+    }
+    return true;
+}
+
+void HttpFrontend::drainCompletions() {
+    std::vector<Completion> ready;
+    {
+        std::lock_guard<std::mutex> lock(completionMutex);
+        ready.swap(completions);
+    }
+
+    for (auto& completion : ready) {
+        auto it = connections.find(completion.connectionId);
+        if (it == connections.end()) continue;  // 客户端已断开
+
+        Connection& connection = *it->second;
+        connection.busy = false;
+        bool keepAlive = completion.keepAlive && !connection.closeAfterWrite && !connection.peerClosed;
+        queueResponse(connection, 200, "OK", contentTypeFor(completion.format), completion.response, keepAlive);
+        serviceConnection(completion.connectionId);
+    }
+}
+
+void HttpFrontend::closeIdleConnections(time_t now, bool stopping) {
+    std::vector<uint64_t> idle;
+    for (const auto& entry : connections) {
+        const Connection& connection = *entry.second;
+        if (connection.busy || connection.outputOffset < connection.output.size()) continue;
+        if (stopping || now - connection.lastActive >= options.idleTimeoutSeconds) {
+            idle.push_back(entry.first);
+        }
+    }
+    for (uint64_t id : idle) closeConnection(id);
+}
+
+void HttpFrontend::queueResponse(Connection& connection, int status, const char* reason, const char* contentType,
+                                 const std::string& body, bool keepAlive, const char* extraHeaders) {
+    std::string& out = connection.output;
+    out.reserve(out.size() + body.size() + 160);
+    out += "HTTP/1.1 ";
+    out += std::to_string(status);
+    out += ' ';
+    out += reason;
+    out += "\r\nContent-Type: ";
+    out += contentType;
+    out += "\r\nContent-Length: ";
+    out += std::to_string(body.size());
+    out += keepAlive ? "\r\nConnection: keep-alive\r\n" : "\r\nConnection: close\r\n";
+    out += extraHeaders;
+    out += "\r\n";
+    out += body;
+
+    if (!keepAlive) connection.closeAfterWrite = true;
+}
+
+void HttpFrontend::rejectRequest(Connection& connection, int status, const char* reason, bool keepAlive,
+                                 const char* extraHeaders) {
+    rejectedRequests.fetch_add(1, std::memory_order_relaxed);
+    if (!keepAlive) connection.input.clear();
+
+    std::string body;
+    JsonResponseWriter::write(body, "error", status, reason, nlohmann::json::object());
+    queueResponse(connection, status, reason, contentTypeFor(WireFormat::JSON), body, keepAlive, extraHeaders);
+}
+
+void HttpFrontend::updateInterest(Connection& connection) {
+    // 对端半关闭后不再关注可读：水平触发下EOF一直就绪，请求仍在工作线程中时事件循环会空转
+    bool wantRead = !connection.peerClosed;
+    bool wantWrite = connection.outputOffset < connection.output.size();
+    if (wantRead == connection.readInterest && wantWrite == connection.writeInterest) return;
+
+    epoll_event event;
+    event.events = 0;
+    if (wantRead) event.events |= EPOLLIN | EPOLLRDHUP;
+    if (wantWrite) event.events |= EPOLLOUT;
+    event.data.u64 = connection.id;
+    ::epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+    connection.readInterest = wantRead;
+    connection.writeInterest = wantWrite;
+}
+
+void HttpFrontend::closeConnection(uint64_t connectionId) {
+    auto it = connections.find(connectionId);
+    if (it == connections.end()) return;
+    ::epoll_ctl(epollFd, EPOLL_CTL_DEL, it->second->fd, nullptr);
+    ::close(it->second->fd);
+    connections.erase(it);
+}
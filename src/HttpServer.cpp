@@ -0,0 +1,331 @@
+#include <iostream>
+#include <memory>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include <getopt.h>
+#include "HospitalService.h"
+#include "CampusDirectory.h"
+#include "ApiHandler.h"
+#include "HttpFrontend.h"
+
+void printUsage(const char* programName) {
+    std::cout << "用法: " << programName << " [选项]" << std::endl;
+    std::cout << "选项:" << std::endl;
+    std::cout << "  --listen <地址:端口>  HTTP监听地址 (默认: 0.0.0.0:8080)" << std::endl;
+    std::cout << "  --workers <数量>      工作线程数 (默认: CPU核数)" << std::endl;
+    std::cout << "  --max-body <字节数>   请求体大小上限 (默认: 67108864)" << std::endl;
+    std::cout << "  --max-connections <数量> 最大并发连接数 (默认: 10000)" << std::endl;
+    std::cout << "  --idle-timeout <秒>   keep-alive空闲连接超时 (默认: 60)" << std::endl;
+    std::cout << "  --host <主机地址>     数据库主机地址 (默认: localhost)" << std::endl;
+    std::cout << "  --user <用户名>       数据库用户名 (默认: root)" << std::endl;
+    std::cout << "  --password <密码>     数据库密码 (默认: 空)" << std::endl;
+    std::cout << "  --database <数据库名> 数据库名称 (默认: hospital_db)" << std::endl;
+    std::cout << "  --bloom-file <文件路径> 启用用户名/邮箱/身份证号存在性过滤器并持久化到该文件" << std::endl;
+    std::cout << "  --replica <主机[:端口]> 只读副本，可重复指定；读取按复制延迟路由到副本" << std::endl;
+    std::cout << "  --shard-map <文件路径> 按分片映射文件把患者数据分布到多个数据库 (由ShardTool生成)" << std::endl;
+    std::cout << "  --campus <院区=主机[:端口]/数据库[@权重]> 多院区部署，可重复指定；各院区使用独立数据库和相同账号" << std::endl;
+    std::cout << "  --db-connections <数量> 多院区时所有院区合计的数据库连接上限 (默认: 每院区max(10, 工作线程数))" << std::endl;
+    std::cout << "  --db-connect-timeout <秒> 连接数据库的超时时间 (默认: 5)" << std::endl;
+    std::cout << "  --db-read-timeout <秒> 等待数据库响应的超时时间，同时用于写入 (默认: 不限制)" << std::endl;
+    std::cout << "  --db-faults <文件路径> 按规则文件给数据库访问注入延迟和错误，仅用于测试" << std::endl;
+    std::cout << "  --slow-query-log <文件路径> 把超过阈值的SQL语句及其执行计划记录到该文件（按大小轮转）" << std::endl;
+    std::cout << "  --slow-query-ms <毫秒> 慢查询阈值 (默认: 200)" << std::endl;
+    std::cout << "  --doctor-cache-ttl <秒> 医生信息与科室列表的缓存有效期，0表示不缓存 (默认: 60)" << std::endl;
+    std::cout << "  --query-cache-mb <MB> 计数等查询结果缓存的内存上限，0表示不缓存 (默认: 0)" << std::endl;
+    std::cout << "  --help               显示此帮助信息" << std::endl;
+    std::cout << std::endl;
+    std::cout << "示例:" << std::endl;
+    std::cout << "  " << programName << " --listen 0.0.0.0:8080 --workers 16 --password secret" << std::endl;
+    std::cout << "  " << programName << " --campus east=db1/hospital_east --campus west=db2/hospital_west@2 "
+              << "--db-connections 64" << std::endl;
+    std::cout << "  curl -X POST http://localhost:8080/api -d '{\"api\":\"public.doctor.get\",\"data\":{\"doctorId\":\"1\"}}'" << std::endl;
+}
+
+static HttpFrontend* activeFrontend = nullptr;
+
+// 多院区时按院区输出准入统计，便于发现某个院区的高峰挤占了其他院区
+void printCampusStats(ApiHandler& apiHandler, const CampusDirectory& campuses) {
+    if (!campuses.isMultiCampus()) return;
+    
+    json stats = apiHandler.getCampusStats();
+    for (const auto& campus : stats["campuses"]) {
+        const json& admission = campus["admission"];
+        std::cout << "院区 " << campus["id"].get<std::string>() << ": 准入 " << admission["admitted"]
+                  << " 个, 排队 " << admission["queued"] << " 个, 拒绝(队列满/超时/限流) "
+                  << admission["rejectedQueueFull"] << "/" << admission["rejectedTimeout"] << "/"
+                  << admission["rejectedRateLimit"] << " 个, 平均耗时 " << admission["averageServiceMs"] << "ms"
+                  << std::endl;
+    }
+    std::cout << "数据库连接: " << stats["connectionBudget"]["inUse"] << "/" << stats["connectionBudget"]["limit"]
+              << std::endl;
+}
+
+void handleStopSignal(int) {
+    if (activeFrontend) {
+        activeFrontend->requestStop();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "=== 医院管理系统 HTTP API 服务 ===" << std::endl;
+    
+    HttpFrontend::Options options;
+    options.workers = std::max(1u, std::thread::hardware_concurrency());
+    std::string listenAddress = "0.0.0.0:8080";
+    std::string host = "localhost";
+    std::string username = "root";
+    std::string password = "";
+    std::string database = "hospital_db";
+    std::string bloomFile;
+    std::vector<ReplicaEndpoint> replicas;
+    std::string shardMapFile;
+    std::vector<CampusSpec> campusSpecs;
+    size_t dbConnections = 0;
+    DatabaseConnection::Timeouts dbTimeouts;
+    std::string dbFaultsFile;
+    std::string slowQueryFile;
+    SlowQueryLog::Config slowQueryConfig;
+    DoctorDAO::CacheConfig doctorCacheConfig;
+    QueryCache::Config queryCacheConfig;
+    
+    static struct option long_options[] = {
+        {"listen",   required_argument, 0, 'l'},
+        {"workers",  required_argument, 0, 'w'},
+        {"max-body", required_argument, 0, 'm'},
+        {"max-connections", required_argument, 0, 'c'},
+        {"idle-timeout", required_argument, 0, 't'},
+        {"host",     required_argument, 0, 'h'},
+        {"user",     required_argument, 0, 'u'},
+        {"password", required_argument, 0, 'p'},
+        {"database", required_argument, 0, 'd'},
+        {"bloom-file", required_argument, 0, 'b'},
+        {"replica",  required_argument, 0, 'r'},
+        {"shard-map", required_argument, 0, 'S'},
+        {"campus",   required_argument, 0, 'C'},
+        {"db-connections", required_argument, 0, 'D'},
+        {"db-connect-timeout", required_argument, 0, 'T'},
+        {"db-read-timeout", required_argument, 0, 'R'},
+        {"db-faults", required_argument, 0, 'F'},
+        {"slow-query-log", required_argument, 0, 'L'},
+        {"slow-query-ms", required_argument, 0, 'M'},
+        {"doctor-cache-ttl", required_argument, 0, 'E'},
+        {"query-cache-mb", required_argument, 0, 'Q'},
+        {"help",     no_argument,       0, '?'},
+        {0, 0, 0, 0}
+    };
+    
+    int option_index = 0;
+    int c;
+    
+    while ((c = getopt_long(argc, argv, "l:w:m:c:t:h:u:p:d:b:r:S:C:D:T:R:F:L:M:E:Q:?", long_options, &option_index)) != -1) {
+        switch (c) {
+            case 'l':
+                listenAddress = optarg;
+                break;
+            case 'w':
+                options.workers = std::max(1, std::atoi(optarg));
+                break;
+            case 'm':
+                options.maxBodySize = std::strtoull(optarg, nullptr, 10);
+                break;
+            case 'c':
+                options.maxConnections = std::max(1, std::atoi(optarg));
+                break;
+            case 't':
+                options.idleTimeoutSeconds = std::max(1, std::atoi(optarg));
+                break;
+            case 'h':
+                host = optarg;
+                break;
+            case 'u':
+                username = optarg;
+                break;
+            case 'p':
+                password = optarg;
+                break;
+            case 'd':
+                database = optarg;
+                break;
+            case 'b':
+                bloomFile = optarg;
+                break;
+            case 'r': {
+                ReplicaEndpoint endpoint;
+                if (!ReplicaEndpoint::parse(optarg, endpoint)) {
+                    std::cerr << "错误: 无效的副本地址: " << optarg << std::endl;
+                    return 1;
+                }
+                replicas.push_back(endpoint);
+                break;
+            }
+            case 'S':
+                shardMapFile = optarg;
+                break;
+            case 'C': {
+                CampusSpec spec;
+                if (!CampusSpec::parse(optarg, spec)) {
+                    std::cerr << "错误: 无效的院区配置: " << optarg << std::endl;
+                    return 1;
+                }
+                campusSpecs.push_back(spec);
+                break;
+            }
+            case 'D':
+                dbConnections = std::max(1, std::atoi(optarg));
+                break;
+            case 'T':
+                dbTimeouts.connectSeconds = std::max(1, std::atoi(optarg));
+                break;
+            case 'R':
+                dbTimeouts.readSeconds = std::max(1, std::atoi(optarg));
+                dbTimeouts.writeSeconds = dbTimeouts.readSeconds;
+                break;
+            case 'F':
+                dbFaultsFile = optarg;
+                break;
+            case 'L':
+                slowQueryFile = optarg;
+                break;
+            case 'M':
+                slowQueryConfig.threshold = std::chrono::milliseconds(std::max(0, std::atoi(optarg)));
+                break;
+            case 'E':
+                doctorCacheConfig.ttl = std::chrono::seconds(std::max(0, std::atoi(optarg)));
+                if (doctorCacheConfig.ttl.count() == 0) doctorCacheConfig.capacity = 0;
+                break;
+            case 'Q':
+                queryCacheConfig.maxBytes = static_cast<size_t>(std::max(0, std::atoi(optarg))) * 1024 * 1024;
+                break;
+            case '?':
+            default:
+                printUsage(argv[0]);
+                return 0;
+        }
+    }
+    
+    size_t colon = listenAddress.rfind(':');
+    int port = colon == std::string::npos ? 0 : std::atoi(listenAddress.c_str() + colon + 1);
+    if (port <= 0 || port > 65535) {
+        std::cerr << "错误: 无效的监听地址: " << listenAddress << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+    options.host = listenAddress.substr(0, colon);
+    options.port = static_cast<uint16_t>(port);
+    
+    if (!campusSpecs.empty() && (!replicas.empty() || !shardMapFile.empty())) {
+        std::cerr << "错误: --campus 不能与 --replica、--shard-map 同时使用" << std::endl;
+        return 1;
+    }
+    // 数据库宕机时连接和等待响应有上限，熔断打开前的请求也不会长时间挂起
+    DatabaseConnection::setDefaultTimeouts(dbTimeouts);
+    // 本进程内对医生的修改立即失效缓存；其他进程的修改最迟在有效期后可见
+    DoctorDAO::setCacheConfig(doctorCacheConfig);
+    queryCacheConfig.deleteCascades = HospitalService::deleteCascades();
+    ConnectionPool::setDefaultQueryCache(queryCacheConfig);
+    // 故障注入规则文件优先于环境变量HOSPITAL_DB_FAULTS
+    if (!dbFaultsFile.empty()) {
+        std::string faultError;
+        auto injector = FaultInjector::load(dbFaultsFile, faultError);
+        if (!injector) {
+            std::cerr << "错误: 无效的故障注入规则: " << faultError << std::endl;
+            return 1;
+        }
+        DatabaseConnection::setFaultInjector(injector);
+    }
+    if (DatabaseConnection::getFaultInjector()) {
+        std::cerr << "警告: 已启用数据库故障注入" << std::endl;
+    }
+    if (!slowQueryFile.empty()) {
+        slowQueryConfig.path = slowQueryFile;
+        std::string logError;
+        auto slowQueryLog = SlowQueryLog::open(slowQueryConfig, logError);
+        if (!slowQueryLog) {
+            std::cerr << "错误: 无法打开慢查询日志: " << logError << std::endl;
+            return 1;
+        }
+        DatabaseConnection::setSlowQueryLog(slowQueryLog);
+    }
+    
+    try {
+        // 每个工作线程至少能拿到一个连接
+        size_t poolSize = std::max<size_t>(10, options.workers);
+        std::shared_ptr<CampusDirectory> campuses;
+        std::shared_ptr<HospitalService> hospitalService;
+        
+        if (!campusSpecs.empty()) {
+            // 多院区：各院区连接池共用一个连接预算
+            size_t budget = dbConnections ? dbConnections : poolSize * campusSpecs.size();
+            for (const auto& spec : campusSpecs) {
+                std::cout << "连接院区数据库: " << spec.id << " -> " << spec.host << "/" << spec.database
+                          << " (权重: " << spec.weight << ")" << std::endl;
+            }
+            campuses = CampusDirectory::connect(campusSpecs, username, password, budget);
+            if (!campuses) {
+                std::cerr << "错误: 院区标识重复" << std::endl;
+                return 1;
+            }
+            std::cout << "院区: " << campusSpecs.size() << " 个, 数据库连接上限: "
+                      << campuses->getBudget()->getLimit() << std::endl;
+        } else {
+            std::cout << "连接数据库: " << host << "/" << database << " (用户: " << username << ")" << std::endl;
+            hospitalService = std::make_shared<HospitalService>(host, username, password, database, 3306, poolSize);
+            campuses = CampusDirectory::single(hospitalService);
+        }
+        
+        // 多院区时每个院区各用一个过滤器文件
+        for (const auto& campus : campuses->getCampuses()) {
+            campus.service->initializeExistenceFilter(campus.id.empty() || bloomFile.empty()
+                                                          ? bloomFile : bloomFile + "." + campus.id);
+        }
+        if (!replicas.empty()) {
+            hospitalService->enableReadReplicas(replicas);
+            std::cout << "只读副本: " << replicas.size() << " 个" << std::endl;
+        }
+        
+        if (!shardMapFile.empty()) {
+            if (!hospitalService->enableSharding(shardMapFile)) {
+                std::cerr << "错误: 无法启用分片: " << shardMapFile << std::endl;
+                return 1;
+            }
+            std::cout << "患者数据分片: " << hospitalService->getShards()->size() << " 个" << std::endl;
+        }
+        
+        auto apiHandler = std::make_shared<ApiHandler>(campuses);
+        
+        HttpFrontend frontend(options, [apiHandler](const std::string& body, WireFormat format, std::string& response) {
+            apiHandler->processApiRequest(body, response, format);
+        });
+        // 请求内的扇出读取与请求本身在同一个线程池上调度
+        campuses->useWorkerPool(frontend.getWorkerPool());
+        
+        if (!frontend.start()) {
+            std::cerr << "启动HTTP服务失败: " << frontend.getError() << std::endl;
+            return 1;
+        }
+        
+        activeFrontend = &frontend;
+        std::signal(SIGINT, handleStopSignal);
+        std::signal(SIGTERM, handleStopSignal);
+        
+        std::cout << "HTTP服务已启动: http://" << listenAddress << "/api (工作线程: " << options.workers << ")" << std::endl;
+        frontend.run();
+        activeFrontend = nullptr;
+        
+        auto stats = frontend.getStats();
+        std::cout << "HTTP服务已停止: 连接 " << stats.connections << " 个, 请求 " << stats.requests
+                  << " 个, 拒绝 " << stats.rejectedRequests << " 个" << std::endl;
+        printCampusStats(*apiHandler, *campuses);
+        
+    } catch (const std::exception& e) {
+        std::cerr << "服务异常退出: " << e.what() << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
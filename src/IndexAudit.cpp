@@ -0,0 +1,611 @@
+#include <getopt.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <regex>
+#include <set>
+#include <string>
+#include <vector>
+#include "HospitalService.h"
+#include "SchemaIndexes.h"
+#include "SlowQueryLog.h"
+
+#if __has_include(<nlohmann/json.hpp>)
+    #include <nlohmann/json.hpp>
+#elif __has_include(<json/json.hpp>)
+    #include <json/json.hpp>
+#else
+    #error "nlohmann/json library not found. Please install nlohmann-json3-dev package."
+#endif
+
+// 索引审计工具：以各DAO读取方法的实际语句取得EXPLAIN执行计划，报告全表扫描、
+// 全索引扫描、文件排序与临时表，以及审计期间没有被任何语句使用的二级索引。
+// 计划依赖数据分布，应在接近生产规模的数据上运行，可用--seed生成合成数据。
+
+namespace {
+
+const char* const kDepartments[] = {"内科", "外科", "儿科", "妇产科", "眼科", "耳鼻喉科", "口腔科", "皮肤科", "神经科", "急诊科"};
+const char* const kMedications[] = {"阿莫西林", "布洛芬", "对乙酰氨基酚", "头孢克肟", "奥美拉唑",
+                                    "二甲双胍", "阿司匹林", "氯雷他定", "蒙脱石散", "维生素C"};
+const char* const kStatuses[] = {"Booked", "Attended", "Cancelled"};
+
+// 每条INSERT语句携带的行数
+const size_t kInsertBatchRows = 1000;
+
+struct Options {
+    std::string host = "localhost";
+    unsigned int port = 3306;
+    std::string username = "root";
+    std::string password = "";
+    std::string database = "hospital_db";
+    long seedPatients = 0;
+    bool migrate = false;
+};
+
+void printUsage(const char* programName) {
+    std::cout << "用法: " << programName << " [选项]" << std::endl;
+    std::cout << "选项:" << std::endl;
+    std::cout << "  --host <主机地址>     数据库地址 (默认: localhost)" << std::endl;
+    std::cout << "  --port <端口>         数据库端口 (默认: 3306)" << std::endl;
+    std::cout << "  --user <用户名>       数据库用户名 (默认: root)" << std::endl;
+    std::cout << "  --password <密码>     数据库密码 (默认: 空)" << std::endl;
+    std::cout << "  --database <数据库名> 数据库名称 (默认: hospital_db)" << std::endl;
+    std::cout << "  --seed <患者数>       在空库中建表并生成合成数据后再审计" << std::endl;
+    std::cout << "  --migrate             审计前把已有库的索引迁移到当前定义" << std::endl;
+    std::cout << "退出码: 0 没有发现问题，1 有非预期的扫描或排序，2 执行出错" << std::endl;
+}
+
+// 把多行VALUES攒成一条INSERT，满批后执行
+class BatchInsert {
+public:
+    BatchInsert(DatabaseConnection& conn, const std::string& prefix) : conn(conn), prefix(prefix) {}
+
+    bool add(const std::string& row) {
+        values += rows > 0 ? ", (" : "(";
+        values += row;
+        values += ")";
+        return ++rows < kInsertBatchRows || flush();
+    }
+
+    bool flush() {
+        if (rows == 0) return true;
+        bool ok = conn.executeUpdate(prefix + values);
+        if (!ok) std::cerr << "插入失败: " << conn.getError() << std::endl;
+        values.clear();
+        rows = 0;
+        return ok;
+    }
+
+private:
+    DatabaseConnection& conn;
+    std::string prefix;
+    std::string values;
+    size_t rows = 0;
+};
+
+std::string quoted(DatabaseConnection& conn, const std::string& value) {
+    return "'" + conn.escapeString(value) + "'";
+}
+
+std::string dateTime(std::mt19937& random, int firstYear) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d %02d:%02d:00",
+                  firstYear + static_cast<int>(random() % 5), static_cast<int>(random() % 12) + 1,
+                  static_cast<int>(random() % 28) + 1, static_cast<int>(random() % 10) + 8,
+                  static_cast<int>(random() % 4) * 15);
+    return buffer;
+}
+
+std::string queryValue(DatabaseConnection& conn, const std::string& query) {
+    std::string value;
+    if (MYSQL_RES* result = conn.executeQuery(query)) {
+        MYSQL_ROW row = mysql_fetch_row(result);
+        if (row && row[0]) value = row[0];
+        mysql_free_result(result);
+    }
+    return value;
+}
+
+// 按外键依赖顺序插入，主键显式指定以便直接引用；固定随机种子使数据可重现
+bool seed(DatabaseConnection& conn, long patients) {
+    std::mt19937 random(20240101);
+    long doctors = std::max(20L, patients / 50);
+    size_t departmentCount = sizeof(kDepartments) / sizeof(kDepartments[0]);
+    size_t medicationCount = sizeof(kMedications) / sizeof(kMedications[0]);
+
+    std::cout << "生成 " << doctors << " 名医生、" << patients << " 名患者..." << std::endl;
+    BatchInsert users(conn, "INSERT INTO users (user_id, username, password, user_type, email, phone_number) VALUES ");
+    for (long id = 1; id <= doctors + patients; ++id) {
+        bool doctor = id <= doctors;
+        std::string name = (doctor ? "doctor" : "patient") + std::to_string(id);
+        if (!users.add(std::to_string(id) + ", '" + name + "', 'x', '" + (doctor ? "Doctor" : "Patient") + "', '" +
+                       name + "@example.com', '138" + std::to_string(10000000 + id) + "'")) {
+            return false;
+        }
+    }
+    if (!users.flush()) return false;
+
+    BatchInsert doctorRows(conn, "INSERT INTO doctors (doctor_id, user_id, name, department, title, working_hours) VALUES ");
+    for (long id = 1; id <= doctors; ++id) {
+        if (!doctorRows.add(std::to_string(id) + ", " + std::to_string(id) + ", " + quoted(conn, "医生" + std::to_string(id)) +
+                            ", " + quoted(conn, kDepartments[id % departmentCount]) + ", " + quoted(conn, "主治医师") +
+                            ", '08:00-17:00'")) {
+            return false;
+        }
+    }
+    if (!doctorRows.flush()) return false;
+
+    BatchInsert patientRows(conn, "INSERT INTO patients (patient_id, user_id, name, gender, birth_date, id_number) VALUES ");
+    for (long id = 1; id <= patients; ++id) {
+        char birthDate[16];
+        std::snprintf(birthDate, sizeof(birthDate), "%04d-%02d-%02d", 1940 + static_cast<int>(random() % 80),
+                      static_cast<int>(random() % 12) + 1, static_cast<int>(random() % 28) + 1);
+        if (!patientRows.add(std::to_string(id) + ", " + std::to_string(doctors + id) + ", " +
+                             quoted(conn, "患者" + std::to_string(id)) + ", '" + (random() % 2 ? "Male" : "Female") +
+                             "', '" + birthDate + "', '" + std::to_string(110000000000000000LL + id) + "'")) {
+            return false;
+        }
+    }
+    if (!patientRows.flush()) return false;
+
+    // 各表分批写入的进度不同，药品批次可能先于其处方写入；数据按构造保证引用完整
+    std::cout << "生成病例、处方、药品、预约与住院记录..." << std::endl;
+    if (!conn.executeUpdate("SET FOREIGN_KEY_CHECKS = 0")) return false;
+    BatchInsert cases(conn, "INSERT INTO cases (case_id, patient_id, department, doctor_id, diagnosis, diagnosis_date) VALUES ");
+    BatchInsert prescriptions(conn, "INSERT INTO prescriptions (prescription_id, case_id, doctor_id, prescription_content, issued_date) VALUES ");
+    BatchInsert medications(conn, "INSERT INTO medications (prescription_id, medication_name, quantity, usage_instructions) VALUES ");
+    BatchInsert appointments(conn, "INSERT INTO appointments (patient_id, doctor_id, appointment_time, department, status) VALUES ");
+    BatchInsert hospitalizations(conn, "INSERT INTO hospitalization (patient_id, ward_number, bed_number, admission_date, attending_doctor) VALUES ");
+    long caseId = 0;
+    for (long patient = 1; patient <= patients; ++patient) {
+        for (int i = 0; i < 3; ++i) {
+            long doctor = static_cast<long>(random() % doctors) + 1;
+            std::string department = quoted(conn, kDepartments[doctor % departmentCount]);
+            std::string date = dateTime(random, 2020);
+            ++caseId;
+            std::string id = std::to_string(caseId);
+            if (!cases.add(id + ", " + std::to_string(patient) + ", " + department + ", " + std::to_string(doctor) + ", " +
+                           quoted(conn, "诊断记录" + id) + ", '" + date + "'") ||
+                !prescriptions.add(id + ", " + id + ", " + std::to_string(doctor) + ", " + quoted(conn, "处方" + id) +
+                                   ", '" + date + "'")) {
+                return false;
+            }
+            for (int m = 0; m < 2; ++m) {
+                if (!medications.add(id + ", " + quoted(conn, kMedications[random() % medicationCount]) + ", " +
+                                     std::to_string(random() % 30 + 1) + ", " + quoted(conn, "每日三次"))) {
+                    return false;
+                }
+            }
+        }
+        for (int i = 0; i < 4; ++i) {
+            long doctor = static_cast<long>(random() % doctors) + 1;
+            if (!appointments.add(std::to_string(patient) + ", " + std::to_string(doctor) + ", '" + dateTime(random, 2022) +
+                                  "', " + quoted(conn, kDepartments[doctor % departmentCount]) + ", '" +
+                                  kStatuses[random() % 3] + "'")) {
+                return false;
+            }
+        }
+        if (random() % 10 < 3) {
+            if (!hospitalizations.add(std::to_string(patient) + ", 'W" + std::to_string(random() % 40 + 1) + "', 'B" +
+                                      std::to_string(random() % 60 + 1) + "', '" + dateTime(random, 2020) + "', " +
+                                      quoted(conn, "医生" + std::to_string(random() % doctors + 1)))) {
+                return false;
+            }
+        }
+    }
+    bool flushed = cases.flush() && prescriptions.flush() && medications.flush() && appointments.flush() &&
+                   hospitalizations.flush();
+    if (!conn.executeUpdate("SET FOREIGN_KEY_CHECKS = 1") || !flushed) return false;
+
+    // 刷新统计信息，否则优化器按空表估算
+    for (const char* table : {"users", "doctors", "patients", "cases", "appointments", "hospitalization", "prescriptions", "medications"}) {
+        if (MYSQL_RES* result = conn.executeQuery(std::string("ANALYZE TABLE ") + table)) {
+            mysql_free_result(result);
+        }
+    }
+    return true;
+}
+
+// 审计用的样本值，取自现有数据
+struct Samples {
+    int userId = 1;
+    int doctorUserId = 1;
+    int patientUserId = 1;
+    int doctorId = 1;
+    int patientId = 1;
+    int caseId = 1;
+    int appointmentId = 1;
+    int hospitalizationId = 1;
+    int prescriptionId = 1;
+    int medicationId = 1;
+    std::string username;
+    std::string email;
+    std::string department;
+    std::string idNumber;
+    std::string ward;
+    std::string bed;
+    std::string medication;
+};
+
+int toInt(const std::string& value, int fallback) {
+    return value.empty() ? fallback : std::atoi(value.c_str());
+}
+
+Samples pickSamples(DatabaseConnection& conn) {
+    Samples samples;
+    samples.userId = toInt(queryValue(conn, "SELECT MIN(user_id) FROM users"), 1);
+    samples.doctorId = toInt(queryValue(conn, "SELECT MIN(doctor_id) FROM doctors"), 1);
+    samples.doctorUserId = toInt(queryValue(conn, "SELECT user_id FROM doctors WHERE doctor_id = " + std::to_string(samples.doctorId)), 1);
+    samples.patientId = toInt(queryValue(conn, "SELECT MIN(patient_id) FROM patients"), 1);
+    samples.patientUserId = toInt(queryValue(conn, "SELECT user_id FROM patients WHERE patient_id = " + std::to_string(samples.patientId)), 1);
+    samples.caseId = toInt(queryValue(conn, "SELECT MIN(case_id) FROM cases"), 1);
+    samples.appointmentId = toInt(queryValue(conn, "SELECT MIN(appointment_id) FROM appointments"), 1);
+    samples.hospitalizationId = toInt(queryValue(conn, "SELECT MIN(hospitalization_id) FROM hospitalization"), 1);
+    samples.prescriptionId = toInt(queryValue(conn, "SELECT MIN(prescription_id) FROM prescriptions"), 1);
+    samples.medicationId = toInt(queryValue(conn, "SELECT MIN(medication_id) FROM medications"), 1);
+    samples.username = queryValue(conn, "SELECT username FROM users WHERE user_id = " + std::to_string(samples.userId));
+    samples.email = queryValue(conn, "SELECT email FROM users WHERE user_id = " + std::to_string(samples.userId));
+    samples.department = queryValue(conn, "SELECT department FROM doctors WHERE doctor_id = " + std::to_string(samples.doctorId));
+    samples.idNumber = queryValue(conn, "SELECT id_number FROM patients WHERE patient_id = " + std::to_string(samples.patientId));
+    samples.ward = queryValue(conn, "SELECT ward_number FROM hospitalization WHERE hospitalization_id = " + std::to_string(samples.hospitalizationId));
+    samples.bed = queryValue(conn, "SELECT bed_number FROM hospitalization WHERE hospitalization_id = " + std::to_string(samples.hospitalizationId));
+    samples.medication = queryValue(conn, "SELECT medication_name FROM medications WHERE medication_id = " + std::to_string(samples.medicationId));
+    return samples;
+}
+
+// 依次调用各DAO的读取方法与服务层的联表查询；结果不需要，只为让语句经过慢查询日志
+void exerciseReads(HospitalService& service, const Samples& s) {
+    UserDAO* users = service.getUserDAO();
+    users->getUserById(s.userId);
+    users->getUserByUsername(s.username);
+    users->getUserByEmail(s.email);
+    users->getAllUsers();
+    users->getActiveUsers();
+    users->searchUsers("user");
+    users->userExists(s.username);
+    users->userExists(s.username, s.email);
+    users->getUserCount();
+
+    DoctorDAO* doctors = service.getDoctorDAO();
+    doctors->getDoctorById(s.doctorId);
+    doctors->getDoctorByUserId(s.doctorUserId);
+    doctors->getAllDoctors();
+    doctors->getDoctorsByDepartment(s.department);
+    doctors->searchDoctors("医生");
+    doctors->getAllDepartments();
+    doctors->getDoctorCount();
+    doctors->getDoctorCountByDepartment(s.department);
+
+    PatientDAO* patients = service.getPatientDAO();
+    patients->getPatientById(s.patientId);
+    patients->getPatientByUserId(s.patientUserId);
+    patients->getPatientByIdNumber(s.idNumber);
+    patients->getAllPatients();
+    patients->searchPatients("患者");
+    patients->getPatientsByGender(Gender::FEMALE);
+    patients->patientExists(s.idNumber);
+    patients->getPatientCount();
+
+    CaseDAO* cases = service.getCaseDAO();
+    cases->getCaseById(s.caseId);
+    cases->getCasesByPatientId(s.patientId);
+    cases->getCasesByDoctorId(s.doctorId);
+    cases->getCasesByDepartment(s.department);
+    cases->getAllCases();
+    cases->searchCases("诊断");
+    cases->getCaseCount();
+    cases->getCaseCountByDoctor(s.doctorId);
+    cases->getCaseCountByPatient(s.patientId);
+
+    AppointmentDAO* appointments = service.getAppointmentDAO();
+    appointments->getAppointmentById(s.appointmentId);
+    appointments->getAppointmentsByPatientId(s.patientId);
+    appointments->getAppointmentsByDoctorId(s.doctorId);
+    appointments->getAppointmentsByDepartment(s.department);
+    appointments->getAppointmentsByStatus(AppointmentStatus::BOOKED);
+    appointments->getAllAppointments();
+    appointments->searchAppointments("科");
+    appointments->getAppointmentCount();
+    appointments->getAppointmentCountByStatus(AppointmentStatus::BOOKED);
+    appointments->getAppointmentCountByDoctor(s.doctorId);
+
+    HospitalizationDAO* hospitalizations = service.getHospitalizationDAO();
+    hospitalizations->getHospitalizationById(s.hospitalizationId);
+    hospitalizations->getHospitalizationsByPatientId(s.patientId);
+    hospitalizations->getHospitalizationsByWard(s.ward);
+    hospitalizations->getAllHospitalizations();
+    hospitalizations->getAvailableBeds(s.ward);
+    hospitalizations->isBedOccupied(s.ward, s.bed);
+    hospitalizations->getAllWards();
+    hospitalizations->searchHospitalizations("W");
+    hospitalizations->getHospitalizationCount();
+    hospitalizations->getCurrentHospitalizationCount();
+
+    PrescriptionDAO* prescriptions = service.getPrescriptionDAO();
+    prescriptions->getPrescriptionById(s.prescriptionId);
+    prescriptions->getPrescriptionsByCaseId(s.caseId);
+    prescriptions->getPrescriptionsByDoctorId(s.doctorId);
+    prescriptions->getAllPrescriptions();
+    prescriptions->searchPrescriptions("处方");
+    prescriptions->getPrescriptionCount();
+    prescriptions->getPrescriptionCountByDoctor(s.doctorId);
+
+    MedicationDAO* medications = service.getMedicationDAO();
+    medications->getMedicationById(s.medicationId);
+    medications->getMedicationsByPrescriptionId(s.prescriptionId);
+    medications->getAllMedications();
+    medications->searchMedications("素");
+    medications->getMedicationsByName(s.medication);
+    medications->getMedicationCount();
+    medications->getTotalQuantityByName(s.medication);
+
+    service.getPatientCaseHistory(s.patientId);
+    service.getDoctorAppointments(s.doctorId);
+    service.getDoctorsWithBookingCounts();
+    service.getHospitalStats();
+    service.getPatientProfile(s.patientUserId);
+    service.getDoctorProfile(s.doctorUserId);
+}
+
+struct PlanFindings {
+    std::vector<std::string> scans;           // 全表或全索引扫描的表
+    bool filesort = false;
+    bool temporary = false;
+    std::set<std::pair<std::string, std::string>> keys;  // (表名或别名, 索引名)
+};
+
+// MySQL与MariaDB的JSON计划结构不同，递归查找两者共有的几个字段
+void walkPlan(const nlohmann::json& node, PlanFindings& findings) {
+    if (node.is_array()) {
+        for (const auto& child : node) walkPlan(child, findings);
+        return;
+    }
+    if (!node.is_object()) return;
+    if (node.contains("access_type") && node["access_type"].is_string()) {
+        std::string table = node.value("table_name", std::string("?"));
+        std::string access = node["access_type"];
+        if (access == "ALL" || access == "index") {
+            findings.scans.push_back(table + (access == "ALL" ? "(全表扫描)" : "(全索引扫描)"));
+        }
+        if (node.contains("key") && node["key"].is_string()) {
+            findings.keys.emplace(table, node["key"].get<std::string>());
+        }
+    }
+    for (auto it = node.begin(); it != node.end(); ++it) {
+        if ((it.key() == "using_filesort" && it->is_boolean() && it->get<bool>()) || it.key() == "filesort") {
+            findings.filesort = true;
+        }
+        if ((it.key() == "using_temporary_table" && it->is_boolean() && it->get<bool>()) || it.key() == "temporary_table") {
+            findings.temporary = true;
+        }
+        walkPlan(*it, findings);
+    }
+}
+
+// 语句中"FROM 表 别名"与"JOIN 表 别名"的别名到表名映射
+std::map<std::string, std::string> tableAliases(const std::string& statement) {
+    static const std::regex pattern(R"(\b(?:FROM|JOIN)\s+(\w+)(?:\s+(?:AS\s+)?(\w+))?)", std::regex::icase);
+    static const std::set<std::string> keywords = {"WHERE", "JOIN", "ON", "ORDER", "GROUP", "LIMIT", "LEFT", "RIGHT", "INNER"};
+    std::map<std::string, std::string> aliases;
+    for (auto it = std::sregex_iterator(statement.begin(), statement.end(), pattern); it != std::sregex_iterator(); ++it) {
+        std::string table = (*it)[1];
+        aliases[table] = table;
+        std::string alias = (*it)[2];
+        std::string upper = alias;
+        std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+        if (!alias.empty() && !keywords.count(upper)) aliases[alias] = table;
+    }
+    return aliases;
+}
+
+// 全表扫描本就无法避免的语句：没有WHERE条件的整表读取与统计，以及前缀通配的LIKE搜索
+bool scanExpected(const std::string& statement) {
+    return statement.find(" WHERE ") == std::string::npos || statement.find("LIKE ?") != std::string::npos;
+}
+
+// 审计库中的二级索引，跳过主键、唯一键与外键所需的索引
+std::set<std::pair<std::string, std::string>> auditedIndexes(DatabaseConnection& conn) {
+    std::set<std::pair<std::string, std::string>> indexes;
+    MYSQL_RES* result = conn.executeQuery(
+        "SELECT s.TABLE_NAME, s.INDEX_NAME FROM information_schema.STATISTICS s "
+        "WHERE s.TABLE_SCHEMA = DATABASE() AND s.NON_UNIQUE = 1 AND s.SEQ_IN_INDEX = 1 AND NOT EXISTS ("
+        "SELECT 1 FROM information_schema.KEY_COLUMN_USAGE k WHERE k.TABLE_SCHEMA = s.TABLE_SCHEMA "
+        "AND k.TABLE_NAME = s.TABLE_NAME AND k.COLUMN_NAME = s.COLUMN_NAME AND k.REFERENCED_TABLE_NAME IS NOT NULL)");
+    if (!result) return indexes;
+    while (MYSQL_ROW row = mysql_fetch_row(result)) {
+        if (row[0] && row[1]) indexes.emplace(row[0], row[1]);
+    }
+    mysql_free_result(result);
+    return indexes;
+}
+
+int runAudit(HospitalService& service, const std::string& database) {
+    auto pool = service.getConnectionPool();
+    auto conn = pool->getConnection();
+    if (!conn) {
+        std::cerr << "无法连接数据库" << std::endl;
+        return 2;
+    }
+    Samples samples = pickSamples(*conn);
+    auto indexes = auditedIndexes(*conn);
+    pool->returnConnection(std::move(conn));
+
+    // 阈值为0使每条语句都进入日志，每种语句形状附带一次执行计划
+    char logPath[] = "/tmp/index_audit_XXXXXX";
+    int fd = mkstemp(logPath);
+    if (fd < 0) {
+        std::cerr << "无法创建临时文件" << std::endl;
+        return 2;
+    }
+    close(fd);
+    SlowQueryLog::Config config;
+    config.path = logPath;
+    config.threshold = std::chrono::milliseconds(0);
+    config.maxBytes = static_cast<size_t>(1) << 40;
+    std::string error;
+    auto log = SlowQueryLog::open(config, error);
+    if (!log) {
+        std::cerr << "无法打开日志: " << error << std::endl;
+        std::remove(logPath);
+        return 2;
+    }
+    DatabaseConnection::setSlowQueryLog(log);
+    exerciseReads(service, samples);
+    DatabaseConnection::setSlowQueryLog(nullptr);
+    log.reset();
+
+    std::ifstream in(logPath);
+    std::string line;
+    std::set<std::string> seen;
+    std::set<std::pair<std::string, std::string>> used;
+    int problems = 0;
+    int expected = 0;
+    int unplanned = 0;
+    std::cout << "=== 数据库 " << database << " 的语句执行计划 ===" << std::endl;
+    while (std::getline(in, line)) {
+        nlohmann::json entry = nlohmann::json::parse(line, nullptr, false);
+        if (entry.is_discarded() || !entry.contains("statement")) continue;
+        std::string statement = entry["statement"];
+        if (!entry.contains("plan")) {
+            // 多语句批量与重复的语句形状没有计划
+            if (!seen.count(statement) && statement.find("; ") != std::string::npos) {
+                ++unplanned;
+                std::cout << "[未分析] " << entry.value("caller", std::string()) << ": 多语句批量，EXPLAIN只接受单条语句" << std::endl;
+            }
+            seen.insert(statement);
+            continue;
+        }
+        seen.insert(statement);
+
+        PlanFindings findings;
+        walkPlan(entry["plan"], findings);
+        auto aliases = tableAliases(statement);
+        for (const auto& key : findings.keys) {
+            auto alias = aliases.find(key.first);
+            used.emplace(alias != aliases.end() ? alias->second : key.first, key.second);
+        }
+
+        bool flagged = !findings.scans.empty() || findings.filesort || findings.temporary;
+        bool tolerated = flagged && scanExpected(statement);
+        std::string tag = !flagged ? "[正常]" : tolerated ? "[预期]" : "[问题]";
+        if (flagged) {
+            tolerated ? ++expected : ++problems;
+        }
+        std::cout << tag << " " << entry.value("caller", std::string()) << std::endl;
+        std::cout << "    " << statement << std::endl;
+        std::cout << "    耗时 " << entry.value("durationMs", 0.0) << "ms, 行数 " << entry.value("rows", -1L);
+        std::string keys;
+        for (const auto& key : findings.keys) keys += (keys.empty() ? "" : ", ") + key.first + "." + key.second;
+        std::cout << ", 索引 " << (keys.empty() ? "无" : keys);
+        for (const auto& scan : findings.scans) std::cout << ", " << scan;
+        if (findings.filesort) std::cout << ", 文件排序";
+        if (findings.temporary) std::cout << ", 临时表";
+        std::cout << std::endl;
+    }
+    in.close();
+    std::remove(logPath);
+
+    std::cout << "=== 未被使用的二级索引（不含外键所需的索引）===" << std::endl;
+    int unused = 0;
+    for (const auto& index : indexes) {
+        if (used.count(index)) continue;
+        ++unused;
+        std::cout << "[警告] " << index.first << "." << index.second << std::endl;
+    }
+    if (unused == 0) std::cout << "无" << std::endl;
+
+    std::cout << "=== 汇总 ===" << std::endl;
+    std::cout << "语句形状: " << seen.size() << ", 问题: " << problems << ", 预期的扫描: " << expected
+              << ", 未分析: " << unplanned << ", 未使用的索引: " << unused << std::endl;
+    return problems > 0 ? 1 : 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+
+    static struct option long_options[] = {
+        {"host",     required_argument, 0, 'h'},
+        {"port",     required_argument, 0, 'P'},
+        {"user",     required_argument, 0, 'u'},
+        {"password", required_argument, 0, 'p'},
+        {"database", required_argument, 0, 'd'},
+        {"seed",     required_argument, 0, 's'},
+        {"migrate",  no_argument,       0, 'm'},
+        {"help",     no_argument,       0, '?'},
+        {0, 0, 0, 0}
+    };
+
+    int option_index = 0;
+    int c;
+
+    while ((c = getopt_long(argc, argv, "h:P:u:p:d:s:m?", long_options, &option_index)) != -1) {
+        switch (c) {
+            case 'h':
+                options.host = optarg;
+                break;
+            case 'P':
+                options.port = static_cast<unsigned int>(std::max(1, std::atoi(optarg)));
+                break;
+            case 'u':
+                options.username = optarg;
+                break;
+            case 'p':
+                options.password = optarg;
+                break;
+            case 'd':
+                options.database = optarg;
+                break;
+            case 's':
+                options.seedPatients = std::max(1L, std::atol(optarg));
+                break;
+            case 'm':
+                options.migrate = true;
+                break;
+            case '?':
+            default:
+                printUsage(argv[0]);
+                return 0;
+        }
+    }
+
+    try {
+        // 审计逐条顺序执行，少量连接即可
+        HospitalService service(options.host, options.username, options.password, options.database, options.port, 2);
+
+        if (options.seedPatients > 0 || options.migrate) {
+            // createTables在建表后迁移已有表的索引
+            if (!service.createTables()) {
+                std::cerr << "建表或索引迁移失败" << std::endl;
+                return 2;
+            }
+        }
+        if (options.seedPatients > 0) {
+            auto pool = service.getConnectionPool();
+            auto conn = pool->getConnection();
+            if (!conn) {
+                std::cerr << "无法连接数据库" << std::endl;
+                return 2;
+            }
+            if (queryValue(*conn, "SELECT COUNT(*) FROM users") != "0") {
+                std::cerr << "数据库 " << options.database << " 不是空库，拒绝生成合成数据" << std::endl;
+                pool->returnConnection(std::move(conn));
+                return 2;
+            }
+            bool seeded = seed(*conn, options.seedPatients);
+            pool->returnConnection(std::move(conn));
+            if (!seeded) return 2;
+        }
+        return runAudit(service, options.database);
+    } catch (const std::exception& e) {
+        std::cerr << "错误: " << e.what() << std::endl;
+        return 2;
+    }
+}
@@ -2,9 +2,29 @@
 #include <fstream>
 #include <memory>
 #include <string>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cerrno>
+#include <csignal>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
 #include <getopt.h>
+#include <unistd.h>
 #include "HospitalService.h"
+#include "CampusDirectory.h"
 #include "ApiHandler.h"
+#include "ThreadPool.h"
+#include "UnixSocketServer.h"
+
+namespace fs = std::filesystem;
 
 void printUsage(const char* programName) {
     std::cout << "用法: " << programName << " [选项]" << std::endl;
@@ -15,50 +35,416 @@ void printUsage(const char* programName) {
     std::cout << "  --user <用户名>       数据库用户名 (默认: root)" << std::endl;
     std::cout << "  --password <密码>     数据库密码 (默认: 空)" << std::endl;
     std::cout << "  --database <数据库名> 数据库名称 (默认: hospital_db)" << std::endl;
+    std::cout << "  --bloom-file <文件路径> 启用用户名/邮箱/身份证号存在性过滤器并持久化到该文件" << std::endl;
+    std::cout << "  --format <格式>       请求/响应编码: auto, json, msgpack, cbor (默认: auto，按首字节识别)" << std::endl;
+    std::cout << "  --serve <套接字路径>  常驻模式：在Unix域套接字上接收长度前缀帧请求，SIGINT/SIGTERM优雅退出" << std::endl;
+    std::cout << "  --stdin-ndjson        流式模式：从标准输入逐行读取JSON请求，按输入顺序逐行输出响应到标准输出" << std::endl;
+    std::cout << "  --batch-dir <输入目录> <输出目录>  批量模式：处理输入目录下所有*.json，按相同相对路径写入输出目录" << std::endl;
+    std::cout << "  --workers <数量>      常驻/流式/批量模式的工作线程数 (默认: CPU核数)" << std::endl;
+    std::cout << "  --max-connections <数量> 常驻模式的最大并发连接数 (默认: 1024)" << std::endl;
+    std::cout << "  --ordered             流式/批量模式下，token相同（无token时account/email相同）的请求按输入顺序逐个执行" << std::endl;
+    std::cout << "  --replica <主机[:端口]> 只读副本，可重复指定；读取按复制延迟路由到副本" << std::endl;
+    std::cout << "  --shard-map <文件路径> 按分片映射文件把患者数据分布到多个数据库 (由ShardTool生成)" << std::endl;
+    std::cout << "  --campus <院区=主机[:端口]/数据库[@权重]> 多院区部署，可重复指定；各院区使用独立数据库和相同账号" << std::endl;
+    std::cout << "  --db-connections <数量> 多院区时所有院区合计的数据库连接上限 (默认: 每院区max(10, 工作线程数))" << std::endl;
+    std::cout << "  --db-connect-timeout <秒> 连接数据库的超时时间 (默认: 5)" << std::endl;
+    std::cout << "  --db-read-timeout <秒> 等待数据库响应的超时时间，同时用于写入 (默认: 不限制)" << std::endl;
+    std::cout << "  --db-faults <文件路径> 按规则文件给数据库访问注入延迟和错误，仅用于测试" << std::endl;
+    std::cout << "  --slow-query-log <文件路径> 把超过阈值的SQL语句及其执行计划记录到该文件（按大小轮转）" << std::endl;
+    std::cout << "  --slow-query-ms <毫秒> 慢查询阈值 (默认: 200)" << std::endl;
+    std::cout << "  --doctor-cache-ttl <秒> 医生信息与科室列表的缓存有效期，0表示不缓存 (默认: 60)" << std::endl;
+    std::cout << "  --query-cache-mb <MB> 计数等查询结果缓存的内存上限，0表示不缓存 (默认: 0)" << std::endl;
     std::cout << "  --help               显示此帮助信息" << std::endl;
     std::cout << std::endl;
     std::cout << "示例:" << std::endl;
     std::cout << "  " << programName << " --input request.json --output response.json" << std::endl;
     std::cout << "  " << programName << " --input test.json --output result.json --host 192.168.1.100 --user admin" << std::endl;
+    std::cout << "  " << programName << " --input upload.msgpack --output result.msgpack" << std::endl;
+    std::cout << "  " << programName << " --serve /run/hospital/api.sock --workers 16" << std::endl;
+    std::cout << "  " << programName << " --stdin-ndjson < requests.ndjson > responses.ndjson" << std::endl;
+    std::cout << "  " << programName << " --batch-dir test build/test_results" << std::endl;
+    std::cout << "  " << programName << " --serve /run/hospital/api.sock --campus east=db1/hospital_east "
+              << "--campus west=db2/hospital_west@2 --db-connections 64" << std::endl;
 }
 
-std::string readFileContent(const std::string& filePath) {
-    std::ifstream file(filePath);
+bool readWholeFile(const std::string& filePath, std::string& content) {
+    // 按二进制一次性读入，MessagePack/CBOR请求不能按行处理
+    std::ifstream file(filePath, std::ios::binary | std::ios::ate);
     if (!file.is_open()) {
-        throw std::runtime_error("无法打开输入文件: " + filePath);
+        return false;
     }
     
-    std::string content;
-    std::string line;
-    while (std::getline(file, line)) {
-        content += line + "\n";
+    std::streamsize size = file.tellg();
+    if (size < 0) {
+        return false;
     }
-    
-    file.close();
-    return content;
+    content.resize(static_cast<size_t>(size));
+    file.seekg(0);
+    return size == 0 || static_cast<bool>(file.read(&content[0], size));
 }
 
-void writeFileContent(const std::string& filePath, const std::string& content) {
+bool writeWholeFile(const std::string& filePath, const std::string& content) {
     // 确保输出目录存在
-    size_t lastSlash = filePath.find_last_of('/');
-    if (lastSlash != std::string::npos) {
-        std::string directory = filePath.substr(0, lastSlash);
-        std::string createDirCommand = "mkdir -p " + directory;
-        system(createDirCommand.c_str());
+    fs::path parent = fs::path(filePath).parent_path();
+    if (!parent.empty()) {
+        std::error_code ec;
+        fs::create_directories(parent, ec);
+        if (ec) {
+            return false;
+        }
     }
     
-    std::ofstream file(filePath);
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
     if (!file.is_open()) {
-        throw std::runtime_error("无法创建输出文件: " + filePath);
+        return false;
     }
-    
-    file << content;
+    file.write(content.data(), static_cast<std::streamsize>(content.size()));
     file.close();
+    return static_cast<bool>(file);
 }
 
-int main(int argc, char* argv[]) {
-    std::cout << "=== 医院管理系统 JSON API 处理器 ===" << std::endl;
+void processRequest(ApiHandler& apiHandler, const std::string& request, std::string& response,
+                    bool autoFormat, WireFormat format) {
+    if (autoFormat) {
+        apiHandler.processApiRequest(request, response);
+    } else {
+        apiHandler.processApiRequest(request, response, format);
+    }
+}
+
+bool writeAll(int fd, const std::string& data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t n = write(fd, data.data() + written, data.size() - written);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        written += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// 有序模式的顺序键：同一token或同一账号的请求可能相互依赖（先注册后登录、先创建后查询），
+// 无法解析或不带身份的请求返回空串，不参与排序
+std::string orderingKey(const std::string& request) {
+    json parsed = json::parse(request, nullptr, false);
+    if (!parsed.is_object()) return "";
+    auto dataIt = parsed.find("data");
+    if (dataIt == parsed.end() || !dataIt->is_object()) return "";
+    for (const char* field : {"token", "account", "email"}) {
+        auto it = dataIt->find(field);
+        if (it != dataIt->end() && it->is_string() && !it->get_ref<const std::string&>().empty()) {
+            return std::string(field) + ":" + it->get<std::string>();
+        }
+    }
+    return "";
+}
+
+// 顺序键相同的任务按提交顺序逐个执行，不同键之间仍在线程池上并行；
+// 同键的后续任务排在链上，由执行前一个任务的工作线程接着执行，不占用其他工作线程等待
+class OrderedSubmitter {
+public:
+    explicit OrderedSubmitter(std::shared_ptr<ThreadPool> pool) : pool(std::move(pool)) {}
+
+    bool submit(const std::string& key, std::function<void()> task) {
+        if (key.empty()) {
+            return pool->submit(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto& chain = chains[key];
+            chain.push_back(std::move(task));
+            if (chain.size() > 1) return true;
+        }
+        return pool->submit([this, key]() { drain(key); });
+    }
+
+private:
+    std::shared_ptr<ThreadPool> pool;
+    std::mutex mutex;
+    std::map<std::string, std::deque<std::function<void()>>> chains;
+
+    // 链首任务执行完才出队，执行期间同键的新任务只会追加到链尾
+    void drain(const std::string& key) {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                task = std::move(chains[key].front());
+            }
+            task();
+            std::lock_guard<std::mutex> lock(mutex);
+            auto chain = chains.find(key);
+            chain->second.pop_front();
+            if (chain->second.empty()) {
+                chains.erase(chain);
+                return;
+            }
+        }
+    }
+};
+
+// 常驻模式下由信号处理函数通知服务退出
+static UnixSocketServer* activeServer = nullptr;
+
+void handleStopSignal(int) {
+    if (activeServer) {
+        activeServer->requestStop();
+    }
+}
+
+int serveSocket(std::shared_ptr<CampusDirectory> campuses, std::shared_ptr<ApiHandler> apiHandler,
+                const std::string& socketPath, size_t workers, size_t maxConnections,
+                const std::string& formatName, WireFormat format) {
+    bool autoFormat = formatName == "auto";
+    UnixSocketServer server(socketPath, [apiHandler, autoFormat, format](const std::string& request, std::string& response) {
+        processRequest(*apiHandler, request, response, autoFormat, format);
+    }, workers, UnixSocketServer::DEFAULT_MAX_FRAME_SIZE, UnixSocketServer::DEFAULT_MAX_IN_FLIGHT, maxConnections);
+    // 请求内的扇出读取与请求本身在同一个线程池上调度
+    campuses->useWorkerPool(server.getWorkerPool());
+    
+    if (!server.start()) {
+        std::cerr << "启动常驻服务失败: " << server.getError() << std::endl;
+        return 1;
+    }
+    
+    activeServer = &server;
+    std::signal(SIGINT, handleStopSignal);
+    std::signal(SIGTERM, handleStopSignal);
+    
+    std::cout << "常驻服务已启动: " << socketPath << " (工作线程: " << workers << ")" << std::endl;
+    server.run();
+    activeServer = nullptr;
+    
+    auto stats = server.getStats();
+    std::cout << "常驻服务已停止: 连接 " << stats.connections << " 个, 请求 " << stats.requests
+              << " 个, 拒绝超长帧 " << stats.rejectedFrames << " 个, 拒绝超限连接 " << stats.rejectedConnections
+              << " 个" << std::endl;
+    return 0;
+}
+
+// 流式模式：逐行读取请求并行处理，响应按输入顺序逐行写出；ordered时同一顺序键的请求按输入顺序执行。
+// responseFd是原标准输出的副本，标准输出本身已重定向到标准错误，避免日志混入响应流
+int streamNdjson(std::shared_ptr<CampusDirectory> campuses, std::shared_ptr<ApiHandler> apiHandler,
+                 size_t workers, bool ordered, int responseFd) {
+    const size_t maxInFlight = workers * 4;
+    
+    auto pool = std::make_shared<ThreadPool>(workers);
+    campuses->useWorkerPool(pool);
+    OrderedSubmitter submitter(pool);
+    std::mutex orderMutex;
+    std::condition_variable slotAvailable;
+    std::map<uint64_t, std::string> completed;
+    uint64_t nextToWrite = 0;
+    size_t inFlight = 0;
+    bool outputFailed = false;
+    
+    auto complete = [&](uint64_t sequence, std::string response) {
+        std::lock_guard<std::mutex> lock(orderMutex);
+        completed.emplace(sequence, std::move(response));
+        
+        // 只写出连续就绪的前缀，后完成的响应在缓冲区等待
+        std::string ready;
+        auto it = completed.begin();
+        while (it != completed.end() && it->first == nextToWrite) {
+            ready += it->second;
+            ready += '\n';
+            it = completed.erase(it);
+            ++nextToWrite;
+            --inFlight;
+        }
+        if (!ready.empty() && !outputFailed && !writeAll(responseFd, ready)) {
+            outputFailed = true;
+        }
+        slotAvailable.notify_one();
+    };
+    
+    uint64_t sequence = 0;
+    std::string buffer;
+    size_t lineStart = 0;
+    char chunk[65536];
+    bool eof = false;
+    
+    while (!eof) {
+        ssize_t n = read(STDIN_FILENO, chunk, sizeof(chunk));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "读取标准输入失败" << std::endl;
+            break;
+        }
+        if (n == 0) {
+            eof = true;
+            if (lineStart < buffer.size()) buffer += '\n';  // 最后一行可以没有换行符
+        } else {
+            buffer.append(chunk, static_cast<size_t>(n));
+        }
+        
+        size_t newline;
+        while ((newline = buffer.find('\n', lineStart)) != std::string::npos) {
+            size_t lineEnd = newline;
+            if (lineEnd > lineStart && buffer[lineEnd - 1] == '\r') --lineEnd;
+            std::string line = buffer.substr(lineStart, lineEnd - lineStart);
+            lineStart = newline + 1;
+            
+            if (line.find_first_not_of(" \t") == std::string::npos) {
+                continue;
+            }
+            
+            {
+                std::unique_lock<std::mutex> lock(orderMutex);
+                slotAvailable.wait(lock, [&] { return inFlight < maxInFlight; });
+                ++inFlight;
+            }
+            uint64_t current = sequence++;
+            std::string key = ordered ? orderingKey(line) : std::string();
+            submitter.submit(key, [apiHandler, current, request = std::move(line), &complete]() {
+                std::string response;
+                apiHandler->processApiRequest(request, response, WireFormat::JSON);
+                complete(current, std::move(response));
+            });
+        }
+        
+        // 丢弃已消费的行，保留未完整的尾部
+        buffer.erase(0, lineStart);
+        lineStart = 0;
+    }
+    
+    pool->shutdown();
+    std::cerr << "流式处理完成: 请求 " << sequence << " 个" << std::endl;
+    return outputFailed ? 1 : 0;
+}
+
+// 判断path是否位于directory之内（两者均为规范化后的绝对路径）
+bool isWithin(const fs::path& path, const fs::path& directory) {
+    auto dirIt = directory.begin();
+    auto pathIt = path.begin();
+    for (; dirIt != directory.end(); ++dirIt, ++pathIt) {
+        if (dirIt->empty()) continue;  // 末尾的"/"
+        if (pathIt == path.end() || *pathIt != *dirIt) return false;
+    }
+    return true;
+}
+
+// 批量模式：递归收集输入目录下的*.json，在工作线程池上并行处理，
+// 响应写入输出目录下相同的相对路径（输出目录位于输入目录内时跳过其中文件）。
+// ordered时同一顺序键的文件按相对路径的字典序逐个执行
+int processBatchDirectory(std::shared_ptr<CampusDirectory> campuses, std::shared_ptr<ApiHandler> apiHandler,
+                          const std::string& inputDir, const std::string& outputDir, size_t workers,
+                          bool ordered, bool autoFormat, WireFormat format) {
+    std::error_code ec;
+    fs::path inputRoot = fs::weakly_canonical(inputDir, ec);
+    if (ec || !fs::is_directory(inputRoot)) {
+        std::cerr << "错误: 输入目录不存在: " << inputDir << std::endl;
+        return 1;
+    }
+    fs::path outputRoot = fs::weakly_canonical(outputDir, ec);
+    if (ec) {
+        std::cerr << "错误: 无效的输出目录: " << outputDir << std::endl;
+        return 1;
+    }
+    
+    std::vector<fs::path> relativePaths;
+    for (auto it = fs::recursive_directory_iterator(inputRoot, ec); !ec && it != fs::recursive_directory_iterator();
+         it.increment(ec)) {
+        if (it->is_directory() && isWithin(it->path(), outputRoot)) {
+            it.disable_recursion_pending();
+            continue;
+        }
+        if (it->is_regular_file() && it->path().extension() == ".json") {
+            relativePaths.push_back(it->path().lexically_relative(inputRoot));
+        }
+    }
+    if (ec) {
+        std::cerr << "错误: 遍历输入目录失败: " << ec.message() << std::endl;
+        return 1;
+    }
+    std::sort(relativePaths.begin(), relativePaths.end());
+    
+    // 输出目录在主线程中一次性建好，工作线程只负责读写文件
+    std::set<fs::path> directories;
+    for (const auto& relative : relativePaths) {
+        directories.insert((outputRoot / relative).parent_path());
+    }
+    for (const auto& directory : directories) {
+        fs::create_directories(directory, ec);
+        if (ec) {
+            std::cerr << "错误: 无法创建输出目录: " << directory.string() << std::endl;
+            return 1;
+        }
+    }
+    
+    std::cout << "批量处理: " << relativePaths.size() << " 个请求文件 (工作线程: " << workers << ")" << std::endl;
     
+    auto startTime = std::chrono::steady_clock::now();
+    std::atomic<size_t> failed{0};
+    std::mutex reportMutex;
+    
+    {
+        auto pool = std::make_shared<ThreadPool>(workers);
+        campuses->useWorkerPool(pool);
+        OrderedSubmitter submitter(pool);
+        for (const auto& relative : relativePaths) {
+            // 有序模式需要先读出请求才能确定顺序键，否则在工作线程上读取
+            std::string request;
+            bool readFailed = false;
+            std::string key;
+            if (ordered) {
+                readFailed = !readWholeFile((inputRoot / relative).string(), request);
+                if (!readFailed) key = orderingKey(request);
+            }
+            submitter.submit(key, [&, relative, request = std::move(request), readFailed]() mutable {
+                std::string inputPath = (inputRoot / relative).string();
+                std::string outputPath = (outputRoot / relative).string();
+                
+                std::string response;
+                const char* error = nullptr;
+                if (readFailed || (!ordered && !readWholeFile(inputPath, request))) {
+                    error = "无法读取输入文件";
+                } else {
+                    processRequest(*apiHandler, request, response, autoFormat, format);
+                    if (!writeWholeFile(outputPath, response)) {
+                        error = "无法写入输出文件";
+                    }
+                }
+                
+                if (error) {
+                    failed.fetch_add(1, std::memory_order_relaxed);
+                    std::lock_guard<std::mutex> lock(reportMutex);
+                    std::cerr << error << ": " << relative.string() << std::endl;
+                }
+            });
+        }
+        pool->shutdown();
+    }
+    
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+    std::cout << "\n=== 批量处理结果摘要 ===" << std::endl;
+    std::cout << "输入目录: " << inputRoot.string() << std::endl;
+    std::cout << "输出目录: " << outputRoot.string() << std::endl;
+    std::cout << "处理文件: " << relativePaths.size() << " 个, 失败 " << failed.load() << " 个" << std::endl;
+    std::cout << "耗时: " << elapsed.count() << " ms" << std::endl;
+    return failed.load() == 0 ? 0 : 1;
+}
+
+// 多院区时按院区输出准入统计，便于发现某个院区的高峰挤占了其他院区
+void printCampusStats(ApiHandler& apiHandler, const CampusDirectory& campuses) {
+    if (!campuses.isMultiCampus()) return;
+    
+    json stats = apiHandler.getCampusStats();
+    for (const auto& campus : stats["campuses"]) {
+        const json& admission = campus["admission"];
+        std::cout << "院区 " << campus["id"].get<std::string>() << ": 准入 " << admission["admitted"]
+                  << " 个, 排队 " << admission["queued"] << " 个, 拒绝(队列满/超时/限流) "
+                  << admission["rejectedQueueFull"] << "/" << admission["rejectedTimeout"] << "/"
+                  << admission["rejectedRateLimit"] << " 个, 平均耗时 " << admission["averageServiceMs"] << "ms"
+                  << std::endl;
+    }
+    std::cout << "数据库连接: " << stats["connectionBudget"]["inUse"] << "/" << stats["connectionBudget"]["limit"]
+              << std::endl;
+}
+
+int main(int argc, char* argv[]) {
     // 命令行参数
     std::string inputFile;
     std::string outputFile;
@@ -66,6 +452,25 @@ int main(int argc, char* argv[]) {
     std::string username = "root";
     std::string password = "";
     std::string database = "hospital_db";
+    std::string bloomFile;
+    std::string formatName = "auto";
+    std::string socketPath;
+    std::string batchInputDir;
+    std::string batchOutputDir;
+    bool stdinNdjson = false;
+    bool ordered = false;
+    std::vector<ReplicaEndpoint> replicas;
+    std::string shardMapFile;
+    std::vector<CampusSpec> campusSpecs;
+    size_t dbConnections = 0;
+    DatabaseConnection::Timeouts dbTimeouts;
+    std::string dbFaultsFile;
+    std::string slowQueryFile;
+    SlowQueryLog::Config slowQueryConfig;
+    DoctorDAO::CacheConfig doctorCacheConfig;
+    QueryCache::Config queryCacheConfig;
+    size_t workers = std::max(1u, std::thread::hardware_concurrency());
+    size_t maxConnections = UnixSocketServer::DEFAULT_MAX_CONNECTIONS;
     
     // 解析命令行参数
     static struct option long_options[] = {
@@ -75,6 +480,25 @@ int main(int argc, char* argv[]) {
         {"user",     required_argument, 0, 'u'},
         {"password", required_argument, 0, 'p'},
         {"database", required_argument, 0, 'd'},
+        {"bloom-file", required_argument, 0, 'b'},
+        {"format",   required_argument, 0, 'f'},
+        {"serve",    required_argument, 0, 's'},
+        {"workers",  required_argument, 0, 'w'},
+        {"max-connections", required_argument, 0, 'c'},
+        {"stdin-ndjson", no_argument,   0, 'n'},
+        {"ordered",  no_argument,       0, 'O'},
+        {"batch-dir", required_argument, 0, 'B'},
+        {"replica",  required_argument, 0, 'r'},
+        {"shard-map", required_argument, 0, 'S'},
+        {"campus",   required_argument, 0, 'C'},
+        {"db-connections", required_argument, 0, 'D'},
+        {"db-connect-timeout", required_argument, 0, 'T'},
+        {"db-read-timeout", required_argument, 0, 'R'},
+        {"db-faults", required_argument, 0, 'F'},
+        {"slow-query-log", required_argument, 0, 'L'},
+        {"slow-query-ms", required_argument, 0, 'M'},
+        {"doctor-cache-ttl", required_argument, 0, 'E'},
+        {"query-cache-mb", required_argument, 0, 'Q'},
         {"help",     no_argument,       0, '?'},
         {0, 0, 0, 0}
     };
@@ -82,7 +506,7 @@ int main(int argc, char* argv[]) {
     int option_index = 0;
     int c;
     
-    while ((c = getopt_long(argc, argv, "i:o:h:u:p:d:?", long_options, &option_index)) != -1) {
+    while ((c = getopt_long(argc, argv, "i:o:h:u:p:d:b:f:s:w:c:nOB:r:S:C:D:T:R:F:L:M:E:Q:?", long_options, &option_index)) != -1) {
         switch (c) {
             case 'i':
                 inputFile = optarg;
@@ -102,6 +526,77 @@ int main(int argc, char* argv[]) {
             case 'd':
                 database = optarg;
                 break;
+            case 'b':
+                bloomFile = optarg;
+                break;
+            case 'f':
+                formatName = optarg;
+                break;
+            case 's':
+                socketPath = optarg;
+                break;
+            case 'w':
+                workers = std::max(1, std::atoi(optarg));
+                break;
+            case 'c':
+                maxConnections = std::max(1, std::atoi(optarg));
+                break;
+            case 'n':
+                stdinNdjson = true;
+                break;
+            case 'O':
+                ordered = true;
+                break;
+            case 'B':
+                batchInputDir = optarg;
+                break;
+            case 'r': {
+                ReplicaEndpoint endpoint;
+                if (!ReplicaEndpoint::parse(optarg, endpoint)) {
+                    std::cerr << "错误: 无效的副本地址: " << optarg << std::endl;
+                    return 1;
+                }
+                replicas.push_back(endpoint);
+                break;
+            }
+            case 'S':
+                shardMapFile = optarg;
+                break;
+            case 'C': {
+                CampusSpec spec;
+                if (!CampusSpec::parse(optarg, spec)) {
+                    std::cerr << "错误: 无效的院区配置: " << optarg << std::endl;
+                    return 1;
+                }
+                campusSpecs.push_back(spec);
+                break;
+            }
+            case 'D':
+                dbConnections = std::max(1, std::atoi(optarg));
+                break;
+            case 'T':
+                dbTimeouts.connectSeconds = std::max(1, std::atoi(optarg));
+                break;
+            case 'R':
+                dbTimeouts.readSeconds = std::max(1, std::atoi(optarg));
+                dbTimeouts.writeSeconds = dbTimeouts.readSeconds;
+                break;
+            case 'F':
+                dbFaultsFile = optarg;
+                break;
+            case 'L':
+                slowQueryFile = optarg;
+                break;
+            case 'M':
+                slowQueryConfig.threshold = std::chrono::milliseconds(std::max(0, std::atoi(optarg)));
+                break;
+            case 'E':
+                doctorCacheConfig.ttl = std::chrono::seconds(std::max(0, std::atoi(optarg)));
+                if (doctorCacheConfig.ttl.count() == 0) doctorCacheConfig.capacity = 0;
+                break;
+            case 'Q':
+                queryCacheConfig.maxBytes = static_cast<size_t>(std::max(0, std::atoi(optarg))) * 1024 * 1024;
+                break;
             case '?':
             default:
                 printUsage(argv[0]);
@@ -109,38 +604,192 @@ int main(int argc, char* argv[]) {
         }
     }
     
+    // --batch-dir的第二个参数（输出目录）作为非选项参数出现在argv末尾
+    if (!batchInputDir.empty()) {
+        if (optind >= argc) {
+            std::cerr << "错误: --batch-dir 需要输入目录和输出目录两个参数" << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+        batchOutputDir = argv[optind];
+    }
+    
     // 验证必需参数
-    if (inputFile.empty() || outputFile.empty()) {
+    bool fileMode = !inputFile.empty() || !outputFile.empty();
+    int modeCount = (fileMode ? 1 : 0) + (socketPath.empty() ? 0 : 1) + (stdinNdjson ? 1 : 0) +
+                    (batchInputDir.empty() ? 0 : 1);
+    if (modeCount > 1) {
+        std::cerr << "错误: --input/--output、--serve、--stdin-ndjson、--batch-dir 只能选择一种" << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (modeCount == 0 || (fileMode && (inputFile.empty() || outputFile.empty()))) {
         std::cerr << "错误: 必须指定输入文件和输出文件路径" << std::endl;
         printUsage(argv[0]);
         return 1;
     }
     
+    WireFormat format = WireFormat::JSON;
+    if (formatName != "auto" && !WireCodec::parseFormatName(formatName, format)) {
+        std::cerr << "错误: 不支持的格式: " << formatName << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (ordered && !stdinNdjson && batchInputDir.empty()) {
+        std::cerr << "错误: --ordered 仅用于 --stdin-ndjson 和 --batch-dir" << std::endl;
+        return 1;
+    }
+    if (stdinNdjson && formatName != "auto" && format != WireFormat::JSON) {
+        std::cerr << "错误: --stdin-ndjson 仅支持JSON格式" << std::endl;
+        return 1;
+    }
+    if (!campusSpecs.empty() && (!replicas.empty() || !shardMapFile.empty())) {
+        std::cerr << "错误: --campus 不能与 --replica、--shard-map 同时使用" << std::endl;
+        return 1;
+    }
+    // 数据库宕机时连接和等待响应有上限，熔断打开前的请求也不会长时间挂起
+    DatabaseConnection::setDefaultTimeouts(dbTimeouts);
+    // 本进程内对医生的修改立即失效缓存；其他进程的修改最迟在有效期后可见
+    DoctorDAO::setCacheConfig(doctorCacheConfig);
+    queryCacheConfig.deleteCascades = HospitalService::deleteCascades();
+    ConnectionPool::setDefaultQueryCache(queryCacheConfig);
+    // 故障注入规则文件优先于环境变量HOSPITAL_DB_FAULTS
+    if (!dbFaultsFile.empty()) {
+        std::string faultError;
+        auto injector = FaultInjector::load(dbFaultsFile, faultError);
+        if (!injector) {
+            std::cerr << "错误: 无效的故障注入规则: " << faultError << std::endl;
+            return 1;
+        }
+        DatabaseConnection::setFaultInjector(injector);
+    }
+    if (DatabaseConnection::getFaultInjector()) {
+        std::cerr << "警告: 已启用数据库故障注入" << std::endl;
+    }
+    if (!slowQueryFile.empty()) {
+        slowQueryConfig.path = slowQueryFile;
+        std::string logError;
+        auto slowQueryLog = SlowQueryLog::open(slowQueryConfig, logError);
+        if (!slowQueryLog) {
+            std::cerr << "错误: 无法打开慢查询日志: " << logError << std::endl;
+            return 1;
+        }
+        DatabaseConnection::setSlowQueryLog(slowQueryLog);
+    }
+    
+    // 流式模式下标准输出是响应流：保留一份原标准输出用于写响应，
+    // 再把标准输出重定向到标准错误，库代码中的日志输出不会混入响应
+    int responseFd = -1;
+    if (stdinNdjson) {
+        std::cout.flush();
+        responseFd = dup(STDOUT_FILENO);
+        if (responseFd < 0 || dup2(STDERR_FILENO, STDOUT_FILENO) < 0) {
+            std::cerr << "错误: 无法重定向标准输出" << std::endl;
+            return 1;
+        }
+    }
+    
+    std::cout << "=== 医院管理系统 JSON API 处理器 ===" << std::endl;
+    
     try {
-        std::cout << "连接数据库: " << host << "/" << database << " (用户: " << username << ")" << std::endl;
+        // 初始化医院服务（常驻/流式/批量模式下每个工作线程至少能拿到一个连接）
+        bool multiRequest = !fileMode;
+        size_t poolSize = std::max<size_t>(10, multiRequest ? workers : 0);
+        std::shared_ptr<CampusDirectory> campuses;
+        std::shared_ptr<HospitalService> hospitalService;
         
-        // 初始化医院服务
-        auto hospitalService = std::make_shared<HospitalService>(host, username, password, database);
+        if (!campusSpecs.empty()) {
+            // 多院区：各院区连接池共用一个连接预算
+            size_t budget = dbConnections ? dbConnections : poolSize * campusSpecs.size();
+            for (const auto& spec : campusSpecs) {
+                std::cout << "连接院区数据库: " << spec.id << " -> " << spec.host << "/" << spec.database
+                          << " (权重: " << spec.weight << ")" << std::endl;
+            }
+            campuses = CampusDirectory::connect(campusSpecs, username, password, budget);
+            if (!campuses) {
+                std::cerr << "错误: 院区标识重复" << std::endl;
+                return 1;
+            }
+            std::cout << "院区: " << campusSpecs.size() << " 个, 数据库连接上限: "
+                      << campuses->getBudget()->getLimit() << std::endl;
+        } else {
+            std::cout << "连接数据库: " << host << "/" << database << " (用户: " << username << ")" << std::endl;
+            hospitalService = std::make_shared<HospitalService>(host, username, password, database, 3306, poolSize);
+            campuses = CampusDirectory::single(hospitalService);
+        }
+        
+        // 单次请求进程全量加载代价过高，仅在提供持久化文件时启用（启动时增量补齐）；
+        // 多院区时每个院区各用一个文件
+        if (!bloomFile.empty()) {
+            for (const auto& campus : campuses->getCampuses()) {
+                campus.service->initializeExistenceFilter(campus.id.empty() ? bloomFile : bloomFile + "." + campus.id);
+            }
+        }
+        
+        if (!replicas.empty()) {
+            hospitalService->enableReadReplicas(replicas);
+            std::cout << "只读副本: " << replicas.size() << " 个" << std::endl;
+        }
+        
+        if (!shardMapFile.empty()) {
+            if (!hospitalService->enableSharding(shardMapFile)) {
+                std::cerr << "错误: 无法启用分片: " << shardMapFile << std::endl;
+                return 1;
+            }
+            std::cout << "患者数据分片: " << hospitalService->getShards()->size() << " 个" << std::endl;
+        }
         
         // 初始化API处理器
-        auto apiHandler = std::make_shared<ApiHandler>(hospitalService);
+        auto apiHandler = std::make_shared<ApiHandler>(campuses);
+        
+        if (!socketPath.empty()) {
+            int result = serveSocket(campuses, apiHandler, socketPath, workers, maxConnections, formatName, format);
+            printCampusStats(*apiHandler, *campuses);
+            return result;
+        }
+        if (stdinNdjson) {
+            int result = streamNdjson(campuses, apiHandler, workers, ordered, responseFd);
+            close(responseFd);
+            printCampusStats(*apiHandler, *campuses);
+            return result;
+        }
+        if (!batchInputDir.empty()) {
+            int result = processBatchDirectory(campuses, apiHandler, batchInputDir, batchOutputDir, workers, ordered,
+                                               formatName == "auto", format);
+            printCampusStats(*apiHandler, *campuses);
+            return result;
+        }
         
         std::cout << "读取输入文件: " << inputFile << std::endl;
         
         // 读取输入JSON文件
-        std::string jsonInput = readFileContent(inputFile);
+        std::string jsonInput;
+        if (!readWholeFile(inputFile, jsonInput)) {
+            throw std::runtime_error("无法打开输入文件: " + inputFile);
+        }
         
-        std::cout << "处理JSON请求..." << std::endl;
-        std::cout << "请求内容: " << jsonInput << std::endl;
+        if (formatName == "auto") {
+            format = WireCodec::detect(jsonInput);
+        }
+        
+        std::cout << "处理" << WireCodec::formatName(format) << "请求..." << std::endl;
+        if (format == WireFormat::JSON) {
+            std::cout << "请求内容: " << jsonInput << std::endl;
+        }
         
         // 处理API请求
-        std::string jsonResponse = apiHandler->processApiRequest(jsonInput);
+        std::string jsonResponse;
+        apiHandler->processApiRequest(jsonInput, jsonResponse, format);
         
-        std::cout << "响应内容: " << jsonResponse << std::endl;
+        if (format == WireFormat::JSON) {
+            std::cout << "响应内容: " << jsonResponse << std::endl;
+        }
         std::cout << "写入输出文件: " << outputFile << std::endl;
         
         // 写入输出JSON文件
-        writeFileContent(outputFile, jsonResponse);
+        if (!writeWholeFile(outputFile, jsonResponse)) {
+            throw std::runtime_error("无法创建输出文件: " + outputFile);
+        }
         
         std::cout << "JSON API处理完成！" << std::endl;
         
@@ -154,13 +803,16 @@ int main(int argc, char* argv[]) {
     } catch (const std::exception& e) {
         std::cerr << "处理失败: " << e.what() << std::endl;
         
+        if (outputFile.empty()) {
+            return 1;
+        }
+        
         // 写入错误响应到输出文件
-        try {
-            std::string errorResponse = R"({"status": "error", "code": 500, "message": ")" + std::string(e.what()) + R"(", "data": {}})";
-            writeFileContent(outputFile, errorResponse);
+        std::string errorResponse = R"({"status": "error", "code": 500, "message": ")" + std::string(e.what()) + R"(", "data": {}})";
+        if (writeWholeFile(outputFile, errorResponse)) {
             std::cout << "错误信息已写入输出文件: " << outputFile << std::endl;
-        } catch (const std::exception& writeError) {
-            std::cerr << "无法写入错误信息到输出文件: " << writeError.what() << std::endl;
+        } else {
+            std::cerr << "无法写入错误信息到输出文件: " << outputFile << std::endl;
         }
         
         return 1;
@@ -0,0 +1,369 @@
+#include "JsonStream.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+inline const char* skipWhitespace(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) ++p;
+    return p;
+}
+
+// 8字节一组检测是否含 '"'、'\\' 或控制字符（SWAR），长字符串（如Base64文件内容）按字扫描
+inline bool hasStringSpecial(uint64_t word) {
+    const uint64_t ones = 0x0101010101010101ULL;
+    const uint64_t highs = 0x8080808080808080ULL;
+    uint64_t quote = word ^ (ones * '"');
+    uint64_t backslash = word ^ (ones * '\\');
+    uint64_t special = ((quote - ones) & ~quote) | ((backslash - ones) & ~backslash) | ((word - ones * 0x20) & ~word);
+    return (special & highs) != 0;
+}
+
+inline bool hasNonAscii(uint64_t word) {
+    return (word & 0x8080808080808080ULL) != 0;
+}
+
+// s[i]起的UTF-8序列长度，不合法（过长编码、代理区、超出U+10FFFF、截断）时返回0
+size_t utf8SequenceLength(const std::string& s, size_t i) {
+    unsigned char lead = static_cast<unsigned char>(s[i]);
+    size_t length;
+    unsigned char low = 0x80, high = 0xbf;  // 第二个字节的取值范围
+    if (lead >= 0xc2 && lead <= 0xdf) {
+        length = 2;
+    } else if (lead >= 0xe0 && lead <= 0xef) {
+        length = 3;
+        if (lead == 0xe0) low = 0xa0;
+        if (lead == 0xed) high = 0x9f;
+    } else if (lead >= 0xf0 && lead <= 0xf4) {
+        length = 4;
+        if (lead == 0xf0) low = 0x90;
+        if (lead == 0xf4) high = 0x8f;
+    } else {
+        return 0;
+    }
+    if (s.size() - i < length) return 0;
+    for (size_t k = 1; k < length; ++k) {
+        unsigned char c = static_cast<unsigned char>(s[i + k]);
+        if (c < (k == 1 ? low : 0x80) || c > (k == 1 ? high : 0xbf)) return 0;
+    }
+    return length;
+}
+
+// p指向起始引号，返回结束引号之后的位置；hasEscape报告是否含转义，hasNonAsciiByte报告是否含非ASCII字节
+const char* skipString(const char* p, const char* end, bool& hasEscape, bool& hasNonAsciiByte) {
+    hasEscape = false;
+    hasNonAsciiByte = false;
+    for (++p; p < end; ++p) {
+        while (end - p >= 8) {
+            uint64_t word;
+            std::memcpy(&word, p, sizeof(word));
+            if (hasStringSpecial(word)) break;
+            hasNonAsciiByte |= hasNonAscii(word);
+            p += 8;
+        }
+        if (p == end) break;
+
+        unsigned char c = static_cast<unsigned char>(*p);
+        if (c == '"') return p + 1;
+        if (c == '\\') {
+            hasEscape = true;
+            if (++p == end) return nullptr;
+        } else if (c < 0x20) {
+            return nullptr;
+        } else if (c >= 0x80) {
+            hasNonAsciiByte = true;
+        }
+    }
+    return nullptr;
+}
+
+inline const char* skipString(const char* p, const char* end) {
+    bool hasEscape = false, hasNonAsciiByte = false;
+    return skipString(p, end, hasEscape, hasNonAsciiByte);
+}
+
+const char* skipLiteral(const char* p, const char* end) {
+    static const char* const keywords[] = {"true", "false", "null"};
+    for (const char* keyword : keywords) {
+        size_t length = std::strlen(keyword);
+        if (static_cast<size_t>(end - p) >= length && std::memcmp(p, keyword, length) == 0) {
+            return p + length;
+        }
+    }
+
+    const char* start = p;
+    while (p < end && ((*p >= '0' && *p <= '9') || *p == '-' || *p == '+' || *p == '.' || *p == 'e' || *p == 'E')) {
+        ++p;
+    }
+    return p == start ? nullptr : p;
+}
+
+// 跳过一个完整的值，容器内部只做括号配对与字符串边界识别
+const char* skipValue(const char* p, const char* end) {
+    if (p >= end) return nullptr;
+
+    if (*p == '"') return skipString(p, end);
+    if (*p != '{' && *p != '[') return skipLiteral(p, end);
+
+    std::string closers;
+    for (; p < end; ++p) {
+        switch (*p) {
+            case '"':
+                p = skipString(p, end);
+                if (!p) return nullptr;
+                --p;
+                break;
+            case '{':
+                closers.push_back('}');
+                break;
+            case '[':
+                closers.push_back(']');
+                break;
+            case '}':
+            case ']':
+                if (closers.empty() || closers.back() != *p) return nullptr;
+                closers.pop_back();
+                if (closers.empty()) return p + 1;
+                break;
+            default:
+                break;
+        }
+    }
+    return nullptr;
+}
+
+// 遍历对象 [p, end) 的顶层成员，onMember(key, keyLength, valueBegin, valueEnd)返回false时中止；
+// 对象结构不规范或键含转义时返回false
+template <typename Callback>
+bool forEachMember(const char* p, const char* end, Callback onMember) {
+    p = skipWhitespace(p, end);
+    if (p == end || *p != '{') return false;
+    p = skipWhitespace(p + 1, end);
+    if (p < end && *p == '}') {
+        return skipWhitespace(p + 1, end) == end;
+    }
+
+    while (p < end) {
+        if (*p != '"') return false;
+        bool keyEscaped = false, keyNonAscii = false;
+        const char* keyEnd = skipString(p, end, keyEscaped, keyNonAscii);
+        if (!keyEnd || keyEscaped) return false;
+        const char* key = p + 1;
+        size_t keyLength = static_cast<size_t>(keyEnd - p - 2);
+
+        p = skipWhitespace(keyEnd, end);
+        if (p == end || *p != ':') return false;
+        p = skipWhitespace(p + 1, end);
+
+        const char* valueBegin = p;
+        const char* valueEnd = skipValue(p, end);
+        if (!valueEnd || !onMember(key, keyLength, valueBegin, valueEnd)) return false;
+
+        p = skipWhitespace(valueEnd, end);
+        if (p == end) return false;
+        if (*p == '}') {
+            return skipWhitespace(p + 1, end) == end;
+        }
+        if (*p != ',') return false;
+        p = skipWhitespace(p + 1, end);
+    }
+    return false;
+}
+
+// 无转义的纯ASCII字符串可直接按字节构造，跳过逐字符词法分析（Base64文件内容即属此类）
+bool isPlainAsciiString(const char* begin, const char* end) {
+    if (end - begin < 2 || *begin != '"') return false;
+    bool hasEscape = false, hasNonAsciiByte = false;
+    return skipString(begin, end, hasEscape, hasNonAsciiByte) == end && !hasEscape && !hasNonAsciiByte;
+}
+
+void appendInt(std::string& out, int value) {
+    char digits[16];
+    int length = std::snprintf(digits, sizeof(digits), "%d", value);
+    out.append(digits, static_cast<size_t>(length));
+}
+
+} // namespace
+
+bool RequestEnvelope::scan(const std::string& input) {
+    api.clear();
+    hasApi = false;
+    timeoutMs = -1;
+    dataBegin = dataEnd = nullptr;
+
+    // 重复键以最后一次出现为准，与完整解析一致
+    return forEachMember(input.data(), input.data() + input.size(),
+        [this](const char* key, size_t keyLength, const char* valueBegin, const char* valueEnd) {
+            if (keyLength == 3 && std::memcmp(key, "api", 3) == 0) {
+                if (!isPlainAsciiString(valueBegin, valueEnd)) return false;
+                api.assign(valueBegin + 1, valueEnd - 1);
+                hasApi = true;
+            } else if (keyLength == 4 && std::memcmp(key, "data", 4) == 0) {
+                dataBegin = valueBegin;
+                dataEnd = valueEnd;
+            } else if (keyLength == 9 && std::memcmp(key, "timeoutMs", 9) == 0) {
+                // 只接受正整数，其余情况交给完整解析路径报告错误
+                nlohmann::json value = nlohmann::json::parse(valueBegin, valueEnd, nullptr, false);
+                if (!value.is_number_unsigned() || value.get<uint64_t>() == 0 ||
+                    value.get<uint64_t>() > static_cast<uint64_t>(INT64_MAX)) return false;
+                timeoutMs = value.get<int64_t>();
+            } else {
+                return nlohmann::json::accept(valueBegin, valueEnd);
+            }
+            return true;
+        });
+}
+
+nlohmann::json RequestEnvelope::parseData() const {
+    // 逐个成员构造：大字符串直接复制字节，其余成员按区间交给完整解析器
+    nlohmann::json data = nlohmann::json::object();
+    bool structured = forEachMember(dataBegin, dataEnd,
+        [&data](const char* key, size_t keyLength, const char* valueBegin, const char* valueEnd) {
+            nlohmann::json& member = data[std::string(key, keyLength)];
+            if (isPlainAsciiString(valueBegin, valueEnd)) {
+                member = std::string(valueBegin + 1, valueEnd - 1);
+            } else {
+                member = nlohmann::json::parse(valueBegin, valueEnd);
+            }
+            return true;
+        });
+    if (!structured) {
+        return nlohmann::json::parse(dataBegin, dataEnd);
+    }
+    return data;
+}
+
+void JsonResponseWriter::write(std::string& out, const std::string& status, int code,
+                               const std::string& message, const nlohmann::json& data) {
+    // 键按字典序输出（code, data, message, status），与std::map排序的json对象一致
+    out.clear();
+    out += "{\"code\":";
+    appendInt(out, code);
+    out += ",\"data\":";
+    nlohmann::detail::serializer<nlohmann::json> serializer(nlohmann::detail::output_adapter<char>(out), ' ');
+    serializer.dump(data, false, false, 0);
+    out += ",\"message\":";
+    appendEscaped(out, message);
+    out += ",\"status\":";
+    appendEscaped(out, status);
+    out += '}';
+}
+
+void JsonResponseWriter::appendEscaped(std::string& out, const std::string& value) {
+    static const char hexDigits[] = "0123456789abcdef";
+
+    out += '"';
+    size_t runStart = 0;
+    for (size_t i = 0; i < value.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(value[i]);
+        if (c >= 0x80) {
+            size_t length = utf8SequenceLength(value, i);
+            if (length == 0) {
+                // 与dump()一样拒绝无效UTF-8：交给dump()抛出相同的type_error(316)
+                (void)nlohmann::json(value).dump();
+                length = 1;
+            }
+            i += length - 1;
+            continue;
+        }
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        out.append(value, runStart, i - runStart);
+        runStart = i + 1;
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                out += "\\u00";
+                out += hexDigits[c >> 4];
+                out += hexDigits[c & 0x0f];
+                break;
+        }
+    }
+    out.append(value, runStart, std::string::npos);
+    out += '"';
+}
+
+namespace {
+
+// 写入短键名（<24字节），两种格式的短字符串头均为 类型前缀|长度
+void appendShortKey(std::string& out, WireFormat format, const char* key) {
+    size_t length = std::strlen(key);
+    out += static_cast<char>((format == WireFormat::MSGPACK ? 0xa0 : 0x60) | length);
+    out.append(key, length);
+}
+
+void appendValue(std::string& out, WireFormat format, const nlohmann::json& value) {
+    if (format == WireFormat::MSGPACK) {
+        nlohmann::json::to_msgpack(value, nlohmann::detail::output_adapter<char>(out));
+    } else {
+        nlohmann::json::to_cbor(value, nlohmann::detail::output_adapter<char>(out));
+    }
+}
+
+} // namespace
+
+WireFormat WireCodec::detect(const std::string& input) {
+    if (input.empty()) return WireFormat::JSON;
+    unsigned char first = static_cast<unsigned char>(input[0]);
+    if ((first >= 0x80 && first <= 0x8f) || first == 0xde || first == 0xdf) return WireFormat::MSGPACK;
+    if ((first >= 0xa0 && first <= 0xbb) || first == 0xbf) return WireFormat::CBOR;
+    return WireFormat::JSON;
+}
+
+nlohmann::json WireCodec::decode(const std::string& input, WireFormat format) {
+    switch (format) {
+        case WireFormat::MSGPACK: return nlohmann::json::from_msgpack(input);
+        case WireFormat::CBOR: return nlohmann::json::from_cbor(input);
+        case WireFormat::JSON: break;
+    }
+    return nlohmann::json::parse(input);
+}
+
+void WireCodec::writeResponse(std::string& out, WireFormat format, const std::string& status, int code,
+                              const std::string& message, const nlohmann::json& data) {
+    if (format == WireFormat::JSON) {
+        JsonResponseWriter::write(out, status, code, message, data);
+        return;
+    }
+
+    // 与 to_msgpack/to_cbor(json{status, code, message, data}) 逐字节一致
+    out.clear();
+    out += static_cast<char>(format == WireFormat::MSGPACK ? 0x84 : 0xa4);
+    appendShortKey(out, format, "code");
+    appendValue(out, format, code);
+    appendShortKey(out, format, "data");
+    appendValue(out, format, data);
+    appendShortKey(out, format, "message");
+    appendValue(out, format, message);
+    appendShortKey(out, format, "status");
+    appendValue(out, format, status);
+}
+
+const char* WireCodec::formatName(WireFormat format) {
+    switch (format) {
+        case WireFormat::MSGPACK: return "msgpack";
+        case WireFormat::CBOR: return "cbor";
+        case WireFormat::JSON: break;
+    }
+    return "json";
+}
+
+bool WireCodec::parseFormatName(const std::string& name, WireFormat& format) {
+    if (name == "json") {
+        format = WireFormat::JSON;
+    } else if (name == "msgpack") {
+        format = WireFormat::MSGPACK;
+    } else if (name == "cbor") {
+        format = WireFormat::CBOR;
+    } else {
+        return false;
+    }
+    return true;
+}
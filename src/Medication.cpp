@@ -28,7 +28,7 @@ bool MedicationDAO::createMedication(const Medication& medication) {
 }
 
 std::unique_ptr<Medication> MedicationDAO::getMedicationById(int medicationId) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     if (!conn) return nullptr;
     
     std::stringstream query;
@@ -55,7 +55,7 @@ std::unique_ptr<Medication> MedicationDAO::getMedicationById(int medicationId) {
 }
 
 std::vector<std::unique_ptr<Medication>> MedicationDAO::getMedicationsByPrescriptionId(int prescriptionId) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<Medication>> medications;
     if (!conn) return medications;
     
@@ -81,7 +81,7 @@ std::vector<std::unique_ptr<Medication>> MedicationDAO::getMedicationsByPrescrip
 }
 
 std::vector<std::unique_ptr<Medication>> MedicationDAO::getAllMedications() {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<Medication>> medications;
     if (!conn) return medications;
     
@@ -135,7 +135,7 @@ bool MedicationDAO::deleteMedication(int medicationId) {
 }
 
 std::vector<std::unique_ptr<Medication>> MedicationDAO::searchMedications(const std::string& searchTerm) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<Medication>> medications;
     if (!conn) return medications;
     
@@ -163,7 +163,7 @@ std::vector<std::unique_ptr<Medication>> MedicationDAO::searchMedications(const
 }
 
 std::vector<std::unique_ptr<Medication>> MedicationDAO::getMedicationsByName(const std::string& medicationName) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<Medication>> medications;
     if (!conn) return medications;
     
@@ -190,29 +190,13 @@ std::vector<std::unique_ptr<Medication>> MedicationDAO::getMedicationsByName(con
 }
 
 int MedicationDAO::getMedicationCount() {
-    auto conn = connectionPool->getConnection();
-    if (!conn) return 0;
-    
-    std::string query = "SELECT COUNT(*) FROM medications";
-    MYSQL_RES* result = conn->executeQuery(query);
-    if (!result) {
-        connectionPool->returnConnection(std::move(conn));
-        return 0;
-    }
-    
-    MYSQL_ROW row = mysql_fetch_row(result);
-    int count = 0;
-    if (row && row[0]) {
-        count = std::stoi(row[0]);
-    }
-    
-    mysql_free_result(result);
-    connectionPool->returnConnection(std::move(conn));
-    return count;
+    auto result = connectionPool->executeCachedQuery("SELECT COUNT(*) FROM medications");
+    if (!result || result->rowCount() == 0 || !result->get(0, 0)) return 0;
+    return std::stoi(*result->get(0, 0));
 }
 
 int MedicationDAO::getTotalQuantityByName(const std::string& medicationName) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     if (!conn) return 0;
     
     std::stringstream query;
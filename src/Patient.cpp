@@ -2,6 +2,7 @@
 #include <sstream>
 #include <iostream>
 #include <ctime>
+#include <algorithm>
 
 // Patient class implementation
 Patient::Patient() : patientId(0), userId(0), gender(Gender::MALE) {}
@@ -24,9 +25,11 @@ Gender Patient::stringToGender(const std::string& genderStr) {
 
 int Patient::getAge() const {
     // Simple age calculation - in real implementation, use proper date library
+    // localtime_r: getAge runs concurrently on worker threads
     time_t now = time(0);
-    tm* ltm = localtime(&now);
-    int currentYear = 1900 + ltm->tm_year;
+    tm ltm{};
+    localtime_r(&now, &ltm);
+    int currentYear = 1900 + ltm.tm_year;
     
     // Extract year from birthDate (assuming YYYY-MM-DD format)
     if (birthDate.length() >= 4) {
@@ -39,6 +42,43 @@ int Patient::getAge() const {
 // PatientDAO class implementation
 PatientDAO::PatientDAO(std::shared_ptr<ConnectionPool> pool) : connectionPool(pool) {}
 
+uint64_t PatientDAO::loadExistenceFilter(uint64_t afterPatientId) {
+    if (!existenceFilter) return afterPatientId;
+    
+    auto conn = connectionPool->getConnection();
+    if (!conn) return afterPatientId;
+    
+    std::stringstream query;
+    query << "SELECT patient_id, id_number FROM patients WHERE patient_id > " << afterPatientId;
+    
+    MYSQL_RES* result = conn->executeStreamingQuery(query.str());
+    if (!result) {
+        connectionPool->returnConnection(std::move(conn));
+        return afterPatientId;
+    }
+    
+    uint64_t watermark = afterPatientId;
+    MYSQL_ROW row;
+    while ((row = mysql_fetch_row(result))) {
+        unsigned long* lengths = mysql_fetch_lengths(result);
+        if (row[0]) watermark = std::max<uint64_t>(watermark, std::stoull(row[0]));
+        if (row[1]) addToExistenceFilter(std::string(row[1], lengths[1]));
+    }
+    
+    mysql_free_result(result);
+    connectionPool->returnConnection(std::move(conn));
+    return watermark;
+}
+
+void PatientDAO::addToExistenceFilter(const std::string& idNumber) {
+    if (!existenceFilter) return;
+    
+    std::string key;
+    if (BloomFilter::normalizeKey("i:", idNumber, key)) {
+        existenceFilter->add(key);
+    }
+}
+
 bool PatientDAO::createPatient(const Patient& patient) {
     auto conn = connectionPool->getConnection();
     if (!conn) return false;
@@ -53,12 +93,16 @@ bool PatientDAO::createPatient(const Patient& patient) {
           << (patient.getPhoneNumber().empty() ? "NULL" : "'" + conn->escapeString(patient.getPhoneNumber()) + "'") << ")";
     
     bool result = conn->executeUpdate(query.str());
+    // 因身份证号重复而失败说明过滤器漏掉了该键（其他进程或直接SQL写入），同样补上
+    if (result || conn->isDuplicateKeyError()) {
+        addToExistenceFilter(patient.getIdNumber());
+    }
     connectionPool->returnConnection(std::move(conn));
     return result;
 }
 
 std::unique_ptr<Patient> PatientDAO::getPatientById(int patientId) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     if (!conn) return nullptr;
     
     std::stringstream query;
@@ -85,34 +129,45 @@ std::unique_ptr<Patient> PatientDAO::getPatientById(int patientId) {
 }
 
 std::unique_ptr<Patient> PatientDAO::getPatientByUserId(int userId) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     if (!conn) return nullptr;
     
-    std::stringstream query;
-    query << "SELECT patient_id, user_id, name, gender, birth_date, id_number, phone_number "
-          << "FROM patients WHERE user_id = " << userId;
-    
-    MYSQL_RES* result = conn->executeQuery(query.str());
+    MYSQL_RES* result = conn->executeQuery(getPatientByUserIdQuery(userId));
     if (!result) {
         connectionPool->returnConnection(std::move(conn));
         return nullptr;
     }
     
-    MYSQL_ROW row = mysql_fetch_row(result);
-    std::unique_ptr<Patient> patient = nullptr;
-    
-    if (row) {
-        unsigned long* lengths = mysql_fetch_lengths(result);
-        patient = std::unique_ptr<Patient>(mapRowToPatient(row, lengths));
-    }
+    std::unique_ptr<Patient> patient = readPatient(result);
     
     mysql_free_result(result);
     connectionPool->returnConnection(std::move(conn));
     return patient;
 }
 
+std::string PatientDAO::getPatientByUserIdQuery(int userId) {
+    std::stringstream query;
+    query << "SELECT patient_id, user_id, name, gender, birth_date, id_number, phone_number "
+          << "FROM patients WHERE user_id = " << userId;
+    return query.str();
+}
+
+// Maps the first row of a getPatientByUserIdQuery() result; the caller frees the result
+std::unique_ptr<Patient> PatientDAO::readPatient(MYSQL_RES* result) {
+    MYSQL_ROW row = result ? mysql_fetch_row(result) : nullptr;
+    if (!row) return nullptr;
+    
+    unsigned long* lengths = mysql_fetch_lengths(result);
+    return std::unique_ptr<Patient>(mapRowToPatient(row, lengths));
+}
+
+std::future<std::unique_ptr<Patient>> PatientDAO::getPatientByUserIdAsync(AsyncQueryExecutor& executor, int userId) {
+    return executor.fetch<std::unique_ptr<Patient>>(getPatientByUserIdQuery(userId),
+                                                    [this](MYSQL_RES* result) { return readPatient(result); });
+}
+
 std::unique_ptr<Patient> PatientDAO::getPatientByIdNumber(const std::string& idNumber) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     if (!conn) return nullptr;
     
     std::stringstream query;
@@ -139,7 +194,7 @@ std::unique_ptr<Patient> PatientDAO::getPatientByIdNumber(const std::string& idN
 }
 
 std::vector<std::unique_ptr<Patient>> PatientDAO::getAllPatients() {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<Patient>> patients;
     if (!conn) return patients;
     
@@ -177,6 +232,9 @@ bool PatientDAO::updatePatient(const Patient& patient) {
           << "WHERE patient_id = " << patient.getPatientId();
     
     bool result = conn->executeUpdate(query.str());
+    if (result) {
+        addToExistenceFilter(patient.getIdNumber());
+    }
     connectionPool->returnConnection(std::move(conn));
     return result;
 }
@@ -194,7 +252,7 @@ bool PatientDAO::deletePatient(int patientId) {
 }
 
 std::vector<std::unique_ptr<Patient>> PatientDAO::searchPatients(const std::string& searchTerm) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<Patient>> patients;
     if (!conn) return patients;
     
@@ -223,7 +281,7 @@ std::vector<std::unique_ptr<Patient>> PatientDAO::searchPatients(const std::stri
 }
 
 std::vector<std::unique_ptr<Patient>> PatientDAO::getPatientsByGender(Gender gender) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<Patient>> patients;
     if (!conn) return patients;
     
@@ -252,6 +310,16 @@ std::vector<std::unique_ptr<Patient>> PatientDAO::getPatientsByGender(Gender gen
 }
 
 bool PatientDAO::patientExists(const std::string& idNumber) {
+    // 过滤器的"一定不存在"只是提示：本进程之外写入的行可能不在其中，插入时仍以唯一约束为准
+    bool filtered = false;
+    if (existenceFilter) {
+        std::string key;
+        if (BloomFilter::normalizeKey("i:", idNumber, key) && !existenceFilter->mightContain(key)) {
+            return false;
+        }
+        filtered = true;
+    }
+    
     auto conn = connectionPool->getConnection();
     if (!conn) return false;
     
@@ -270,31 +338,19 @@ bool PatientDAO::patientExists(const std::string& idNumber) {
         exists = std::stoi(row[0]) > 0;
     }
     
+    if (filtered && !exists) {
+        existenceFilter->recordFalsePositive();
+    }
+    
     mysql_free_result(result);
     connectionPool->returnConnection(std::move(conn));
     return exists;
 }
 
 int PatientDAO::getPatientCount() {
-    auto conn = connectionPool->getConnection();
-    if (!conn) return 0;
-    
-    std::string query = "SELECT COUNT(*) FROM patients";
-    MYSQL_RES* result = conn->executeQuery(query);
-    if (!result) {
-        connectionPool->returnConnection(std::move(conn));
-        return 0;
-    }
-    
-    MYSQL_ROW row = mysql_fetch_row(result);
-    int count = 0;
-    if (row && row[0]) {
-        count = std::stoi(row[0]);
-    }
-    
-    mysql_free_result(result);
-    connectionPool->returnConnection(std::move(conn));
-    return count;
+    auto result = connectionPool->executeCachedQuery("SELECT COUNT(*) FROM patients");
+    if (!result || result->rowCount() == 0 || !result->get(0, 0)) return 0;
+    return std::stoi(*result->get(0, 0));
 }
 
 Patient* PatientDAO::mapRowToPatient(MYSQL_ROW row, unsigned long* lengths) {
@@ -27,7 +27,7 @@ bool PrescriptionDAO::createPrescription(const Prescription& prescription) {
 }
 
 std::unique_ptr<Prescription> PrescriptionDAO::getPrescriptionById(int prescriptionId) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     if (!conn) return nullptr;
     
     std::stringstream query;
@@ -54,7 +54,7 @@ std::unique_ptr<Prescription> PrescriptionDAO::getPrescriptionById(int prescript
 }
 
 std::vector<std::unique_ptr<Prescription>> PrescriptionDAO::getPrescriptionsByCaseId(int caseId) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<Prescription>> prescriptions;
     if (!conn) return prescriptions;
     
@@ -80,7 +80,7 @@ std::vector<std::unique_ptr<Prescription>> PrescriptionDAO::getPrescriptionsByCa
 }
 
 std::vector<std::unique_ptr<Prescription>> PrescriptionDAO::getPrescriptionsByDoctorId(int doctorId) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<Prescription>> prescriptions;
     if (!conn) return prescriptions;
     
@@ -106,7 +106,7 @@ std::vector<std::unique_ptr<Prescription>> PrescriptionDAO::getPrescriptionsByDo
 }
 
 std::vector<std::unique_ptr<Prescription>> PrescriptionDAO::getAllPrescriptions() {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<Prescription>> prescriptions;
     if (!conn) return prescriptions;
     
@@ -159,7 +159,7 @@ bool PrescriptionDAO::deletePrescription(int prescriptionId) {
 }
 
 std::vector<std::unique_ptr<Prescription>> PrescriptionDAO::searchPrescriptions(const std::string& searchTerm) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<Prescription>> prescriptions;
     if (!conn) return prescriptions;
     
@@ -186,29 +186,13 @@ std::vector<std::unique_ptr<Prescription>> PrescriptionDAO::searchPrescriptions(
 }
 
 int PrescriptionDAO::getPrescriptionCount() {
-    auto conn = connectionPool->getConnection();
-    if (!conn) return 0;
-    
-    std::string query = "SELECT COUNT(*) FROM prescriptions";
-    MYSQL_RES* result = conn->executeQuery(query);
-    if (!result) {
-        connectionPool->returnConnection(std::move(conn));
-        return 0;
-    }
-    
-    MYSQL_ROW row = mysql_fetch_row(result);
-    int count = 0;
-    if (row && row[0]) {
-        count = std::stoi(row[0]);
-    }
-    
-    mysql_free_result(result);
-    connectionPool->returnConnection(std::move(conn));
-    return count;
+    auto result = connectionPool->executeCachedQuery("SELECT COUNT(*) FROM prescriptions");
+    if (!result || result->rowCount() == 0 || !result->get(0, 0)) return 0;
+    return std::stoi(*result->get(0, 0));
 }
 
 int PrescriptionDAO::getPrescriptionCountByDoctor(int doctorId) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     if (!conn) return 0;
     
     std::stringstream query;
@@ -0,0 +1,312 @@
+#include "QueryCache.h"
+#include <algorithm>
+#include <cctype>
+#include <strings.h>
+
+namespace {
+
+bool isIdentifierChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$';
+}
+
+// Index just past the quoted literal or identifier starting at i
+size_t skipQuoted(const std::string& text, size_t i) {
+    char quote = text[i];
+    for (++i; i < text.size(); ++i) {
+        if (text[i] == '\\' && quote != '`') {
+            ++i;
+        } else if (text[i] == quote) {
+            if (i + 1 < text.size() && text[i + 1] == quote) {
+                ++i;
+            } else {
+                return i + 1;
+            }
+        }
+    }
+    return text.size();
+}
+
+// Lower-cased words and single punctuation characters; each literal becomes
+// "?" and backquoted identifiers lose their quotes
+std::vector<std::string> tokenize(const std::string& statement) {
+    std::vector<std::string> tokens;
+    size_t i = 0;
+    while (i < statement.size()) {
+        char c = statement[i];
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            ++i;
+            continue;
+        }
+        size_t start = i;
+        if (c == '\'' || c == '"') {
+            i = skipQuoted(statement, i);
+            tokens.push_back("?");
+            continue;
+        }
+        if (c == '`') {
+            i = skipQuoted(statement, i);
+            size_t end = (i > start + 1 && statement[i - 1] == '`') ? i - 1 : i;
+            start += 1;
+            std::string name = statement.substr(start, end - start);
+            std::transform(name.begin(), name.end(), name.begin(),
+                           [](unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
+            tokens.push_back(name);
+            continue;
+        }
+        if (!isIdentifierChar(c)) {
+            tokens.push_back(std::string(1, c));
+            ++i;
+            continue;
+        }
+        while (i < statement.size() && isIdentifierChar(statement[i])) ++i;
+        std::string word = statement.substr(start, i - start);
+        std::transform(word.begin(), word.end(), word.begin(),
+                       [](unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
+        tokens.push_back(word);
+    }
+    return tokens;
+}
+
+bool startsWithWord(const std::string& statement, const char* word) {
+    size_t start = 0;
+    while (start < statement.size() && std::isspace(static_cast<unsigned char>(statement[start]))) ++start;
+    size_t length = std::char_traits<char>::length(word);
+    return statement.size() - start >= length && strncasecmp(statement.c_str() + start, word, length) == 0 &&
+           (statement.size() - start == length || !isIdentifierChar(statement[start + length]));
+}
+
+} // namespace
+
+void QueryCache::Result::addRow(char** row, const unsigned long* lengths) {
+    for (size_t i = 0; i < columns; ++i) {
+        if (row[i]) {
+            values.emplace_back(row[i], lengths[i]);
+            byteCount += lengths[i];
+        } else {
+            values.emplace_back();
+        }
+        nulls.push_back(row[i] == nullptr);
+        byteCount += sizeof(std::string);
+    }
+}
+
+const std::string* QueryCache::Result::get(size_t row, size_t column) const {
+    size_t index = row * columns + column;
+    if (column >= columns || index >= values.size() || nulls[index]) return nullptr;
+    return &values[index];
+}
+
+std::shared_ptr<const QueryCache::Result> QueryCache::lookup(const std::string& statement) {
+    if (!enabled()) return nullptr;
+    std::string key = keyOf(statement);
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = entries.find(key);
+    if (found == entries.end()) {
+        ++misses;
+        return nullptr;
+    }
+    if (Clock::now() >= found->second.expires) {
+        erase(found);
+        ++expirations;
+        ++misses;
+        return nullptr;
+    }
+    order.splice(order.begin(), order, found->second.position);
+    ++hits;
+    return found->second.result;
+}
+
+QueryCache::Ticket QueryCache::beginFill(const std::string& statement) const {
+    Ticket ticket;
+    if (!enabled()) return ticket;
+    std::vector<std::string> tables = tablesOf(statement);
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& table : tables) {
+        uint64_t version = versionOf(table);
+        ticket.versions.emplace_back(std::move(table), version);
+    }
+    return ticket;
+}
+
+void QueryCache::fill(const std::string& statement, const Ticket& ticket, std::shared_ptr<const Result> result) {
+    if (!enabled() || !result) return;
+    std::string key = keyOf(statement);
+    // The key is held twice, by the index and the recency list
+    size_t entryBytes = result->bytes() + 2 * key.size() + sizeof(Entry);
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& version : ticket.versions) {
+        if (versionOf(version.first) != version.second) {
+            ++staleFills;
+            return;
+        }
+    }
+    if (entryBytes > config.maxEntryBytes || entryBytes > config.maxBytes) {
+        ++oversized;
+        return;
+    }
+
+    auto found = entries.find(key);
+    if (found != entries.end()) {
+        erase(found);
+    }
+    while (!order.empty() && bytes + entryBytes > config.maxBytes) {
+        erase(entries.find(order.back()));
+        ++evictions;
+    }
+
+    order.push_front(key);
+    Entry entry{std::move(result), {}, entryBytes, Clock::now() + config.ttl, order.begin()};
+    for (const auto& version : ticket.versions) {
+        entry.tables.push_back(version.first);
+        dependents[version.first].insert(key);
+    }
+    entries.emplace(std::move(key), std::move(entry));
+    bytes += entryBytes;
+    ++fills;
+}
+
+void QueryCache::invalidateTables(const std::vector<std::string>& tables) {
+    if (!enabled() || tables.empty()) return;
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& table : tables) {
+        ++versions[table];
+        auto dependent = dependents.find(table);
+        if (dependent == dependents.end()) continue;
+        // erase() edits the set being walked
+        std::vector<std::string> keys(dependent->second.begin(), dependent->second.end());
+        for (const auto& key : keys) {
+            auto found = entries.find(key);
+            if (found == entries.end()) continue;
+            erase(found);
+            ++invalidations;
+        }
+    }
+}
+
+std::vector<std::string> QueryCache::writtenTables(const std::string& statement) const {
+    std::vector<std::string> tables = tablesOf(statement);
+    if (config.deleteCascades.empty() || (!startsWithWord(statement, "DELETE") && !startsWithWord(statement, "REPLACE"))) {
+        return tables;
+    }
+    // REPLACE deletes the row it replaces, so it cascades like a DELETE
+    for (size_t i = 0; i < tables.size(); ++i) {
+        auto cascade = config.deleteCascades.find(tables[i]);
+        if (cascade == config.deleteCascades.end()) continue;
+        for (const auto& child : cascade->second) {
+            if (std::find(tables.begin(), tables.end(), child) == tables.end()) {
+                tables.push_back(child);
+            }
+        }
+    }
+    return tables;
+}
+
+QueryCache::Stats QueryCache::getStats() const {
+    Stats stats;
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.hits = hits;
+    stats.misses = misses;
+    stats.fills = fills;
+    stats.staleFills = staleFills;
+    stats.oversized = oversized;
+    stats.invalidations = invalidations;
+    stats.evictions = evictions;
+    stats.expirations = expirations;
+    stats.entries = entries.size();
+    stats.bytes = bytes;
+    stats.maxBytes = config.maxBytes;
+    return stats;
+}
+
+std::vector<std::string> QueryCache::tablesOf(const std::string& statement) {
+    std::vector<std::string> tokens = tokenize(statement);
+    std::vector<std::string> tables;
+
+    // Reads a possibly qualified name at i, advancing past it; "" when there is none
+    auto nameAt = [&tokens](size_t& i) -> std::string {
+        if (i >= tokens.size() || !isIdentifierChar(tokens[i][0])) return "";
+        std::string name = tokens[i++];
+        while (i + 1 < tokens.size() && tokens[i] == "." && isIdentifierChar(tokens[i + 1][0])) {
+            name = tokens[i + 1];
+            i += 2;
+        }
+        return name;
+    };
+    auto add = [&tables](const std::string& name) {
+        if (std::find(tables.begin(), tables.end(), name) == tables.end()) tables.push_back(name);
+    };
+
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        const std::string& word = tokens[i];
+        bool list = word == "from" || word == "update" || word == "table";
+        if (!list && word != "join" && word != "into") continue;
+        // ON DUPLICATE KEY UPDATE names columns, not a table
+        if (word == "update" && i > 0 && tokens[i - 1] == "key") continue;
+
+        size_t next = i + 1;
+        if (word == "table") {
+            while (next < tokens.size() && (tokens[next] == "if" || tokens[next] == "not" || tokens[next] == "exists")) ++next;
+        }
+        // A derived table "FROM (SELECT ...)" is covered by its own FROM
+        std::string name = nameAt(next);
+        if (name.empty()) continue;
+        add(name);
+        if (!list) continue;
+
+        // FROM a [AS] x, b y ...: anything after a name other than a comma
+        // (WHERE, JOIN, ORDER BY, an alias) ends the list after at most one word
+        while (next < tokens.size()) {
+            if (tokens[next] == "as") ++next;
+            if (next < tokens.size() && tokens[next] != "," && isIdentifierChar(tokens[next][0])) ++next;
+            if (next >= tokens.size() || tokens[next] != ",") break;
+            ++next;
+            name = nameAt(next);
+            if (name.empty()) break;
+            add(name);
+        }
+    }
+    return tables;
+}
+
+std::string QueryCache::keyOf(const std::string& statement) {
+    std::string key;
+    key.reserve(statement.size());
+    bool space = false;
+    size_t i = 0;
+    while (i < statement.size()) {
+        char c = statement[i];
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            space = true;
+            ++i;
+            continue;
+        }
+        if (space && !key.empty()) key += ' ';
+        space = false;
+        if (c == '\'' || c == '"' || c == '`') {
+            size_t end = skipQuoted(statement, i);
+            key.append(statement, i, end - i);
+            i = end;
+        } else {
+            key += c;
+            ++i;
+        }
+    }
+    return key;
+}
+
+void QueryCache::erase(std::unordered_map<std::string, Entry>::iterator found) {
+    for (const auto& table : found->second.tables) {
+        auto dependent = dependents.find(table);
+        if (dependent == dependents.end()) continue;
+        dependent->second.erase(found->first);
+        if (dependent->second.empty()) dependents.erase(dependent);
+    }
+    bytes -= found->second.bytes;
+    order.erase(found->second.position);
+    entries.erase(found);
+}
+
+uint64_t QueryCache::versionOf(const std::string& table) const {
+    auto found = versions.find(table);
+    return found == versions.end() ? 0 : found->second;
+}
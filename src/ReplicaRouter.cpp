@@ -0,0 +1,191 @@
+#include "ReplicaRouter.h"
+#include "DatabaseConnection.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+
+// Request context of the current thread; only honoured inside a SessionScope
+thread_local bool sessionActive = false;
+thread_local int sessionUser = 0;
+thread_local bool sessionWrote = false;
+
+const char* const kCreateHeartbeatTable =
+    "CREATE TABLE IF NOT EXISTS replication_heartbeat ("
+    "id INT PRIMARY KEY, beat_at DATETIME(6) NOT NULL) ENGINE=InnoDB";
+const char* const kWriteHeartbeat = "REPLACE INTO replication_heartbeat (id, beat_at) VALUES (1, NOW(6))";
+const char* const kReadLag = "SELECT TIMESTAMPDIFF(MICROSECOND, beat_at, NOW(6)) FROM replication_heartbeat WHERE id = 1";
+
+}
+
+bool ReplicaEndpoint::parse(const std::string& text, ReplicaEndpoint& endpoint) {
+    size_t colon = text.rfind(':');
+    endpoint.host = text.substr(0, colon);
+    endpoint.port = 3306;
+    if (colon != std::string::npos) {
+        int port = std::atoi(text.c_str() + colon + 1);
+        if (port <= 0 || port > 65535) return false;
+        endpoint.port = static_cast<unsigned int>(port);
+    }
+    return !endpoint.host.empty();
+}
+
+ReplicaRouter::SessionScope::SessionScope(int userId)
+    : previousUser(sessionUser), previousWrote(sessionWrote), previousActive(sessionActive) {
+    sessionActive = true;
+    sessionUser = userId;
+    sessionWrote = false;
+}
+
+ReplicaRouter::SessionScope::SessionScope(const Session& session)
+    : previousUser(sessionUser), previousWrote(sessionWrote), previousActive(sessionActive) {
+    sessionActive = session.active;
+    sessionUser = session.userId;
+    sessionWrote = session.wrote;
+}
+
+ReplicaRouter::SessionScope::Session ReplicaRouter::SessionScope::current() {
+    Session session;
+    session.active = sessionActive;
+    session.userId = sessionUser;
+    session.wrote = sessionWrote;
+    return session;
+}
+
+ReplicaRouter::SessionScope::~SessionScope() {
+    // A write inside a nested scope (a batch item) also counts for the enclosing request
+    bool wrote = sessionWrote;
+    sessionActive = previousActive;
+    sessionUser = previousUser;
+    sessionWrote = previousWrote || (previousActive && wrote);
+}
+
+ReplicaRouter::ReplicaRouter(ConnectionPool& primary,
+                             std::vector<std::pair<ReplicaEndpoint, std::shared_ptr<ConnectionPool>>> pools,
+                             const Policy& policy)
+    : primary(primary), policy(policy) {
+    for (auto& entry : pools) {
+        auto replica = std::make_unique<Replica>();
+        replica->endpoint = entry.first.host + ":" + std::to_string(entry.first.port);
+        replica->pool = std::move(entry.second);
+        replicas.push_back(std::move(replica));
+    }
+    for (auto& slot : recentWrites) {
+        slot.store(0, std::memory_order_relaxed);
+    }
+}
+
+ReplicaRouter::~ReplicaRouter() {
+    stop();
+}
+
+int64_t ReplicaRouter::nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void ReplicaRouter::start() {
+    auto conn = primary.getConnection();
+    if (conn) {
+        if (!conn->executeUpdate(kCreateHeartbeatTable)) {
+            std::cerr << "Failed to create replication_heartbeat: " << conn->getError() << std::endl;
+        }
+        primary.returnConnection(std::move(conn));
+    }
+    writeHeartbeat();
+    for (auto& replica : replicas) {
+        probe(*replica);
+    }
+    monitor = std::thread(&ReplicaRouter::monitorLoop, this);
+}
+
+void ReplicaRouter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(monitorMutex);
+        stopping = true;
+    }
+    monitorWakeup.notify_all();
+    if (monitor.joinable()) {
+        monitor.join();
+    }
+}
+
+void ReplicaRouter::monitorLoop() {
+    std::unique_lock<std::mutex> lock(monitorMutex);
+    while (!monitorWakeup.wait_for(lock, policy.heartbeatInterval, [this]() { return stopping; })) {
+        lock.unlock();
+        writeHeartbeat();
+        for (auto& replica : replicas) {
+            probe(*replica);
+        }
+        lock.lock();
+    }
+}
+
+void ReplicaRouter::writeHeartbeat() {
+    auto conn = primary.getConnection();
+    if (!conn) return;
+    conn->executeUpdate(kWriteHeartbeat);
+    primary.returnConnection(std::move(conn));
+}
+
+void ReplicaRouter::probe(Replica& replica) {
+    int64_t lagMs = -1;
+    auto conn = replica.pool->getConnection();
+    if (conn) {
+        MYSQL_RES* result = conn->executeQuery(kReadLag);
+        MYSQL_ROW row = result ? mysql_fetch_row(result) : nullptr;
+        if (row && row[0]) {
+            lagMs = std::max<int64_t>(0, std::atoll(row[0]) / 1000);
+        }
+        if (result) mysql_free_result(result);
+        replica.pool->returnConnection(std::move(conn));
+    }
+
+    replica.lagMs.store(lagMs, std::memory_order_relaxed);
+    replica.healthy.store(lagMs >= 0 && lagMs <= policy.maxLag.count(), std::memory_order_release);
+}
+
+void ReplicaRouter::recordWrite() {
+    if (!sessionActive) return;
+    sessionWrote = true;
+    if (sessionUser != 0) {
+        recentWrites[static_cast<size_t>(sessionUser) % kRecentWriteSlots].store(nowMs(), std::memory_order_relaxed);
+    }
+}
+
+bool ReplicaRouter::isPinnedToPrimary() const {
+    if (!sessionActive) return false;
+    if (sessionWrote) return true;
+    if (sessionUser == 0) return false;
+    int64_t lastWrite = recentWrites[static_cast<size_t>(sessionUser) % kRecentWriteSlots].load(std::memory_order_relaxed);
+    return lastWrite != 0 && nowMs() - lastWrite < policy.stickyWindow.count();
+}
+
+std::unique_ptr<DatabaseConnection> ReplicaRouter::acquireRead(bool multiStatements) {
+    if (replicas.empty() || isPinnedToPrimary()) return nullptr;
+
+    size_t start = nextReplica.fetch_add(1, std::memory_order_relaxed);
+    for (size_t i = 0; i < replicas.size(); ++i) {
+        Replica& replica = *replicas[(start + i) % replicas.size()];
+        if (!replica.healthy.load(std::memory_order_acquire)) continue;
+
+        auto conn = multiStatements ? replica.pool->getMultiStatementConnection() : replica.pool->getConnection();
+        if (conn) {
+            replica.reads.fetch_add(1, std::memory_order_relaxed);
+            return conn;
+        }
+        // Unreachable until the next successful probe
+        replica.healthy.store(false, std::memory_order_release);
+    }
+    return nullptr;
+}
+
+std::vector<ReplicaRouter::ReplicaStatus> ReplicaRouter::getStatus() const {
+    std::vector<ReplicaStatus> status;
+    for (const auto& replica : replicas) {
+        status.push_back({replica->endpoint, replica->healthy.load(), replica->lagMs.load(), replica->reads.load()});
+    }
+    return status;
+}
@@ -0,0 +1,25 @@
+#include "RequestDeadline.h"
+#include <algorithm>
+
+namespace {
+
+thread_local RequestDeadline* currentDeadline = nullptr;
+
+}
+
+int64_t RequestDeadline::remainingMs() const {
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(at - Clock::now()).count();
+    return std::max<int64_t>(1, remaining);
+}
+
+RequestDeadline* RequestDeadline::current() {
+    return currentDeadline;
+}
+
+RequestDeadline::Scope::Scope(RequestDeadline* deadline) : previous(currentDeadline) {
+    currentDeadline = deadline;
+}
+
+RequestDeadline::Scope::~Scope() {
+    currentDeadline = previous;
+}
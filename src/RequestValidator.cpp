@@ -0,0 +1,191 @@
+#include "RequestValidator.h"
+
+namespace {
+
+inline bool isDigit(unsigned char c) { return c >= '0' && c <= '9'; }
+inline bool isAlpha(unsigned char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+
+// 邮箱local部分: [a-zA-Z0-9._%+-]
+inline bool isEmailLocalChar(unsigned char c) {
+    return isAlpha(c) || isDigit(c) || c == '.' || c == '_' || c == '%' || c == '+' || c == '-';
+}
+
+}
+
+bool RequestValidator::matchEmail(const std::string& value) {
+    // 等价于 [a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,}
+    // 域名部分：最后一个点之前至少一个字符，之后至少两个字母
+    enum State { LOCAL_START, LOCAL, DOMAIN_START, DOMAIN, DOT, TLD1, TLD2 };
+    State state = LOCAL_START;
+
+    for (unsigned char c : value) {
+        switch (state) {
+            case LOCAL_START:
+            case LOCAL:
+                if (isEmailLocalChar(c)) state = LOCAL;
+                else if (c == '@' && state == LOCAL) state = DOMAIN_START;
+                else return false;
+                break;
+            case DOMAIN_START:
+                if (isAlpha(c) || isDigit(c) || c == '-' || c == '.') state = DOMAIN;
+                else return false;
+                break;
+            case DOMAIN:
+            case DOT:
+            case TLD1:
+            case TLD2:
+                if (c == '.') state = DOT;
+                else if (isAlpha(c)) state = (state == DOT) ? TLD1 : (state == TLD1 || state == TLD2) ? TLD2 : DOMAIN;
+                else if (isDigit(c) || c == '-') state = DOMAIN;
+                else return false;
+                break;
+        }
+    }
+    return state == TLD2;
+}
+
+bool RequestValidator::matchCnMobile(const std::string& value) {
+    // 1[3-9]\d{9}
+    if (value.size() != 11 || value[0] != '1' || value[1] < '3' || value[1] > '9') return false;
+    for (size_t i = 2; i < value.size(); ++i) {
+        if (!isDigit(value[i])) return false;
+    }
+    return true;
+}
+
+bool RequestValidator::matchIdNumber(const std::string& value) {
+    // \d{17}[\dXx]，并按GB 11643校验最后一位
+    static const int weights[17] = {7, 9, 10, 5, 8, 4, 2, 1, 6, 3, 7, 9, 10, 5, 8, 4, 2};
+    static const char checkDigits[11] = {'1', '0', 'X', '9', '8', '7', '6', '5', '4', '3', '2'};
+
+    if (value.size() != 18) return false;
+    int sum = 0;
+    for (size_t i = 0; i < 17; ++i) {
+        if (!isDigit(value[i])) return false;
+        sum += (value[i] - '0') * weights[i];
+    }
+    char last = value[17] == 'x' ? 'X' : value[17];
+    return last == checkDigits[sum % 11];
+}
+
+bool RequestValidator::matchDate(const std::string& value) {
+    // YYYY-MM-DD
+    if (value.size() != 10 || value[4] != '-' || value[7] != '-') return false;
+    for (size_t i : {0, 1, 2, 3, 5, 6, 8, 9}) {
+        if (!isDigit(value[i])) return false;
+    }
+    int year = (value[0] - '0') * 1000 + (value[1] - '0') * 100 + (value[2] - '0') * 10 + (value[3] - '0');
+    int month = (value[5] - '0') * 10 + (value[6] - '0');
+    int day = (value[8] - '0') * 10 + (value[9] - '0');
+    if (month < 1 || month > 12 || day < 1) return false;
+
+    // 按公历月份天数校验，闰年二月29天
+    static const int daysInMonth[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return day <= daysInMonth[month - 1] + (month == 2 && leap ? 1 : 0);
+}
+
+void RequestValidator::addSchema(const std::string& api, const std::vector<FieldRule>& rules) {
+    CompiledSchema schema;
+    schema.rules = rules;
+    for (size_t i = 0; i < rules.size(); ++i) {
+        schema.index[rules[i].name] = i;
+    }
+    schemas[api] = std::move(schema);
+}
+
+std::vector<RequestValidator::ValidationError> RequestValidator::validate(const std::string& api,
+                                                                            const nlohmann::json& data) const {
+    std::vector<ValidationError> errors;
+
+    auto schemaIt = schemas.find(api);
+    if (schemaIt == schemas.end()) {
+        return errors;
+    }
+    const CompiledSchema& schema = schemaIt->second;
+
+    if (!data.is_object()) {
+        errors.push_back({"data", 400, "data必须为对象"});
+        return errors;
+    }
+
+    // 单遍扫描data，按规则下标记录出现情况与校验结果
+    enum FieldStatus : unsigned char { ABSENT, VALID, BAD_TYPE, BAD_FORMAT };
+    std::vector<FieldStatus> status(schema.rules.size(), ABSENT);
+
+    for (auto it = data.begin(); it != data.end(); ++it) {
+        auto ruleIt = schema.index.find(it.key());
+        if (ruleIt == schema.index.end()) continue;
+
+        const FieldRule& rule = schema.rules[ruleIt->second];
+        const nlohmann::json& value = it.value();
+        FieldStatus& fieldStatus = status[ruleIt->second];
+
+        if (!checkType(rule.type, value)) {
+            fieldStatus = BAD_TYPE;
+        } else if (rule.format != FieldFormat::NONE && value.is_string() &&
+                   !checkFormat(rule.format, value.get_ref<const std::string&>())) {
+            fieldStatus = BAD_FORMAT;
+        } else {
+            fieldStatus = VALID;
+        }
+    }
+
+    // 先报告缺失字段（保持与原处理函数相同的优先级），再报告类型/格式错误
+    for (size_t i = 0; i < schema.rules.size(); ++i) {
+        const FieldRule& rule = schema.rules[i];
+        if (status[i] == ABSENT && rule.isRequired) {
+            errors.push_back({rule.name, rule.missingCode, rule.missingMessage});
+        }
+    }
+    for (size_t i = 0; i < schema.rules.size(); ++i) {
+        const FieldRule& rule = schema.rules[i];
+        if (status[i] == BAD_TYPE) {
+            errors.push_back({rule.name, 400, "参数" + rule.name + "类型错误，应为" + typeName(rule.type)});
+        } else if (status[i] == BAD_FORMAT) {
+            errors.push_back({rule.name, rule.invalidCode,
+                              rule.invalidMessage.empty() ? "参数" + rule.name + "格式错误" : rule.invalidMessage});
+        }
+    }
+
+    return errors;
+}
+
+bool RequestValidator::checkType(FieldType type, const nlohmann::json& value) {
+    switch (type) {
+        case FieldType::ANY: return true;
+        case FieldType::STRING: return value.is_string();
+        case FieldType::INTEGER: return value.is_number_integer();
+        case FieldType::NUMBER: return value.is_number();
+        case FieldType::BOOLEAN: return value.is_boolean();
+        case FieldType::ARRAY: return value.is_array();
+        case FieldType::OBJECT: return value.is_object();
+    }
+    return false;
+}
+
+bool RequestValidator::checkFormat(FieldFormat format, const std::string& value) {
+    switch (format) {
+        case FieldFormat::NONE: return true;
+        case FieldFormat::NON_EMPTY: return !value.empty();
+        case FieldFormat::EMAIL: return matchEmail(value);
+        case FieldFormat::CN_MOBILE: return matchCnMobile(value);
+        case FieldFormat::ID_NUMBER: return matchIdNumber(value);
+        case FieldFormat::DATE: return matchDate(value);
+        case FieldFormat::PASSWORD: return value.length() >= 6;
+    }
+    return false;
+}
+
+std::string RequestValidator::typeName(FieldType type) {
+    switch (type) {
+        case FieldType::ANY: return "任意类型";
+        case FieldType::STRING: return "字符串";
+        case FieldType::INTEGER: return "整数";
+        case FieldType::NUMBER: return "数字";
+        case FieldType::BOOLEAN: return "布尔值";
+        case FieldType::ARRAY: return "数组";
+        case FieldType::OBJECT: return "对象";
+    }
+    return "未知类型";
+}
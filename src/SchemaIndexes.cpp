@@ -0,0 +1,84 @@
+#include "SchemaIndexes.h"
+#include <set>
+#include <utility>
+
+const std::vector<SchemaIndexes::Index>& SchemaIndexes::required() {
+    static const std::vector<Index> indexes = {
+        {"doctors", "idx_department_name", "department, name"},
+        {"patients", "idx_gender_name", "gender, name"},
+        {"cases", "idx_patient_date", "patient_id, diagnosis_date"},
+        {"cases", "idx_doctor_date", "doctor_id, diagnosis_date"},
+        {"cases", "idx_department_date", "department, diagnosis_date"},
+        {"appointments", "idx_patient_time", "patient_id, appointment_time"},
+        {"appointments", "idx_doctor_time", "doctor_id, appointment_time"},
+        {"appointments", "idx_department_time", "department, appointment_time"},
+        {"appointments", "idx_status_time", "status, appointment_time"},
+        {"hospitalization", "idx_patient_date", "patient_id, admission_date"},
+        {"hospitalization", "idx_ward_bed", "ward_number, bed_number"},
+        {"prescriptions", "idx_case_date", "case_id, issued_date"},
+        {"prescriptions", "idx_doctor_date", "doctor_id, issued_date"},
+        {"medications", "idx_prescription_name", "prescription_id, medication_name"},
+        {"medications", "idx_name_quantity", "medication_name, quantity"}
+    };
+    return indexes;
+}
+
+const std::vector<SchemaIndexes::Index>& SchemaIndexes::superseded() {
+    static const std::vector<Index> indexes = {
+        {"users", "idx_username", "username"},
+        {"users", "idx_email", "email"},
+        {"doctors", "idx_department", "department"},
+        {"patients", "idx_id_number", "id_number"},
+        {"cases", "idx_patient_id", "patient_id"},
+        {"cases", "idx_doctor_id", "doctor_id"},
+        {"cases", "idx_department", "department"},
+        {"appointments", "idx_patient_id", "patient_id"},
+        {"appointments", "idx_doctor_id", "doctor_id"},
+        {"appointments", "idx_department", "department"},
+        {"appointments", "idx_status", "status"},
+        {"hospitalization", "idx_patient_id", "patient_id"},
+        {"hospitalization", "idx_ward_number", "ward_number"},
+        {"hospitalization", "idx_bed_number", "bed_number"},
+        {"prescriptions", "idx_case_id", "case_id"},
+        {"prescriptions", "idx_doctor_id", "doctor_id"},
+        {"medications", "idx_prescription_id", "prescription_id"},
+        {"medications", "idx_medication_name", "medication_name"}
+    };
+    return indexes;
+}
+
+bool SchemaIndexes::migrate(DatabaseConnection& conn, std::string& error) {
+    MYSQL_RES* result = conn.executeQuery(
+        "SELECT DISTINCT TABLE_NAME, INDEX_NAME FROM information_schema.STATISTICS WHERE TABLE_SCHEMA = DATABASE()");
+    if (!result) {
+        error = "Failed to read indexes: " + conn.getError();
+        return false;
+    }
+    std::set<std::string> tables;
+    std::set<std::pair<std::string, std::string>> existing;
+    while (MYSQL_ROW row = mysql_fetch_row(result)) {
+        if (!row[0] || !row[1]) continue;
+        tables.insert(row[0]);
+        existing.emplace(row[0], row[1]);
+    }
+    mysql_free_result(result);
+
+    // Add before dropping: a foreign key needs an index leading with its column at all times
+    for (const Index& index : required()) {
+        if (!tables.count(index.table) || existing.count({index.table, index.name})) continue;
+        std::string statement = std::string("ALTER TABLE ") + index.table + " ADD INDEX " + index.name + " (" + index.columns + ")";
+        if (!conn.executeUpdate(statement)) {
+            error = std::string("Failed to add index ") + index.table + "." + index.name + ": " + conn.getError();
+            return false;
+        }
+    }
+    for (const Index& index : superseded()) {
+        if (!existing.count({index.table, index.name})) continue;
+        std::string statement = std::string("ALTER TABLE ") + index.table + " DROP INDEX " + index.name;
+        if (!conn.executeUpdate(statement)) {
+            error = std::string("Failed to drop index ") + index.table + "." + index.name + ": " + conn.getError();
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,236 @@
+#include "Sha256.h"
+#include <openssl/evp.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SHA256_HAVE_AVX2_KERNEL 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+std::atomic<bool> forceScalar{false};
+
+// 256项查表，每个字节直接映射为两个十六进制字符
+struct HexTable {
+    char pairs[256][2];
+    HexTable() {
+        const char* digits = "0123456789abcdef";
+        for (int i = 0; i < 256; ++i) {
+            pairs[i][0] = digits[i >> 4];
+            pairs[i][1] = digits[i & 0x0f];
+        }
+    }
+};
+
+const HexTable hexTable;
+
+#ifdef SHA256_HAVE_AVX2_KERNEL
+
+const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+const uint32_t H0[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+const size_t LANES = 8;
+
+bool cpuHasAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+// 按SHA-256规则补位：0x80、补零、64位大端比特长度
+size_t padMessage(const std::string& message, std::vector<uint8_t>& buffer) {
+    size_t blocks = (message.size() + 9 + 63) / 64;
+    buffer.assign(blocks * 64, 0);
+    std::memcpy(buffer.data(), message.data(), message.size());
+    buffer[message.size()] = 0x80;
+    uint64_t bitLength = static_cast<uint64_t>(message.size()) * 8;
+    for (int i = 0; i < 8; ++i) {
+        buffer[buffer.size() - 1 - i] = static_cast<uint8_t>(bitLength >> (8 * i));
+    }
+    return blocks;
+}
+
+#define SHA256_AVX2 __attribute__((target("avx2")))
+
+SHA256_AVX2 inline __m256i rotr(__m256i x, int n) {
+    return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n));
+}
+
+// 8路并行压缩：每个lane对应一条消息，所有lane的分块数相同
+SHA256_AVX2 void compressX8(const uint8_t* const lanes[LANES], size_t numBlocks, uint8_t out[LANES][32]) {
+    __m256i state[8];
+    for (int i = 0; i < 8; ++i) {
+        state[i] = _mm256_set1_epi32(static_cast<int>(H0[i]));
+    }
+
+    alignas(32) uint32_t words[LANES];
+    __m256i w[64];
+
+    for (size_t block = 0; block < numBlocks; ++block) {
+        for (int t = 0; t < 16; ++t) {
+            for (size_t lane = 0; lane < LANES; ++lane) {
+                uint32_t word;
+                std::memcpy(&word, lanes[lane] + block * 64 + t * 4, sizeof(word));
+                words[lane] = __builtin_bswap32(word);
+            }
+            w[t] = _mm256_load_si256(reinterpret_cast<const __m256i*>(words));
+        }
+        for (int t = 16; t < 64; ++t) {
+            __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(rotr(w[t - 15], 7), rotr(w[t - 15], 18)),
+                                          _mm256_srli_epi32(w[t - 15], 3));
+            __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(rotr(w[t - 2], 17), rotr(w[t - 2], 19)),
+                                          _mm256_srli_epi32(w[t - 2], 10));
+            w[t] = _mm256_add_epi32(_mm256_add_epi32(w[t - 16], s0), _mm256_add_epi32(w[t - 7], s1));
+        }
+
+        __m256i a = state[0], b = state[1], c = state[2], d = state[3];
+        __m256i e = state[4], f = state[5], g = state[6], h = state[7];
+
+        for (int t = 0; t < 64; ++t) {
+            __m256i S1 = _mm256_xor_si256(_mm256_xor_si256(rotr(e, 6), rotr(e, 11)), rotr(e, 25));
+            __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+            __m256i temp1 = _mm256_add_epi32(_mm256_add_epi32(h, S1),
+                                             _mm256_add_epi32(_mm256_add_epi32(ch, _mm256_set1_epi32(static_cast<int>(K[t]))), w[t]));
+            __m256i S0 = _mm256_xor_si256(_mm256_xor_si256(rotr(a, 2), rotr(a, 13)), rotr(a, 22));
+            __m256i maj = _mm256_xor_si256(_mm256_xor_si256(_mm256_and_si256(a, b), _mm256_and_si256(a, c)),
+                                           _mm256_and_si256(b, c));
+            __m256i temp2 = _mm256_add_epi32(S0, maj);
+
+            h = g;
+            g = f;
+            f = e;
+            e = _mm256_add_epi32(d, temp1);
+            d = c;
+            c = b;
+            b = a;
+            a = _mm256_add_epi32(temp1, temp2);
+        }
+
+        state[0] = _mm256_add_epi32(state[0], a);
+        state[1] = _mm256_add_epi32(state[1], b);
+        state[2] = _mm256_add_epi32(state[2], c);
+        state[3] = _mm256_add_epi32(state[3], d);
+        state[4] = _mm256_add_epi32(state[4], e);
+        state[5] = _mm256_add_epi32(state[5], f);
+        state[6] = _mm256_add_epi32(state[6], g);
+        state[7] = _mm256_add_epi32(state[7], h);
+    }
+
+    for (int i = 0; i < 8; ++i) {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(words), state[i]);
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            uint32_t word = __builtin_bswap32(words[lane]);
+            std::memcpy(out[lane] + i * 4, &word, sizeof(word));
+        }
+    }
+}
+
+#endif // SHA256_HAVE_AVX2_KERNEL
+
+} // namespace
+
+void Sha256::digest(const void* data, size_t length, uint8_t out[DIGEST_LENGTH]) {
+    unsigned int outLength = 0;
+    if (EVP_Digest(data, length, out, &outLength, EVP_sha256(), nullptr) != 1) {
+        throw std::runtime_error("SHA-256 digest failed");
+    }
+}
+
+void Sha256::toHex(const uint8_t* bytes, size_t length, char* out) {
+    for (size_t i = 0; i < length; ++i) {
+        out[2 * i] = hexTable.pairs[bytes[i]][0];
+        out[2 * i + 1] = hexTable.pairs[bytes[i]][1];
+    }
+}
+
+std::string Sha256::hex(const std::string& message) {
+    uint8_t hash[DIGEST_LENGTH];
+    digest(message.data(), message.size(), hash);
+
+    std::string result(DIGEST_LENGTH * 2, '\0');
+    toHex(hash, DIGEST_LENGTH, &result[0]);
+    return result;
+}
+
+std::vector<std::string> Sha256::hexBatch(const std::vector<std::string>& messages) {
+    std::vector<std::string> results(messages.size());
+
+#ifdef SHA256_HAVE_AVX2_KERNEL
+    if (!forceScalar.load(std::memory_order_relaxed) && cpuHasAvx2() && messages.size() >= LANES / 2) {
+        // 补位后按分块数分组，同组内每8条消息走一次多缓冲压缩
+        std::vector<std::vector<uint8_t>> padded(messages.size());
+        std::vector<size_t> blockCounts(messages.size());
+        std::vector<size_t> order(messages.size());
+        for (size_t i = 0; i < messages.size(); ++i) {
+            blockCounts[i] = padMessage(messages[i], padded[i]);
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(),
+                         [&](size_t x, size_t y) { return blockCounts[x] < blockCounts[y]; });
+
+        size_t pos = 0;
+        while (pos < order.size()) {
+            size_t blocks = blockCounts[order[pos]];
+            size_t groupSize = 1;
+            while (groupSize < LANES && pos + groupSize < order.size() &&
+                   blockCounts[order[pos + groupSize]] == blocks) {
+                ++groupSize;
+            }
+
+            if (groupSize < LANES / 2) {
+                // 同长度消息太少，空lane的浪费超过并行收益
+                for (size_t j = 0; j < groupSize; ++j) {
+                    results[order[pos + j]] = hex(messages[order[pos + j]]);
+                }
+            } else {
+                const uint8_t* lanes[LANES];
+                for (size_t lane = 0; lane < LANES; ++lane) {
+                    lanes[lane] = padded[order[pos + std::min(lane, groupSize - 1)]].data();
+                }
+                uint8_t hashes[LANES][32];
+                compressX8(lanes, blocks, hashes);
+                for (size_t j = 0; j < groupSize; ++j) {
+                    std::string& out = results[order[pos + j]];
+                    out.resize(DIGEST_LENGTH * 2);
+                    toHex(hashes[j], DIGEST_LENGTH, &out[0]);
+                }
+            }
+            pos += groupSize;
+        }
+        return results;
+    }
+#endif
+
+    for (size_t i = 0; i < messages.size(); ++i) {
+        results[i] = hex(messages[i]);
+    }
+    return results;
+}
+
+const char* Sha256::batchBackend() {
+#ifdef SHA256_HAVE_AVX2_KERNEL
+    if (!forceScalar.load(std::memory_order_relaxed) && cpuHasAvx2()) {
+        return "avx2-x8";
+    }
+#endif
+    return "scalar";
+}
+
+void Sha256::setForceScalar(bool force) {
+    forceScalar.store(force, std::memory_order_relaxed);
+}
@@ -0,0 +1,164 @@
+#include "ShardMap.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+// Fibonacci hashing: consecutive AUTO_INCREMENT patient ids spread over all buckets
+const uint32_t kHashMultiplier = 2654435761u;
+const int kBucketShift = 22;  // 32 - log2(kBuckets)
+
+bool parseIndex(const std::string& text, long limit, long& value) {
+    char* end = nullptr;
+    value = std::strtol(text.c_str(), &end, 10);
+    return !text.empty() && *end == '\0' && value >= 0 && value < limit;
+}
+
+}
+
+bool ShardLocation::parse(const std::string& text, ShardLocation& location) {
+    size_t slash = text.find('/');
+    if (slash == std::string::npos || slash + 1 == text.size()) return false;
+
+    std::string address = text.substr(0, slash);
+    location.database = text.substr(slash + 1);
+    location.port = 3306;
+    size_t colon = address.rfind(':');
+    location.host = address.substr(0, colon);
+    if (colon != std::string::npos) {
+        int port = std::atoi(address.c_str() + colon + 1);
+        if (port <= 0 || port > 65535) return false;
+        location.port = static_cast<unsigned int>(port);
+    }
+    return !location.host.empty();
+}
+
+std::string ShardLocation::toString() const {
+    return host + ":" + std::to_string(port) + "/" + database;
+}
+
+int ShardMap::bucketOf(int patientId) {
+    return static_cast<int>((static_cast<uint32_t>(patientId) * kHashMultiplier) >> kBucketShift);
+}
+
+std::string ShardMap::bucketExpression(const std::string& column) {
+    return "(((" + column + " * " + std::to_string(kHashMultiplier) + ") & 4294967295) >> " +
+           std::to_string(kBucketShift) + ")";
+}
+
+size_t ShardMap::addShard(const ShardLocation& location) {
+    shards.push_back(location);
+    return shards.size() - 1;
+}
+
+std::vector<int> ShardMap::bucketsOf(size_t shard) const {
+    std::vector<int> owned;
+    for (int bucket = 0; bucket < kBuckets; ++bucket) {
+        if (buckets[bucket] == shard) owned.push_back(bucket);
+    }
+    return owned;
+}
+
+int ShardMap::homeShardOf(int id) const {
+    if (id <= 0) return -1;
+    size_t shard = static_cast<size_t>(id - 1) % kIdStride;
+    return shard < shards.size() ? static_cast<int>(shard) : -1;
+}
+
+bool ShardMap::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        lastError = "Cannot open shard map " + path;
+        return false;
+    }
+
+    std::vector<ShardLocation> loaded(kMaxShards);
+    std::vector<bool> present(kMaxShards, false);
+    std::vector<long> owners(kBuckets, -1);
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        std::string directive, first, second;
+        if (!(fields >> directive)) continue;
+
+        bool valid = static_cast<bool>(fields >> first >> second);
+        if (valid && directive == "shard") {
+            long index = 0;
+            valid = parseIndex(first, kMaxShards, index) && !present[index] &&
+                    ShardLocation::parse(second, loaded[index]);
+            if (valid) present[index] = true;
+        } else if (valid && directive == "buckets") {
+            size_t dash = first.find('-');
+            std::string last = dash == std::string::npos ? first : first.substr(dash + 1);
+            long from = 0, to = 0, shard = 0;
+            valid = parseIndex(first.substr(0, dash), kBuckets, from) && parseIndex(last, kBuckets, to) &&
+                    from <= to && parseIndex(second, kMaxShards, shard);
+            for (long bucket = from; valid && bucket <= to; ++bucket) {
+                owners[bucket] = shard;
+            }
+        } else {
+            valid = false;
+        }
+        if (!valid) {
+            lastError = path + ":" + std::to_string(lineNumber) + ": invalid directive";
+            return false;
+        }
+    }
+
+    size_t count = 0;
+    while (count < kMaxShards && present[count]) ++count;
+    for (size_t index = count; index < kMaxShards; ++index) {
+        if (present[index]) {
+            lastError = "Shard indexes in " + path + " must be contiguous from 0";
+            return false;
+        }
+    }
+    if (count == 0) {
+        lastError = "No shards in " + path;
+        return false;
+    }
+
+    for (int bucket = 0; bucket < kBuckets; ++bucket) {
+        if (owners[bucket] >= static_cast<long>(count)) {
+            lastError = "Bucket " + std::to_string(bucket) + " is assigned to an undefined shard";
+            return false;
+        }
+    }
+
+    loaded.resize(count);
+    shards = std::move(loaded);
+    for (int bucket = 0; bucket < kBuckets; ++bucket) {
+        buckets[bucket] = owners[bucket] >= 0 ? static_cast<size_t>(owners[bucket]) : bucket * count / kBuckets;
+    }
+    return true;
+}
+
+bool ShardMap::save(const std::string& path) const {
+    // Write a sibling file and rename it so readers never see a partial map
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if (!file) return false;
+
+        file << "# Patient shard map: patient_id -> bucket (" << kBuckets << ") -> shard\n";
+        for (size_t shard = 0; shard < shards.size(); ++shard) {
+            file << "shard " << shard << " " << shards[shard].toString() << "\n";
+        }
+        int first = 0;
+        for (int bucket = 1; bucket <= kBuckets; ++bucket) {
+            if (bucket == kBuckets || buckets[bucket] != buckets[first]) {
+                file << "buckets " << first;
+                if (bucket - 1 != first) file << "-" << bucket - 1;
+                file << " " << buckets[first] << "\n";
+                first = bucket;
+            }
+        }
+        if (!file.flush()) return false;
+    }
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
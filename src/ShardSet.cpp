@@ -0,0 +1,139 @@
+#include "ShardSet.h"
+#include "SchemaIndexes.h"
+
+namespace {
+
+// Patient-owned tables as they exist on a shard. patients and doctors stay in
+// the main database, so only the keys between shard-local tables remain; a
+// case, its prescriptions and their medications always share a shard.
+const char* const kShardTables[] = {
+    R"(CREATE TABLE IF NOT EXISTS cases (
+        case_id INT AUTO_INCREMENT PRIMARY KEY,
+        patient_id INT NOT NULL,
+        department VARCHAR(50) NOT NULL,
+        doctor_id INT NOT NULL,
+        diagnosis TEXT NOT NULL,
+        diagnosis_date DATETIME NOT NULL DEFAULT CURRENT_TIMESTAMP,
+        INDEX idx_patient_date (patient_id, diagnosis_date),
+        INDEX idx_doctor_date (doctor_id, diagnosis_date),
+        INDEX idx_department_date (department, diagnosis_date),
+        INDEX idx_diagnosis_date (diagnosis_date)
+    ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4)",
+
+    R"(CREATE TABLE IF NOT EXISTS appointments (
+        appointment_id INT AUTO_INCREMENT PRIMARY KEY,
+        patient_id INT NOT NULL,
+        doctor_id INT NOT NULL,
+        appointment_time DATETIME NOT NULL,
+        department VARCHAR(50) NOT NULL,
+        status ENUM('Booked', 'Attended', 'Cancelled') NOT NULL DEFAULT 'Booked',
+        INDEX idx_patient_time (patient_id, appointment_time),
+        INDEX idx_doctor_time (doctor_id, appointment_time),
+        INDEX idx_department_time (department, appointment_time),
+        INDEX idx_status_time (status, appointment_time),
+        INDEX idx_appointment_time (appointment_time)
+    ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4)",
+
+    R"(CREATE TABLE IF NOT EXISTS hospitalization (
+        hospitalization_id INT AUTO_INCREMENT PRIMARY KEY,
+        patient_id INT NOT NULL,
+        ward_number VARCHAR(20) NOT NULL,
+        bed_number VARCHAR(20) NOT NULL,
+        admission_date DATETIME NOT NULL DEFAULT CURRENT_TIMESTAMP,
+        attending_doctor VARCHAR(100) NOT NULL,
+        INDEX idx_patient_date (patient_id, admission_date),
+        INDEX idx_ward_bed (ward_number, bed_number),
+        INDEX idx_admission_date (admission_date)
+    ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4)",
+
+    R"(CREATE TABLE IF NOT EXISTS prescriptions (
+        prescription_id INT AUTO_INCREMENT PRIMARY KEY,
+        case_id INT NOT NULL,
+        doctor_id INT NOT NULL,
+        prescription_content TEXT NOT NULL,
+        issued_date DATETIME NOT NULL DEFAULT CURRENT_TIMESTAMP,
+        FOREIGN KEY (case_id) REFERENCES cases(case_id) ON DELETE CASCADE,
+        INDEX idx_case_date (case_id, issued_date),
+        INDEX idx_doctor_date (doctor_id, issued_date),
+        INDEX idx_issued_date (issued_date)
+    ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4)",
+
+    R"(CREATE TABLE IF NOT EXISTS medications (
+        medication_id INT AUTO_INCREMENT PRIMARY KEY,
+        prescription_id INT NOT NULL,
+        medication_name VARCHAR(100) NOT NULL,
+        quantity INT NOT NULL,
+        usage_instructions TEXT NOT NULL,
+        FOREIGN KEY (prescription_id) REFERENCES prescriptions(prescription_id) ON DELETE CASCADE,
+        INDEX idx_prescription_name (prescription_id, medication_name),
+        INDEX idx_name_quantity (medication_name, quantity)
+    ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4)"
+};
+
+}
+
+ShardSet::ShardSet(ShardMap map, std::vector<std::shared_ptr<ConnectionPool>> pools)
+    : map(std::move(map)), pools(std::move(pools)) {}
+
+std::shared_ptr<ShardSet> ShardSet::connect(const ShardMap& map, const ConnectionPool& main) {
+    std::vector<std::shared_ptr<ConnectionPool>> pools;
+    for (size_t shard = 0; shard < map.size(); ++shard) {
+        const ShardLocation& location = map.getShard(shard);
+        pools.push_back(main.connectTo(location.host, location.port, location.database, idAllocationCommand(shard)));
+    }
+    return std::make_shared<ShardSet>(map, std::move(pools));
+}
+
+std::string ShardSet::idAllocationCommand(size_t shard) {
+    return "SET SESSION auto_increment_increment = " + std::to_string(ShardMap::kIdStride) +
+           ", auto_increment_offset = " + std::to_string(shard + 1);
+}
+
+bool ShardSet::hasRow(size_t shard, const std::string& query) const {
+    auto conn = pools[shard]->getConnection();
+    if (!conn) return false;
+
+    MYSQL_RES* result = conn->executeQuery(query);
+    bool found = result && mysql_fetch_row(result);
+    if (result) mysql_free_result(result);
+    pools[shard]->returnConnection(std::move(conn));
+    return found;
+}
+
+int ShardSet::locate(const std::string& table, const std::string& idColumn, int id) const {
+    std::string query = "SELECT 1 FROM " + table + " WHERE " + idColumn + " = " + std::to_string(id) + " LIMIT 1";
+
+    int home = map.homeShardOf(id);
+    if (home >= 0 && hasRow(home, query)) return home;
+
+    auto found = scatter([&](size_t shard) { return static_cast<int>(shard) != home && hasRow(shard, query); });
+    for (size_t shard = 0; shard < found.size(); ++shard) {
+        if (found[shard]) return static_cast<int>(shard);
+    }
+    return -1;
+}
+
+bool ShardSet::createTables() {
+    for (size_t shard = 0; shard < pools.size(); ++shard) {
+        auto conn = pools[shard]->getConnection();
+        if (!conn) {
+            lastError = "Cannot connect to shard " + map.getShard(shard).toString();
+            return false;
+        }
+        for (const char* query : kShardTables) {
+            if (!conn->executeUpdate(query)) {
+                lastError = "Failed to create table on shard " + map.getShard(shard).toString() + ": " + conn->getError();
+                pools[shard]->returnConnection(std::move(conn));
+                return false;
+            }
+        }
+        std::string error;
+        if (!SchemaIndexes::migrate(*conn, error)) {
+            lastError = "Failed to migrate indexes on shard " + map.getShard(shard).toString() + ": " + error;
+            pools[shard]->returnConnection(std::move(conn));
+            return false;
+        }
+        pools[shard]->returnConnection(std::move(conn));
+    }
+    return true;
+}
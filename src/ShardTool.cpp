@@ -0,0 +1,402 @@
+#include <getopt.h>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "DatabaseConnection.h"
+#include "ShardMap.h"
+#include "ShardSet.h"
+
+// 分片维护工具：生成分片映射、把主库患者数据导入分片、增加分片后按桶迁移数据。
+// 迁移期间数据库不应有写入，完成后重启JsonAPI/HttpServer以加载新的映射文件。
+
+namespace {
+
+// 按外键依赖排列：插入时先病例后处方、药品
+const char* const kShardedTables[] = {"cases", "prescriptions", "medications", "appointments", "hospitalization"};
+const char* const kIdColumns[] = {"case_id", "prescription_id", "medication_id", "appointment_id", "hospitalization_id"};
+
+// 每条REPLACE语句携带的行数
+const size_t kCopyBatchRows = 500;
+
+void printUsage(const char* programName) {
+    std::cout << "用法: " << programName << " [选项] <命令> <映射文件> [参数]" << std::endl;
+    std::cout << "命令:" << std::endl;
+    std::cout << "  init <映射文件> <主机[:端口]/数据库>...  创建映射文件，桶平均分配到各分片，并在各分片建表" << std::endl;
+    std::cout << "  import <映射文件>                       把主库中的病例、预约、住院、处方、药品按桶复制到各分片" << std::endl;
+    std::cout << "  add-shard <映射文件> <主机[:端口]/数据库> 追加一个分片并建表，新分片在rebalance之前不拥有桶" << std::endl;
+    std::cout << "  rebalance <映射文件>                    把桶平均分配到所有分片，迁移数据后删除原分片上的副本" << std::endl;
+    std::cout << "  status <映射文件>                       显示各分片拥有的桶数与各表行数" << std::endl;
+    std::cout << "选项:" << std::endl;
+    std::cout << "  --host <主机地址>     主库地址 (默认: localhost)" << std::endl;
+    std::cout << "  --port <端口>         主库端口 (默认: 3306)" << std::endl;
+    std::cout << "  --user <用户名>       数据库用户名，分片使用相同的账号 (默认: root)" << std::endl;
+    std::cout << "  --password <密码>     数据库密码 (默认: 空)" << std::endl;
+    std::cout << "  --database <数据库名> 主库名称 (默认: hospital_db)" << std::endl;
+}
+
+std::string joinBuckets(const std::vector<int>& buckets) {
+    std::ostringstream list;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        if (i > 0) list << ",";
+        list << buckets[i];
+    }
+    return list.str();
+}
+
+// table中属于buckets的行；处方与药品通过所属病例定位患者
+std::string ownedRows(const std::string& table, const std::vector<int>& buckets) {
+    std::string inBuckets = " IN (" + joinBuckets(buckets) + ")";
+    if (table == "prescriptions") {
+        return "case_id IN (SELECT case_id FROM cases WHERE " + ShardMap::bucketExpression("patient_id") + inBuckets + ")";
+    }
+    if (table == "medications") {
+        return "prescription_id IN (SELECT p.prescription_id FROM prescriptions p JOIN cases c ON p.case_id = c.case_id "
+               "WHERE " + ShardMap::bucketExpression("c.patient_id") + inBuckets + ")";
+    }
+    return ShardMap::bucketExpression("patient_id") + inBuckets;
+}
+
+bool execute(ConnectionPool& pool, const std::string& statement) {
+    auto conn = pool.getConnection();
+    if (!conn) return false;
+    bool ok = conn->executeUpdate(statement);
+    if (!ok) std::cerr << "执行失败: " << conn->getError() << std::endl;
+    pool.returnConnection(std::move(conn));
+    return ok;
+}
+
+long long queryNumber(ConnectionPool& pool, const std::string& query) {
+    auto conn = pool.getConnection();
+    if (!conn) return -1;
+    long long value = -1;
+    if (MYSQL_RES* result = conn->executeQuery(query)) {
+        MYSQL_ROW row = mysql_fetch_row(result);
+        value = (row && row[0]) ? std::stoll(row[0]) : 0;
+        mysql_free_result(result);
+    }
+    pool.returnConnection(std::move(conn));
+    return value;
+}
+
+// 把source中table满足where的行以REPLACE写入target，保留原有主键；返回复制行数，失败返回-1
+long long copyRows(ConnectionPool& source, ConnectionPool& target, const std::string& table, const std::string& where) {
+    auto reader = source.getConnection();
+    auto writer = target.getConnection();
+    if (!reader || !writer) {
+        if (reader) source.returnConnection(std::move(reader));
+        if (writer) target.returnConnection(std::move(writer));
+        return -1;
+    }
+
+    long long copied = -1;
+    if (MYSQL_RES* result = reader->executeQuery("SELECT * FROM " + table + " WHERE " + where)) {
+        unsigned int fieldCount = mysql_num_fields(result);
+        MYSQL_FIELD* fields = mysql_fetch_fields(result);
+        std::string prefix = "REPLACE INTO " + table + " (";
+        for (unsigned int i = 0; i < fieldCount; ++i) {
+            prefix += (i > 0 ? ", " : "") + std::string(fields[i].name);
+        }
+        prefix += ") VALUES ";
+
+        copied = 0;
+        std::string values;
+        size_t pending = 0;
+        MYSQL_ROW row;
+        bool ok = true;
+        while (ok && (row = mysql_fetch_row(result))) {
+            unsigned long* lengths = mysql_fetch_lengths(result);
+            values += pending > 0 ? ", (" : "(";
+            for (unsigned int i = 0; i < fieldCount; ++i) {
+                if (i > 0) values += ", ";
+                values += row[i] ? "'" + writer->escapeString(std::string(row[i], lengths[i])) + "'" : "NULL";
+            }
+            values += ")";
+            ++copied;
+            if (++pending == kCopyBatchRows) {
+                ok = writer->executeUpdate(prefix + values);
+                values.clear();
+                pending = 0;
+            }
+        }
+        if (ok && pending > 0) ok = writer->executeUpdate(prefix + values);
+        if (!ok) {
+            std::cerr << "写入" << table << "失败: " << writer->getError() << std::endl;
+            copied = -1;
+        }
+        mysql_free_result(result);
+    } else {
+        std::cerr << "读取" << table << "失败: " << reader->getError() << std::endl;
+    }
+
+    source.returnConnection(std::move(reader));
+    target.returnConnection(std::move(writer));
+    return copied;
+}
+
+// 按依赖顺序复制buckets内的全部患者数据
+bool copyBuckets(ConnectionPool& source, ConnectionPool& target, const std::vector<int>& buckets) {
+    if (buckets.empty()) return true;
+    for (const char* table : kShardedTables) {
+        long long copied = copyRows(source, target, table, ownedRows(table, buckets));
+        if (copied < 0) return false;
+        std::cout << "  " << table << ": " << copied << " 行" << std::endl;
+    }
+    return true;
+}
+
+bool loadMap(const std::string& path, ShardMap& map) {
+    if (!map.load(path)) {
+        std::cerr << "错误: " << map.getError() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool createShardTables(ShardSet& shards) {
+    if (!shards.createTables()) {
+        std::cerr << "错误: " << shards.getError() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int runInit(const std::string& mapPath, const std::vector<std::string>& args, const ConnectionPool& main) {
+    if (args.empty() || args.size() > ShardMap::kMaxShards) {
+        std::cerr << "错误: init 需要1到" << ShardMap::kMaxShards << "个分片地址" << std::endl;
+        return 1;
+    }
+    if (std::ifstream(mapPath)) {
+        std::cerr << "错误: 映射文件已存在: " << mapPath << std::endl;
+        return 1;
+    }
+
+    ShardMap map;
+    for (const auto& arg : args) {
+        ShardLocation location;
+        if (!ShardLocation::parse(arg, location)) {
+            std::cerr << "错误: 无效的分片地址: " << arg << std::endl;
+            return 1;
+        }
+        map.addShard(location);
+    }
+    for (int bucket = 0; bucket < ShardMap::kBuckets; ++bucket) {
+        map.assignBucket(bucket, bucket * map.size() / ShardMap::kBuckets);
+    }
+
+    auto shards = ShardSet::connect(map, main);
+    if (!createShardTables(*shards)) return 1;
+    if (!map.save(mapPath)) {
+        std::cerr << "错误: 无法写入映射文件: " << mapPath << std::endl;
+        return 1;
+    }
+    std::cout << "已创建 " << mapPath << "，" << map.size() << " 个分片" << std::endl;
+    return 0;
+}
+
+int runImport(const std::string& mapPath, ConnectionPool& main) {
+    ShardMap map;
+    if (!loadMap(mapPath, map)) return 1;
+    auto shards = ShardSet::connect(map, main);
+    if (!createShardTables(*shards)) return 1;
+
+    for (size_t shard = 0; shard < shards->size(); ++shard) {
+        std::cout << "导入分片 " << shard << " (" << map.getShard(shard).toString() << ")" << std::endl;
+        if (!copyBuckets(main, *shards->at(shard), map.bucketsOf(shard))) return 1;
+    }
+
+    // 导入的行保留主库分配的id，不属于任何分片的余数类；
+    // 所有分片的计数器越过全局最大id，之后新分配的id不会与导入的行冲突
+    for (size_t i = 0; i < std::size(kShardedTables); ++i) {
+        std::string table = kShardedTables[i];
+        long long maxId = queryNumber(main, "SELECT COALESCE(MAX(" + std::string(kIdColumns[i]) + "), 0) FROM " + table);
+        if (maxId < 0) return 1;
+        for (size_t shard = 0; shard < shards->size(); ++shard) {
+            if (!execute(*shards->at(shard), "ALTER TABLE " + table + " AUTO_INCREMENT = " + std::to_string(maxId + 1))) {
+                return 1;
+            }
+        }
+    }
+    std::cout << "导入完成；确认分片数据无误后可清空主库中的这些表" << std::endl;
+    return 0;
+}
+
+int runAddShard(const std::string& mapPath, const std::vector<std::string>& args, const ConnectionPool& main) {
+    ShardMap map;
+    ShardLocation location;
+    if (args.size() != 1 || !ShardLocation::parse(args[0], location)) {
+        std::cerr << "错误: add-shard 需要一个分片地址 <主机[:端口]/数据库>" << std::endl;
+        return 1;
+    }
+    if (!loadMap(mapPath, map)) return 1;
+    if (map.size() >= ShardMap::kMaxShards) {
+        std::cerr << "错误: 分片数已达上限 " << ShardMap::kMaxShards << std::endl;
+        return 1;
+    }
+
+    size_t shard = map.addShard(location);
+    auto shards = ShardSet::connect(map, main);
+    if (!createShardTables(*shards)) return 1;
+    if (!map.save(mapPath)) {
+        std::cerr << "错误: 无法写入映射文件: " << mapPath << std::endl;
+        return 1;
+    }
+    std::cout << "已添加分片 " << shard << " (" << location.toString() << ")，运行rebalance为其分配桶" << std::endl;
+    return 0;
+}
+
+int runRebalance(const std::string& mapPath, const ConnectionPool& main) {
+    ShardMap map;
+    if (!loadMap(mapPath, map)) return 1;
+    auto shards = ShardSet::connect(map, main);
+
+    // 只移动超出平均数的桶，其余患者留在原分片
+    size_t count = map.size();
+    std::vector<std::vector<int>> owned(count);
+    for (int bucket = 0; bucket < ShardMap::kBuckets; ++bucket) {
+        owned[map.shardOfBucket(bucket)].push_back(bucket);
+    }
+    std::vector<std::pair<int, size_t>> surplus;  // (桶, 原分片)
+    for (size_t shard = 0; shard < count; ++shard) {
+        size_t target = ShardMap::kBuckets / count + (shard < ShardMap::kBuckets % count ? 1 : 0);
+        while (owned[shard].size() > target) {
+            surplus.emplace_back(owned[shard].back(), shard);
+            owned[shard].pop_back();
+        }
+    }
+    std::map<std::pair<size_t, size_t>, std::vector<int>> moves;  // (原分片, 新分片) -> 桶
+    for (size_t shard = 0; shard < count; ++shard) {
+        size_t target = ShardMap::kBuckets / count + (shard < ShardMap::kBuckets % count ? 1 : 0);
+        while (owned[shard].size() < target && !surplus.empty()) {
+            moves[{surplus.back().second, shard}].push_back(surplus.back().first);
+            owned[shard].push_back(surplus.back().first);
+            surplus.pop_back();
+        }
+    }
+    if (moves.empty()) {
+        std::cout << "桶已平均分配，无需迁移" << std::endl;
+        return 0;
+    }
+
+    // 先复制，映射文件写入后才删除原分片上的行；中途失败时旧映射仍然完整可用
+    for (const auto& move : moves) {
+        std::cout << "迁移 " << move.second.size() << " 个桶: 分片 " << move.first.first
+                  << " -> 分片 " << move.first.second << std::endl;
+        if (!copyBuckets(*shards->at(move.first.first), *shards->at(move.first.second), move.second)) return 1;
+        for (int bucket : move.second) {
+            map.assignBucket(bucket, move.first.second);
+        }
+    }
+    if (!map.save(mapPath)) {
+        std::cerr << "错误: 无法写入映射文件: " << mapPath << std::endl;
+        return 1;
+    }
+
+    // 删除病例时处方与药品随外键级联删除
+    for (const auto& move : moves) {
+        ConnectionPool& source = *shards->at(move.first.first);
+        for (const char* table : {"cases", "appointments", "hospitalization"}) {
+            if (!execute(source, std::string("DELETE FROM ") + table + " WHERE " + ownedRows(table, move.second))) {
+                std::cerr << "警告: 分片 " << move.first.first << " 上残留已迁移的行，可重新运行rebalance后手动清理" << std::endl;
+                return 1;
+            }
+        }
+    }
+    std::cout << "重新分配完成，重启服务以加载新的映射" << std::endl;
+    return 0;
+}
+
+int runStatus(const std::string& mapPath, const ConnectionPool& main) {
+    ShardMap map;
+    if (!loadMap(mapPath, map)) return 1;
+    auto shards = ShardSet::connect(map, main);
+
+    for (size_t shard = 0; shard < shards->size(); ++shard) {
+        std::cout << "分片 " << shard << " " << map.getShard(shard).toString()
+                  << " 桶: " << map.bucketsOf(shard).size() << std::endl;
+        for (const char* table : kShardedTables) {
+            long long rows = queryNumber(*shards->at(shard), std::string("SELECT COUNT(*) FROM ") + table);
+            std::cout << "  " << table << ": " << (rows < 0 ? std::string("不可用") : std::to_string(rows)) << std::endl;
+        }
+    }
+    return 0;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::string host = "localhost";
+    unsigned int port = 3306;
+    std::string username = "root";
+    std::string password = "";
+    std::string database = "hospital_db";
+
+    static struct option long_options[] = {
+        {"host",     required_argument, 0, 'h'},
+        {"port",     required_argument, 0, 'P'},
+        {"user",     required_argument, 0, 'u'},
+        {"password", required_argument, 0, 'p'},
+        {"database", required_argument, 0, 'd'},
+        {"help",     no_argument,       0, '?'},
+        {0, 0, 0, 0}
+    };
+
+    int option_index = 0;
+    int c;
+
+    while ((c = getopt_long(argc, argv, "h:P:u:p:d:?", long_options, &option_index)) != -1) {
+        switch (c) {
+            case 'h':
+                host = optarg;
+                break;
+            case 'P':
+                port = static_cast<unsigned int>(std::max(1, std::atoi(optarg)));
+                break;
+            case 'u':
+                username = optarg;
+                break;
+            case 'p':
+                password = optarg;
+                break;
+            case 'd':
+                database = optarg;
+                break;
+            case '?':
+            default:
+                printUsage(argv[0]);
+                return 0;
+        }
+    }
+
+    if (argc - optind < 2) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    std::string command = argv[optind];
+    std::string mapPath = argv[optind + 1];
+    std::vector<std::string> args(argv + optind + 2, argv + argc);
+
+    try {
+        // 工具逐表顺序执行，少量连接即可
+        ConnectionPool main(host, username, password, database, port, 2);
+
+        if (command == "init") return runInit(mapPath, args, main);
+        if (command == "import") return runImport(mapPath, main);
+        if (command == "add-shard") return runAddShard(mapPath, args, main);
+        if (command == "rebalance") return runRebalance(mapPath, main);
+        if (command == "status") return runStatus(mapPath, main);
+    } catch (const std::exception& e) {
+        std::cerr << "错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cerr << "错误: 未知命令: " << command << std::endl;
+    printUsage(argv[0]);
+    return 1;
+}
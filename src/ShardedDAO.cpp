@@ -0,0 +1,332 @@
+#include "ShardedDAO.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+template <typename T>
+using Rows = std::vector<std::unique_ptr<T>>;
+
+void reportShardMove(const char* table, int id) {
+    std::cerr << "Cannot move " << table << " row " << id << " to another shard" << std::endl;
+}
+
+// Keys of the ORDER BY clauses of the single-database queries
+auto byDiagnosisDate = [](const std::unique_ptr<Case>& row) { return row->getDiagnosisDate(); };
+auto byAppointmentTime = [](const std::unique_ptr<Appointment>& row) { return row->getAppointmentTime(); };
+auto byAdmissionDate = [](const std::unique_ptr<Hospitalization>& row) { return row->getAdmissionDate(); };
+auto byBedNumber = [](const std::unique_ptr<Hospitalization>& row) { return row->getBedNumber(); };
+auto byIssuedDate = [](const std::unique_ptr<Prescription>& row) { return row->getIssuedDate(); };
+auto byMedicationName = [](const std::unique_ptr<Medication>& row) { return row->getMedicationName(); };
+auto byQuantity = [](const std::unique_ptr<Medication>& row) { return row->getQuantity(); };
+
+}
+
+// ShardedCaseDAO
+ShardedCaseDAO::ShardedCaseDAO(std::shared_ptr<ShardSet> shards)
+    : CaseDAO(shards->at(0)), ShardedDAOBase<CaseDAO>(shards) {}
+
+bool ShardedCaseDAO::createCase(const Case& medicalCase) {
+    return forPatient(medicalCase.getPatientId()).createCase(medicalCase);
+}
+
+std::unique_ptr<Case> ShardedCaseDAO::getCaseById(int caseId) {
+    return findById(caseId, [caseId](CaseDAO& dao) { return dao.getCaseById(caseId); });
+}
+
+Rows<Case> ShardedCaseDAO::getCasesByPatientId(int patientId) {
+    return forPatient(patientId).getCasesByPatientId(patientId);
+}
+
+Rows<Case> ShardedCaseDAO::getCasesByDoctorId(int doctorId) {
+    return gather([doctorId](CaseDAO& dao) { return dao.getCasesByDoctorId(doctorId); }, byDiagnosisDate, true);
+}
+
+Rows<Case> ShardedCaseDAO::getCasesByDepartment(const std::string& department) {
+    return gather([&](CaseDAO& dao) { return dao.getCasesByDepartment(department); }, byDiagnosisDate, true);
+}
+
+Rows<Case> ShardedCaseDAO::getAllCases() {
+    return gather([](CaseDAO& dao) { return dao.getAllCases(); }, byDiagnosisDate, true);
+}
+
+bool ShardedCaseDAO::updateCase(const Case& medicalCase) {
+    CaseDAO* owner = locate("cases", "case_id", medicalCase.getCaseId());
+    if (!owner) return false;
+    if (owner != &forPatient(medicalCase.getPatientId())) {
+        reportShardMove("cases", medicalCase.getCaseId());
+        return false;
+    }
+    return owner->updateCase(medicalCase);
+}
+
+bool ShardedCaseDAO::deleteCase(int caseId) {
+    CaseDAO* owner = locate("cases", "case_id", caseId);
+    // Deleting a missing row succeeds on a single database too
+    return owner ? owner->deleteCase(caseId) : true;
+}
+
+Rows<Case> ShardedCaseDAO::searchCases(const std::string& searchTerm) {
+    return gather([&](CaseDAO& dao) { return dao.searchCases(searchTerm); }, byDiagnosisDate, true);
+}
+
+int ShardedCaseDAO::getCaseCount() {
+    return sum([](CaseDAO& dao) { return dao.getCaseCount(); });
+}
+
+int ShardedCaseDAO::getCaseCountByDoctor(int doctorId) {
+    return sum([doctorId](CaseDAO& dao) { return dao.getCaseCountByDoctor(doctorId); });
+}
+
+int ShardedCaseDAO::getCaseCountByPatient(int patientId) {
+    return forPatient(patientId).getCaseCountByPatient(patientId);
+}
+
+// ShardedAppointmentDAO
+ShardedAppointmentDAO::ShardedAppointmentDAO(std::shared_ptr<ShardSet> shards)
+    : AppointmentDAO(shards->at(0)), ShardedDAOBase<AppointmentDAO>(shards) {}
+
+bool ShardedAppointmentDAO::createAppointment(const Appointment& appointment) {
+    return forPatient(appointment.getPatientId()).createAppointment(appointment);
+}
+
+std::unique_ptr<Appointment> ShardedAppointmentDAO::getAppointmentById(int appointmentId) {
+    return findById(appointmentId, [appointmentId](AppointmentDAO& dao) { return dao.getAppointmentById(appointmentId); });
+}
+
+Rows<Appointment> ShardedAppointmentDAO::getAppointmentsByPatientId(int patientId) {
+    return forPatient(patientId).getAppointmentsByPatientId(patientId);
+}
+
+Rows<Appointment> ShardedAppointmentDAO::getAppointmentsByDoctorId(int doctorId) {
+    return gather([doctorId](AppointmentDAO& dao) { return dao.getAppointmentsByDoctorId(doctorId); },
+                  byAppointmentTime, true);
+}
+
+Rows<Appointment> ShardedAppointmentDAO::getAppointmentsByDepartment(const std::string& department) {
+    return gather([&](AppointmentDAO& dao) { return dao.getAppointmentsByDepartment(department); },
+                  byAppointmentTime, true);
+}
+
+Rows<Appointment> ShardedAppointmentDAO::getAppointmentsByStatus(AppointmentStatus status) {
+    return gather([status](AppointmentDAO& dao) { return dao.getAppointmentsByStatus(status); },
+                  byAppointmentTime, true);
+}
+
+Rows<Appointment> ShardedAppointmentDAO::getAllAppointments() {
+    return gather([](AppointmentDAO& dao) { return dao.getAllAppointments(); }, byAppointmentTime, true);
+}
+
+bool ShardedAppointmentDAO::updateAppointment(const Appointment& appointment) {
+    AppointmentDAO* owner = locate("appointments", "appointment_id", appointment.getAppointmentId());
+    if (!owner) return false;
+    if (owner != &forPatient(appointment.getPatientId())) {
+        reportShardMove("appointments", appointment.getAppointmentId());
+        return false;
+    }
+    return owner->updateAppointment(appointment);
+}
+
+bool ShardedAppointmentDAO::updateAppointmentStatus(int appointmentId, AppointmentStatus status) {
+    AppointmentDAO* owner = locate("appointments", "appointment_id", appointmentId);
+    return owner ? owner->updateAppointmentStatus(appointmentId, status) : true;
+}
+
+bool ShardedAppointmentDAO::deleteAppointment(int appointmentId) {
+    AppointmentDAO* owner = locate("appointments", "appointment_id", appointmentId);
+    return owner ? owner->deleteAppointment(appointmentId) : true;
+}
+
+Rows<Appointment> ShardedAppointmentDAO::searchAppointments(const std::string& searchTerm) {
+    return gather([&](AppointmentDAO& dao) { return dao.searchAppointments(searchTerm); }, byAppointmentTime, true);
+}
+
+int ShardedAppointmentDAO::getAppointmentCount() {
+    return sum([](AppointmentDAO& dao) { return dao.getAppointmentCount(); });
+}
+
+int ShardedAppointmentDAO::getAppointmentCountByStatus(AppointmentStatus status) {
+    return sum([status](AppointmentDAO& dao) { return dao.getAppointmentCountByStatus(status); });
+}
+
+int ShardedAppointmentDAO::getAppointmentCountByDoctor(int doctorId) {
+    return sum([doctorId](AppointmentDAO& dao) { return dao.getAppointmentCountByDoctor(doctorId); });
+}
+
+// ShardedHospitalizationDAO
+ShardedHospitalizationDAO::ShardedHospitalizationDAO(std::shared_ptr<ShardSet> shards)
+    : HospitalizationDAO(shards->at(0)), ShardedDAOBase<HospitalizationDAO>(shards) {}
+
+bool ShardedHospitalizationDAO::createHospitalization(const Hospitalization& hospitalization) {
+    return forPatient(hospitalization.getPatientId()).createHospitalization(hospitalization);
+}
+
+std::unique_ptr<Hospitalization> ShardedHospitalizationDAO::getHospitalizationById(int hospitalizationId) {
+    return findById(hospitalizationId, [hospitalizationId](HospitalizationDAO& dao) {
+        return dao.getHospitalizationById(hospitalizationId);
+    });
+}
+
+Rows<Hospitalization> ShardedHospitalizationDAO::getHospitalizationsByPatientId(int patientId) {
+    return forPatient(patientId).getHospitalizationsByPatientId(patientId);
+}
+
+Rows<Hospitalization> ShardedHospitalizationDAO::getHospitalizationsByWard(const std::string& wardNumber) {
+    return gather([&](HospitalizationDAO& dao) { return dao.getHospitalizationsByWard(wardNumber); },
+                  byBedNumber, false);
+}
+
+Rows<Hospitalization> ShardedHospitalizationDAO::getAllHospitalizations() {
+    return gather([](HospitalizationDAO& dao) { return dao.getAllHospitalizations(); }, byAdmissionDate, true);
+}
+
+bool ShardedHospitalizationDAO::updateHospitalization(const Hospitalization& hospitalization) {
+    HospitalizationDAO* owner = locate("hospitalization", "hospitalization_id", hospitalization.getHospitalizationId());
+    if (!owner) return false;
+    if (owner != &forPatient(hospitalization.getPatientId())) {
+        reportShardMove("hospitalization", hospitalization.getHospitalizationId());
+        return false;
+    }
+    return owner->updateHospitalization(hospitalization);
+}
+
+bool ShardedHospitalizationDAO::deleteHospitalization(int hospitalizationId) {
+    HospitalizationDAO* owner = locate("hospitalization", "hospitalization_id", hospitalizationId);
+    return owner ? owner->deleteHospitalization(hospitalizationId) : true;
+}
+
+bool ShardedHospitalizationDAO::isBedOccupied(const std::string& wardNumber, const std::string& bedNumber) {
+    for (bool occupied : scatter([&](HospitalizationDAO& dao) { return dao.isBedOccupied(wardNumber, bedNumber); })) {
+        if (occupied) return true;
+    }
+    return false;
+}
+
+std::vector<std::string> ShardedHospitalizationDAO::getAllWards() {
+    std::vector<std::string> wards;
+    for (auto& part : scatter([](HospitalizationDAO& dao) { return dao.getAllWards(); })) {
+        wards.insert(wards.end(), part.begin(), part.end());
+    }
+    std::sort(wards.begin(), wards.end());
+    wards.erase(std::unique(wards.begin(), wards.end()), wards.end());
+    return wards;
+}
+
+Rows<Hospitalization> ShardedHospitalizationDAO::searchHospitalizations(const std::string& searchTerm) {
+    return gather([&](HospitalizationDAO& dao) { return dao.searchHospitalizations(searchTerm); },
+                  byAdmissionDate, true);
+}
+
+int ShardedHospitalizationDAO::getHospitalizationCount() {
+    return sum([](HospitalizationDAO& dao) { return dao.getHospitalizationCount(); });
+}
+
+// ShardedPrescriptionDAO
+ShardedPrescriptionDAO::ShardedPrescriptionDAO(std::shared_ptr<ShardSet> shards)
+    : PrescriptionDAO(shards->at(0)), ShardedDAOBase<PrescriptionDAO>(shards) {}
+
+bool ShardedPrescriptionDAO::createPrescription(const Prescription& prescription) {
+    // A missing case fails like the foreign key would
+    PrescriptionDAO* owner = locate("cases", "case_id", prescription.getCaseId());
+    return owner && owner->createPrescription(prescription);
+}
+
+std::unique_ptr<Prescription> ShardedPrescriptionDAO::getPrescriptionById(int prescriptionId) {
+    return findById(prescriptionId, [prescriptionId](PrescriptionDAO& dao) {
+        return dao.getPrescriptionById(prescriptionId);
+    });
+}
+
+Rows<Prescription> ShardedPrescriptionDAO::getPrescriptionsByCaseId(int caseId) {
+    PrescriptionDAO* owner = locate("cases", "case_id", caseId);
+    return owner ? owner->getPrescriptionsByCaseId(caseId) : Rows<Prescription>();
+}
+
+Rows<Prescription> ShardedPrescriptionDAO::getPrescriptionsByDoctorId(int doctorId) {
+    return gather([doctorId](PrescriptionDAO& dao) { return dao.getPrescriptionsByDoctorId(doctorId); },
+                  byIssuedDate, true);
+}
+
+Rows<Prescription> ShardedPrescriptionDAO::getAllPrescriptions() {
+    return gather([](PrescriptionDAO& dao) { return dao.getAllPrescriptions(); }, byIssuedDate, true);
+}
+
+bool ShardedPrescriptionDAO::updatePrescription(const Prescription& prescription) {
+    PrescriptionDAO* owner = locate("prescriptions", "prescription_id", prescription.getPrescriptionId());
+    if (!owner) return false;
+    if (owner != locate("cases", "case_id", prescription.getCaseId())) {
+        reportShardMove("prescriptions", prescription.getPrescriptionId());
+        return false;
+    }
+    return owner->updatePrescription(prescription);
+}
+
+bool ShardedPrescriptionDAO::deletePrescription(int prescriptionId) {
+    PrescriptionDAO* owner = locate("prescriptions", "prescription_id", prescriptionId);
+    return owner ? owner->deletePrescription(prescriptionId) : true;
+}
+
+Rows<Prescription> ShardedPrescriptionDAO::searchPrescriptions(const std::string& searchTerm) {
+    return gather([&](PrescriptionDAO& dao) { return dao.searchPrescriptions(searchTerm); }, byIssuedDate, true);
+}
+
+int ShardedPrescriptionDAO::getPrescriptionCount() {
+    return sum([](PrescriptionDAO& dao) { return dao.getPrescriptionCount(); });
+}
+
+int ShardedPrescriptionDAO::getPrescriptionCountByDoctor(int doctorId) {
+    return sum([doctorId](PrescriptionDAO& dao) { return dao.getPrescriptionCountByDoctor(doctorId); });
+}
+
+// ShardedMedicationDAO
+ShardedMedicationDAO::ShardedMedicationDAO(std::shared_ptr<ShardSet> shards)
+    : MedicationDAO(shards->at(0)), ShardedDAOBase<MedicationDAO>(shards) {}
+
+bool ShardedMedicationDAO::createMedication(const Medication& medication) {
+    MedicationDAO* owner = locate("prescriptions", "prescription_id", medication.getPrescriptionId());
+    return owner && owner->createMedication(medication);
+}
+
+std::unique_ptr<Medication> ShardedMedicationDAO::getMedicationById(int medicationId) {
+    return findById(medicationId, [medicationId](MedicationDAO& dao) { return dao.getMedicationById(medicationId); });
+}
+
+Rows<Medication> ShardedMedicationDAO::getMedicationsByPrescriptionId(int prescriptionId) {
+    MedicationDAO* owner = locate("prescriptions", "prescription_id", prescriptionId);
+    return owner ? owner->getMedicationsByPrescriptionId(prescriptionId) : Rows<Medication>();
+}
+
+Rows<Medication> ShardedMedicationDAO::getAllMedications() {
+    return gather([](MedicationDAO& dao) { return dao.getAllMedications(); }, byMedicationName, false);
+}
+
+bool ShardedMedicationDAO::updateMedication(const Medication& medication) {
+    MedicationDAO* owner = locate("medications", "medication_id", medication.getMedicationId());
+    if (!owner) return false;
+    if (owner != locate("prescriptions", "prescription_id", medication.getPrescriptionId())) {
+        reportShardMove("medications", medication.getMedicationId());
+        return false;
+    }
+    return owner->updateMedication(medication);
+}
+
+bool ShardedMedicationDAO::deleteMedication(int medicationId) {
+    MedicationDAO* owner = locate("medications", "medication_id", medicationId);
+    return owner ? owner->deleteMedication(medicationId) : true;
+}
+
+Rows<Medication> ShardedMedicationDAO::searchMedications(const std::string& searchTerm) {
+    return gather([&](MedicationDAO& dao) { return dao.searchMedications(searchTerm); }, byMedicationName, false);
+}
+
+Rows<Medication> ShardedMedicationDAO::getMedicationsByName(const std::string& medicationName) {
+    return gather([&](MedicationDAO& dao) { return dao.getMedicationsByName(medicationName); }, byQuantity, true);
+}
+
+int ShardedMedicationDAO::getMedicationCount() {
+    return sum([](MedicationDAO& dao) { return dao.getMedicationCount(); });
+}
+
+int ShardedMedicationDAO::getTotalQuantityByName(const std::string& medicationName) {
+    return sum([&](MedicationDAO& dao) { return dao.getTotalQuantityByName(medicationName); });
+}
@@ -0,0 +1,171 @@
+#include "SlowQueryLog.h"
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <cxxabi.h>
+#include <dlfcn.h>
+
+#if __has_include(<nlohmann/json.hpp>)
+    #include <nlohmann/json.hpp>
+#elif __has_include(<json/json.hpp>)
+    #include <json/json.hpp>
+#else
+    #error "nlohmann/json library not found. Please install nlohmann-json3-dev package."
+#endif
+
+namespace {
+
+// Plans are captured for this many distinct statements, then no more
+const size_t kMaxExplained = 10000;
+
+bool isIdentifierChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$';
+}
+
+std::string timestamp() {
+    auto now = std::chrono::system_clock::now();
+    std::time_t seconds = std::chrono::system_clock::to_time_t(now);
+    auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000;
+    std::tm local;
+    localtime_r(&seconds, &local);
+    char buffer[32];
+    size_t length = std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", &local);
+    std::snprintf(buffer + length, sizeof(buffer) - length, ".%03d", static_cast<int>(millis));
+    return buffer;
+}
+
+}
+
+SlowQueryLog::SlowQueryLog(const Config& config) : config(config) {
+    out.open(config.path, std::ios::app);
+    if (out.is_open()) {
+        out.seekp(0, std::ios::end);
+        written = static_cast<size_t>(out.tellp());
+    }
+}
+
+std::shared_ptr<SlowQueryLog> SlowQueryLog::open(const Config& config, std::string& error) {
+    auto log = std::make_shared<SlowQueryLog>(config);
+    if (!log->out.is_open()) {
+        error = "cannot open " + config.path;
+        return nullptr;
+    }
+    return log;
+}
+
+bool SlowQueryLog::claimExplain(const std::string& normalized) {
+    if (!config.explain) return false;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (explained.size() >= kMaxExplained) return false;
+    return explained.insert(normalized).second;
+}
+
+void SlowQueryLog::record(const Entry& entry) {
+    nlohmann::json line;
+    line["time"] = timestamp();
+    line["durationMs"] = entry.duration.count() / 1000.0;
+    line["rows"] = entry.rows;
+    line["caller"] = entry.caller;
+    line["statement"] = entry.statement;
+    if (entry.error) line["error"] = entry.error;
+    if (!entry.plan.empty()) {
+        nlohmann::json plan = nlohmann::json::parse(entry.plan, nullptr, false);
+        line["plan"] = plan.is_discarded() ? nlohmann::json(entry.plan) : std::move(plan);
+    }
+    std::string text = line.dump() + "\n";
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (written > 0 && written + text.size() > config.maxBytes) {
+        rotate();
+    }
+    out << text;
+    out.flush();
+    written += text.size();
+    recorded.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SlowQueryLog::rotate() {
+    out.close();
+    if (config.maxFiles > 0) {
+        for (size_t index = config.maxFiles - 1; index >= 1; --index) {
+            std::string from = config.path + "." + std::to_string(index);
+            std::string to = config.path + "." + std::to_string(index + 1);
+            std::rename(from.c_str(), to.c_str());
+        }
+        std::rename(config.path.c_str(), (config.path + ".1").c_str());
+    }
+    out.open(config.path, std::ios::trunc);
+    written = 0;
+}
+
+std::string SlowQueryLog::normalize(const std::string& statement) {
+    std::string normalized;
+    normalized.reserve(statement.size());
+    size_t i = 0;
+    while (i < statement.size()) {
+        char c = statement[i];
+        if (c == '\'' || c == '"') {
+            // Quoted literal, with backslash escapes and doubled quotes
+            ++i;
+            while (i < statement.size()) {
+                if (statement[i] == '\\') {
+                    i += 2;
+                } else if (statement[i] == c) {
+                    if (i + 1 < statement.size() && statement[i + 1] == c) {
+                        i += 2;
+                    } else {
+                        ++i;
+                        break;
+                    }
+                } else {
+                    ++i;
+                }
+            }
+            normalized += '?';
+        } else if (std::isdigit(static_cast<unsigned char>(c)) && (normalized.empty() || !isIdentifierChar(normalized.back()))) {
+            // Number, including decimals, exponents and hex
+            while (i < statement.size() && (isIdentifierChar(statement[i]) || statement[i] == '.')) ++i;
+            normalized += '?';
+        } else if (std::isspace(static_cast<unsigned char>(c))) {
+            if (!normalized.empty() && normalized.back() != ' ') normalized += ' ';
+            ++i;
+        } else {
+            normalized += c;
+            ++i;
+        }
+    }
+    while (!normalized.empty() && (normalized.back() == ' ' || normalized.back() == ';')) normalized.pop_back();
+
+    // IN lists of any length share one shape
+    std::string collapsed;
+    collapsed.reserve(normalized.size());
+    for (size_t pos = 0; pos < normalized.size(); ++pos) {
+        collapsed += normalized[pos];
+        if (normalized[pos] != '?') continue;
+        bool repeated = false;
+        while (true) {
+            size_t next = pos + 1;
+            if (next < normalized.size() && normalized[next] == ' ') ++next;
+            if (next >= normalized.size() || normalized[next] != ',') break;
+            ++next;
+            if (next < normalized.size() && normalized[next] == ' ') ++next;
+            if (next >= normalized.size() || normalized[next] != '?') break;
+            pos = next;
+            repeated = true;
+        }
+        if (repeated) collapsed += '+';
+    }
+    return collapsed;
+}
+
+std::string SlowQueryLog::describeCaller(const void* address) {
+    Dl_info info;
+    if (!address || !dladdr(address, &info) || !info.dli_sname) return "";
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+    std::string name = status == 0 && demangled ? demangled : info.dli_sname;
+    std::free(demangled);
+    // "CaseDAO::getCasesByPatientId" also for lambdas inside it
+    return name.substr(0, name.find('('));
+}
@@ -0,0 +1,115 @@
+#include "ThreadPool.h"
+
+namespace {
+// 当前线程所属的线程池及其工作线程下标
+thread_local const ThreadPool* currentPool = nullptr;
+thread_local size_t currentIndex = 0;
+}
+
+ThreadPool::ThreadPool(size_t workerCount) : workerCount(workerCount == 0 ? 1 : workerCount) {
+    localQueues.reserve(this->workerCount);
+    for (size_t i = 0; i < this->workerCount; ++i) {
+        localQueues.push_back(std::make_unique<WorkerQueue>());
+    }
+    workers.reserve(this->workerCount);
+    for (size_t i = 0; i < this->workerCount; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    shutdown();
+}
+
+bool ThreadPool::isWorkerThread() const {
+    return currentPool == this;
+}
+
+bool ThreadPool::submit(std::function<void()> task) {
+    // 先计数再检查关闭标志：计数非零时工作线程不会退出，已接受的任务一定会被执行
+    pendingTasks.fetch_add(1);
+    if (stopping.load()) {
+        pendingTasks.fetch_sub(1);
+        return false;
+    }
+
+    WorkerQueue& queue = isWorkerThread() ? *localQueues[currentIndex] : injectQueue;
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+
+    // 工作线程在sleepMutex下登记空闲后才检查计数，这里看不到空闲线程时对方必然能看到新任务
+    if (idleWorkers.load() > 0) {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        sleepCondition.notify_one();
+    }
+    return true;
+}
+
+void ThreadPool::shutdown() {
+    std::lock_guard<std::mutex> shutdownLock(shutdownMutex);
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        if (stopping.load() && workers.empty()) return;
+        stopping.store(true);
+    }
+    sleepCondition.notify_all();
+    for (auto& worker : workers) {
+        if (worker.joinable()) worker.join();
+    }
+    workers.clear();
+}
+
+bool ThreadPool::popBack(WorkerQueue& queue, std::function<void()>& task) {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) return false;
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::popFront(WorkerQueue& queue, std::function<void()>& task) {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) return false;
+    task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    return true;
+}
+
+bool ThreadPool::takeTask(size_t index, std::function<void()>& task) {
+    // 优先处理自己最近产生的子任务，其次是外部请求，最后从其他线程窃取最早的任务
+    if (popBack(*localQueues[index], task)) return true;
+    if (popFront(injectQueue, task)) return true;
+    for (size_t offset = 1; offset < workerCount; ++offset) {
+        if (popFront(*localQueues[(index + offset) % workerCount], task)) return true;
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    currentPool = this;
+    currentIndex = index;
+
+    for (;;) {
+        std::function<void()> task;
+        if (takeTask(index, task)) {
+            pendingTasks.fetch_sub(1);
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        if (pendingTasks.load() > 0) {
+            // 任务已计数但提交方尚未入队，稍后重试
+            lock.unlock();
+            std::this_thread::yield();
+            continue;
+        }
+        if (stopping.load()) return;
+
+        idleWorkers.fetch_add(1);
+        sleepCondition.wait(lock, [this] { return stopping.load() || pendingTasks.load() > 0; });
+        idleWorkers.fetch_sub(1);
+    }
+}
@@ -0,0 +1,325 @@
+#include "UnixSocketServer.h"
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <map>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+struct UnixSocketServer::Connection {
+    int fd = -1;
+    std::atomic<bool> finished{false};
+
+    // 乱序完成的响应暂存，由连接的写线程按序号顺序写回；锁不跨越任何IO
+    std::mutex mutex;
+    std::condition_variable drained;  // 在途数减少
+    std::condition_variable ready;    // 有响应完成，或读线程已结束
+    uint64_t nextToWrite = 0;
+    size_t inFlight = 0;
+    bool writeFailed = false;
+    bool readerDone = false;
+    std::map<uint64_t, std::string> pending;
+};
+
+namespace {
+
+// 客户端停止读取超过该时长即视为写失败并断开，避免写线程与退出流程无限期阻塞
+const time_t kSendTimeoutSeconds = 30;
+
+// 文件描述符耗尽时暂停接受连接的时长；期间待接受的连接留在监听队列中，poll不会空转
+const int kAcceptBackoffMs = 100;
+
+bool readFully(int fd, char* buffer, size_t length) {
+    while (length > 0) {
+        ssize_t n = ::read(fd, buffer, length);
+        if (n > 0) {
+            buffer += n;
+            length -= static_cast<size_t>(n);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool writeFully(int fd, const char* buffer, size_t length) {
+    while (length > 0) {
+        ssize_t n = ::send(fd, buffer, length, MSG_NOSIGNAL);
+        if (n > 0) {
+            buffer += n;
+            length -= static_cast<size_t>(n);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool writeFrame(int fd, const std::string& payload) {
+    uint32_t length = static_cast<uint32_t>(payload.size());
+    unsigned char header[4] = {
+        static_cast<unsigned char>(length >> 24), static_cast<unsigned char>(length >> 16),
+        static_cast<unsigned char>(length >> 8), static_cast<unsigned char>(length)
+    };
+    return writeFully(fd, reinterpret_cast<const char*>(header), sizeof(header)) &&
+           writeFully(fd, payload.data(), payload.size());
+}
+
+} // namespace
+
+UnixSocketServer::UnixSocketServer(const std::string& socketPath, RequestProcessor processor, size_t workerCount,
+                                   uint32_t maxFrameSize, size_t maxInFlightPerConnection, size_t maxConnections)
+    : socketPath(socketPath), processor(std::move(processor)), workerPool(std::make_shared<ThreadPool>(workerCount)),
+      maxFrameSize(maxFrameSize), maxInFlight(maxInFlightPerConnection == 0 ? 1 : maxInFlightPerConnection),
+      maxConnections(maxConnections == 0 ? 1 : maxConnections) {}
+
+UnixSocketServer::~UnixSocketServer() {
+    closeListener();
+    for (int& fd : wakePipe) {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+}
+
+bool UnixSocketServer::start() {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) {
+        lastError = "套接字路径为空或过长: " + socketPath;
+        return false;
+    }
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    // 清理上次异常退出遗留的套接字文件，但不抢占仍在服务的实例
+    struct stat info;
+    if (::lstat(socketPath.c_str(), &info) == 0) {
+        if (!S_ISSOCK(info.st_mode)) {
+            lastError = "路径已存在且不是套接字: " + socketPath;
+            return false;
+        }
+        int probe = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        bool inUse = probe >= 0 && ::connect(probe, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+        if (probe >= 0) ::close(probe);
+        if (inUse) {
+            lastError = "套接字已被其他实例使用: " + socketPath;
+            return false;
+        }
+        ::unlink(socketPath.c_str());
+    }
+
+    if (::pipe2(wakePipe, O_CLOEXEC | O_NONBLOCK) != 0) {
+        lastError = std::string("创建唤醒管道失败: ") + std::strerror(errno);
+        return false;
+    }
+
+    listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenFd < 0 ||
+        ::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listenFd, SOMAXCONN) != 0) {
+        lastError = std::string("监听套接字失败: ") + std::strerror(errno);
+        closeListener();
+        return false;
+    }
+    return true;
+}
+
+void UnixSocketServer::run() {
+    pollfd fds[2] = {{listenFd, POLLIN, 0}, {wakePipe[0], POLLIN, 0}};
+
+    while (listenFd >= 0) {
+        int ready = ::poll(fds, 2, -1);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            lastError = std::string("poll失败: ") + std::strerror(errno);
+            break;
+        }
+        if (fds[1].revents & POLLIN) break;
+        if (!(fds[0].revents & POLLIN)) continue;
+
+        int clientFd = ::accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (clientFd < 0) {
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                // 连接仍在监听队列中，立即重试只会让poll空转；只等待退出通知，超时后再接受
+                reapFinishedConnections();
+                ::poll(&fds[1], 1, kAcceptBackoffMs);
+                if (fds[1].revents & POLLIN) break;
+            }
+            continue;
+        }
+
+        reapFinishedConnections();
+        {
+            std::lock_guard<std::mutex> lock(connectionsMutex);
+            if (connections.size() >= maxConnections) {
+                ::close(clientFd);
+                rejectedConnections.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+        }
+        timeval sendTimeout = {kSendTimeoutSeconds, 0};
+        ::setsockopt(clientFd, SOL_SOCKET, SO_SNDTIMEO, &sendTimeout, sizeof(sendTimeout));
+        totalConnections.fetch_add(1, std::memory_order_relaxed);
+
+        auto connection = std::make_shared<Connection>();
+        connection->fd = clientFd;
+        std::lock_guard<std::mutex> lock(connectionsMutex);
+        connections.push_back({connection, std::thread(&UnixSocketServer::serveConnection, this, connection)});
+    }
+
+    // 优雅退出：不再接受新连接；关闭各连接的读方向，读线程在已接收请求写回后退出
+    closeListener();
+    std::vector<ConnectionSlot> remaining;
+    {
+        std::lock_guard<std::mutex> lock(connectionsMutex);
+        for (auto& slot : connections) {
+            if (slot.connection->fd >= 0) {
+                ::shutdown(slot.connection->fd, SHUT_RD);
+            }
+        }
+        remaining.swap(connections);
+    }
+    for (auto& slot : remaining) {
+        if (slot.reader.joinable()) slot.reader.join();
+    }
+    workerPool->shutdown();
+}
+
+void UnixSocketServer::requestStop() {
+    // 仅写管道，满足异步信号安全
+    if (wakePipe[1] >= 0) {
+        char byte = 1;
+        ssize_t ignored = ::write(wakePipe[1], &byte, 1);
+        (void)ignored;
+    }
+}
+
+UnixSocketServer::Stats UnixSocketServer::getStats() const {
+    Stats stats;
+    stats.connections = totalConnections.load(std::memory_order_relaxed);
+    stats.requests = totalRequests.load(std::memory_order_relaxed);
+    stats.rejectedFrames = rejectedFrames.load(std::memory_order_relaxed);
+    stats.rejectedConnections = rejectedConnections.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void UnixSocketServer::serveConnection(std::shared_ptr<Connection> connection) {
+    uint64_t sequence = 0;
+    std::thread writer(&UnixSocketServer::writeResponses, this, connection);
+
+    for (;;) {
+        unsigned char header[4];
+        if (!readFully(connection->fd, reinterpret_cast<char*>(header), sizeof(header))) break;
+        uint32_t length = (static_cast<uint32_t>(header[0]) << 24) | (static_cast<uint32_t>(header[1]) << 16) |
+                          (static_cast<uint32_t>(header[2]) << 8) | static_cast<uint32_t>(header[3]);
+        if (length > maxFrameSize) {
+            // 超长帧无法重新同步，直接断开连接
+            rejectedFrames.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+
+        std::string request(length, '\0');
+        if (length > 0 && !readFully(connection->fd, &request[0], length)) break;
+
+        {
+            // 限制单连接在途请求数，客户端写得比处理快时由套接字缓冲区施加背压
+            std::unique_lock<std::mutex> lock(connection->mutex);
+            connection->drained.wait(lock, [&] { return connection->inFlight < maxInFlight || connection->writeFailed; });
+            if (connection->writeFailed) break;
+            ++connection->inFlight;
+        }
+
+        totalRequests.fetch_add(1, std::memory_order_relaxed);
+        uint64_t current = sequence++;
+        bool accepted = workerPool->submit([this, connection, current, request = std::move(request)]() {
+            std::string response;
+            processor(request, response);
+            completeRequest(connection, current, std::move(response));
+        });
+        if (!accepted) {
+            std::lock_guard<std::mutex> lock(connection->mutex);
+            --connection->inFlight;
+            break;
+        }
+    }
+
+    // 写线程在本连接已接收的请求全部写回（或写失败后丢弃）后退出，随后关闭
+    {
+        std::lock_guard<std::mutex> lock(connection->mutex);
+        connection->readerDone = true;
+        connection->ready.notify_all();
+    }
+    writer.join();
+    {
+        std::lock_guard<std::mutex> lock(connectionsMutex);
+        ::close(connection->fd);
+        connection->fd = -1;
+    }
+    connection->finished.store(true, std::memory_order_release);
+}
+
+void UnixSocketServer::completeRequest(const std::shared_ptr<Connection>& connection, uint64_t sequence,
+                                       std::string response) {
+    // 工作线程只入队不写套接字：不读取响应的客户端不会占住共享的工作线程
+    std::lock_guard<std::mutex> lock(connection->mutex);
+    connection->pending.emplace(sequence, std::move(response));
+    if (sequence == connection->nextToWrite) connection->ready.notify_one();
+}
+
+void UnixSocketServer::writeResponses(std::shared_ptr<Connection> connection) {
+    std::unique_lock<std::mutex> lock(connection->mutex);
+    for (;;) {
+        connection->ready.wait(lock, [&] {
+            return connection->pending.count(connection->nextToWrite) ||
+                   (connection->readerDone && connection->inFlight == 0);
+        });
+        auto it = connection->pending.find(connection->nextToWrite);
+        if (it == connection->pending.end()) break;
+
+        // 写失败后仍按序消化在途计数，读线程据此退出
+        std::string response = std::move(it->second);
+        connection->pending.erase(it);
+        bool failed = connection->writeFailed;
+        lock.unlock();
+        bool written = !failed && writeFrame(connection->fd, response);
+        lock.lock();
+        if (!written && !connection->writeFailed) {
+            connection->writeFailed = true;
+            ::shutdown(connection->fd, SHUT_RD);
+        }
+        ++connection->nextToWrite;
+        --connection->inFlight;
+        connection->drained.notify_all();
+    }
+}
+
+void UnixSocketServer::reapFinishedConnections() {
+    std::lock_guard<std::mutex> lock(connectionsMutex);
+    for (auto it = connections.begin(); it != connections.end();) {
+        if (it->connection->finished.load(std::memory_order_acquire)) {
+            it->reader.join();
+            it = connections.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void UnixSocketServer::closeListener() {
+    if (listenFd >= 0) {
+        ::close(listenFd);
+        listenFd = -1;
+        ::unlink(socketPath.c_str());
+    }
+}
@@ -1,15 +1,14 @@
 #include "User.h"
+#include "Sha256.h"
 #include <sstream>
 #include <iostream>
-#include <openssl/sha.h>
-#include <iomanip>
+#include <algorithm>
 
 // User class implementation
 User::User() : userId(0), userType(UserType::PATIENT), isActive(true) {}
 
 User::User(const std::string& username, const std::string& password, UserType userType)
     : userId(0), username(username), userType(userType), isActive(true) {
-    // Use the private hashPassword method from UserDAO class
     // For now, we'll set a placeholder - the actual hashing will be done in UserDAO
     this->passwordHash = password; // This will be properly hashed when stored via UserDAO
 }
@@ -34,12 +33,53 @@ bool User::validatePassword(const std::string& password) const {
 // UserDAO class implementation
 UserDAO::UserDAO(std::shared_ptr<ConnectionPool> pool) : connectionPool(pool) {}
 
+uint64_t UserDAO::loadExistenceFilter(uint64_t afterUserId) {
+    if (!existenceFilter) return afterUserId;
+    
+    auto conn = connectionPool->getConnection();
+    if (!conn) return afterUserId;
+    
+    std::stringstream query;
+    query << "SELECT user_id, username, email FROM users WHERE user_id > " << afterUserId;
+    
+    MYSQL_RES* result = conn->executeStreamingQuery(query.str());
+    if (!result) {
+        connectionPool->returnConnection(std::move(conn));
+        return afterUserId;
+    }
+    
+    uint64_t watermark = afterUserId;
+    MYSQL_ROW row;
+    while ((row = mysql_fetch_row(result))) {
+        unsigned long* lengths = mysql_fetch_lengths(result);
+        if (row[0]) watermark = std::max<uint64_t>(watermark, std::stoull(row[0]));
+        addToExistenceFilter(row[1] ? std::string(row[1], lengths[1]) : "",
+                             row[2] ? std::string(row[2], lengths[2]) : "");
+    }
+    
+    mysql_free_result(result);
+    connectionPool->returnConnection(std::move(conn));
+    return watermark;
+}
+
+void UserDAO::addToExistenceFilter(const std::string& username, const std::string& email) {
+    if (!existenceFilter) return;
+    
+    std::string key;
+    if (!username.empty() && BloomFilter::normalizeKey("u:", username, key)) {
+        existenceFilter->add(key);
+    }
+    if (!email.empty() && BloomFilter::normalizeKey("e:", email, key)) {
+        existenceFilter->add(key);
+    }
+}
+
 bool UserDAO::createUser(const User& user) {
     auto conn = connectionPool->getConnection();
     if (!conn) return false;
     
     // Hash the password before storing
-    std::string hashedPassword = hashPassword(user.getPasswordHash());
+    std::string hashedPassword = Sha256::hex(user.getPasswordHash());
     
     std::stringstream query;
     query << "INSERT INTO users (username, password, user_type, email, phone_number) VALUES ("
@@ -52,44 +92,63 @@ bool UserDAO::createUser(const User& user) {
     bool result = conn->executeUpdate(query.str());
     
     if (!result) {
+        // 过滤器漏掉了已存在的用户（其他进程或直接SQL写入），补上以免再次误判
+        if (conn->isDuplicateKeyError()) {
+            addToExistenceFilter(user.getUsername(), user.getEmail());
+        }
         connectionPool->returnConnection(std::move(conn));
         return false;
     }
     
+    addToExistenceFilter(user.getUsername(), user.getEmail());
+    
     // 不要立即归还连接，让调用者获取last_insert_id
     connectionPool->returnConnection(std::move(conn));
     return true;
 }
 
 std::unique_ptr<User> UserDAO::getUserById(int userId) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     if (!conn) return nullptr;
     
-    std::stringstream query;
-    query << "SELECT user_id, username, password, user_type, email, phone_number, created_at "
-          << "FROM users WHERE user_id = " << userId;
-    
-    MYSQL_RES* result = conn->executeQuery(query.str());
+    MYSQL_RES* result = conn->executeQuery(getUserByIdQuery(userId));
     if (!result) {
         connectionPool->returnConnection(std::move(conn));
         return nullptr;
     }
     
-    MYSQL_ROW row = mysql_fetch_row(result);
-    std::unique_ptr<User> user = nullptr;
-    
-    if (row) {
-        unsigned long* lengths = mysql_fetch_lengths(result);
-        user = std::unique_ptr<User>(mapRowToUser(row, lengths));
-    }
+    std::unique_ptr<User> user = readUser(result);
     
     mysql_free_result(result);
     connectionPool->returnConnection(std::move(conn));
     return user;
 }
 
+std::string UserDAO::getUserByIdQuery(int userId) {
+    std::stringstream query;
+    query << "SELECT user_id, username, password, user_type, email, phone_number, created_at "
+          << "FROM users WHERE user_id = " << userId;
+    return query.str();
+}
+
+// Maps the first row of a getUserByIdQuery() result; the caller frees the result
+std::unique_ptr<User> UserDAO::readUser(MYSQL_RES* result) {
+    MYSQL_ROW row = result ? mysql_fetch_row(result) : nullptr;
+    if (!row) return nullptr;
+    
+    unsigned long* lengths = mysql_fetch_lengths(result);
+    return std::unique_ptr<User>(mapRowToUser(row, lengths));
+}
+
+std::future<std::unique_ptr<User>> UserDAO::getUserByIdAsync(AsyncQueryExecutor& executor, int userId) {
+    return executor.fetch<std::unique_ptr<User>>(getUserByIdQuery(userId),
+                                                 [this](MYSQL_RES* result) { return readUser(result); });
+}
+
+// 账号查找服务于登录与token校验，读主库：匿名请求（注册、重置密码）的写入不会让
+// 随后的登录粘在主库上，副本延迟期间会查不到新账号或读到旧密码哈希
 std::unique_ptr<User> UserDAO::getUserByUsername(const std::string& username) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getPrimaryReadConnection();
     if (!conn) return nullptr;
     
     std::stringstream query;
@@ -116,7 +175,7 @@ std::unique_ptr<User> UserDAO::getUserByUsername(const std::string& username) {
 }
 
 std::unique_ptr<User> UserDAO::getUserByEmail(const std::string& email) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getPrimaryReadConnection();
     if (!conn) return nullptr;
     
     std::stringstream query;
@@ -142,8 +201,9 @@ std::unique_ptr<User> UserDAO::getUserByEmail(const std::string& email) {
     return user;
 }
 
+// 同样读主库：validateToken按它匹配刚签发的token
 std::vector<std::unique_ptr<User>> UserDAO::getAllUsers() {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getPrimaryReadConnection();
     std::vector<std::unique_ptr<User>> users;
     if (!conn) return users;
     
@@ -168,7 +228,7 @@ std::vector<std::unique_ptr<User>> UserDAO::getAllUsers() {
 }
 
 std::vector<std::unique_ptr<User>> UserDAO::getActiveUsers() {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<User>> users;
     if (!conn) return users;
     
@@ -205,6 +265,9 @@ bool UserDAO::updateUser(const User& user) {
           << "WHERE user_id = " << user.getUserId();
     
     bool result = conn->executeUpdate(query.str());
+    if (result) {
+        addToExistenceFilter(user.getUsername(), user.getEmail());
+    }
     connectionPool->returnConnection(std::move(conn));
     return result;
 }
@@ -262,7 +325,7 @@ bool UserDAO::changePassword(int userId, const std::string& oldPassword, const s
     auto conn = connectionPool->getConnection();
     if (!conn) return false;
     
-    std::string hashedNewPassword = hashPassword(newPassword);
+    std::string hashedNewPassword = Sha256::hex(newPassword);
     std::stringstream query;
     query << "UPDATE users SET password = '" << conn->escapeString(hashedNewPassword) 
           << "' WHERE user_id = " << userId;
@@ -276,7 +339,7 @@ bool UserDAO::resetPassword(int userId, const std::string& newPassword) {
     auto conn = connectionPool->getConnection();
     if (!conn) return false;
     
-    std::string hashedNewPassword = hashPassword(newPassword);
+    std::string hashedNewPassword = Sha256::hex(newPassword);
     std::stringstream query;
     query << "UPDATE users SET password = '" << conn->escapeString(hashedNewPassword) 
           << "' WHERE user_id = " << userId;
@@ -287,7 +350,7 @@ bool UserDAO::resetPassword(int userId, const std::string& newPassword) {
 }
 
 std::vector<std::unique_ptr<User>> UserDAO::searchUsers(const std::string& searchTerm) {
-    auto conn = connectionPool->getConnection();
+    auto conn = connectionPool->getReadConnection();
     std::vector<std::unique_ptr<User>> users;
     if (!conn) return users;
     
@@ -315,6 +378,20 @@ std::vector<std::unique_ptr<User>> UserDAO::searchUsers(const std::string& searc
 }
 
 bool UserDAO::userExists(const std::string& username, const std::string& email) {
+    // 过滤器判定"一定不存在"时直接返回，只有"可能存在"才查库。
+    // 该判定只是提示：本进程之外写入的行可能不在过滤器中，插入时仍以唯一约束为准
+    bool filtered = false;
+    if (existenceFilter) {
+        std::string key;
+        bool usernameMaybe = !BloomFilter::normalizeKey("u:", username, key) || existenceFilter->mightContain(key);
+        bool emailMaybe = !email.empty() &&
+            (!BloomFilter::normalizeKey("e:", email, key) || existenceFilter->mightContain(key));
+        if (!usernameMaybe && !emailMaybe) {
+            return false;
+        }
+        filtered = true;
+    }
+    
     auto conn = connectionPool->getConnection();
     if (!conn) return false;
     
@@ -336,6 +413,10 @@ bool UserDAO::userExists(const std::string& username, const std::string& email)
         exists = std::stoi(row[0]) > 0;
     }
     
+    if (filtered && !exists) {
+        existenceFilter->recordFalsePositive();
+    }
+    
     mysql_free_result(result);
     connectionPool->returnConnection(std::move(conn));
     return exists;
@@ -346,25 +427,9 @@ bool UserDAO::userExists(const std::string& username) {
 }
 
 int UserDAO::getUserCount() {
-    auto conn = connectionPool->getConnection();
-    if (!conn) return 0;
-    
-    std::string query = "SELECT COUNT(*) FROM users";
-    MYSQL_RES* result = conn->executeQuery(query);
-    if (!result) {
-        connectionPool->returnConnection(std::move(conn));
-        return 0;
-    }
-    
-    MYSQL_ROW row = mysql_fetch_row(result);
-    int count = 0;
-    if (row && row[0]) {
-        count = std::stoi(row[0]);
-    }
-    
-    mysql_free_result(result);
-    connectionPool->returnConnection(std::move(conn));
-    return count;
+    auto result = connectionPool->executeCachedQuery("SELECT COUNT(*) FROM users");
+    if (!result || result->rowCount() == 0 || !result->get(0, 0)) return 0;
+    return std::stoi(*result->get(0, 0));
 }
 
 User* UserDAO::mapRowToUser(MYSQL_ROW row, unsigned long* lengths) {
@@ -401,20 +466,6 @@ User* UserDAO::mapRowToUser(MYSQL_ROW row, unsigned long* lengths) {
     return user;
 }
 
-std::string UserDAO::hashPassword(const std::string& password) {
-    unsigned char hash[SHA256_DIGEST_LENGTH];
-    SHA256_CTX sha256;
-    SHA256_Init(&sha256);
-    SHA256_Update(&sha256, password.c_str(), password.length());
-    SHA256_Final(hash, &sha256);
-    
-    std::stringstream ss;
-    for (int i = 0; i < SHA256_DIGEST_LENGTH; i++) {
-        ss << std::hex << std::setw(2) << std::setfill('0') << (int)hash[i];
-    }
-    return ss.str();
-}
-
 bool UserDAO::verifyPassword(const std::string& password, const std::string& hash) {
-    return hashPassword(password) == hash;
+    return Sha256::hex(password) == hash;
 }
\ No newline at end of file
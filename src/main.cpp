@@ -114,6 +114,7 @@ int main() {
     try {
         // 初始化医院服务
         auto hospitalService = std::make_shared<HospitalService>(host, username, password, database);
+        hospitalService->initializeExistenceFilter();
         
         int choice;
         while (true) {
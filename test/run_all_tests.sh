@@ -14,9 +14,6 @@ if [ ! -f "./build/bin/JsonAPI" ]; then
     exit 1
 fi
 
-# 创建结果目录
-mkdir -p test/results
-
 # 测试计数器
 total_tests=0
 passed_tests=0
@@ -29,60 +26,66 @@ YELLOW='\033[1;33m'
 BLUE='\033[0;34m'
 NC='\033[0m' # No Color
 
-# 运行单个测试的函数
-run_test() {
+# 结果写入临时目录，不覆盖test/results下纳入版本管理的参考结果
+results_dir="./build/test_results/full"
+rm -rf "$results_dir"
+
+# 用例之间有依赖（注册/登录/预约），按 public → patient → doctor 的顺序逐目录批量处理，
+# 每个目录内单线程按文件顺序执行
+for suite in public patient doctor; do
+    if ! ./build/bin/JsonAPI --batch-dir "test/$suite" "$results_dir/$suite" --workers 1 > /dev/null 2>&1; then
+        echo -e "${RED}批量处理失败: $suite${NC}"
+    fi
+done
+
+# 检查单个测试结果的函数
+check_result() {
     local test_file=$1
     local test_name=$(basename "$test_file" .json)
-    local result_file="test/results/${test_name}_result.json"
+    local result_file="$results_dir/${test_file#test/}"
     
     echo -n "运行测试: $test_name ... "
     
-    # 运行测试
-    if ./build/bin/JsonAPI --input "$test_file" --output "$result_file" 2>/dev/null; then
-        # 检查结果文件是否生成
-        if [ -f "$result_file" ]; then
-            # 检查响应是否包含错误
-            if grep -q '"status": "error"' "$result_file"; then
-                echo -e "${YELLOW}EXPECTED_ERROR${NC}"
-            else
-                echo -e "${GREEN}PASS${NC}"
-                ((passed_tests++))
-            fi
+    # 检查结果文件是否生成
+    if [ -f "$result_file" ]; then
+        # 检查响应是否包含错误
+        if grep -q '"status": *"error"' "$result_file"; then
+            echo -e "${YELLOW}EXPECTED_ERROR${NC}"
         else
-            echo -e "${RED}FAIL (no output)${NC}"
-            ((failed_tests++))
+            echo -e "${GREEN}PASS${NC}"
+            ((passed_tests++))
         fi
     else
-        echo -e "${RED}FAIL (execution error)${NC}"
+        echo -e "${RED}FAIL (no output)${NC}"
         ((failed_tests++))
     fi
     
     ((total_tests++))
 }
 
-# 运行Public API测试
+# Public API测试结果
 echo -e "${BLUE}=== Public API 测试 ===${NC}"
 for test_file in test/public/*.json; do
     if [ -f "$test_file" ]; then
-        run_test "$test_file"
+        check_result "$test_file"
     fi
 done
 echo ""
 
-# 运行Patient API测试
+# Patient API测试结果
 echo -e "${BLUE}=== Patient API 测试 ===${NC}"
 for test_file in test/patient/*.json; do
     if [ -f "$test_file" ]; then
-        run_test "$test_file"
+        check_result "$test_file"
     fi
 done
 echo ""
 
-# 运行Doctor API测试
+# Doctor API测试结果
 echo -e "${BLUE}=== Doctor API 测试 ===${NC}"
 for test_file in test/doctor/*.json; do
     if [ -f "$test_file" ]; then
-        run_test "$test_file"
+        check_result "$test_file"
     fi
 done
 echo ""